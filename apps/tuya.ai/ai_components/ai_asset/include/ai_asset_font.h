@@ -0,0 +1,182 @@
+/**
+ * @file ai_asset_font.h
+ * @brief Header file for the bitmap fonts of an asset pack.
+ *
+ * A font asset holds the tables of an lv_font_conv font (glyph descriptions, character maps and kerning) and its
+ * glyph bitmaps split in blocks, a glyph never crosses a block. Letters are looked up through a small cache, the
+ * blocks are decompressed through the cache of the pack. This module does not depend on LVGL, ai_asset_lvgl.h
+ * turns a font into an lv_font_t.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#ifndef __AI_ASSET_FONT_H__
+#define __AI_ASSET_FONT_H__
+
+#include "tuya_cloud_types.h"
+
+#include "ai_asset_pack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define AI_ASSET_FONT_BLOCK_SIZE_DEFAULT 4096
+
+// character map types, same values as lv_font_fmt_txt_cmap_type_t
+#define AI_ASSET_CMAP_FORMAT0_FULL 0
+#define AI_ASSET_CMAP_SPARSE_FULL  1
+#define AI_ASSET_CMAP_FORMAT0_TINY 2
+#define AI_ASSET_CMAP_SPARSE_TINY  3
+
+#define AI_ASSET_KERN_NONE    0
+#define AI_ASSET_KERN_PAIRS   1 // uint16_t left/right glyph id pairs sorted, then int8_t values
+#define AI_ASSET_KERN_CLASSES 2 // uint8_t left and right class of each glyph, then int8_t class pair values
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *AI_ASSET_FONT_HANDLE;
+
+/*
+ * Font asset layout, offsets are from the start of the asset:
+ *   AI_ASSET_FONT_HEAD_T
+ *   AI_ASSET_GLYPH_T x glyph_num, glyph 0 is reserved
+ *   AI_ASSET_CMAP_T x cmap_num and their lists
+ *   kerning, see AI_ASSET_KERN_xxx
+ *   AI_ASSET_BLOCK_T x block_num
+ *   block data
+ * Everything before block data is the font tables, kept in RAM unless the pack is memory mapped.
+ */
+typedef struct {
+    int16_t  line_height;
+    int16_t  base_line;
+    int8_t   underline_position;
+    int8_t   underline_thickness;
+    uint8_t  bpp;         // 1, 2, 4 or 8
+    uint8_t  subpx;       // lv_font_subpx_t
+    uint16_t kern_scale;  // 12.4 format
+    uint8_t  kern_type;   // AI_ASSET_KERN_xxx
+    uint8_t  reserved;
+    uint16_t cmap_num;
+    uint16_t kern_left;   // left class count
+    uint32_t kern_right;  // right class count, or pair count for AI_ASSET_KERN_PAIRS
+    uint32_t glyph_num;
+    uint32_t block_size;  // nominal raw bytes of a block
+    uint32_t block_num;
+    uint32_t glyph_ofs;
+    uint32_t cmap_ofs;
+    uint32_t kern_ofs;
+    uint32_t block_ofs;
+    uint32_t table_len;   // bytes of the tables, the block data starts here
+} AI_ASSET_FONT_HEAD_T;
+
+typedef struct {
+    uint32_t bitmap_index; // offset of the bitmap in the glyph bitmap of the original font
+    uint16_t adv_w;        // 12.4 format
+    uint8_t  box_w;
+    uint8_t  box_h;
+    int8_t   ofs_x;
+    int8_t   ofs_y;
+    uint16_t block;        // block holding the bitmap
+} AI_ASSET_GLYPH_T;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint32_t list_ofs;    // list of the map from the start of the asset, 0 if none:
+                          // FORMAT0_FULL: uint8_t glyph id offset x range_length
+                          // SPARSE_TINY: uint16_t unicode offset x list_length
+                          // SPARSE_FULL: uint16_t unicode offset x list_length, then uint16_t glyph id offsets
+    uint16_t list_length;
+    uint8_t  type;        // AI_ASSET_CMAP_xxx
+    uint8_t  reserved;
+} AI_ASSET_CMAP_T;
+
+typedef struct {
+    uint32_t raw_start; // bitmap_index of the first byte of the block
+    uint32_t raw_len;
+    uint32_t data_ofs;  // offset of the stored block from the start of the asset
+    uint32_t data_len;  // stored bytes, equal to raw_len if the block is not compressed
+} AI_ASSET_BLOCK_T;
+
+typedef struct {
+    uint32_t gid;   // glyph id, 0 if the letter is not in the font
+    uint32_t adv_w; // advance width in px, kerning applied
+    uint16_t box_w;
+    uint16_t box_h;
+    int16_t  ofs_x;
+    int16_t  ofs_y;
+} AI_ASSET_GLYPH_DSC_T;
+
+typedef struct {
+    uint32_t lookups;
+    uint32_t lookup_hit; // letters found in the lookup cache
+    uint32_t glyphs;     // bitmaps drawn
+} AI_ASSET_FONT_STATS_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Opens a font of a pack.
+ * @param pack Pack handle.
+ * @param name Asset name of the font.
+ * @param handle Pointer to receive the font handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_open(AI_ASSET_PACK_HANDLE pack, const char *name, AI_ASSET_FONT_HANDLE *handle);
+
+/**
+ * @brief Closes a font.
+ * @param handle Font handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_close(AI_ASSET_FONT_HANDLE handle);
+
+/**
+ * @brief Gets the header of a font, line height, base line, bpp...
+ * @param handle Font handle.
+ * @return const AI_ASSET_FONT_HEAD_T* - The font header.
+ */
+const AI_ASSET_FONT_HEAD_T *ai_asset_font_head_get(AI_ASSET_FONT_HANDLE handle);
+
+/**
+ * @brief Describes the glyph of a letter.
+ * @param handle Font handle.
+ * @param letter Unicode letter.
+ * @param letter_next Next unicode letter for kerning, 0 if none.
+ * @param dsc Pointer to receive the glyph description.
+ * @return BOOL_T - TRUE if the letter is in the font.
+ */
+BOOL_T ai_asset_font_glyph_dsc_get(AI_ASSET_FONT_HANDLE handle, uint32_t letter, uint32_t letter_next,
+                                   AI_ASSET_GLYPH_DSC_T *dsc);
+
+/**
+ * @brief Draws the bitmap of a glyph as 8 bits per pixel alpha.
+ * @param handle Font handle.
+ * @param gid Glyph id from ai_asset_font_glyph_dsc_get.
+ * @param out Buffer of box_h rows of stride bytes.
+ * @param stride Bytes of a row of out, at least box_w.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_glyph_bitmap_get(AI_ASSET_FONT_HANDLE handle, uint32_t gid, uint8_t *out,
+                                           uint32_t stride);
+
+/**
+ * @brief Gets the statistics of a font.
+ * @param handle Font handle.
+ * @param stats Pointer to receive the statistics.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_stats_get(AI_ASSET_FONT_HANDLE handle, AI_ASSET_FONT_STATS_T *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_ASSET_FONT_H__ */
@@ -0,0 +1,63 @@
+/**
+ * @file ai_asset_lvgl.h
+ * @brief Header file for the LVGL fonts and images served from an asset pack.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#ifndef __AI_ASSET_LVGL_H__
+#define __AI_ASSET_LVGL_H__
+
+#include "tuya_cloud_types.h"
+
+#include "ai_asset_pack.h"
+
+#if defined(ENABLE_LIBLVGL) && (ENABLE_LIBLVGL == 1)
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Creates an LVGL font from a font of a pack, drawn glyph by glyph from the pack.
+ * @param pack Pack handle.
+ * @param name Asset name of the font, the name of the lv_font_t it replaces.
+ * @return lv_font_t* - The font, NULL if it is not in the pack.
+ */
+lv_font_t *ai_asset_lv_font_create(AI_ASSET_PACK_HANDLE pack, const char *name);
+
+/**
+ * @brief Destroys a font created by ai_asset_lv_font_create, no label must use it anymore.
+ * @param font The font.
+ * @return None
+ */
+void ai_asset_lv_font_destroy(lv_font_t *font);
+
+/**
+ * @brief Loads an image of a pack, decompressed if needed.
+ * @param pack Pack handle.
+ * @param name Asset name of the image, the name of the lv_image_dsc_t it replaces.
+ * @param dsc Image descriptor to fill in, to be released with ai_asset_lv_image_release.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_lv_image_load(AI_ASSET_PACK_HANDLE pack, const char *name, lv_image_dsc_t *dsc);
+
+/**
+ * @brief Releases an image loaded by ai_asset_lv_image_load and drops it from the LVGL image cache.
+ * @param pack Pack handle.
+ * @param dsc Image descriptor.
+ * @return None
+ */
+void ai_asset_lv_image_release(AI_ASSET_PACK_HANDLE pack, lv_image_dsc_t *dsc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENABLE_LIBLVGL */
+
+#endif /* __AI_ASSET_LVGL_H__ */
@@ -0,0 +1,275 @@
+/**
+ * @file ai_asset_pack.h
+ * @brief Header file for the asset pack loader, fonts, images and sounds kept out of the firmware image.
+ *
+ * A pack is built on the host by script/ai_asset_pack.py and stored in a flash partition or a file. It starts with
+ * a header and an index sorted by name, followed by the assets, each one aligned to head.align. An asset is stored
+ * as is or LZ4 compressed. Fonts are stored as tables followed by their glyph bitmaps in LZ4 blocks of a few KB,
+ * so a glyph is drawn by decompressing one block, the last blocks used are kept in a cache shared by the pack.
+ *
+ * When the pack is memory mapped (ai_asset_pack_open_mem), the index, the font tables and the assets stored as is
+ * are used in place, without any copy in RAM.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#ifndef __AI_ASSET_PACK_H__
+#define __AI_ASSET_PACK_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define AI_ASSET_MAGIC       0x4B504154 // "TAPK"
+#define AI_ASSET_VERSION     1
+#define AI_ASSET_NAME_LEN    32
+#define AI_ASSET_ALIGN_MIN   4
+
+// decompressed blocks kept by a pack, the RAM used is about cache_num * the block size of the fonts
+#define AI_ASSET_CACHE_NUM_DEFAULT 8
+
+typedef uint8_t AI_ASSET_TYPE_E;
+#define AI_ASSET_TYPE_RAW   0x00
+#define AI_ASSET_TYPE_FONT  0x01 // AI_ASSET_FONT_HEAD_T and its tables, see ai_asset_font.h
+#define AI_ASSET_TYPE_IMAGE 0x02 // image data, meta holds the LVGL image header
+#define AI_ASSET_TYPE_MEDIA 0x03 // encoded audio, mp3...
+
+typedef uint8_t AI_ASSET_COMP_E;
+#define AI_ASSET_COMP_NONE 0x00
+#define AI_ASSET_COMP_LZ4  0x01 // LZ4 block format, raw_size bytes once decompressed
+
+// meta of AI_ASSET_TYPE_IMAGE
+#define AI_ASSET_IMAGE_CF(entry)     ((entry)->meta[0] & 0xFF)
+#define AI_ASSET_IMAGE_FLAGS(entry)  (((entry)->meta[0] >> 16) & 0xFFFF)
+#define AI_ASSET_IMAGE_W(entry)      ((entry)->meta[1] & 0xFFFF)
+#define AI_ASSET_IMAGE_H(entry)      (((entry)->meta[1] >> 16) & 0xFFFF)
+#define AI_ASSET_IMAGE_STRIDE(entry) ((entry)->meta[2] & 0xFFFF)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *AI_ASSET_PACK_HANDLE;
+
+/*
+ * Pack layout, all fields little endian:
+ *   AI_ASSET_HEAD_T
+ *   AI_ASSET_ENTRY_T x asset_num, sorted by name
+ *   assets, each one at a multiple of align from the start of the pack
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t head_len;  // sizeof(AI_ASSET_HEAD_T)
+    uint32_t asset_num;
+    uint32_t index_ofs; // offset of the index
+    uint32_t align;
+    uint32_t total_len; // bytes of the whole pack
+    uint32_t index_crc; // crc32 of the index
+    uint32_t reserved;
+} AI_ASSET_HEAD_T;
+
+typedef struct {
+    char     name[AI_ASSET_NAME_LEN]; // symbol name of the C array it replaces, zero padded
+    uint8_t  type;                    // AI_ASSET_TYPE_xxx
+    uint8_t  comp;                    // AI_ASSET_COMP_xxx
+    uint16_t reserved;
+    uint32_t offset;   // offset of the stored data from the start of the pack
+    uint32_t size;     // stored bytes
+    uint32_t raw_size; // bytes once decompressed, for fonts the size of the built-in C arrays
+    uint32_t crc;      // crc32 of the stored bytes
+    uint32_t meta[3];  // type specific
+} AI_ASSET_ENTRY_T;
+
+typedef struct {
+    uint16_t cache_num; // decompressed blocks kept, 0 -> AI_ASSET_CACHE_NUM_DEFAULT
+    uint8_t  check_crc; // check the crc of the assets when they are loaded
+} AI_ASSET_PACK_CFG_T;
+
+typedef struct {
+    uint32_t ram_bytes;   // heap used by the pack: index, font tables and cache, without the loaded assets
+    uint32_t cache_hit;
+    uint32_t cache_miss;
+    uint32_t read_bytes;  // bytes read from flash or file
+    uint32_t decomp_bytes; // bytes produced by the decompressor
+} AI_ASSET_PACK_STATS_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Opens a pack stored in a file.
+ * @param path Path of the pack file.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_file(const char *path, AI_ASSET_PACK_CFG_T *cfg, AI_ASSET_PACK_HANDLE *handle);
+
+/**
+ * @brief Opens a pack stored in a flash partition, read with tkl_flash_read.
+ * @param type Flash partition holding the pack.
+ * @param offset Offset of the pack in the partition.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_flash(TUYA_FLASH_TYPE_E type, uint32_t offset, AI_ASSET_PACK_CFG_T *cfg,
+                                     AI_ASSET_PACK_HANDLE *handle);
+
+/**
+ * @brief Opens a pack mapped in memory, the memory must stay valid until the pack is closed.
+ *        Uncompressed assets and the font tables are used in place.
+ * @param addr Address of the pack, aligned to AI_ASSET_ALIGN_MIN.
+ * @param len Bytes available at addr.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_mem(const void *addr, uint32_t len, AI_ASSET_PACK_CFG_T *cfg,
+                                   AI_ASSET_PACK_HANDLE *handle);
+
+/**
+ * @brief Closes a pack, the fonts opened from it must be closed and the loaded assets released first.
+ * @param handle Pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_close(AI_ASSET_PACK_HANDLE handle);
+
+/**
+ * @brief Sets the pack used by the components that look up assets by name, alerts, display...
+ * @param handle Pack handle, NULL to clear it.
+ * @return None
+ */
+void ai_asset_pack_default_set(AI_ASSET_PACK_HANDLE handle);
+
+/**
+ * @brief Gets the pack set by ai_asset_pack_default_set.
+ * @param None
+ * @return AI_ASSET_PACK_HANDLE - The pack handle, NULL if no pack is set.
+ */
+AI_ASSET_PACK_HANDLE ai_asset_pack_default_get(void);
+
+/**
+ * @brief Gets the statistics of a pack.
+ * @param handle Pack handle.
+ * @param stats Pointer to receive the statistics.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_stats_get(AI_ASSET_PACK_HANDLE handle, AI_ASSET_PACK_STATS_T *stats);
+
+/**
+ * @brief Gets the number of assets in a pack.
+ * @param handle Pack handle.
+ * @return uint32_t - The number of assets.
+ */
+uint32_t ai_asset_num_get(AI_ASSET_PACK_HANDLE handle);
+
+/**
+ * @brief Gets an asset by its position in the index.
+ * @param handle Pack handle.
+ * @param idx Position in the index, 0 ~ ai_asset_num_get() - 1.
+ * @return const AI_ASSET_ENTRY_T* - The index entry, NULL if idx is out of range.
+ */
+const AI_ASSET_ENTRY_T *ai_asset_get(AI_ASSET_PACK_HANDLE handle, uint32_t idx);
+
+/**
+ * @brief Finds an asset by name.
+ * @param handle Pack handle.
+ * @param name Asset name.
+ * @return const AI_ASSET_ENTRY_T* - The index entry, valid until the pack is closed, NULL if not found.
+ */
+const AI_ASSET_ENTRY_T *ai_asset_find(AI_ASSET_PACK_HANDLE handle, const char *name);
+
+/**
+ * @brief Reads stored bytes of an asset, the data is not decompressed.
+ * @param handle Pack handle.
+ * @param entry Index entry of the asset.
+ * @param offset Offset in the stored data.
+ * @param buf Buffer to receive the data.
+ * @param len Bytes to read.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_read(AI_ASSET_PACK_HANDLE handle, const AI_ASSET_ENTRY_T *entry, uint32_t offset, void *buf,
+                          uint32_t len);
+
+/**
+ * @brief Loads the content of an asset, decompressed. The data is used in place when the pack is memory mapped
+ *        and the asset is not compressed, otherwise it is loaded in a buffer allocated for the caller.
+ * @param handle Pack handle.
+ * @param entry Index entry of the asset.
+ * @param data Pointer to receive the content, to be released with ai_asset_release.
+ * @param len Pointer to receive the content length.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_load(AI_ASSET_PACK_HANDLE handle, const AI_ASSET_ENTRY_T *entry, const uint8_t **data,
+                          uint32_t *len);
+
+/**
+ * @brief Releases the content returned by ai_asset_load.
+ * @param handle Pack handle.
+ * @param data Content returned by ai_asset_load.
+ * @return None
+ */
+void ai_asset_release(AI_ASSET_PACK_HANDLE handle, const uint8_t *data);
+
+/**
+ * @brief Gets a block of an asset decompressed, through the cache of the pack. The block stays valid until
+ *        ai_asset_block_put is called.
+ * @param handle Pack handle.
+ * @param offset Offset of the stored block from the start of the pack.
+ * @param size Stored bytes of the block, equal to raw_size when the block is not compressed.
+ * @param raw_size Bytes of the block once decompressed.
+ * @param data Pointer to receive the block.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_block_get(AI_ASSET_PACK_HANDLE handle, uint32_t offset, uint32_t size, uint32_t raw_size,
+                               const uint8_t **data);
+
+/**
+ * @brief Gives back a block got by ai_asset_block_get.
+ * @param handle Pack handle.
+ * @param data Block returned by ai_asset_block_get.
+ * @return None
+ */
+void ai_asset_block_put(AI_ASSET_PACK_HANDLE handle, const uint8_t *data);
+
+/**
+ * @brief Gets a part of a pack read only, in place when the pack is memory mapped, otherwise read in a buffer
+ *        allocated and accounted to the pack. Used to keep the font tables.
+ * @param handle Pack handle.
+ * @param offset Offset from the start of the pack.
+ * @param len Bytes to get.
+ * @param data Pointer to receive the data, to be released with ai_asset_table_put.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_table_get(AI_ASSET_PACK_HANDLE handle, uint32_t offset, uint32_t len, const uint8_t **data);
+
+/**
+ * @brief Releases the data got by ai_asset_table_get.
+ * @param handle Pack handle.
+ * @param data Data returned by ai_asset_table_get.
+ * @param len Bytes passed to ai_asset_table_get.
+ * @return None
+ */
+void ai_asset_table_put(AI_ASSET_PACK_HANDLE handle, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Decompresses an LZ4 block.
+ * @param src Compressed data.
+ * @param src_len Compressed bytes.
+ * @param dst Buffer to receive the data.
+ * @param dst_len Size of dst, the block must decompress to exactly dst_len bytes.
+ * @return OPERATE_RET - OPRT_OK on success, OPRT_COM_ERROR if the block is corrupted.
+ */
+OPERATE_RET ai_asset_lz4_decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst, uint32_t dst_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_ASSET_PACK_H__ */
@@ -0,0 +1,641 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Builds an asset pack from the C arrays of the firmware (lv_font_conv fonts, LVGL images, media alerts) and from
+plain files, see ai_asset_pack.h for the layout.
+
+    ai_asset_pack.py -o assets.bin font_puhui_18_2.c TuyaOpen_img_320_480.c ai_media_alert.c boot=boot.mp3
+    ai_asset_pack.py --list assets.bin
+
+Every asset is named after the C symbol it replaces, so the firmware looks it up with the same name. Fonts keep
+their tables as is and split their glyph bitmaps in LZ4 blocks of --block bytes, the other assets are LZ4
+compressed as a whole when it saves enough, otherwise stored as is so they can be streamed or used in place.
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+try:
+    import lz4.block as lz4_block
+except ImportError:
+    lz4_block = None
+
+AI_ASSET_MAGIC = 0x4B504154
+AI_ASSET_VERSION = 1
+AI_ASSET_NAME_LEN = 32
+AI_ASSET_ALIGN_MIN = 4
+
+AI_ASSET_TYPE_RAW = 0
+AI_ASSET_TYPE_FONT = 1
+AI_ASSET_TYPE_IMAGE = 2
+AI_ASSET_TYPE_MEDIA = 3
+TYPE_NAMES = {AI_ASSET_TYPE_RAW: "raw", AI_ASSET_TYPE_FONT: "font", AI_ASSET_TYPE_IMAGE: "image",
+              AI_ASSET_TYPE_MEDIA: "media"}
+
+AI_ASSET_COMP_NONE = 0
+AI_ASSET_COMP_LZ4 = 1
+
+AI_ASSET_KERN_NONE = 0
+AI_ASSET_KERN_PAIRS = 1
+AI_ASSET_KERN_CLASSES = 2
+
+HEAD_FMT = "<IHHIIIIII"          # AI_ASSET_HEAD_T
+ENTRY_FMT = "<32sBBHIIII3I"      # AI_ASSET_ENTRY_T
+FONT_HEAD_FMT = "<hhbbBBHBBHHIIIIIIIII"  # AI_ASSET_FONT_HEAD_T
+GLYPH_FMT = "<IHBBbbH"           # AI_ASSET_GLYPH_T
+CMAP_FMT = "<IHHIHBB"            # AI_ASSET_CMAP_T
+BLOCK_FMT = "<IIII"              # AI_ASSET_BLOCK_T
+
+# sizes of the LVGL structures of the built-in arrays, 32 bits target with LV_FONT_FMT_TXT_LARGE
+LV_GLYPH_DSC_SIZE = 16
+LV_CMAP_SIZE = 20
+LV_IMAGE_DSC_SIZE = 24
+
+CMAP_TYPES = {
+    "LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL": 0,
+    "LV_FONT_FMT_TXT_CMAP_SPARSE_FULL": 1,
+    "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY": 2,
+    "LV_FONT_FMT_TXT_CMAP_SPARSE_TINY": 3,
+}
+
+SUBPX = {"LV_FONT_SUBPX_NONE": 0, "LV_FONT_SUBPX_HOR": 1, "LV_FONT_SUBPX_VER": 2, "LV_FONT_SUBPX_BOTH": 3}
+
+COLOR_FORMATS = {
+    "LV_COLOR_FORMAT_UNKNOWN": 0x00, "LV_COLOR_FORMAT_RAW": 0x01, "LV_COLOR_FORMAT_RAW_ALPHA": 0x02,
+    "LV_COLOR_FORMAT_L8": 0x06, "LV_COLOR_FORMAT_I1": 0x07, "LV_COLOR_FORMAT_I2": 0x08,
+    "LV_COLOR_FORMAT_I4": 0x09, "LV_COLOR_FORMAT_I8": 0x0A, "LV_COLOR_FORMAT_A1": 0x0B,
+    "LV_COLOR_FORMAT_A2": 0x0C, "LV_COLOR_FORMAT_A4": 0x0D, "LV_COLOR_FORMAT_A8": 0x0E,
+    "LV_COLOR_FORMAT_RGB888": 0x0F, "LV_COLOR_FORMAT_ARGB8888": 0x10, "LV_COLOR_FORMAT_XRGB8888": 0x11,
+    "LV_COLOR_FORMAT_RGB565": 0x12, "LV_COLOR_FORMAT_ARGB8565": 0x13, "LV_COLOR_FORMAT_RGB565A8": 0x14,
+}
+
+MEDIA_EXT = (".mp3", ".wav", ".opus", ".pcm", ".amr")
+IMAGE_EXT = (".gif", ".png", ".jpg", ".jpeg", ".bmp")
+
+
+def align_up(value, align):
+    return (value + align - 1) & ~(align - 1)
+
+
+# ---------------------------------------------------------------------------------------------------------------
+# LZ4 block format
+# ---------------------------------------------------------------------------------------------------------------
+def _lz4_len(out, value):
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def _lz4_sequence(out, literals, offset, match_len):
+    lit_len = len(literals)
+    token = min(lit_len, 15) << 4
+    if offset:
+        token |= min(match_len - 4, 15)
+    out.append(token)
+    if lit_len >= 15:
+        _lz4_len(out, lit_len - 15)
+    out += literals
+    if offset:
+        out += struct.pack("<H", offset)
+        if match_len - 4 >= 15:
+            _lz4_len(out, match_len - 4 - 15)
+
+
+def lz4_compress(data):
+    """Greedy LZ4 block compressor, used when the lz4 module is not installed."""
+    if lz4_block is not None:
+        return lz4_block.compress(bytes(data), store_size=False, mode="high_compression")
+
+    data = bytes(data)
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    # the spec keeps the last 5 bytes as literals and the last match 12 bytes away from the end
+    match_limit = n - 12
+    end_limit = n - 5
+    while pos < match_limit:
+        seq = data[pos:pos + 4]
+        cand = table.get(seq)
+        table[seq] = pos
+        if cand is None or pos - cand > 0xFFFF:
+            pos += 1
+            continue
+        match_len = 4
+        while pos + match_len + 16 <= end_limit and \
+                data[cand + match_len:cand + match_len + 16] == data[pos + match_len:pos + match_len + 16]:
+            match_len += 16
+        while pos + match_len < end_limit and data[cand + match_len] == data[pos + match_len]:
+            match_len += 1
+        _lz4_sequence(out, data[anchor:pos], pos - cand, match_len)
+        pos += match_len
+        anchor = pos
+        if pos - 2 < match_limit:
+            table[data[pos - 2:pos + 2]] = pos - 2
+    _lz4_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def lz4_decompress(src, raw_len):
+    out = bytearray()
+    ip = 0
+    while ip < len(src):
+        token = src[ip]
+        ip += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                lit_len += b
+                if b != 255:
+                    break
+        out += src[ip:ip + lit_len]
+        ip += lit_len
+        if ip >= len(src):
+            break
+        offset = src[ip] | (src[ip + 1] << 8)
+        ip += 2
+        match_len = token & 0x0F
+        if match_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += 4
+        start = len(out) - offset
+        for i in range(match_len):
+            out.append(out[start + i])
+    if len(out) != raw_len:
+        raise ValueError("lz4 length mismatch")
+    return bytes(out)
+
+
+def compress(data, min_gain):
+    """Returns (comp, stored), stored as is unless LZ4 saves min_gain of the size."""
+    if len(data) < 64:
+        return AI_ASSET_COMP_NONE, data
+    packed = lz4_compress(data)
+    if len(packed) < len(data) and len(data) - len(packed) >= len(data) * min_gain:
+        return AI_ASSET_COMP_LZ4, packed
+    return AI_ASSET_COMP_NONE, data
+
+
+# ---------------------------------------------------------------------------------------------------------------
+# C source parsing
+# ---------------------------------------------------------------------------------------------------------------
+def c_preprocess(text):
+    """Drops the comments and keeps the first branch of every #if, the lv_font_conv and LVGL image converter
+    outputs only use #if for LVGL versions and feature switches."""
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    text = re.sub(r"//[^\n]*", " ", text)
+    lines = []
+    stack = []
+    for line in text.split("\n"):
+        directive = line.strip()
+        if directive.startswith("#"):
+            word = directive[1:].strip().split(" ")[0].split("(")[0]
+            if word in ("if", "ifdef", "ifndef"):
+                stack.append(True)
+            elif word in ("elif", "else"):
+                if stack:
+                    stack[-1] = False
+            elif word == "endif":
+                if stack:
+                    stack.pop()
+            continue
+        if all(stack):
+            lines.append(line)
+    return "\n".join(lines)
+
+
+def c_body(text, name, tail=r"\s*=\s*\{"):
+    """Returns the text between the braces of the initializer of name, None if not found."""
+    # searched from the literal name, a leading \b makes the regex scan the multi MB font files very slowly
+    m = None
+    for found in re.finditer(re.escape(name) + tail, text):
+        if found.start() == 0 or not (text[found.start() - 1].isalnum() or text[found.start() - 1] == "_"):
+            m = found
+            break
+    if not m:
+        return None
+    start = text.index("{", m.end() - 1)
+    depth = 0
+    for brace in re.finditer(r"[{}]", text[start:]):
+        depth += 1 if brace.group(0) == "{" else -1
+        if depth == 0:
+            return text[start + 1:start + brace.start()]
+    raise ValueError("unbalanced braces after %s" % name)
+
+
+def c_array(text, name):
+    body = c_body(text, name, r"\s*\[[^\]]*\]\s*=\s*\{")
+    if body is None:
+        raise ValueError("array %s not found" % name)
+    return body
+
+
+def c_bytes(text, name):
+    body = c_array(text, name)
+    if re.search(r"\b0x[0-9a-fA-F]{3,}", body):
+        raise ValueError("array %s is not a byte array" % name)
+    # most arrays are plain hex bytes, parsed in one go
+    hex_bytes = re.findall(r"0x([0-9a-fA-F]{1,2})\b", body)
+    tokens = [t for t in re.split(r"[\s,]+", body) if t]
+    if len(hex_bytes) == len(tokens):
+        return bytes.fromhex("".join(h.rjust(2, "0") for h in hex_bytes))
+    return bytes(int(t, 0) & 0xFF for t in tokens)
+
+
+def c_ints(text, name):
+    return [int(t, 0) for t in re.split(r"[\s,]+", c_array(text, name)) if t]
+
+
+def c_fields(body):
+    """Designated initializers .field = value of one struct."""
+    return {m.group(1): m.group(2).strip() for m in re.finditer(r"\.(\w+)\s*=\s*([^,{}]+)", body)}
+
+
+def c_struct_items(body):
+    return [c_fields(m.group(1)) for m in re.finditer(r"\{([^{}]*)\}", body)]
+
+
+def c_value(value, arrays=None):
+    """Evaluates a simple C constant expression: numbers, + - * /, sizeof(array)."""
+    value = value.strip()
+    if arrays is not None:
+        value = re.sub(r"sizeof\s*\(\s*(\w+)\s*\)", lambda m: str(len(arrays[m.group(1)])), value)
+    value = re.sub(r"\b(0x[0-9a-fA-F]+|\d+)[uUlL]*\b", r"\1", value)
+    if not re.fullmatch(r"[0-9a-fA-Fx\s+\-*/()]+", value):
+        raise ValueError("cannot evaluate %s" % value)
+    return int(eval(value, {"__builtins__": {}}))  # only digits and operators at this point
+
+
+def c_is_null(value):
+    return value is None or value.strip() in ("NULL", "0")
+
+
+def c_ref(value):
+    return value.strip().lstrip("&").strip()
+
+
+# ---------------------------------------------------------------------------------------------------------------
+# assets
+# ---------------------------------------------------------------------------------------------------------------
+class Asset:
+    def __init__(self, name, type_, raw, builtin_size, meta=(0, 0, 0), payload=None):
+        if len(name.encode()) >= AI_ASSET_NAME_LEN:
+            raise ValueError("asset name %s longer than %d" % (name, AI_ASSET_NAME_LEN - 1))
+        self.name = name
+        self.type = type_
+        self.raw = raw                  # content once loaded
+        self.builtin_size = builtin_size  # bytes of the C arrays it replaces
+        self.meta = meta
+        self.payload = payload          # stored as is, fonts are compressed block by block
+        self.comp = AI_ASSET_COMP_NONE
+        self.stored = b""
+        self.blocks = 0
+
+
+def font_asset(text, font_name, block_size):
+    lv_font = c_fields(c_body(text, font_name))
+    dsc_name = c_ref(lv_font["dsc"])
+    dsc = c_fields(c_body(text, dsc_name))
+
+    if int(dsc.get("bitmap_format", "0"), 0) != 0:
+        raise ValueError("%s: compressed lv_font_conv bitmaps are not supported, convert with --no-compress"
+                         % font_name)
+    bpp = int(dsc["bpp"], 0)
+    if bpp not in (1, 2, 4, 8):
+        raise ValueError("%s: bpp %d not supported" % (font_name, bpp))
+
+    bitmap = c_bytes(text, c_ref(dsc["glyph_bitmap"]))
+    glyphs = c_struct_items(c_array(text, c_ref(dsc["glyph_dsc"])))
+    glyphs = [{k: c_value(v) for k, v in g.items()} for g in glyphs]
+    glyph_num = len(glyphs)
+    builtin = len(bitmap) + glyph_num * LV_GLYPH_DSC_SIZE
+
+    for gid, g in enumerate(glyphs):
+        if not (0 <= g["box_w"] <= 255 and 0 <= g["box_h"] <= 255 and -128 <= g["ofs_x"] <= 127 and
+                -128 <= g["ofs_y"] <= 127 and 0 <= g["adv_w"] <= 0xFFFF):
+            raise ValueError("%s: glyph %d out of range" % (font_name, gid))
+
+    # character maps
+    cmaps = []
+    lists = []
+    for c in c_struct_items(c_array(text, c_ref(dsc["cmaps"]))):
+        cmap_type = CMAP_TYPES[c["type"].strip()]
+        list_length = c_value(c.get("list_length", "0"))
+        range_length = c_value(c["range_length"])
+        unicode_list = None if c_is_null(c.get("unicode_list")) else c_ints(text, c_ref(c["unicode_list"]))
+        ofs_list = None if c_is_null(c.get("glyph_id_ofs_list")) else c_ints(text, c_ref(c["glyph_id_ofs_list"]))
+        if cmap_type == CMAP_TYPES["LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL"]:
+            data = bytes(ofs_list[:range_length])
+            builtin += len(ofs_list)
+        elif cmap_type == CMAP_TYPES["LV_FONT_FMT_TXT_CMAP_SPARSE_TINY"]:
+            data = struct.pack("<%dH" % list_length, *unicode_list[:list_length])
+            builtin += len(unicode_list) * 2
+        elif cmap_type == CMAP_TYPES["LV_FONT_FMT_TXT_CMAP_SPARSE_FULL"]:
+            data = struct.pack("<%dH" % list_length, *unicode_list[:list_length]) + \
+                struct.pack("<%dH" % list_length, *ofs_list[:list_length])
+            builtin += len(unicode_list) * 2 + len(ofs_list) * 2
+        else:
+            data = b""
+        cmaps.append((c_value(c["range_start"]), range_length, c_value(c["glyph_id_start"]), list_length,
+                      cmap_type))
+        lists.append(data)
+    builtin += len(cmaps) * LV_CMAP_SIZE
+
+    # kerning
+    kern_type, kern_left, kern_right, kern = AI_ASSET_KERN_NONE, 0, 0, b""
+    if not c_is_null(dsc.get("kern_dsc")):
+        kern_fields = c_fields(c_body(text, c_ref(dsc["kern_dsc"])))
+        if int(dsc.get("kern_classes", "0"), 0):
+            kern_left = c_value(kern_fields["left_class_cnt"])
+            kern_right = c_value(kern_fields["right_class_cnt"])
+            left_map = c_ints(text, c_ref(kern_fields["left_class_mapping"]))
+            right_map = c_ints(text, c_ref(kern_fields["right_class_mapping"]))
+            values = c_ints(text, c_ref(kern_fields["class_pair_values"]))
+            builtin += len(left_map) + len(right_map) + len(values)
+            left_map = (left_map + [0] * glyph_num)[:glyph_num]
+            right_map = (right_map + [0] * glyph_num)[:glyph_num]
+            kern_type = AI_ASSET_KERN_CLASSES
+            kern = bytes(left_map) + bytes(right_map) + struct.pack("<%db" % (kern_left * kern_right),
+                                                                    *values[:kern_left * kern_right])
+        else:
+            pair_cnt = c_value(kern_fields["pair_cnt"])
+            ids = c_ints(text, c_ref(kern_fields["glyph_ids"]))
+            values = c_ints(text, c_ref(kern_fields["values"]))
+            builtin += len(ids) * (2 if int(kern_fields.get("glyph_ids_size", "0"), 0) else 1) + len(values)
+            pairs = sorted(((ids[i * 2], ids[i * 2 + 1]), values[i]) for i in range(pair_cnt))
+            kern_type = AI_ASSET_KERN_PAIRS
+            kern_right = pair_cnt
+            kern = struct.pack("<%dH" % (pair_cnt * 2), *[g for p in pairs for g in p[0]]) + \
+                struct.pack("<%db" % pair_cnt, *[p[1] for p in pairs])
+
+    # glyph bitmaps in blocks, a glyph never crosses a block
+    order = sorted(range(1, glyph_num), key=lambda gid: glyphs[gid]["bitmap_index"])
+    glyph_block = [0] * glyph_num
+    blocks = []  # [raw_start, raw_end]
+    for gid in order:
+        g = glyphs[gid]
+        length = (g["box_w"] * g["box_h"] * bpp + 7) >> 3
+        if length == 0:
+            continue
+        start, end = g["bitmap_index"], g["bitmap_index"] + length
+        if end > len(bitmap):
+            raise ValueError("%s: glyph %d out of the bitmap" % (font_name, gid))
+        if not blocks or end - blocks[-1][0] > block_size and end > blocks[-1][1]:
+            blocks.append([start, end])
+        else:
+            blocks[-1][1] = max(blocks[-1][1], end)
+        glyph_block[gid] = len(blocks) - 1
+    if len(blocks) > 0xFFFF:
+        raise ValueError("%s: too many blocks, use a larger --block" % font_name)
+
+    # tables
+    head_len = struct.calcsize(FONT_HEAD_FMT)
+    glyph_ofs = align_up(head_len, 4)
+    cmap_ofs = align_up(glyph_ofs + glyph_num * struct.calcsize(GLYPH_FMT), 4)
+    ofs = cmap_ofs + len(cmaps) * struct.calcsize(CMAP_FMT)
+    list_ofs = []
+    for data in lists:
+        ofs = align_up(ofs, 4)
+        list_ofs.append(ofs if data else 0)
+        ofs += len(data)
+    kern_ofs = align_up(ofs, 4)
+    block_ofs = align_up(kern_ofs + len(kern), 4)
+    table_len = align_up(block_ofs + len(blocks) * struct.calcsize(BLOCK_FMT), 4)
+
+    block_table = bytearray()
+    block_data = bytearray()
+    raw_blocks = 0
+    for start, end in blocks:
+        raw = bitmap[start:end]
+        packed = lz4_compress(raw)
+        if len(packed) >= len(raw):
+            packed = raw
+            raw_blocks += 1
+        block_table += struct.pack(BLOCK_FMT, start, end - start, table_len + len(block_data), len(packed))
+        block_data += packed
+
+    head = struct.pack(FONT_HEAD_FMT, c_value(lv_font["line_height"]), c_value(lv_font["base_line"]),
+                       c_value(lv_font.get("underline_position", "0")),
+                       c_value(lv_font.get("underline_thickness", "0")), bpp,
+                       SUBPX.get(lv_font.get("subpx", "LV_FONT_SUBPX_NONE").strip(), 0),
+                       c_value(dsc.get("kern_scale", "16")), kern_type, 0, len(cmaps), kern_left, kern_right,
+                       glyph_num, block_size, len(blocks), glyph_ofs, cmap_ofs, kern_ofs, block_ofs, table_len)
+
+    table = bytearray(table_len)
+    table[0:head_len] = head
+    for gid, g in enumerate(glyphs):
+        struct.pack_into(GLYPH_FMT, table, glyph_ofs + gid * struct.calcsize(GLYPH_FMT), g["bitmap_index"],
+                         g["adv_w"], g["box_w"], g["box_h"], g["ofs_x"], g["ofs_y"], glyph_block[gid])
+    for i, (range_start, range_length, glyph_id_start, list_length, cmap_type) in enumerate(cmaps):
+        struct.pack_into(CMAP_FMT, table, cmap_ofs + i * struct.calcsize(CMAP_FMT), range_start, range_length,
+                         glyph_id_start, list_ofs[i], list_length, cmap_type, 0)
+        table[list_ofs[i]:list_ofs[i] + len(lists[i])] = lists[i]
+    table[kern_ofs:kern_ofs + len(kern)] = kern
+    table[block_ofs:block_ofs + len(block_table)] = block_table
+
+    asset = Asset(font_name, AI_ASSET_TYPE_FONT, bytes(table) + bytes(block_data), builtin,
+                  payload=bytes(table) + bytes(block_data))
+    asset.blocks = len(blocks)
+    asset.bitmap = bitmap
+    asset.raw_blocks = raw_blocks
+    return asset
+
+
+def image_assets(text):
+    assets = []
+    for m in re.finditer(r"lv_im(?:age|g)_dsc_t\s+(\w+)\s*=\s*\{", text):
+        name = m.group(1)
+        fields = c_fields(c_body(text, name))
+        data_name = c_ref(fields["data"])
+        data = c_bytes(text, data_name)
+        size = c_value(fields.get("data_size", str(len(data))), {data_name: data})
+        if size > len(data):
+            raise ValueError("image %s: data_size %d larger than its array" % (name, size))
+        data = data[:size]
+        cf = fields.get("header.cf", "0").strip()
+        cf = COLOR_FORMATS[cf] if cf in COLOR_FORMATS else c_value(cf)
+        flags = c_value(fields.get("header.flags", "0"))
+        w = c_value(fields.get("header.w", "0"))
+        h = c_value(fields.get("header.h", "0"))
+        stride = c_value(fields.get("header.stride", "0"))
+        meta = (cf | (flags << 16), w | (h << 16), stride)
+        assets.append(Asset(name, AI_ASSET_TYPE_IMAGE, data, len(data) + LV_IMAGE_DSC_SIZE, meta))
+    return assets
+
+
+def media_type(data):
+    if data[:3] == b"ID3" or (len(data) > 1 and data[0] == 0xFF and (data[1] & 0xE0) == 0xE0) or \
+            data[:4] in (b"RIFF", b"OggS", b"#!AM"):
+        return AI_ASSET_TYPE_MEDIA
+    return AI_ASSET_TYPE_RAW
+
+
+def c_file_assets(path, block_size):
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        text = c_preprocess(f.read())
+
+    fonts = re.findall(r"lv_font_t\s+(\w+)\s*=\s*\{", text)
+    if fonts:
+        return [font_asset(text, name, block_size) for name in fonts]
+
+    images = image_assets(text)
+    if images:
+        return images
+
+    # plain arrays, the media alerts
+    assets = []
+    for m in re.finditer(r"(?<!static )\bconst\s+uint8_t\s+(\w+)\s*\[[^\]]*\]\s*=\s*\{", text):
+        data = c_bytes(text, m.group(1))
+        assets.append(Asset(m.group(1), media_type(data), data, len(data)))
+    if not assets:
+        raise ValueError("%s: no font, image or array found" % path)
+    return assets
+
+
+def file_asset(name, path):
+    with open(path, "rb") as f:
+        data = f.read()
+    ext = os.path.splitext(path)[1].lower()
+    if ext in MEDIA_EXT:
+        type_ = AI_ASSET_TYPE_MEDIA
+    elif ext in IMAGE_EXT:
+        # decoded by LVGL, gif, png...
+        type_ = AI_ASSET_TYPE_IMAGE
+    else:
+        type_ = AI_ASSET_TYPE_RAW
+    meta = (COLOR_FORMATS["LV_COLOR_FORMAT_RAW"], 0, 0) if type_ == AI_ASSET_TYPE_IMAGE else (0, 0, 0)
+    return Asset(name, type_, data, len(data), meta)
+
+
+# ---------------------------------------------------------------------------------------------------------------
+# pack
+# ---------------------------------------------------------------------------------------------------------------
+def build_pack(assets, align, min_gain):
+    assets = sorted(assets, key=lambda a: a.name.encode())
+    names = [a.name for a in assets]
+    for i in range(1, len(names)):
+        if names[i] == names[i - 1]:
+            raise ValueError("asset %s given twice" % names[i])
+
+    head_len = struct.calcsize(HEAD_FMT)
+    index_ofs = head_len
+    ofs = index_ofs + len(assets) * struct.calcsize(ENTRY_FMT)
+    body = bytearray()
+    for a in assets:
+        if a.payload is not None:
+            a.comp, a.stored = AI_ASSET_COMP_NONE, a.payload
+        else:
+            a.comp, a.stored = compress(a.raw, min_gain)
+        ofs = align_up(ofs, align)
+        a.offset = ofs
+        ofs += len(a.stored)
+
+    total_len = ofs
+    data = bytearray(total_len)
+    index = bytearray()
+    for a in assets:
+        raw_size = a.builtin_size if a.type == AI_ASSET_TYPE_FONT else len(a.raw)
+        index += struct.pack(ENTRY_FMT, a.name.encode(), a.type, a.comp, 0, a.offset, len(a.stored), raw_size,
+                             zlib.crc32(a.stored) & 0xFFFFFFFF, *a.meta)
+        data[a.offset:a.offset + len(a.stored)] = a.stored
+    data[index_ofs:index_ofs + len(index)] = index
+    data[0:head_len] = struct.pack(HEAD_FMT, AI_ASSET_MAGIC, AI_ASSET_VERSION, head_len, len(assets), index_ofs,
+                                   align, total_len, zlib.crc32(index) & 0xFFFFFFFF, 0)
+    del body
+    return assets, bytes(data)
+
+
+def report(assets, pack_len):
+    print("%-32s %-6s %-5s %10s %10s %7s" % ("name", "type", "comp", "built-in", "stored", "ratio"))
+    builtin_total = 0
+    for a in assets:
+        builtin_total += a.builtin_size
+        comp = "lz4" if a.comp == AI_ASSET_COMP_LZ4 else ("lz4/b" if a.type == AI_ASSET_TYPE_FONT else "none")
+        extra = ""
+        if a.type == AI_ASSET_TYPE_FONT:
+            extra = "  %d blocks, %d stored as is" % (a.blocks, a.raw_blocks)
+        print("%-32s %-6s %-5s %10d %10d %6.1f%%%s" % (a.name, TYPE_NAMES[a.type], comp, a.builtin_size,
+                                                      len(a.stored), 100.0 * len(a.stored) / max(a.builtin_size, 1),
+                                                      extra))
+    print("%-32s %-6s %-5s %10d %10d %6.1f%%" % ("total", "", "", builtin_total, pack_len,
+                                                 100.0 * pack_len / max(builtin_total, 1)))
+
+
+def list_pack(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, head_len, asset_num, index_ofs, align, total_len, index_crc, _ = \
+        struct.unpack_from(HEAD_FMT, data, 0)
+    if magic != AI_ASSET_MAGIC:
+        raise ValueError("%s is not an asset pack" % path)
+    index = data[index_ofs:index_ofs + asset_num * struct.calcsize(ENTRY_FMT)]
+    print("version %d, %d assets, align %d, %d bytes, index crc %s" %
+          (version, asset_num, align, total_len, "ok" if zlib.crc32(index) & 0xFFFFFFFF == index_crc else "ERROR"))
+    print("%-32s %-6s %-5s %10s %10s %10s %s" % ("name", "type", "comp", "offset", "stored", "raw", "crc"))
+    for i in range(asset_num):
+        name, type_, comp, _, offset, size, raw_size, crc, m0, m1, m2 = \
+            struct.unpack_from(ENTRY_FMT, index, i * struct.calcsize(ENTRY_FMT))
+        ok = zlib.crc32(data[offset:offset + size]) & 0xFFFFFFFF == crc
+        print("%-32s %-6s %-5s %10d %10d %10d %s" % (name.rstrip(b"\0").decode(), TYPE_NAMES.get(type_, type_),
+                                                    "lz4" if comp else "none", offset, size, raw_size,
+                                                    "ok" if ok else "ERROR"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build an asset pack from C arrays and files")
+    parser.add_argument("inputs", nargs="*",
+                        help="C files (lv_font_conv fonts, LVGL images, uint8_t arrays) or name=path files")
+    parser.add_argument("-o", "--output", help="Path of the pack to write")
+    parser.add_argument("--align", type=int, default=64, help="Alignment of the assets, a power of 2")
+    parser.add_argument("--block", type=int, default=4096, help="Raw bytes of a font bitmap block")
+    parser.add_argument("--min-gain", type=float, default=0.0625,
+                        help="Store an asset compressed only if it saves this part of its size")
+    parser.add_argument("--list", metavar="PACK", help="List the assets of a pack")
+    args = parser.parse_args()
+
+    if args.list:
+        list_pack(args.list)
+        return
+
+    if not args.output or not args.inputs:
+        parser.error("an output and at least one input are required")
+    if args.align < AI_ASSET_ALIGN_MIN or args.align & (args.align - 1):
+        parser.error("--align must be a power of 2, at least %d" % AI_ASSET_ALIGN_MIN)
+
+    if lz4_block is None:
+        print("lz4 module not found, using the built-in compressor (pip install lz4 for better ratio)")
+
+    assets = []
+    for item in args.inputs:
+        if "=" in item and not item.endswith(".c"):
+            name, path = item.split("=", 1)
+            assets.append(file_asset(name, path))
+        else:
+            assets.extend(c_file_assets(item, args.block))
+
+    assets, data = build_pack(assets, args.align, args.min_gain)
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    report(assets, len(data))
+    print("asset pack %s written, %d bytes" % (args.output, len(data)))
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except (ValueError, KeyError, OSError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        sys.exit(1)
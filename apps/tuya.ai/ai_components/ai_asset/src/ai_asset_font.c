@@ -0,0 +1,495 @@
+/**
+ * @file ai_asset_font.c
+ * @brief Implementation of the bitmap fonts of an asset pack.
+ *
+ * The letter to glyph id lookup follows lv_font_fmt_txt (same character map types, same kerning), so a font of a
+ * pack draws exactly as the C array it was built from. A font is used from one thread at a time (the display
+ * thread), the blocks are shared through the cache of the pack.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#include "tal_api.h"
+
+#include "ai_asset_font.h"
+/***********************************************************
+************************macro define************************
+***********************************************************/
+// letters cached by a font, a power of 2
+#define AI_ASSET_FONT_LOOKUP_NUM 64
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint32_t letter;
+    uint32_t gid;
+} AI_ASSET_FONT_LOOKUP_T;
+
+typedef struct {
+    AI_ASSET_PACK_HANDLE pack;
+    uint32_t base; // offset of the font asset in the pack
+    uint32_t size;
+
+    const uint8_t *table;
+    const AI_ASSET_FONT_HEAD_T *head;
+    const AI_ASSET_GLYPH_T *glyph;
+    const AI_ASSET_CMAP_T *cmap;
+    const AI_ASSET_BLOCK_T *block;
+
+    AI_ASSET_FONT_LOOKUP_T lookup[AI_ASSET_FONT_LOOKUP_NUM];
+    AI_ASSET_FONT_STATS_T stats;
+} AI_ASSET_FONT_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static BOOL_T __font_range_check(uint32_t ofs, uint32_t len, uint32_t limit)
+{
+    return (ofs <= limit && len <= limit - ofs);
+}
+
+static OPERATE_RET __font_check(AI_ASSET_FONT_T *font)
+{
+    const AI_ASSET_FONT_HEAD_T *head = font->head;
+    const AI_ASSET_CMAP_T *cmap = NULL;
+    const AI_ASSET_BLOCK_T *block = NULL;
+    uint32_t i = 0, list_len = 0, kern_len = 0;
+
+    if (1 != head->bpp && 2 != head->bpp && 4 != head->bpp && 8 != head->bpp) {
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    if (head->glyph_num > head->table_len / sizeof(AI_ASSET_GLYPH_T) ||
+        head->block_num > head->table_len / sizeof(AI_ASSET_BLOCK_T) ||
+        head->kern_right > head->table_len / (sizeof(uint16_t) * 2 + 1) ||
+        (uint32_t)head->kern_left * head->kern_right > head->table_len) {
+        return OPRT_COM_ERROR;
+    }
+
+    if (0 == head->glyph_num || head->glyph_ofs % 4 || head->cmap_ofs % 4 || head->block_ofs % 4 ||
+        !__font_range_check(head->glyph_ofs, head->glyph_num * sizeof(AI_ASSET_GLYPH_T), head->table_len) ||
+        !__font_range_check(head->cmap_ofs, head->cmap_num * sizeof(AI_ASSET_CMAP_T), head->table_len) ||
+        !__font_range_check(head->block_ofs, head->block_num * sizeof(AI_ASSET_BLOCK_T), head->table_len)) {
+        return OPRT_COM_ERROR;
+    }
+
+    for (i = 0; i < head->cmap_num; i++) {
+        cmap = &font->cmap[i];
+        switch (cmap->type) {
+        case AI_ASSET_CMAP_FORMAT0_TINY:
+            list_len = 0;
+            break;
+        case AI_ASSET_CMAP_FORMAT0_FULL:
+            list_len = cmap->range_length;
+            break;
+        case AI_ASSET_CMAP_SPARSE_TINY:
+            list_len = cmap->list_length * sizeof(uint16_t);
+            break;
+        case AI_ASSET_CMAP_SPARSE_FULL:
+            list_len = cmap->list_length * sizeof(uint16_t) * 2;
+            break;
+        default:
+            return OPRT_NOT_SUPPORTED;
+        }
+        if (list_len && (0 == cmap->list_ofs || cmap->list_ofs % 2 ||
+                         !__font_range_check(cmap->list_ofs, list_len, head->table_len))) {
+            return OPRT_COM_ERROR;
+        }
+    }
+
+    switch (head->kern_type) {
+    case AI_ASSET_KERN_NONE:
+        kern_len = 0;
+        break;
+    case AI_ASSET_KERN_PAIRS:
+        kern_len = head->kern_right * (sizeof(uint16_t) * 2 + 1);
+        break;
+    case AI_ASSET_KERN_CLASSES:
+        kern_len = head->glyph_num * 2 + head->kern_left * head->kern_right;
+        break;
+    default:
+        return OPRT_NOT_SUPPORTED;
+    }
+    if (kern_len && (head->kern_ofs % 2 || !__font_range_check(head->kern_ofs, kern_len, head->table_len))) {
+        return OPRT_COM_ERROR;
+    }
+
+    for (i = 0; i < head->block_num; i++) {
+        block = &font->block[i];
+        if (block->data_ofs < head->table_len || !__font_range_check(block->data_ofs, block->data_len, font->size) ||
+            0 == block->raw_len || block->data_len > block->raw_len) {
+            return OPRT_COM_ERROR;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Opens a font of a pack.
+ * @param pack Pack handle.
+ * @param name Asset name of the font.
+ * @param handle Pointer to receive the font handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_open(AI_ASSET_PACK_HANDLE pack, const char *name, AI_ASSET_FONT_HANDLE *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    AI_ASSET_FONT_HEAD_T head;
+    AI_ASSET_FONT_T *font = NULL;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(handle, OPRT_INVALID_PARM);
+
+    entry = ai_asset_find(pack, name);
+    if (NULL == entry || AI_ASSET_TYPE_FONT != entry->type || AI_ASSET_COMP_NONE != entry->comp) {
+        PR_ERR("font %s not found", name ? name : "null");
+        return OPRT_NOT_FOUND;
+    }
+
+    if (entry->size < sizeof(AI_ASSET_FONT_HEAD_T)) {
+        return OPRT_COM_ERROR;
+    }
+    TUYA_CALL_ERR_RETURN(ai_asset_read(pack, entry, 0, &head, sizeof(AI_ASSET_FONT_HEAD_T)));
+    if (head.table_len < sizeof(AI_ASSET_FONT_HEAD_T) || head.table_len > entry->size) {
+        return OPRT_COM_ERROR;
+    }
+
+    font = (AI_ASSET_FONT_T *)tal_malloc(sizeof(AI_ASSET_FONT_T));
+    TUYA_CHECK_NULL_RETURN(font, OPRT_MALLOC_FAILED);
+    memset(font, 0, sizeof(AI_ASSET_FONT_T));
+
+    font->pack = pack;
+    font->base = entry->offset;
+    font->size = entry->size;
+
+    TUYA_CALL_ERR_GOTO(ai_asset_table_get(pack, entry->offset, head.table_len, &font->table), __ERR);
+    font->head = (const AI_ASSET_FONT_HEAD_T *)font->table;
+    font->glyph = (const AI_ASSET_GLYPH_T *)(font->table + head.glyph_ofs);
+    font->cmap = (const AI_ASSET_CMAP_T *)(font->table + head.cmap_ofs);
+    font->block = (const AI_ASSET_BLOCK_T *)(font->table + head.block_ofs);
+
+    rt = __font_check(font);
+    if (OPRT_OK != rt) {
+        PR_ERR("font %s tables error %d", name, rt);
+        goto __ERR;
+    }
+
+    PR_NOTICE("font %s open, glyphs:%u blocks:%u tables:%u", name, head.glyph_num, head.block_num,
+              head.table_len);
+
+    *handle = font;
+
+    return OPRT_OK;
+
+__ERR:
+    ai_asset_font_close(font);
+
+    return rt;
+}
+
+/**
+ * @brief Closes a font.
+ * @param handle Font handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_close(AI_ASSET_FONT_HANDLE handle)
+{
+    AI_ASSET_FONT_T *font = (AI_ASSET_FONT_T *)handle;
+
+    TUYA_CHECK_NULL_RETURN(font, OPRT_INVALID_PARM);
+
+    if (font->table) {
+        ai_asset_table_put(font->pack, font->table, font->head->table_len);
+    }
+
+    tal_free(font);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Gets the header of a font, line height, base line, bpp...
+ * @param handle Font handle.
+ * @return const AI_ASSET_FONT_HEAD_T* - The font header.
+ */
+const AI_ASSET_FONT_HEAD_T *ai_asset_font_head_get(AI_ASSET_FONT_HANDLE handle)
+{
+    AI_ASSET_FONT_T *font = (AI_ASSET_FONT_T *)handle;
+
+    return font ? font->head : NULL;
+}
+
+static int32_t __font_u16_search(const uint16_t *list, uint32_t num, uint16_t key)
+{
+    uint32_t low = 0, high = num, mid = 0;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (list[mid] == key) {
+            return (int32_t)mid;
+        } else if (list[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return -1;
+}
+
+static uint32_t __font_cmap_search(AI_ASSET_FONT_T *font, uint32_t letter)
+{
+    const AI_ASSET_CMAP_T *cmap = NULL;
+    const uint16_t *list = NULL;
+    uint32_t i = 0, rcp = 0;
+    int32_t idx = 0;
+
+    for (i = 0; i < font->head->cmap_num; i++) {
+        cmap = &font->cmap[i];
+
+        // wraps around when letter < range_start
+        rcp = letter - cmap->range_start;
+        if (rcp >= cmap->range_length) {
+            continue;
+        }
+
+        switch (cmap->type) {
+        case AI_ASSET_CMAP_FORMAT0_TINY:
+            return cmap->glyph_id_start + rcp;
+        case AI_ASSET_CMAP_FORMAT0_FULL:
+            return cmap->glyph_id_start + font->table[cmap->list_ofs + rcp];
+        case AI_ASSET_CMAP_SPARSE_TINY:
+        case AI_ASSET_CMAP_SPARSE_FULL:
+            list = (const uint16_t *)(font->table + cmap->list_ofs);
+            idx = __font_u16_search(list, cmap->list_length, (uint16_t)rcp);
+            if (idx < 0) {
+                break;
+            }
+            if (AI_ASSET_CMAP_SPARSE_TINY == cmap->type) {
+                return cmap->glyph_id_start + idx;
+            }
+            return cmap->glyph_id_start + list[cmap->list_length + idx];
+        default:
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static uint32_t __font_gid_get(AI_ASSET_FONT_T *font, uint32_t letter)
+{
+    AI_ASSET_FONT_LOOKUP_T *lookup = NULL;
+    uint32_t gid = 0;
+
+    if (0 == letter) {
+        return 0;
+    }
+
+    font->stats.lookups++;
+
+    lookup = &font->lookup[letter & (AI_ASSET_FONT_LOOKUP_NUM - 1)];
+    if (lookup->letter == letter) {
+        font->stats.lookup_hit++;
+        return lookup->gid;
+    }
+
+    gid = __font_cmap_search(font, letter);
+    if (gid >= font->head->glyph_num) {
+        gid = 0;
+    }
+
+    lookup->letter = letter;
+    lookup->gid = gid;
+
+    return gid;
+}
+
+static int8_t __font_kern_get(AI_ASSET_FONT_T *font, uint32_t gid_left, uint32_t gid_right)
+{
+    const AI_ASSET_FONT_HEAD_T *head = font->head;
+    const uint8_t *kern = font->table + head->kern_ofs;
+    const uint16_t *pairs = NULL;
+    uint32_t low = 0, high = 0, mid = 0, key = 0, pair_key = 0;
+    uint8_t left_class = 0, right_class = 0;
+
+    if (AI_ASSET_KERN_CLASSES == head->kern_type) {
+        left_class = kern[gid_left];
+        right_class = kern[head->glyph_num + gid_right];
+        if (0 == left_class || 0 == right_class || left_class > head->kern_left || right_class > head->kern_right) {
+            return 0;
+        }
+        return (int8_t)kern[head->glyph_num * 2 + (left_class - 1) * head->kern_right + (right_class - 1)];
+    }
+
+    if (AI_ASSET_KERN_PAIRS == head->kern_type) {
+        pairs = (const uint16_t *)kern;
+        key = (gid_left << 16) | gid_right;
+        high = head->kern_right;
+        while (low < high) {
+            mid = low + (high - low) / 2;
+            pair_key = ((uint32_t)pairs[mid * 2] << 16) | pairs[mid * 2 + 1];
+            if (pair_key == key) {
+                return (int8_t)kern[head->kern_right * 4 + mid];
+            } else if (pair_key < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Describes the glyph of a letter.
+ * @param handle Font handle.
+ * @param letter Unicode letter.
+ * @param letter_next Next unicode letter for kerning, 0 if none.
+ * @param dsc Pointer to receive the glyph description.
+ * @return BOOL_T - TRUE if the letter is in the font.
+ */
+BOOL_T ai_asset_font_glyph_dsc_get(AI_ASSET_FONT_HANDLE handle, uint32_t letter, uint32_t letter_next,
+                                   AI_ASSET_GLYPH_DSC_T *dsc)
+{
+    AI_ASSET_FONT_T *font = (AI_ASSET_FONT_T *)handle;
+    const AI_ASSET_GLYPH_T *glyph = NULL;
+    BOOL_T is_tab = FALSE;
+    uint32_t gid = 0, gid_next = 0, adv_w = 0;
+    int32_t kv = 0;
+
+    if (NULL == font || NULL == dsc) {
+        return FALSE;
+    }
+
+    // a tab is drawn as a space of double width, as lv_font_fmt_txt does
+    if ('\t' == letter) {
+        letter = ' ';
+        is_tab = TRUE;
+    }
+
+    gid = __font_gid_get(font, letter);
+    if (0 == gid) {
+        return FALSE;
+    }
+
+    if (letter_next && AI_ASSET_KERN_NONE != font->head->kern_type) {
+        gid_next = __font_gid_get(font, letter_next);
+        if (gid_next) {
+            kv = ((int32_t)__font_kern_get(font, gid, gid_next) * font->head->kern_scale) >> 4;
+        }
+    }
+
+    glyph = &font->glyph[gid];
+
+    adv_w = glyph->adv_w;
+    if (is_tab) {
+        adv_w *= 2;
+    }
+    adv_w += kv;
+    adv_w = (adv_w + (1 << 3)) >> 4;
+
+    dsc->gid = gid;
+    dsc->adv_w = adv_w;
+    dsc->box_w = is_tab ? glyph->box_w * 2 : glyph->box_w;
+    dsc->box_h = glyph->box_h;
+    dsc->ofs_x = glyph->ofs_x;
+    dsc->ofs_y = glyph->ofs_y;
+
+    return TRUE;
+}
+
+static void __font_bitmap_expand(const uint8_t *in, uint8_t bpp, uint32_t w, uint32_t h, uint8_t *out,
+                                 uint32_t stride)
+{
+    uint32_t x = 0, y = 0, bit = 0;
+    uint8_t mask = (1 << bpp) - 1;
+    uint8_t scale = 0xFF / mask;
+
+    // rows are not padded, the bits run on from one row to the next, most significant bit first
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            out[x] = ((in[bit >> 3] >> (8 - bpp - (bit & 7))) & mask) * scale;
+            bit += bpp;
+        }
+        out += stride;
+    }
+}
+
+/**
+ * @brief Draws the bitmap of a glyph as 8 bits per pixel alpha.
+ * @param handle Font handle.
+ * @param gid Glyph id from ai_asset_font_glyph_dsc_get.
+ * @param out Buffer of box_h rows of stride bytes.
+ * @param stride Bytes of a row of out, at least box_w.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_glyph_bitmap_get(AI_ASSET_FONT_HANDLE handle, uint32_t gid, uint8_t *out,
+                                           uint32_t stride)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_FONT_T *font = (AI_ASSET_FONT_T *)handle;
+    const AI_ASSET_GLYPH_T *glyph = NULL;
+    const AI_ASSET_BLOCK_T *block = NULL;
+    const uint8_t *data = NULL;
+    uint32_t len = 0, ofs = 0;
+
+    TUYA_CHECK_NULL_RETURN(font, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(out, OPRT_INVALID_PARM);
+
+    if (0 == gid || gid >= font->head->glyph_num) {
+        return OPRT_INVALID_PARM;
+    }
+
+    glyph = &font->glyph[gid];
+    if (stride < glyph->box_w) {
+        return OPRT_INVALID_PARM;
+    }
+
+    len = ((uint32_t)glyph->box_w * glyph->box_h * font->head->bpp + 7) >> 3;
+    if (0 == len) {
+        return OPRT_OK;
+    }
+
+    if (glyph->block >= font->head->block_num) {
+        return OPRT_COM_ERROR;
+    }
+    block = &font->block[glyph->block];
+    ofs = glyph->bitmap_index - block->raw_start;
+    if (glyph->bitmap_index < block->raw_start || ofs > block->raw_len || len > block->raw_len - ofs) {
+        return OPRT_COM_ERROR;
+    }
+
+    TUYA_CALL_ERR_RETURN(
+        ai_asset_block_get(font->pack, font->base + block->data_ofs, block->data_len, block->raw_len, &data));
+
+    __font_bitmap_expand(data + ofs, font->head->bpp, glyph->box_w, glyph->box_h, out, stride);
+
+    ai_asset_block_put(font->pack, data);
+
+    font->stats.glyphs++;
+
+    return rt;
+}
+
+/**
+ * @brief Gets the statistics of a font.
+ * @param handle Font handle.
+ * @param stats Pointer to receive the statistics.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_font_stats_get(AI_ASSET_FONT_HANDLE handle, AI_ASSET_FONT_STATS_T *stats)
+{
+    AI_ASSET_FONT_T *font = (AI_ASSET_FONT_T *)handle;
+
+    TUYA_CHECK_NULL_RETURN(font, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(stats, OPRT_INVALID_PARM);
+
+    memcpy(stats, &font->stats, sizeof(AI_ASSET_FONT_STATS_T));
+
+    return OPRT_OK;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file ai_asset_lvgl.c
+ * @brief Implementation of the LVGL fonts and images served from an asset pack.
+ *
+ * A font of a pack is an lv_font_t whose callbacks go to ai_asset_font, the glyph bitmap is drawn as A8 in the
+ * draw buffer given by LVGL, like lv_font_fmt_txt does for the built-in fonts.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#include "tal_api.h"
+
+#include "ai_asset_font.h"
+#include "ai_asset_lvgl.h"
+
+#if defined(ENABLE_LIBLVGL) && (ENABLE_LIBLVGL == 1)
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    lv_font_t lv_font; // first, the lv_font_t pointer is the struct pointer
+    AI_ASSET_FONT_HANDLE font;
+} AI_ASSET_LV_FONT_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static bool __lv_font_glyph_dsc_get(const lv_font_t *lv_font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+                                    uint32_t letter_next)
+{
+    AI_ASSET_LV_FONT_T *font = (AI_ASSET_LV_FONT_T *)lv_font;
+    AI_ASSET_GLYPH_DSC_T dsc;
+
+    if (!ai_asset_font_glyph_dsc_get(font->font, letter, letter_next, &dsc)) {
+        return false;
+    }
+
+    dsc_out->adv_w = dsc.adv_w;
+    dsc_out->box_w = dsc.box_w;
+    dsc_out->box_h = dsc.box_h;
+    dsc_out->ofs_x = dsc.ofs_x;
+    dsc_out->ofs_y = dsc.ofs_y;
+    dsc_out->format = (lv_font_glyph_format_t)ai_asset_font_head_get(font->font)->bpp;
+    dsc_out->is_placeholder = false;
+    dsc_out->glyph_index = dsc.gid;
+
+    return true;
+}
+
+static const void *__lv_font_glyph_bitmap_get(lv_font_glyph_dsc_t *g_dsc, uint32_t letter, lv_draw_buf_t *draw_buf)
+{
+    AI_ASSET_LV_FONT_T *font = (AI_ASSET_LV_FONT_T *)g_dsc->resolved_font;
+
+    if (NULL == draw_buf || 0 == g_dsc->box_w || 0 == g_dsc->box_h) {
+        return NULL;
+    }
+
+    // glyph_index was set by __lv_font_glyph_dsc_get, no second lookup of the letter
+    if (OPRT_OK !=
+        ai_asset_font_glyph_bitmap_get(font->font, g_dsc->glyph_index, draw_buf->data, draw_buf->header.stride)) {
+        return NULL;
+    }
+
+    return draw_buf;
+}
+
+/**
+ * @brief Creates an LVGL font from a font of a pack, drawn glyph by glyph from the pack.
+ * @param pack Pack handle.
+ * @param name Asset name of the font, the name of the lv_font_t it replaces.
+ * @return lv_font_t* - The font, NULL if it is not in the pack.
+ */
+lv_font_t *ai_asset_lv_font_create(AI_ASSET_PACK_HANDLE pack, const char *name)
+{
+    AI_ASSET_LV_FONT_T *font = NULL;
+    const AI_ASSET_FONT_HEAD_T *head = NULL;
+
+    font = (AI_ASSET_LV_FONT_T *)tal_malloc(sizeof(AI_ASSET_LV_FONT_T));
+    if (NULL == font) {
+        return NULL;
+    }
+    memset(font, 0, sizeof(AI_ASSET_LV_FONT_T));
+
+    if (OPRT_OK != ai_asset_font_open(pack, name, &font->font)) {
+        tal_free(font);
+        return NULL;
+    }
+
+    head = ai_asset_font_head_get(font->font);
+
+    font->lv_font.get_glyph_dsc = __lv_font_glyph_dsc_get;
+    font->lv_font.get_glyph_bitmap = __lv_font_glyph_bitmap_get;
+    font->lv_font.line_height = head->line_height;
+    font->lv_font.base_line = head->base_line;
+    font->lv_font.subpx = head->subpx;
+    font->lv_font.underline_position = head->underline_position;
+    font->lv_font.underline_thickness = head->underline_thickness;
+    font->lv_font.dsc = font->font;
+
+    return &font->lv_font;
+}
+
+/**
+ * @brief Destroys a font created by ai_asset_lv_font_create, no label must use it anymore.
+ * @param font The font.
+ * @return None
+ */
+void ai_asset_lv_font_destroy(lv_font_t *font)
+{
+    AI_ASSET_LV_FONT_T *asset_font = (AI_ASSET_LV_FONT_T *)font;
+
+    if (NULL == asset_font) {
+        return;
+    }
+
+    ai_asset_font_close(asset_font->font);
+    tal_free(asset_font);
+}
+
+/**
+ * @brief Loads an image of a pack, decompressed if needed.
+ * @param pack Pack handle.
+ * @param name Asset name of the image, the name of the lv_image_dsc_t it replaces.
+ * @param dsc Image descriptor to fill in, to be released with ai_asset_lv_image_release.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_lv_image_load(AI_ASSET_PACK_HANDLE pack, const char *name, lv_image_dsc_t *dsc)
+{
+    OPERATE_RET rt = OPRT_OK;
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    const uint8_t *data = NULL;
+    uint32_t len = 0;
+
+    TUYA_CHECK_NULL_RETURN(dsc, OPRT_INVALID_PARM);
+
+    entry = ai_asset_find(pack, name);
+    if (NULL == entry || AI_ASSET_TYPE_IMAGE != entry->type) {
+        PR_ERR("image %s not found", name ? name : "null");
+        return OPRT_NOT_FOUND;
+    }
+
+    TUYA_CALL_ERR_RETURN(ai_asset_load(pack, entry, &data, &len));
+
+    memset(dsc, 0, sizeof(lv_image_dsc_t));
+    dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc->header.cf = AI_ASSET_IMAGE_CF(entry);
+    dsc->header.flags = AI_ASSET_IMAGE_FLAGS(entry);
+    dsc->header.w = AI_ASSET_IMAGE_W(entry);
+    dsc->header.h = AI_ASSET_IMAGE_H(entry);
+    dsc->header.stride = AI_ASSET_IMAGE_STRIDE(entry);
+    dsc->data_size = len;
+    dsc->data = data;
+
+    return rt;
+}
+
+/**
+ * @brief Releases an image loaded by ai_asset_lv_image_load and drops it from the LVGL image cache.
+ * @param pack Pack handle.
+ * @param dsc Image descriptor.
+ * @return None
+ */
+void ai_asset_lv_image_release(AI_ASSET_PACK_HANDLE pack, lv_image_dsc_t *dsc)
+{
+    if (NULL == dsc || NULL == dsc->data) {
+        return;
+    }
+
+    lv_image_cache_drop(dsc);
+
+    ai_asset_release(pack, dsc->data);
+    dsc->data = NULL;
+    dsc->data_size = 0;
+}
+
+#endif /* ENABLE_LIBLVGL */
@@ -0,0 +1,900 @@
+/**
+ * @file ai_asset_pack.c
+ * @brief Implementation of the asset pack loader, the storage backends, the LZ4 decompressor and the block cache.
+ *
+ * The pack is read through one of three backends: memory (a mapped flash partition or a buffer), a flash
+ * partition read with tkl_flash_read, or a file. Reads and the cache are protected by the pack mutex, so fonts and
+ * alerts can be served from different threads.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#include "tal_api.h"
+#include "tal_fs.h"
+#include "tkl_flash.h"
+#include "tuya_crc.h"
+
+#include "ai_asset_pack.h"
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define AI_ASSET_BACKEND_MEM   0
+#define AI_ASSET_BACKEND_FLASH 1
+#define AI_ASSET_BACKEND_FILE  2
+
+#define AI_ASSET_LZ4_MIN_MATCH 4
+// an LZ4 block cannot expand more than this, every extra length byte adds at most 255 bytes of output
+#define AI_ASSET_LZ4_MAX_RATIO 255
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint32_t key; // offset of the stored block in the pack, 0 if the slot is free
+    uint32_t len;
+    uint32_t cap;
+    uint32_t tick;
+    uint16_t ref;
+    uint8_t *buf;
+} AI_ASSET_CACHE_T;
+
+typedef struct {
+    uint8_t backend;
+    uint8_t check_crc;
+    uint16_t cache_num;
+
+    const uint8_t *base; // AI_ASSET_BACKEND_MEM
+    uint32_t flash_addr; // AI_ASSET_BACKEND_FLASH
+    TUYA_FILE file;      // AI_ASSET_BACKEND_FILE
+    uint32_t len;
+
+    MUTEX_HANDLE mutex;
+
+    AI_ASSET_HEAD_T head;
+    const AI_ASSET_ENTRY_T *index;
+
+    AI_ASSET_CACHE_T *cache;
+    uint32_t cache_tick;
+    uint8_t *scratch; // stored blocks read from flash or file before they are decompressed
+    uint32_t scratch_cap;
+
+    AI_ASSET_PACK_STATS_T stats;
+} AI_ASSET_PACK_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static AI_ASSET_PACK_HANDLE sg_default_pack = NULL;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief Decompresses an LZ4 block.
+ * @param src Compressed data.
+ * @param src_len Compressed bytes.
+ * @param dst Buffer to receive the data.
+ * @param dst_len Size of dst, the block must decompress to exactly dst_len bytes.
+ * @return OPERATE_RET - OPRT_OK on success, OPRT_COM_ERROR if the block is corrupted.
+ */
+OPERATE_RET ai_asset_lz4_decompress(const uint8_t *src, uint32_t src_len, uint8_t *dst, uint32_t dst_len)
+{
+    const uint8_t *ip = src, *ip_end = src + src_len, *match = NULL;
+    uint8_t *op = dst, *op_end = dst + dst_len;
+    uint32_t lit_len = 0, match_len = 0, offset = 0, i = 0;
+    uint8_t token = 0, b = 0;
+
+    while (ip < ip_end) {
+        token = *ip++;
+
+        lit_len = token >> 4;
+        if (15 == lit_len) {
+            do {
+                if (ip >= ip_end) {
+                    return OPRT_COM_ERROR;
+                }
+                b = *ip++;
+                lit_len += b;
+            } while (255 == b);
+        }
+        if (lit_len > (uint32_t)(ip_end - ip) || lit_len > (uint32_t)(op_end - op)) {
+            return OPRT_COM_ERROR;
+        }
+        memcpy(op, ip, lit_len);
+        op += lit_len;
+        ip += lit_len;
+
+        // the last sequence only has literals
+        if (ip >= ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return OPRT_COM_ERROR;
+        }
+        offset = ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (0 == offset || offset > (uint32_t)(op - dst)) {
+            return OPRT_COM_ERROR;
+        }
+
+        match_len = token & 0x0F;
+        if (15 == match_len) {
+            do {
+                if (ip >= ip_end) {
+                    return OPRT_COM_ERROR;
+                }
+                b = *ip++;
+                match_len += b;
+            } while (255 == b);
+        }
+        match_len += AI_ASSET_LZ4_MIN_MATCH;
+        if (match_len > (uint32_t)(op_end - op)) {
+            return OPRT_COM_ERROR;
+        }
+
+        match = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, match, match_len);
+        } else {
+            // overlapping match, repeats the last offset bytes
+            for (i = 0; i < match_len; i++) {
+                op[i] = match[i];
+            }
+        }
+        op += match_len;
+    }
+
+    return (op == op_end) ? OPRT_OK : OPRT_COM_ERROR;
+}
+
+static OPERATE_RET __pack_read(AI_ASSET_PACK_T *pack, uint32_t offset, void *buf, uint32_t len)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    if (offset > pack->len || len > pack->len - offset) {
+        return OPRT_INVALID_PARM;
+    }
+
+    switch (pack->backend) {
+    case AI_ASSET_BACKEND_MEM:
+        memcpy(buf, pack->base + offset, len);
+        return OPRT_OK;
+    case AI_ASSET_BACKEND_FLASH:
+        rt = tkl_flash_read(pack->flash_addr + offset, (uint8_t *)buf, len);
+        break;
+    case AI_ASSET_BACKEND_FILE:
+        if (tal_fseek(pack->file, offset, TUYA_SEEK_SET) < 0 || tal_fread(buf, len, pack->file) != (int)len) {
+            rt = OPRT_FILE_READ_FAILED;
+        }
+        break;
+    default:
+        rt = OPRT_NOT_SUPPORTED;
+        break;
+    }
+
+    if (OPRT_OK == rt) {
+        pack->stats.read_bytes += len;
+    }
+
+    return rt;
+}
+
+static BOOL_T __pack_is_mapped(AI_ASSET_PACK_T *pack, const uint8_t *data)
+{
+    return (AI_ASSET_BACKEND_MEM == pack->backend && data >= pack->base && data < pack->base + pack->len);
+}
+
+static uint8_t *__pack_scratch_get(AI_ASSET_PACK_T *pack, uint32_t len)
+{
+    if (len > pack->scratch_cap) {
+        if (pack->scratch) {
+            tal_free(pack->scratch);
+            pack->stats.ram_bytes -= pack->scratch_cap;
+        }
+        pack->scratch_cap = 0;
+        pack->scratch = (uint8_t *)tal_malloc(len);
+        if (NULL == pack->scratch) {
+            return NULL;
+        }
+        pack->scratch_cap = len;
+        pack->stats.ram_bytes += len;
+    }
+
+    return pack->scratch;
+}
+
+static OPERATE_RET __pack_check_crc(AI_ASSET_PACK_T *pack, const AI_ASSET_ENTRY_T *entry, const uint8_t *stored)
+{
+    if (!pack->check_crc || tuya_crc32(stored, entry->size) == entry->crc) {
+        return OPRT_OK;
+    }
+
+    PR_ERR("asset %.*s crc error", AI_ASSET_NAME_LEN, entry->name);
+
+    return OPRT_CRC32_FAILED;
+}
+
+static OPERATE_RET __pack_open(AI_ASSET_PACK_T *pack, AI_ASSET_PACK_CFG_T *cfg)
+{
+    OPERATE_RET rt = OPRT_OK;
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    uint8_t *index = NULL;
+    uint32_t index_len = 0, i = 0;
+
+    pack->cache_num = (cfg && cfg->cache_num) ? cfg->cache_num : AI_ASSET_CACHE_NUM_DEFAULT;
+    pack->check_crc = cfg ? cfg->check_crc : 0;
+
+    TUYA_CALL_ERR_RETURN(__pack_read(pack, 0, &pack->head, sizeof(AI_ASSET_HEAD_T)));
+
+    if (AI_ASSET_MAGIC != pack->head.magic || AI_ASSET_VERSION != pack->head.version ||
+        sizeof(AI_ASSET_HEAD_T) != pack->head.head_len) {
+        PR_ERR("asset pack magic:0x%08x version:%d not supported", pack->head.magic, pack->head.version);
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    if (pack->head.align < AI_ASSET_ALIGN_MIN || (pack->head.align & (pack->head.align - 1)) ||
+        pack->head.total_len > pack->len || pack->head.index_ofs > pack->head.total_len ||
+        pack->head.index_ofs % AI_ASSET_ALIGN_MIN ||
+        pack->head.asset_num > (pack->head.total_len - pack->head.index_ofs) / sizeof(AI_ASSET_ENTRY_T)) {
+        PR_ERR("asset pack head error, len:%u total:%u", pack->len, pack->head.total_len);
+        return OPRT_COM_ERROR;
+    }
+    pack->len = pack->head.total_len;
+
+    index_len = pack->head.asset_num * sizeof(AI_ASSET_ENTRY_T);
+    if (AI_ASSET_BACKEND_MEM == pack->backend) {
+        pack->index = (const AI_ASSET_ENTRY_T *)(pack->base + pack->head.index_ofs);
+    } else {
+        index = (uint8_t *)tal_malloc(index_len ? index_len : 1);
+        TUYA_CHECK_NULL_RETURN(index, OPRT_MALLOC_FAILED);
+        pack->stats.ram_bytes += index_len;
+        pack->index = (const AI_ASSET_ENTRY_T *)index;
+        TUYA_CALL_ERR_RETURN(__pack_read(pack, pack->head.index_ofs, index, index_len));
+    }
+
+    if (tuya_crc32(pack->index, index_len) != pack->head.index_crc) {
+        PR_ERR("asset pack index crc error");
+        return OPRT_CRC32_FAILED;
+    }
+
+    for (i = 0; i < pack->head.asset_num; i++) {
+        entry = &pack->index[i];
+        if (entry->offset % pack->head.align || entry->offset > pack->len || entry->size > pack->len - entry->offset) {
+            PR_ERR("asset %.*s out of the pack", AI_ASSET_NAME_LEN, entry->name);
+            return OPRT_COM_ERROR;
+        }
+        // the raw_size of a font is the size of its built-in arrays, it is only reported
+        if ((AI_ASSET_COMP_NONE == entry->comp && AI_ASSET_TYPE_FONT != entry->type &&
+             entry->raw_size != entry->size) ||
+            (AI_ASSET_COMP_LZ4 == entry->comp &&
+             (uint64_t)entry->raw_size > (uint64_t)entry->size * AI_ASSET_LZ4_MAX_RATIO)) {
+            PR_ERR("asset %.*s size:%u raw size:%u error", AI_ASSET_NAME_LEN, entry->name, entry->size,
+                   entry->raw_size);
+            return OPRT_COM_ERROR;
+        }
+    }
+
+    pack->cache = (AI_ASSET_CACHE_T *)tal_malloc(pack->cache_num * sizeof(AI_ASSET_CACHE_T));
+    TUYA_CHECK_NULL_RETURN(pack->cache, OPRT_MALLOC_FAILED);
+    memset(pack->cache, 0, pack->cache_num * sizeof(AI_ASSET_CACHE_T));
+    pack->stats.ram_bytes += pack->cache_num * sizeof(AI_ASSET_CACHE_T);
+
+    TUYA_CALL_ERR_RETURN(tal_mutex_create_init(&pack->mutex));
+
+    PR_NOTICE("asset pack open, assets:%u len:%u backend:%d", pack->head.asset_num, pack->len, pack->backend);
+
+    return rt;
+}
+
+static OPERATE_RET __pack_create(uint8_t backend, uint32_t len, AI_ASSET_PACK_T **pack)
+{
+    *pack = (AI_ASSET_PACK_T *)tal_malloc(sizeof(AI_ASSET_PACK_T));
+    TUYA_CHECK_NULL_RETURN(*pack, OPRT_MALLOC_FAILED);
+    memset(*pack, 0, sizeof(AI_ASSET_PACK_T));
+
+    (*pack)->backend = backend;
+    (*pack)->len = len;
+    (*pack)->stats.ram_bytes = sizeof(AI_ASSET_PACK_T);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Opens a pack stored in a file.
+ * @param path Path of the pack file.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_file(const char *path, AI_ASSET_PACK_CFG_T *cfg, AI_ASSET_PACK_HANDLE *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = NULL;
+    int size = 0;
+
+    TUYA_CHECK_NULL_RETURN(path, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(handle, OPRT_INVALID_PARM);
+
+    size = tal_fgetsize(path);
+    if (size < (int)sizeof(AI_ASSET_HEAD_T)) {
+        PR_ERR("asset pack %s not found", path);
+        return OPRT_NOT_FOUND;
+    }
+
+    TUYA_CALL_ERR_RETURN(__pack_create(AI_ASSET_BACKEND_FILE, size, &pack));
+
+    pack->file = tal_fopen(path, "rb");
+    TUYA_CHECK_NULL_GOTO(pack->file, __ERR);
+
+    TUYA_CALL_ERR_GOTO(__pack_open(pack, cfg), __ERR);
+
+    *handle = pack;
+
+    return OPRT_OK;
+
+__ERR:
+    ai_asset_pack_close(pack);
+
+    return (OPRT_OK == rt) ? OPRT_FILE_OPEN_FAILED : rt;
+}
+
+/**
+ * @brief Opens a pack stored in a flash partition, read with tkl_flash_read.
+ * @param type Flash partition holding the pack.
+ * @param offset Offset of the pack in the partition.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_flash(TUYA_FLASH_TYPE_E type, uint32_t offset, AI_ASSET_PACK_CFG_T *cfg,
+                                     AI_ASSET_PACK_HANDLE *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = NULL;
+    TUYA_FLASH_BASE_INFO_T info;
+
+    TUYA_CHECK_NULL_RETURN(handle, OPRT_INVALID_PARM);
+
+    memset(&info, 0, sizeof(TUYA_FLASH_BASE_INFO_T));
+    TUYA_CALL_ERR_RETURN(tkl_flash_get_one_type_info(type, &info));
+    if (0 == info.partition_num || offset >= info.partition[0].size) {
+        PR_ERR("flash partition %d not found", type);
+        return OPRT_NOT_FOUND;
+    }
+
+    TUYA_CALL_ERR_RETURN(__pack_create(AI_ASSET_BACKEND_FLASH, info.partition[0].size - offset, &pack));
+    pack->flash_addr = info.partition[0].start_addr + offset;
+
+    TUYA_CALL_ERR_GOTO(__pack_open(pack, cfg), __ERR);
+
+    *handle = pack;
+
+    return OPRT_OK;
+
+__ERR:
+    ai_asset_pack_close(pack);
+
+    return rt;
+}
+
+/**
+ * @brief Opens a pack mapped in memory, the memory must stay valid until the pack is closed.
+ *        Uncompressed assets and the font tables are used in place.
+ * @param addr Address of the pack, aligned to AI_ASSET_ALIGN_MIN.
+ * @param len Bytes available at addr.
+ * @param cfg Pack configuration, NULL for the defaults.
+ * @param handle Pointer to receive the pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_open_mem(const void *addr, uint32_t len, AI_ASSET_PACK_CFG_T *cfg,
+                                   AI_ASSET_PACK_HANDLE *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = NULL;
+
+    TUYA_CHECK_NULL_RETURN(addr, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(handle, OPRT_INVALID_PARM);
+
+    if ((uintptr_t)addr % AI_ASSET_ALIGN_MIN || len < sizeof(AI_ASSET_HEAD_T)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    TUYA_CALL_ERR_RETURN(__pack_create(AI_ASSET_BACKEND_MEM, len, &pack));
+    pack->base = (const uint8_t *)addr;
+
+    TUYA_CALL_ERR_GOTO(__pack_open(pack, cfg), __ERR);
+
+    *handle = pack;
+
+    return OPRT_OK;
+
+__ERR:
+    ai_asset_pack_close(pack);
+
+    return rt;
+}
+
+/**
+ * @brief Closes a pack, the fonts opened from it must be closed and the loaded assets released first.
+ * @param handle Pack handle.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_close(AI_ASSET_PACK_HANDLE handle)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    uint16_t i = 0;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+
+    if (sg_default_pack == handle) {
+        sg_default_pack = NULL;
+    }
+
+    if (pack->cache) {
+        for (i = 0; i < pack->cache_num; i++) {
+            if (pack->cache[i].buf) {
+                tal_free(pack->cache[i].buf);
+            }
+        }
+        tal_free(pack->cache);
+    }
+
+    if (pack->scratch) {
+        tal_free(pack->scratch);
+    }
+
+    if (pack->index && AI_ASSET_BACKEND_MEM != pack->backend) {
+        tal_free((void *)pack->index);
+    }
+
+    if (pack->file) {
+        tal_fclose(pack->file);
+    }
+
+    if (pack->mutex) {
+        tal_mutex_release(pack->mutex);
+    }
+
+    tal_free(pack);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Sets the pack used by the components that look up assets by name, alerts, display...
+ * @param handle Pack handle, NULL to clear it.
+ * @return None
+ */
+void ai_asset_pack_default_set(AI_ASSET_PACK_HANDLE handle)
+{
+    sg_default_pack = handle;
+}
+
+/**
+ * @brief Gets the pack set by ai_asset_pack_default_set.
+ * @param None
+ * @return AI_ASSET_PACK_HANDLE - The pack handle, NULL if no pack is set.
+ */
+AI_ASSET_PACK_HANDLE ai_asset_pack_default_get(void)
+{
+    return sg_default_pack;
+}
+
+/**
+ * @brief Gets the statistics of a pack.
+ * @param handle Pack handle.
+ * @param stats Pointer to receive the statistics.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_pack_stats_get(AI_ASSET_PACK_HANDLE handle, AI_ASSET_PACK_STATS_T *stats)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(stats, OPRT_INVALID_PARM);
+
+    tal_mutex_lock(pack->mutex);
+    memcpy(stats, &pack->stats, sizeof(AI_ASSET_PACK_STATS_T));
+    tal_mutex_unlock(pack->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Gets the number of assets in a pack.
+ * @param handle Pack handle.
+ * @return uint32_t - The number of assets.
+ */
+uint32_t ai_asset_num_get(AI_ASSET_PACK_HANDLE handle)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    return pack ? pack->head.asset_num : 0;
+}
+
+/**
+ * @brief Gets an asset by its position in the index.
+ * @param handle Pack handle.
+ * @param idx Position in the index, 0 ~ ai_asset_num_get() - 1.
+ * @return const AI_ASSET_ENTRY_T* - The index entry, NULL if idx is out of range.
+ */
+const AI_ASSET_ENTRY_T *ai_asset_get(AI_ASSET_PACK_HANDLE handle, uint32_t idx)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    if (NULL == pack || idx >= pack->head.asset_num) {
+        return NULL;
+    }
+
+    return &pack->index[idx];
+}
+
+/**
+ * @brief Finds an asset by name.
+ * @param handle Pack handle.
+ * @param name Asset name.
+ * @return const AI_ASSET_ENTRY_T* - The index entry, valid until the pack is closed, NULL if not found.
+ */
+const AI_ASSET_ENTRY_T *ai_asset_find(AI_ASSET_PACK_HANDLE handle, const char *name)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    uint32_t low = 0, high = 0, mid = 0;
+    int cmp = 0;
+
+    if (NULL == pack || NULL == name) {
+        return NULL;
+    }
+
+    // the index is sorted by name
+    high = pack->head.asset_num;
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        cmp = strncmp(name, pack->index[mid].name, AI_ASSET_NAME_LEN);
+        if (0 == cmp) {
+            return &pack->index[mid];
+        } else if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reads stored bytes of an asset, the data is not decompressed.
+ * @param handle Pack handle.
+ * @param entry Index entry of the asset.
+ * @param offset Offset in the stored data.
+ * @param buf Buffer to receive the data.
+ * @param len Bytes to read.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_read(AI_ASSET_PACK_HANDLE handle, const AI_ASSET_ENTRY_T *entry, uint32_t offset, void *buf,
+                          uint32_t len)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(entry, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(buf, OPRT_INVALID_PARM);
+
+    if (offset > entry->size || len > entry->size - offset) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(pack->mutex);
+    rt = __pack_read(pack, entry->offset + offset, buf, len);
+    tal_mutex_unlock(pack->mutex);
+
+    return rt;
+}
+
+/**
+ * @brief Loads the content of an asset, decompressed. The data is used in place when the pack is memory mapped
+ *        and the asset is not compressed, otherwise it is loaded in a buffer allocated for the caller.
+ * @param handle Pack handle.
+ * @param entry Index entry of the asset.
+ * @param data Pointer to receive the content, to be released with ai_asset_release.
+ * @param len Pointer to receive the content length.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_load(AI_ASSET_PACK_HANDLE handle, const AI_ASSET_ENTRY_T *entry, const uint8_t **data,
+                          uint32_t *len)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    const uint8_t *stored = NULL;
+    uint8_t *out = NULL, *tmp = NULL;
+    uint32_t raw_len = 0;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(entry, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(data, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(len, OPRT_INVALID_PARM);
+
+    if (AI_ASSET_COMP_NONE != entry->comp && AI_ASSET_COMP_LZ4 != entry->comp) {
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    if (AI_ASSET_BACKEND_MEM == pack->backend) {
+        stored = pack->base + entry->offset;
+        TUYA_CALL_ERR_RETURN(__pack_check_crc(pack, entry, stored));
+        if (AI_ASSET_COMP_NONE == entry->comp) {
+            *data = stored;
+            *len = entry->size;
+            return OPRT_OK;
+        }
+    }
+
+    raw_len = (AI_ASSET_COMP_NONE == entry->comp) ? entry->size : entry->raw_size;
+    out = (uint8_t *)tal_malloc(raw_len ? raw_len : 1);
+    TUYA_CHECK_NULL_RETURN(out, OPRT_MALLOC_FAILED);
+
+    tal_mutex_lock(pack->mutex);
+
+    if (NULL == stored) {
+        if (AI_ASSET_COMP_NONE == entry->comp) {
+            stored = out;
+        } else {
+            tmp = (uint8_t *)tal_malloc(entry->size ? entry->size : 1);
+            TUYA_CHECK_NULL_GOTO(tmp, __EXIT);
+            stored = tmp;
+        }
+        TUYA_CALL_ERR_GOTO(__pack_read(pack, entry->offset, (uint8_t *)stored, entry->size), __EXIT);
+        TUYA_CALL_ERR_GOTO(__pack_check_crc(pack, entry, stored), __EXIT);
+    }
+
+    if (AI_ASSET_COMP_LZ4 == entry->comp) {
+        rt = ai_asset_lz4_decompress(stored, entry->size, out, entry->raw_size);
+        if (OPRT_OK != rt) {
+            PR_ERR("asset %.*s decompress error", AI_ASSET_NAME_LEN, entry->name);
+            goto __EXIT;
+        }
+        pack->stats.decomp_bytes += entry->raw_size;
+    }
+
+__EXIT:
+    tal_mutex_unlock(pack->mutex);
+
+    if (tmp) {
+        tal_free(tmp);
+    } else if (NULL == stored) {
+        rt = OPRT_MALLOC_FAILED;
+    }
+
+    if (OPRT_OK != rt) {
+        tal_free(out);
+        return rt;
+    }
+
+    *data = out;
+    *len = raw_len;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Releases the content returned by ai_asset_load.
+ * @param handle Pack handle.
+ * @param data Content returned by ai_asset_load.
+ * @return None
+ */
+void ai_asset_release(AI_ASSET_PACK_HANDLE handle, const uint8_t *data)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    if (NULL == pack || NULL == data || __pack_is_mapped(pack, data)) {
+        return;
+    }
+
+    tal_free((void *)data);
+}
+
+/**
+ * @brief Gets a block of an asset decompressed, through the cache of the pack. The block stays valid until
+ *        ai_asset_block_put is called.
+ * @param handle Pack handle.
+ * @param offset Offset of the stored block from the start of the pack.
+ * @param size Stored bytes of the block, equal to raw_size when the block is not compressed.
+ * @param raw_size Bytes of the block once decompressed.
+ * @param data Pointer to receive the block.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_block_get(AI_ASSET_PACK_HANDLE handle, uint32_t offset, uint32_t size, uint32_t raw_size,
+                               const uint8_t **data)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    AI_ASSET_CACHE_T *slot = NULL;
+    const uint8_t *stored = NULL;
+    uint16_t i = 0;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(data, OPRT_INVALID_PARM);
+
+    if (0 == offset || 0 == raw_size || offset > pack->len || size > pack->len - offset) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (AI_ASSET_BACKEND_MEM == pack->backend && size == raw_size) {
+        *data = pack->base + offset;
+        return OPRT_OK;
+    }
+
+    tal_mutex_lock(pack->mutex);
+
+    pack->cache_tick++;
+    for (i = 0; i < pack->cache_num; i++) {
+        if (pack->cache[i].key == offset) {
+            slot = &pack->cache[i];
+            slot->ref++;
+            slot->tick = pack->cache_tick;
+            pack->stats.cache_hit++;
+            *data = slot->buf;
+            tal_mutex_unlock(pack->mutex);
+            return OPRT_OK;
+        }
+    }
+    pack->stats.cache_miss++;
+
+    // a free slot, otherwise the least recently used one that is not in use
+    for (i = 0; i < pack->cache_num; i++) {
+        if (pack->cache[i].ref) {
+            continue;
+        }
+        if (0 == pack->cache[i].key) {
+            slot = &pack->cache[i];
+            break;
+        }
+        if (NULL == slot || pack->cache[i].tick < slot->tick) {
+            slot = &pack->cache[i];
+        }
+    }
+    if (NULL == slot) {
+        tal_mutex_unlock(pack->mutex);
+        PR_ERR("asset cache full, %d blocks in use", pack->cache_num);
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    slot->key = 0;
+    if (raw_size > slot->cap) {
+        if (slot->buf) {
+            tal_free(slot->buf);
+            pack->stats.ram_bytes -= slot->cap;
+        }
+        slot->cap = 0;
+        slot->buf = (uint8_t *)tal_malloc(raw_size);
+        TUYA_CHECK_NULL_GOTO(slot->buf, __EXIT);
+        slot->cap = raw_size;
+        pack->stats.ram_bytes += raw_size;
+    }
+
+    if (size == raw_size) {
+        TUYA_CALL_ERR_GOTO(__pack_read(pack, offset, slot->buf, size), __EXIT);
+    } else {
+        if (AI_ASSET_BACKEND_MEM == pack->backend) {
+            stored = pack->base + offset;
+        } else {
+            stored = __pack_scratch_get(pack, size);
+            TUYA_CHECK_NULL_GOTO(stored, __EXIT);
+            TUYA_CALL_ERR_GOTO(__pack_read(pack, offset, (uint8_t *)stored, size), __EXIT);
+        }
+        TUYA_CALL_ERR_GOTO(ai_asset_lz4_decompress(stored, size, slot->buf, raw_size), __EXIT);
+        pack->stats.decomp_bytes += raw_size;
+    }
+
+    slot->key = offset;
+    slot->len = raw_size;
+    slot->ref = 1;
+    slot->tick = pack->cache_tick;
+    *data = slot->buf;
+
+    tal_mutex_unlock(pack->mutex);
+
+    return OPRT_OK;
+
+__EXIT:
+    tal_mutex_unlock(pack->mutex);
+
+    PR_ERR("asset block 0x%x load error %d", offset, rt);
+
+    return (OPRT_OK == rt) ? OPRT_MALLOC_FAILED : rt;
+}
+
+/**
+ * @brief Gives back a block got by ai_asset_block_get.
+ * @param handle Pack handle.
+ * @param data Block returned by ai_asset_block_get.
+ * @return None
+ */
+void ai_asset_block_put(AI_ASSET_PACK_HANDLE handle, const uint8_t *data)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    uint16_t i = 0;
+
+    if (NULL == pack || NULL == data || __pack_is_mapped(pack, data)) {
+        return;
+    }
+
+    tal_mutex_lock(pack->mutex);
+    for (i = 0; i < pack->cache_num; i++) {
+        if (pack->cache[i].buf == data && pack->cache[i].ref) {
+            pack->cache[i].ref--;
+            break;
+        }
+    }
+    tal_mutex_unlock(pack->mutex);
+}
+
+/**
+ * @brief Gets a part of a pack read only, in place when the pack is memory mapped, otherwise read in a buffer
+ *        allocated and accounted to the pack. Used to keep the font tables.
+ * @param handle Pack handle.
+ * @param offset Offset from the start of the pack.
+ * @param len Bytes to get.
+ * @param data Pointer to receive the data, to be released with ai_asset_table_put.
+ * @return OPERATE_RET - OPRT_OK on success, an error code otherwise.
+ */
+OPERATE_RET ai_asset_table_get(AI_ASSET_PACK_HANDLE handle, uint32_t offset, uint32_t len, const uint8_t **data)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+    uint8_t *buf = NULL;
+
+    TUYA_CHECK_NULL_RETURN(pack, OPRT_INVALID_PARM);
+    TUYA_CHECK_NULL_RETURN(data, OPRT_INVALID_PARM);
+
+    if (0 == len || offset > pack->len || len > pack->len - offset) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (AI_ASSET_BACKEND_MEM == pack->backend) {
+        *data = pack->base + offset;
+        return OPRT_OK;
+    }
+
+    buf = (uint8_t *)tal_malloc(len);
+    TUYA_CHECK_NULL_RETURN(buf, OPRT_MALLOC_FAILED);
+
+    tal_mutex_lock(pack->mutex);
+    rt = __pack_read(pack, offset, buf, len);
+    if (OPRT_OK == rt) {
+        pack->stats.ram_bytes += len;
+    }
+    tal_mutex_unlock(pack->mutex);
+
+    if (OPRT_OK != rt) {
+        tal_free(buf);
+        return rt;
+    }
+
+    *data = buf;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Releases the data got by ai_asset_table_get.
+ * @param handle Pack handle.
+ * @param data Data returned by ai_asset_table_get.
+ * @param len Bytes passed to ai_asset_table_get.
+ * @return None
+ */
+void ai_asset_table_put(AI_ASSET_PACK_HANDLE handle, const uint8_t *data, uint32_t len)
+{
+    AI_ASSET_PACK_T *pack = (AI_ASSET_PACK_T *)handle;
+
+    if (NULL == pack || NULL == data || __pack_is_mapped(pack, data)) {
+        return;
+    }
+
+    tal_free((void *)data);
+
+    tal_mutex_lock(pack->mutex);
+    pack->stats.ram_bytes -= len;
+    tal_mutex_unlock(pack->mutex);
+}
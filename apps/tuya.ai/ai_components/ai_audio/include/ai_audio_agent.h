@@ -15,6 +15,7 @@
 
 #include "tuya_cloud_types.h"
 #include "tuya_ai_protocol.h"
+#include "ai_audio_encoder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +66,14 @@ typedef struct {
  */
 OPERATE_RET ai_audio_agent_init(AI_AGENT_CBS_T *cbs);
 
+/**
+ * @brief Sets the format of the uploaded audio, PCM until it is set.
+ * @param info Encoder info of the uploaded frames.
+ * @param frame_ms Duration of an encoded frame.
+ * @return OPERATE_RET - OPRT_OK on success, or an error code on failure.
+ */
+OPERATE_RET ai_audio_agent_upload_set_format(AI_AUDIO_ENCODER_INFO_T *info, uint16_t frame_ms);
+
 /**
  * @brief Starts the AI audio upload process.
  * @param enable_vad Flag to enable cloud vad.
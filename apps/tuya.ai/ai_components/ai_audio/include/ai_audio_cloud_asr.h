@@ -13,6 +13,7 @@
 #define __AI_AUDIO_CLOUD_ASR_H__
 
 #include "tuya_cloud_types.h"
+#include "ai_audio_encoder.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,13 @@ typedef enum {
  */
 OPERATE_RET ai_audio_cloud_asr_init(void);
 
+/**
+ * @brief Sets the encoder of the uploaded audio, only while the cloud ASR is idle.
+ * @param intfs Encoder interfaces, e.g. ai_audio_encoder_adpcm_get().
+ * @return OPERATE_RET - OPRT_OK if the encoder is set, otherwise an error code.
+ */
+OPERATE_RET ai_audio_cloud_asr_set_encoder(AI_AUDIO_ENCODER_INTFS_T *intfs);
+
 /**
  * @brief Starts the audio cloud ASR process.
  * @param none
@@ -0,0 +1,88 @@
+/**
+ * @file ai_audio_encoder.h
+ * @brief Header file for the uplink audio encoders used by the cloud ASR module.
+ *
+ * An encoder turns one frame of 16-bit mono PCM into one encoded frame, without looking ahead, so the uplink
+ * latency it adds is bounded to one frame. A plain PCM passthrough and an IMA ADPCM encoder are built in, other
+ * codecs (Opus, Speex...) are plugged in by providing an AI_AUDIO_ENCODER_INTFS_T.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#ifndef __AI_AUDIO_ENCODER_H__
+#define __AI_AUDIO_ENCODER_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define AI_AUDIO_ENCODER_FRAME_MS 20
+
+// encoder of the cloud ASR uplink until ai_audio_cloud_asr_set_encoder is called, 0: PCM, 1: IMA ADPCM
+#ifndef AI_AUDIO_UPLOAD_ADPCM
+#define AI_AUDIO_UPLOAD_ADPCM 0
+#endif
+
+// IMA ADPCM frame: 2 bytes predictor (little endian), 1 byte step index, 1 byte reserved, then one nibble per
+// sample, low nibble first. The header holds the state before the first sample so every frame decodes on its own.
+#define AI_AUDIO_ADPCM_HEAD_LEN            4
+#define AI_AUDIO_ADPCM_FRAME_LEN(samples) (AI_AUDIO_ADPCM_HEAD_LEN + ((samples) + 1) / 2)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *AI_AUDIO_ENCODER_CTX_T;
+
+typedef struct {
+    uint16_t codec_type; // AUDIO_CODEC_xxx of tuya_ai_protocol.h
+    uint16_t bit_depth;  // bits per encoded sample, 0 for variable bit rate codecs
+    char    *format;     // format name carried in the upload parameters
+    uint32_t frame_max;  // max encoded bytes of a frame
+} AI_AUDIO_ENCODER_INFO_T;
+
+typedef struct {
+    /**
+     * @brief Creates an encoder for frames of frame_samples samples and fills in its info.
+     */
+    OPERATE_RET (*open)(uint32_t sample_rate, uint32_t frame_samples, AI_AUDIO_ENCODER_CTX_T *ctx,
+                        AI_AUDIO_ENCODER_INFO_T *info);
+    /**
+     * @brief Clears the encoder state at the start of a new stream.
+     */
+    OPERATE_RET (*reset)(AI_AUDIO_ENCODER_CTX_T ctx);
+    /**
+     * @brief Encodes up to frame_samples samples, only the last frame of a stream is short.
+     *        out holds info.frame_max bytes, nothing is kept back for the next call.
+     */
+    OPERATE_RET (*encode)(AI_AUDIO_ENCODER_CTX_T ctx, const int16_t *pcm, uint32_t samples, uint8_t *out,
+                          uint32_t *out_len);
+    OPERATE_RET (*close)(AI_AUDIO_ENCODER_CTX_T ctx);
+} AI_AUDIO_ENCODER_INTFS_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Gets the PCM passthrough encoder.
+ * @param None
+ * @return AI_AUDIO_ENCODER_INTFS_T* - The encoder interfaces.
+ */
+AI_AUDIO_ENCODER_INTFS_T *ai_audio_encoder_pcm_get(void);
+
+/**
+ * @brief Gets the IMA ADPCM encoder, 4 bits per sample.
+ * @param None
+ * @return AI_AUDIO_ENCODER_INTFS_T* - The encoder interfaces.
+ */
+AI_AUDIO_ENCODER_INTFS_T *ai_audio_encoder_adpcm_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AI_AUDIO_ENCODER_H__ */
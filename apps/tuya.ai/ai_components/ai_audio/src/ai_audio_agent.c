@@ -28,6 +28,7 @@
 ************************macro define************************
 ***********************************************************/
 #define AI_AGENT_NLG_TEXT_MAX_LEN (4 * 1024)
+#define AI_AGENT_UPLOAD_ATTR_LEN  256
 
 #define TY_BIZCODE_AI_CHAT     0x00010001 // 聊天场景可支持打断
 #define TY_AI_CHAT_ID_DS_CNT   4
@@ -51,6 +52,10 @@ typedef struct {
     AI_AGENT_CBS_T           cbs;
     AI_AGENT_CHAT_STREAM_E   stream_status;
     bool                     is_audio_upload_first_frame;
+    AI_AUDIO_CODEC_TYPE      upload_codec_type;
+    uint16_t                 upload_bit_depth;
+    char                    *upload_format;
+    uint16_t                 upload_frame_ms;
 } AI_AGENT_SESSION_T;
 // clang-format on
 /***********************************************************
@@ -483,6 +488,11 @@ OPERATE_RET ai_audio_agent_init(AI_AGENT_CBS_T *cbs)
         memcpy(&sg_ai.cbs, cbs, sizeof(AI_AGENT_CBS_T));
     }
 
+    sg_ai.upload_codec_type = AUDIO_CODEC_PCM;
+    sg_ai.upload_bit_depth = 16;
+    sg_ai.upload_format = "pcm";
+    sg_ai.upload_frame_ms = AI_AUDIO_ENCODER_FRAME_MS;
+
     PR_DEBUG("ai session wait for mqtt connected...");
 
     tal_event_subscribe(EVENT_MQTT_CONNECTED, "ai_agent_init", __ai_agent_init, SUBSCRIBE_TYPE_ONETIME);
@@ -490,6 +500,28 @@ OPERATE_RET ai_audio_agent_init(AI_AGENT_CBS_T *cbs)
     return rt;
 }
 
+/**
+ * @brief Sets the format of the uploaded audio, PCM until it is set.
+ * @param info Encoder info of the uploaded frames.
+ * @param frame_ms Duration of an encoded frame.
+ * @return OPERATE_RET - OPRT_OK on success, or an error code on failure.
+ */
+OPERATE_RET ai_audio_agent_upload_set_format(AI_AUDIO_ENCODER_INFO_T *info, uint16_t frame_ms)
+{
+    if (NULL == info || NULL == info->format) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sg_ai.upload_codec_type = info->codec_type;
+    sg_ai.upload_bit_depth = info->bit_depth;
+    sg_ai.upload_format = info->format;
+    sg_ai.upload_frame_ms = frame_ms;
+
+    PR_DEBUG("upload format:%s codec:%d frame:%dms", info->format, info->codec_type, frame_ms);
+
+    return OPRT_OK;
+}
+
 /**
  * @brief Starts the AI audio upload process.
  * @param enable_vad Flag to enable cloud vad.
@@ -508,13 +540,23 @@ OPERATE_RET ai_audio_agent_upload_start(uint8_t enable_vad)
     // send start event
     memset(sg_ai.event_id, 0, AI_UUID_V4_LEN);
 
-    char attr_asr_enable_vad[64] = {0};
+    char attr_asr_enable_vad[AI_AGENT_UPLOAD_ATTR_LEN] = {0};
+    int attr_len = 0;
     if (enable_vad) {
-        snprintf(attr_asr_enable_vad, sizeof(attr_asr_enable_vad),
-                 "{\"asr.enableVad\":true,\"processing.interrupt\":true}");
+        attr_len = snprintf(attr_asr_enable_vad, sizeof(attr_asr_enable_vad),
+                            "{\"asr.enableVad\":true,\"processing.interrupt\":true");
     } else {
-        snprintf(attr_asr_enable_vad, sizeof(attr_asr_enable_vad), "{\"asr.enableVad\":true}");
+        attr_len = snprintf(attr_asr_enable_vad, sizeof(attr_asr_enable_vad), "{\"asr.enableVad\":true");
+    }
+
+    // the codec type travels with every audio packet, the frame layout is only needed for compressed audio
+    if (AUDIO_CODEC_PCM != sg_ai.upload_codec_type) {
+        attr_len += snprintf(attr_asr_enable_vad + attr_len, sizeof(attr_asr_enable_vad) - attr_len,
+                             ",\"asr.audio.format\":{\"format\":\"%s\",\"sampleRate\":16000,\"bitDepth\":%d,"
+                             "\"channels\":1,\"frameDuration\":%d}",
+                             sg_ai.upload_format, sg_ai.upload_bit_depth, sg_ai.upload_frame_ms);
     }
+    snprintf(attr_asr_enable_vad + attr_len, sizeof(attr_asr_enable_vad) - attr_len, "}");
 
     AI_ATTRIBUTE_T attr[] = {{
         .type = 1003,
@@ -552,16 +594,16 @@ OPERATE_RET ai_audio_agent_upload_data(uint8_t *data, uint32_t len)
     ai_audio_debug_data((char *)data, len);
 #endif
 
-    // send data use tuya_ai_send_biz_pkt, pcm
+    // send data use tuya_ai_send_biz_pkt, in the format set by ai_audio_agent_upload_set_format
     AI_BIZ_ATTR_INFO_T attr = {
         .flag = AI_HAS_ATTR,
         .type = AI_PT_AUDIO,
         .value.audio =
             {
-                .base.codec_type = AUDIO_CODEC_PCM,
+                .base.codec_type = sg_ai.upload_codec_type,
                 .base.sample_rate = 16000,
                 .base.channels = AUDIO_CHANNELS_MONO,
-                .base.bit_depth = 16,
+                .base.bit_depth = sg_ai.upload_bit_depth,
                 .option.user_len = 0,
                 .option.user_data = NULL,
                 .option.session_id_list = NULL,
@@ -25,6 +25,8 @@
 #define AI_AUDIO_UPLOAD_BUFF_TIME_MS (100)
 #define AI_AUDIO_WAIT_ASR_TM_MS      (10 * 1000)
 
+#define AI_AUDIO_UPLOAD_FRAME_NUM (AI_AUDIO_UPLOAD_BUFF_TIME_MS / AI_AUDIO_ENCODER_FRAME_MS)
+
 #define AI_CLOUD_ASR_EVENT(event)                                                                                      \
     do {                                                                                                               \
         PR_DEBUG("ai cloud asr event: %d", event);                                                                     \
@@ -73,6 +75,12 @@ typedef struct {
     uint8_t                    *upload_buffer;
     uint32_t                    upload_buffer_len;
 
+    AI_AUDIO_ENCODER_INTFS_T   *enc_intfs;
+    AI_AUDIO_ENCODER_CTX_T      enc_ctx;
+    AI_AUDIO_ENCODER_INFO_T     enc_info;
+    uint8_t                    *frame_buffer;
+    uint32_t                    frame_len;
+    uint32_t                    frames_per_pkt;
 } AI_AUDIO_CLOUD_ASR_T;
 // clang-format on
 /***********************************************************
@@ -104,6 +112,88 @@ static void __ai_audio_wait_cloud_asr_tm_cb(TIMER_ID timer_id, void *arg)
     return;
 }
 
+static OPERATE_RET __ai_audio_cloud_asr_encoder_open(AI_AUDIO_ENCODER_INTFS_T *intfs)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_AUDIO_ENCODER_CTX_T ctx = NULL;
+    AI_AUDIO_ENCODER_INFO_T info;
+    uint32_t frames_per_pkt = 0, buffer_len = 0;
+    uint8_t *buffer = NULL;
+
+    memset(&info, 0, sizeof(AI_AUDIO_ENCODER_INFO_T));
+    TUYA_CALL_ERR_RETURN(intfs->open(16000, sg_ai_cloud_asr.frame_len / sizeof(int16_t), &ctx, &info));
+
+    // variable size frames go one per packet so that the cloud can tell them apart
+    frames_per_pkt = (0 == info.bit_depth) ? 1 : AI_AUDIO_UPLOAD_FRAME_NUM;
+    buffer_len = frames_per_pkt * info.frame_max;
+
+    if (buffer_len != sg_ai_cloud_asr.upload_buffer_len) {
+        buffer = (uint8_t *)tkl_system_psram_malloc(buffer_len);
+        if (NULL == buffer) {
+            intfs->close(ctx);
+            return OPRT_MALLOC_FAILED;
+        }
+    }
+
+    if (sg_ai_cloud_asr.enc_intfs) {
+        sg_ai_cloud_asr.enc_intfs->close(sg_ai_cloud_asr.enc_ctx);
+    }
+
+    if (buffer) {
+        if (sg_ai_cloud_asr.upload_buffer) {
+            tkl_system_psram_free(sg_ai_cloud_asr.upload_buffer);
+        }
+        sg_ai_cloud_asr.upload_buffer = buffer;
+        sg_ai_cloud_asr.upload_buffer_len = buffer_len;
+    }
+
+    sg_ai_cloud_asr.enc_intfs = intfs;
+    sg_ai_cloud_asr.enc_ctx = ctx;
+    sg_ai_cloud_asr.enc_info = info;
+    sg_ai_cloud_asr.frames_per_pkt = frames_per_pkt;
+
+    PR_DEBUG("cloud asr encoder:%s frame max:%d frames per packet:%d", info.format, info.frame_max, frames_per_pkt);
+
+    return OPRT_OK;
+}
+
+// encodes up to frames_per_pkt frames of input data into the upload buffer, a short frame is only taken when flushing
+static uint32_t __ai_audio_cloud_asr_encode_pkt(bool is_flush, uint32_t *pcm_len)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t pkt_len = 0, read_len = 0, enc_len = 0, frame_num = 0;
+
+    *pcm_len = 0;
+
+    for (frame_num = 0; frame_num < sg_ai_cloud_asr.frames_per_pkt; frame_num++) {
+        if (false == is_flush && ai_audio_get_input_data_size() < sg_ai_cloud_asr.frame_len) {
+            break;
+        }
+
+        read_len = ai_audio_get_input_data(sg_ai_cloud_asr.frame_buffer, sg_ai_cloud_asr.frame_len);
+        if (0 == read_len) {
+            break;
+        }
+        *pcm_len += read_len;
+
+        enc_len = 0;
+        rt = sg_ai_cloud_asr.enc_intfs->encode(sg_ai_cloud_asr.enc_ctx, (int16_t *)sg_ai_cloud_asr.frame_buffer,
+                                               read_len / sizeof(int16_t), sg_ai_cloud_asr.upload_buffer + pkt_len,
+                                               &enc_len);
+        if (OPRT_OK != rt) {
+            PR_ERR("encode frame err:%d", rt);
+            continue;
+        }
+        pkt_len += enc_len;
+
+        if (read_len < sg_ai_cloud_asr.frame_len) {
+            break;
+        }
+    }
+
+    return pkt_len;
+}
+
 static void __ai_audio_cloud_asr_task(void *arg)
 {
     static AI_CLOUD_ASR_STATE_E last_state;
@@ -163,6 +253,9 @@ static void __ai_audio_cloud_asr_task(void *arg)
                 tal_sw_timer_stop(sg_ai_cloud_asr.asr_timer_id);
             }
 
+            sg_ai_cloud_asr.enc_intfs->reset(sg_ai_cloud_asr.enc_ctx);
+            ai_audio_agent_upload_set_format(&sg_ai_cloud_asr.enc_info, AI_AUDIO_ENCODER_FRAME_MS);
+
             rt = ai_audio_agent_upload_start(true);
             if (OPRT_OK == rt) {
                 sg_ai_cloud_asr.state = AI_CLOUD_ASR_STATE_UPLOAD;
@@ -177,7 +270,7 @@ static void __ai_audio_cloud_asr_task(void *arg)
             }
         } break;
         case AI_CLOUD_ASR_EVT_UPLOADING: {
-            uint32_t upload_len = 0;
+            uint32_t upload_len = 0, pcm_len = 0;
             uint32_t input_data_size = ai_audio_get_input_data_size();
 
             if (false == sg_ai_cloud_asr.is_uploading) {
@@ -189,11 +282,17 @@ static void __ai_audio_cloud_asr_task(void *arg)
                 break;
             }
 
-            upload_len = ai_audio_get_input_data(sg_ai_cloud_asr.upload_buffer, sg_ai_cloud_asr.upload_buffer_len);
-            TUYA_CALL_ERR_LOG(ai_audio_agent_upload_data(sg_ai_cloud_asr.upload_buffer, upload_len));
+            // only whole frames are sent while uploading, a backlog is sent in several packets
+            do {
+                upload_len = __ai_audio_cloud_asr_encode_pkt(false, &pcm_len);
+                if (0 == upload_len) {
+                    break;
+                }
+                TUYA_CALL_ERR_LOG(ai_audio_agent_upload_data(sg_ai_cloud_asr.upload_buffer, upload_len));
+            } while (ai_audio_get_input_data_size() >= sg_ai_cloud_asr.frame_len * sg_ai_cloud_asr.frames_per_pkt);
         } break;
         case AI_CLOUD_ASR_EVT_STOP: {
-            uint32_t upload_len = 0;
+            uint32_t upload_len = 0, pcm_len = 0;
             uint32_t input_data_size = 0;
 
             if (false == sg_ai_cloud_asr.is_uploading) {
@@ -209,17 +308,19 @@ static void __ai_audio_cloud_asr_task(void *arg)
                     break;
                 }
 
-                upload_len = ai_audio_get_input_data(sg_ai_cloud_asr.upload_buffer, sg_ai_cloud_asr.upload_buffer_len);
-                if (0 == upload_len) {
+                upload_len = __ai_audio_cloud_asr_encode_pkt(true, &pcm_len);
+                if (0 == pcm_len) {
                     break;
                 }
 
-                TUYA_CALL_ERR_LOG(ai_audio_agent_upload_data(sg_ai_cloud_asr.upload_buffer, upload_len));
-                if (input_data_size <= upload_len) {
+                if (upload_len) {
+                    TUYA_CALL_ERR_LOG(ai_audio_agent_upload_data(sg_ai_cloud_asr.upload_buffer, upload_len));
+                }
+                if (input_data_size <= pcm_len) {
                     break;
                 }
 
-                input_data_size -= upload_len;
+                input_data_size -= pcm_len;
             }
 
             ai_audio_agent_upload_stop();
@@ -244,10 +345,16 @@ OPERATE_RET ai_audio_cloud_asr_init(void)
 
     memset(&sg_ai_cloud_asr, 0, sizeof(AI_AUDIO_CLOUD_ASR_T));
 
-    // upload buffer init
-    sg_ai_cloud_asr.upload_buffer_len = AI_AUDIO_VOICE_FRAME_LEN_GET(AI_AUDIO_UPLOAD_BUFF_TIME_MS);
-    sg_ai_cloud_asr.upload_buffer = (uint8_t *)tkl_system_psram_malloc(sg_ai_cloud_asr.upload_buffer_len);
-    TUYA_CHECK_NULL_GOTO(sg_ai_cloud_asr.upload_buffer, __ERR);
+    // frame and upload buffer init, the upload buffer is sized by the encoder
+    sg_ai_cloud_asr.frame_len = AI_AUDIO_VOICE_FRAME_LEN_GET(AI_AUDIO_ENCODER_FRAME_MS);
+    sg_ai_cloud_asr.frame_buffer = (uint8_t *)tkl_system_psram_malloc(sg_ai_cloud_asr.frame_len);
+    TUYA_CHECK_NULL_GOTO(sg_ai_cloud_asr.frame_buffer, __ERR);
+
+#if defined(AI_AUDIO_UPLOAD_ADPCM) && (AI_AUDIO_UPLOAD_ADPCM == 1)
+    TUYA_CALL_ERR_GOTO(__ai_audio_cloud_asr_encoder_open(ai_audio_encoder_adpcm_get()), __ERR);
+#else
+    TUYA_CALL_ERR_GOTO(__ai_audio_cloud_asr_encoder_open(ai_audio_encoder_pcm_get()), __ERR);
+#endif
 
     TUYA_CALL_ERR_GOTO(tal_queue_create_init(&sg_ai_cloud_asr.queue, sizeof(AI_CLOUD_ASR_MSG_T), 8), __ERR);
 
@@ -275,6 +382,17 @@ __ERR:
         sg_ai_cloud_asr.upload_buffer = NULL;
     }
 
+    if (sg_ai_cloud_asr.enc_intfs) {
+        sg_ai_cloud_asr.enc_intfs->close(sg_ai_cloud_asr.enc_ctx);
+        sg_ai_cloud_asr.enc_intfs = NULL;
+        sg_ai_cloud_asr.enc_ctx = NULL;
+    }
+
+    if (sg_ai_cloud_asr.frame_buffer) {
+        tkl_system_psram_free(sg_ai_cloud_asr.frame_buffer);
+        sg_ai_cloud_asr.frame_buffer = NULL;
+    }
+
     if (sg_ai_cloud_asr.mutex) {
         tal_mutex_release(sg_ai_cloud_asr.mutex);
         sg_ai_cloud_asr.mutex = NULL;
@@ -290,6 +408,35 @@ __ERR:
     return rt;
 }
 
+/**
+ * @brief Sets the encoder of the uploaded audio, only while the cloud ASR is idle.
+ * @param intfs Encoder interfaces, e.g. ai_audio_encoder_adpcm_get().
+ * @return OPERATE_RET - OPRT_OK if the encoder is set, otherwise an error code.
+ */
+OPERATE_RET ai_audio_cloud_asr_set_encoder(AI_AUDIO_ENCODER_INTFS_T *intfs)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    if (NULL == intfs || NULL == intfs->open || NULL == intfs->reset || NULL == intfs->encode ||
+        NULL == intfs->close) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(sg_ai_cloud_asr.mutex);
+
+    if (true == sg_ai_cloud_asr.is_uploading || AI_CLOUD_ASR_STATE_IDLE != sg_ai_cloud_asr.state) {
+        PR_ERR("cloud_asr is busy");
+        tal_mutex_unlock(sg_ai_cloud_asr.mutex);
+        return OPRT_COM_ERROR;
+    }
+
+    rt = __ai_audio_cloud_asr_encoder_open(intfs);
+
+    tal_mutex_unlock(sg_ai_cloud_asr.mutex);
+
+    return rt;
+}
+
 /**
  * @brief Starts the audio cloud ASR process.
  * @param None
@@ -0,0 +1,232 @@
+/**
+ * @file ai_audio_encoder.c
+ * @brief Implementation of the built-in uplink audio encoders, a PCM passthrough and an IMA ADPCM encoder.
+ *
+ * The ADPCM encoder compresses 16-bit samples to 4 bits with integer arithmetic only. Every frame starts with the
+ * predictor state, so a lost packet does not corrupt the frames after it.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ */
+
+#include "tal_api.h"
+#include "tuya_ai_protocol.h"
+
+#include "ai_audio_encoder.h"
+/***********************************************************
+************************macro define************************
+***********************************************************/
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint32_t frame_samples;
+    int32_t  predictor;
+    int32_t  index;
+} AI_AUDIO_ADPCM_ENC_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const int16_t sg_adpcm_step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t sg_adpcm_index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static OPERATE_RET __pcm_open(uint32_t sample_rate, uint32_t frame_samples, AI_AUDIO_ENCODER_CTX_T *ctx,
+                              AI_AUDIO_ENCODER_INFO_T *info)
+{
+    if (NULL == ctx || NULL == info || 0 == frame_samples) {
+        return OPRT_INVALID_PARM;
+    }
+
+    info->codec_type = AUDIO_CODEC_PCM;
+    info->bit_depth = 16;
+    info->format = "pcm";
+    info->frame_max = frame_samples * sizeof(int16_t);
+
+    *ctx = NULL;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __pcm_reset(AI_AUDIO_ENCODER_CTX_T ctx)
+{
+    return OPRT_OK;
+}
+
+static OPERATE_RET __pcm_encode(AI_AUDIO_ENCODER_CTX_T ctx, const int16_t *pcm, uint32_t samples, uint8_t *out,
+                                uint32_t *out_len)
+{
+    memcpy(out, pcm, samples * sizeof(int16_t));
+    *out_len = samples * sizeof(int16_t);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __pcm_close(AI_AUDIO_ENCODER_CTX_T ctx)
+{
+    return OPRT_OK;
+}
+
+static OPERATE_RET __adpcm_open(uint32_t sample_rate, uint32_t frame_samples, AI_AUDIO_ENCODER_CTX_T *ctx,
+                                AI_AUDIO_ENCODER_INFO_T *info)
+{
+    AI_AUDIO_ADPCM_ENC_T *enc = NULL;
+
+    if (NULL == ctx || NULL == info || 0 == frame_samples) {
+        return OPRT_INVALID_PARM;
+    }
+
+    enc = (AI_AUDIO_ADPCM_ENC_T *)tal_malloc(sizeof(AI_AUDIO_ADPCM_ENC_T));
+    TUYA_CHECK_NULL_RETURN(enc, OPRT_MALLOC_FAILED);
+    memset(enc, 0, sizeof(AI_AUDIO_ADPCM_ENC_T));
+
+    enc->frame_samples = frame_samples;
+
+    info->codec_type = AUDIO_CODEC_ADPCM;
+    info->bit_depth = 4;
+    info->format = "adpcm";
+    info->frame_max = AI_AUDIO_ADPCM_FRAME_LEN(frame_samples);
+
+    *ctx = enc;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __adpcm_reset(AI_AUDIO_ENCODER_CTX_T ctx)
+{
+    AI_AUDIO_ADPCM_ENC_T *enc = (AI_AUDIO_ADPCM_ENC_T *)ctx;
+
+    enc->predictor = 0;
+    enc->index = 0;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __adpcm_encode(AI_AUDIO_ENCODER_CTX_T ctx, const int16_t *pcm, uint32_t samples, uint8_t *out,
+                                  uint32_t *out_len)
+{
+    AI_AUDIO_ADPCM_ENC_T *enc = (AI_AUDIO_ADPCM_ENC_T *)ctx;
+    int32_t predictor = enc->predictor, index = enc->index;
+    int32_t step = 0, diff = 0, delta = 0;
+    uint8_t code = 0, *dst = out + AI_AUDIO_ADPCM_HEAD_LEN;
+    uint32_t i = 0;
+
+    if (samples > enc->frame_samples) {
+        return OPRT_INVALID_PARM;
+    }
+
+    out[0] = (uint8_t)(predictor & 0xFF);
+    out[1] = (uint8_t)((predictor >> 8) & 0xFF);
+    out[2] = (uint8_t)index;
+    out[3] = 0;
+
+    for (i = 0; i < samples; i++) {
+        step = sg_adpcm_step_table[index];
+        diff = pcm[i] - predictor;
+
+        code = 0;
+        if (diff < 0) {
+            code = 8;
+            diff = -diff;
+        }
+
+        // quantize to 3 bits and rebuild the difference the decoder will see
+        delta = step >> 3;
+        if (diff >= step) {
+            code |= 4;
+            diff -= step;
+            delta += step;
+        }
+        step >>= 1;
+        if (diff >= step) {
+            code |= 2;
+            diff -= step;
+            delta += step;
+        }
+        step >>= 1;
+        if (diff >= step) {
+            code |= 1;
+            delta += step;
+        }
+
+        predictor += (code & 8) ? -delta : delta;
+        if (predictor > 32767) {
+            predictor = 32767;
+        } else if (predictor < -32768) {
+            predictor = -32768;
+        }
+
+        index += sg_adpcm_index_table[code & 0x07];
+        if (index < 0) {
+            index = 0;
+        } else if (index > 88) {
+            index = 88;
+        }
+
+        if (i & 0x01) {
+            *dst++ |= code << 4;
+        } else {
+            *dst = code;
+        }
+    }
+
+    enc->predictor = predictor;
+    enc->index = index;
+
+    *out_len = AI_AUDIO_ADPCM_FRAME_LEN(samples);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __adpcm_close(AI_AUDIO_ENCODER_CTX_T ctx)
+{
+    if (ctx) {
+        tal_free(ctx);
+    }
+
+    return OPRT_OK;
+}
+
+static AI_AUDIO_ENCODER_INTFS_T sg_pcm_intfs = {
+    .open = __pcm_open,
+    .reset = __pcm_reset,
+    .encode = __pcm_encode,
+    .close = __pcm_close,
+};
+
+static AI_AUDIO_ENCODER_INTFS_T sg_adpcm_intfs = {
+    .open = __adpcm_open,
+    .reset = __adpcm_reset,
+    .encode = __adpcm_encode,
+    .close = __adpcm_close,
+};
+
+/**
+ * @brief Gets the PCM passthrough encoder.
+ * @param None
+ * @return AI_AUDIO_ENCODER_INTFS_T* - The encoder interfaces.
+ */
+AI_AUDIO_ENCODER_INTFS_T *ai_audio_encoder_pcm_get(void)
+{
+    return &sg_pcm_intfs;
+}
+
+/**
+ * @brief Gets the IMA ADPCM encoder, 4 bits per sample.
+ * @param None
+ * @return AI_AUDIO_ENCODER_INTFS_T* - The encoder interfaces.
+ */
+AI_AUDIO_ENCODER_INTFS_T *ai_audio_encoder_adpcm_get(void)
+{
+    return &sg_adpcm_intfs;
+}
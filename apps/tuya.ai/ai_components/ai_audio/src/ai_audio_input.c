@@ -55,6 +55,7 @@ typedef struct {
 
     TUYA_RINGBUFF_T                ringbuff_hdl;
     MUTEX_HANDLE                   rb_mutex;
+    SEM_HANDLE                     wake_sem;  // new frame or event to inform, wakes the input task
 
     AI_AUDIO_INPUT_ASR_T           asr;  
 
@@ -96,6 +97,7 @@ static void __ai_audio_asr_wakeup_timeout(TIMER_ID timer_id, void *arg)
     PR_NOTICE("asr wakeup timeout");
     sg_audio_input.asr.is_wakeup = false;
     sg_audio_input.asr.is_need_inform_wakeup_stop = true;
+    tal_semaphore_post(sg_audio_input.wake_sem);
 }
 
 static OPERATE_RET __ai_audio_asr_init(void)
@@ -386,6 +388,8 @@ static void __ai_audio_get_input_frame(TDL_AUDIO_FRAME_FORMAT_E type, TDL_AUDIO_
     tuya_ring_buff_write(sg_audio_input.ringbuff_hdl, data, len);
     tal_mutex_unlock(sg_audio_input.rb_mutex);
 
+    tal_semaphore_post(sg_audio_input.wake_sem);
+
     return;
 }
 
@@ -396,9 +400,11 @@ static void __ai_audio_handle_frame_task(void *arg)
     AI_AUDIO_INPUT_STATE_E last_state = AI_AUDIO_INPUT_STATE_IDLE;
 
     while (1) {
+        // runs once per input frame, the VAD and ASR state only changes when a frame is fed
+        tal_semaphore_wait_forever(sg_audio_input.wake_sem);
+
         rb_used_sz = tuya_ring_buff_used_size_get(sg_audio_input.ringbuff_hdl);
         if (0 == rb_used_sz) {
-            tal_system_sleep(10);
             continue;
         }
 
@@ -427,8 +433,6 @@ static void __ai_audio_handle_frame_task(void *arg)
         if ((event != AI_AUDIO_INPUT_EVT_NONE) && sg_audio_input_inform_cb) {
             sg_audio_input_inform_cb(event, NULL);
         }
-
-        tal_system_sleep(10);
     }
 }
 
@@ -490,6 +494,7 @@ OPERATE_RET ai_audio_input_init(AI_AUDIO_INPUT_CFG_T *cfg, AI_AUDIO_INOUT_INFORM
     TUYA_CALL_ERR_RETURN(tuya_ring_buff_create(AI_AUDIO_VOICE_FRAME_LEN_GET(AI_AUDIO_INPUT_RB_TIME_MS) + 1,
                                                OVERFLOW_PSRAM_STOP_TYPE, &sg_audio_input.ringbuff_hdl));
     TUYA_CALL_ERR_RETURN(tal_mutex_create_init(&sg_audio_input.rb_mutex));
+    TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&sg_audio_input.wake_sem, 0, 1));
 
     TUYA_CALL_ERR_RETURN(__ai_audio_input_set_method(cfg->get_valid_data_method));
 
@@ -571,6 +576,7 @@ OPERATE_RET ai_audio_input_stop_asr_awake(void)
 
     sg_audio_input.asr.is_wakeup = false;
     sg_audio_input.asr.is_need_inform_wakeup_stop = true;
+    tal_semaphore_post(sg_audio_input.wake_sem);
 
     PR_NOTICE("ai audio needs to be awakened again by the wake-up word");
 
@@ -24,6 +24,10 @@
 #include "minimp3_ex.h"
 #include "ai_audio.h"
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+#include "ai_asset_pack.h"
+#endif
+
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
@@ -35,8 +39,9 @@
 #define MAX_NCHAN 2   /* max channels */
 #define MAX_NSAMP 576 /* max samples per channel, per granule */
 
-#define MP3_PCM_SIZE_MAX           (MAX_NSAMP * MAX_NCHAN * MAX_NGRAN * 2)
-#define PLAYING_NO_DATA_TIMEOUT_MS (5 * 1000)
+#define MP3_PCM_SIZE_MAX            (MAX_NSAMP * MAX_NCHAN * MAX_NGRAN * 2)
+#define PLAYING_NO_DATA_TIMEOUT_MS  (5 * 1000)
+#define PLAYER_WAIT_IDLE_TIMEOUT_MS (1000) // re-check period in case another waiter took the wake-up
 
 #define AI_AUDIO_PLAYER_STAT_CHANGE(last_stat, new_stat)                                                               \
     do {                                                                                                               \
@@ -45,12 +50,29 @@
         }                                                                                                              \
     } while (0)
 
+#define ALERT_READ_CHUNK_LEN (4 * 1024)
+
+// the alerts of an asset pack have the name of the array they replace. When they are only in the pack,
+// ai_media_alert.c is not built and the built-in arrays are left out.
+#if defined(ENABLE_AI_ASSET_PACK_ALERT) && (ENABLE_AI_ASSET_PACK_ALERT == 1)
+#define ALERT_SRC(array) {#array, NULL, 0}
+#else
+#define ALERT_SRC(array) {#array, array, sizeof(array)}
+#endif
+
 /***********************************************************
 ***********************typedef define***********************
 ***********************************************************/
+typedef struct {
+    const char *name;
+    const uint8_t *data;
+    uint32_t len;
+} ALERT_SRC_T;
+
 typedef struct {
     bool is_playing;
     bool is_writing;
+    bool is_decoding;
     AI_AUDIO_PLAYER_STATE_E stat;
 
     TDL_AUDIO_HANDLE_T audio_hdl;
@@ -60,6 +82,10 @@ typedef struct {
     char *id;
     TUYA_RINGBUFF_T rb_hdl;
     MUTEX_HANDLE spk_rb_mutex;
+    SEM_HANDLE data_sem;   // posted on new stream data and state changes, wakes the player task
+    SEM_HANDLE space_sem;  // posted when stream data is consumed or playing stops, wakes the writer
+    SEM_HANDLE idle_sem;   // posted when the writer returns or a frame is played
+    SEM_HANDLE finish_sem; // posted when playing ends
     uint8_t is_eof;
     TIMER_ID tm_id;
 
@@ -81,6 +107,22 @@ typedef struct {
 ***********************************************************/
 static APP_PLAYER_T sg_player;
 
+static const ALERT_SRC_T sg_alert_src[] = {
+    [AI_AUDIO_ALERT_POWER_ON] = ALERT_SRC(media_src_power_on),
+    [AI_AUDIO_ALERT_NOT_ACTIVE] = ALERT_SRC(media_src_not_active),
+    [AI_AUDIO_ALERT_NETWORK_CFG] = ALERT_SRC(media_src_netcfg_mode),
+    [AI_AUDIO_ALERT_NETWORK_CONNECTED] = ALERT_SRC(media_src_network_conencted),
+    [AI_AUDIO_ALERT_NETWORK_FAIL] = ALERT_SRC(media_src_network_fail),
+    [AI_AUDIO_ALERT_NETWORK_DISCONNECT] = ALERT_SRC(media_src_network_disconnect),
+    [AI_AUDIO_ALERT_BATTERY_LOW] = ALERT_SRC(media_src_battery_low),
+    [AI_AUDIO_ALERT_PLEASE_AGAIN] = ALERT_SRC(media_src_please_again),
+    [AI_AUDIO_ALERT_WAKEUP] = ALERT_SRC(media_src_wakeup),
+    [AI_AUDIO_ALERT_LONG_KEY_TALK] = ALERT_SRC(media_src_long_press_dialogue),
+    [AI_AUDIO_ALERT_KEY_TALK] = ALERT_SRC(media_src_key_dialogue),
+    [AI_AUDIO_ALERT_WAKEUP_TALK] = ALERT_SRC(media_src_wake_dialogue),
+    [AI_AUDIO_ALERT_FREE_TALK] = ALERT_SRC(media_src_free_dialogue),
+};
+
 /***********************************************************
 ***********************function define**********************
 ***********************************************************/
@@ -142,9 +184,25 @@ static OPERATE_RET __ai_audio_player_mp3_playing(void)
         ctx->mp3_raw_used_len += rt_len;
     }
 
+    if (rb_used_len > 0) {
+        tal_semaphore_post(ctx->space_sem);
+    }
+
     int samples = mp3dec_decode_frame(ctx->mp3_dec, ctx->mp3_raw_head, ctx->mp3_raw_used_len,
                                       (mp3d_sample_t *)ctx->mp3_pcm, &ctx->mp3_frame_info);
     if (samples == 0) {
+        if (ctx->mp3_frame_info.frame_bytes > 0) {
+            // skipped ID3 tag or invalid data
+            ctx->mp3_raw_used_len -= ctx->mp3_frame_info.frame_bytes;
+            ctx->mp3_raw_head += ctx->mp3_frame_info.frame_bytes;
+            goto __EXIT;
+        }
+
+        // wait for the rest of a partial frame, drop data that holds no frame
+        if (ctx->mp3_raw_used_len < MAINBUF_SIZE && !ctx->is_eof) {
+            rt = OPRT_RECV_DA_NOT_ENOUGH;
+            goto __EXIT;
+        }
         ctx->mp3_raw_used_len = 0;
         ctx->mp3_raw_head = ctx->mp3_raw;
         rt = OPRT_COM_ERROR;
@@ -193,10 +251,13 @@ static void __ai_audio_player_task(void *arg)
     OPERATE_RET rt = OPRT_OK;
     APP_PLAYER_T *ctx = &sg_player;
     static AI_AUDIO_PLAYER_STATE_E last_state = 0xFF;
+    bool is_wait = false;
 
     ctx->stat = AI_AUDIO_PLAYER_STAT_IDLE;
 
     for (;;) {
+        is_wait = false;
+
         tal_mutex_lock(sg_player.mutex);
 
         AI_AUDIO_PLAYER_STAT_CHANGE(last_state, ctx->stat);
@@ -208,6 +269,7 @@ static void __ai_audio_player_task(void *arg)
                 tal_sw_timer_stop(ctx->tm_id);
             }
             ctx->is_eof = 0;
+            is_wait = true;
         } break;
         case AI_AUDIO_PLAYER_STAT_START: {
             rt = __ai_audio_player_mp3_start();
@@ -218,9 +280,23 @@ static void __ai_audio_player_task(void *arg)
             }
         } break;
         case AI_AUDIO_PLAYER_STAT_PLAY: {
+            // decode and play out of the player mutex, tdl_audio_play blocks while the codec is busy
+            ctx->is_decoding = true;
+            tal_mutex_unlock(sg_player.mutex);
             rt = __ai_audio_player_mp3_playing();
+            tal_mutex_lock(sg_player.mutex);
+            ctx->is_decoding = false;
+            tal_semaphore_post(ctx->idle_sem);
+
+            if (AI_AUDIO_PLAYER_STAT_PLAY != ctx->stat) {
+                break;
+            }
+
             if (OPRT_RECV_DA_NOT_ENOUGH == rt) {
-                tal_sw_timer_start(ctx->tm_id, PLAYING_NO_DATA_TIMEOUT_MS, TAL_TIMER_ONCE);
+                if (!tal_sw_timer_is_running(ctx->tm_id)) {
+                    tal_sw_timer_start(ctx->tm_id, PLAYING_NO_DATA_TIMEOUT_MS, TAL_TIMER_ONCE);
+                }
+                is_wait = true;
             } else if (OPRT_OK == rt) {
                 if (tal_sw_timer_is_running(ctx->tm_id)) {
                     tal_sw_timer_stop(ctx->tm_id);
@@ -232,6 +308,7 @@ static void __ai_audio_player_task(void *arg)
             if (rb_used_len == 0 && 0 == ctx->mp3_raw_used_len && ctx->is_eof) {
                 PR_DEBUG("app player end");
                 ctx->stat = AI_AUDIO_PLAYER_STAT_FINISH;
+                is_wait = false;
             }
         } break;
         case AI_AUDIO_PLAYER_STAT_FINISH: {
@@ -240,17 +317,23 @@ static void __ai_audio_player_task(void *arg)
             ctx->is_playing = false;
             ctx->stat = AI_AUDIO_PLAYER_STAT_IDLE;
             ctx->is_eof = 0;
+            tal_semaphore_post(ctx->space_sem);
+            tal_semaphore_post(ctx->finish_sem);
         } break;
         case AI_AUDIO_PLAYER_STAT_PAUSE:
             // do nothing
+            is_wait = true;
             break;
         default:
+            is_wait = true;
             break;
         }
 
         tal_mutex_unlock(sg_player.mutex);
 
-        tal_system_sleep(10);
+        if (is_wait) {
+            tal_semaphore_wait_forever(ctx->data_sem);
+        }
     }
 }
 
@@ -260,6 +343,7 @@ static void __app_playing_tm_cb(TIMER_ID timer_id, void *arg)
     tal_mutex_lock(sg_player.mutex);
     sg_player.stat = AI_AUDIO_PLAYER_STAT_FINISH;
     tal_mutex_unlock(sg_player.mutex);
+    tal_semaphore_post(sg_player.data_sem);
     return;
 }
 
@@ -307,6 +391,10 @@ OPERATE_RET ai_audio_player_init(void)
                        __ERR);
     // ring buffer mutex init
     TUYA_CALL_ERR_GOTO(tal_mutex_create_init(&sg_player.spk_rb_mutex), __ERR);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_player.data_sem, 0, 1), __ERR);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_player.space_sem, 0, 1), __ERR);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_player.idle_sem, 0, 1), __ERR);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_player.finish_sem, 0, 1), __ERR);
 
     // thread init
     TUYA_CALL_ERR_GOTO(tkl_thread_create_in_psram(&sg_player.thrd_hdl, "ai_player", 1024 * 4, THREAD_PRIO_1,
@@ -333,6 +421,26 @@ __ERR:
         sg_player.rb_hdl = NULL;
     }
 
+    if (sg_player.data_sem) {
+        tal_semaphore_release(sg_player.data_sem);
+        sg_player.data_sem = NULL;
+    }
+
+    if (sg_player.space_sem) {
+        tal_semaphore_release(sg_player.space_sem);
+        sg_player.space_sem = NULL;
+    }
+
+    if (sg_player.idle_sem) {
+        tal_semaphore_release(sg_player.idle_sem);
+        sg_player.idle_sem = NULL;
+    }
+
+    if (sg_player.finish_sem) {
+        tal_semaphore_release(sg_player.finish_sem);
+        sg_player.finish_sem = NULL;
+    }
+
     return rt;
 }
 
@@ -369,10 +477,13 @@ OPERATE_RET ai_audio_player_start(char *id)
     }
 
     sg_player.is_playing = true;
+    sg_player.is_eof = 0;
     sg_player.stat = AI_AUDIO_PLAYER_STAT_START;
 
     tal_mutex_unlock(sg_player.mutex);
 
+    tal_semaphore_post(sg_player.data_sem);
+
     PR_NOTICE("ai audio player start");
 
     return OPRT_OK;
@@ -414,9 +525,9 @@ OPERATE_RET ai_audio_player_data_write(char *id, uint8_t *data, uint32_t len, ui
             uint32_t rb_free_len = tuya_ring_buff_free_size_get(sg_player.rb_hdl);
             tal_mutex_unlock(sg_player.spk_rb_mutex);
             if (0 == rb_free_len) {
-                // need unlock mutex before sleep
+                // need unlock mutex before waiting for the player to consume data
                 tal_mutex_unlock(sg_player.mutex);
-                tal_system_sleep(3);
+                tal_semaphore_wait_forever(sg_player.space_sem);
                 tal_mutex_lock(sg_player.mutex);
                 continue;
             }
@@ -426,15 +537,21 @@ OPERATE_RET ai_audio_player_data_write(char *id, uint8_t *data, uint32_t len, ui
             tal_mutex_lock(sg_player.spk_rb_mutex);
             tuya_ring_buff_write(sg_player.rb_hdl, data + alreay_write_len, write_len);
             tal_mutex_unlock(sg_player.spk_rb_mutex);
+            tal_semaphore_post(sg_player.data_sem);
 
             alreay_write_len += write_len;
         };
         sg_player.is_writing = false;
+        tal_semaphore_post(sg_player.idle_sem);
     }
 
     sg_player.is_eof = is_eof;
     tal_mutex_unlock(sg_player.mutex);
 
+    if (is_eof) {
+        tal_semaphore_post(sg_player.data_sem);
+    }
+
     return OPRT_OK;
 }
 
@@ -462,9 +579,11 @@ OPERATE_RET ai_audio_player_stop(void)
         sg_player.id = NULL;
     }
 
-    while (sg_player.is_writing) {
+    // wake a writer waiting for space, then wait for it and for the frame being played
+    while (sg_player.is_writing || sg_player.is_decoding) {
         tal_mutex_unlock(sg_player.mutex);
-        tal_system_sleep(3);
+        tal_semaphore_post(sg_player.space_sem);
+        tal_semaphore_wait(sg_player.idle_sem, PLAYER_WAIT_IDLE_TIMEOUT_MS);
         tal_mutex_lock(sg_player.mutex);
     }
 
@@ -479,11 +598,57 @@ OPERATE_RET ai_audio_player_stop(void)
 
     tal_mutex_unlock(sg_player.mutex);
 
+    tal_semaphore_post(sg_player.data_sem);
+    tal_semaphore_post(sg_player.finish_sem);
+
     PR_NOTICE("ai audio player stop");
 
     return rt;
 }
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+static OPERATE_RET __ai_audio_player_pack_alert_write(char *alert_id, const char *name)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_HANDLE pack = ai_asset_pack_default_get();
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    const uint8_t *data = NULL;
+    uint8_t *buf = NULL;
+    uint32_t len = 0, offset = 0, chunk_len = 0;
+
+    entry = ai_asset_find(pack, name);
+    if (NULL == entry || AI_ASSET_TYPE_MEDIA != entry->type) {
+        return OPRT_NOT_FOUND;
+    }
+
+    if (AI_ASSET_COMP_NONE != entry->comp) {
+        TUYA_CALL_ERR_RETURN(ai_asset_load(pack, entry, &data, &len));
+        rt = ai_audio_player_data_write(alert_id, (uint8_t *)data, len, 1);
+        ai_asset_release(pack, data);
+        return rt;
+    }
+
+    // stored as is, streamed to the player so the whole alert is never held in RAM
+    buf = (uint8_t *)tal_malloc(ALERT_READ_CHUNK_LEN);
+    TUYA_CHECK_NULL_RETURN(buf, OPRT_MALLOC_FAILED);
+
+    do {
+        chunk_len = GET_MIN_LEN(ALERT_READ_CHUNK_LEN, entry->size - offset);
+        rt = ai_asset_read(pack, entry, offset, buf, chunk_len);
+        if (OPRT_OK != rt) {
+            ai_audio_player_data_write(alert_id, NULL, 0, 1);
+            break;
+        }
+        offset += chunk_len;
+        rt = ai_audio_player_data_write(alert_id, buf, chunk_len, offset >= entry->size);
+    } while (OPRT_OK == rt && offset < entry->size);
+
+    tal_free(buf);
+
+    return rt;
+}
+#endif
+
 /**
  * @brief Plays an alert sound based on the specified alert type.
  *
@@ -494,59 +659,31 @@ OPERATE_RET ai_audio_player_play_alert(AI_AUDIO_ALERT_TYPE_E type)
 {
     OPERATE_RET rt = OPRT_OK;
     char alert_id[64] = {0};
+    const ALERT_SRC_T *src = NULL;
 
     snprintf(alert_id, sizeof(alert_id), "alert_%d", type);
 
     ai_audio_player_start(alert_id);
 
-    switch (type) {
-    case AI_AUDIO_ALERT_POWER_ON: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_power_on, sizeof(media_src_power_on), 1);
-    } break;
-    case AI_AUDIO_ALERT_NOT_ACTIVE: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_not_active, sizeof(media_src_not_active), 1);
-    } break;
-    case AI_AUDIO_ALERT_NETWORK_CFG: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_netcfg_mode, sizeof(media_src_netcfg_mode), 1);
-    } break;
-    case AI_AUDIO_ALERT_NETWORK_CONNECTED: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_network_conencted,
-                                        sizeof(media_src_network_conencted), 1);
-    } break;
-    case AI_AUDIO_ALERT_NETWORK_FAIL: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_network_fail, sizeof(media_src_network_fail), 1);
-    } break;
-    case AI_AUDIO_ALERT_NETWORK_DISCONNECT: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_network_disconnect,
-                                        sizeof(media_src_network_disconnect), 1);
-    } break;
-    case AI_AUDIO_ALERT_BATTERY_LOW: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_battery_low, sizeof(media_src_battery_low), 1);
-    } break;
-    case AI_AUDIO_ALERT_PLEASE_AGAIN: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_please_again, sizeof(media_src_please_again), 1);
-    } break;
-    case AI_AUDIO_ALERT_WAKEUP: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_wakeup, sizeof(media_src_wakeup), 1);
-    } break;
-    case AI_AUDIO_ALERT_LONG_KEY_TALK: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_long_press_dialogue,
-                                        sizeof(media_src_long_press_dialogue), 1);
-    } break;
-    case AI_AUDIO_ALERT_KEY_TALK: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_key_dialogue, sizeof(media_src_key_dialogue), 1);
-    } break;
-    case AI_AUDIO_ALERT_WAKEUP_TALK: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_wake_dialogue, sizeof(media_src_wake_dialogue),
-                                        1);
-    } break;
-    case AI_AUDIO_ALERT_FREE_TALK: {
-        rt = ai_audio_player_data_write(alert_id, (uint8_t *)media_src_free_dialogue, sizeof(media_src_free_dialogue),
-                                        1);
-    } break;
-    default:
-        break;
+    if ((uint32_t)type >= CNTSOF(sg_alert_src) || NULL == sg_alert_src[type].name) {
+        return OPRT_OK;
+    }
+    src = &sg_alert_src[type];
+
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+    rt = __ai_audio_player_pack_alert_write(alert_id, src->name);
+    if (OPRT_NOT_FOUND != rt) {
+        return rt;
     }
+#endif
+
+    if (NULL == src->data) {
+        PR_ERR("alert %s not found", src->name);
+        ai_audio_player_data_write(alert_id, NULL, 0, 1);
+        return OPRT_NOT_FOUND;
+    }
+
+    rt = ai_audio_player_data_write(alert_id, (uint8_t *)src->data, src->len, 1);
 
     return rt;
 }
@@ -561,7 +698,7 @@ OPERATE_RET ai_audio_player_play_alert_syn(AI_AUDIO_ALERT_TYPE_E type)
     ai_audio_player_play_alert(type);
 
     while (ai_audio_player_is_playing()) {
-        tal_system_sleep(10);
+        tal_semaphore_wait(sg_player.finish_sem, PLAYER_WAIT_IDLE_TIMEOUT_MS);
     }
 
     return OPRT_OK;
@@ -24,6 +24,10 @@
 #include "ai_audio.h"
 #include "app_chat_bot.h"
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+#include "ai_asset_pack.h"
+#endif
+
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
@@ -359,11 +363,40 @@ static OPERATE_RET __app_open_button(void)
 }
 #endif
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+static OPERATE_RET __app_open_asset_pack(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_ASSET_PACK_HANDLE pack = NULL;
+    AI_ASSET_PACK_CFG_T cfg = {.cache_num = AI_ASSET_PACK_CACHE_NUM, .check_crc = 0};
+    const char *path = AI_ASSET_PACK_FILE;
+
+    if (path[0]) {
+        rt = ai_asset_pack_open_file(path, &cfg, &pack);
+    } else {
+        rt = ai_asset_pack_open_flash(TUYA_FLASH_TYPE_USER0, 0, &cfg, &pack);
+    }
+    if (OPRT_OK != rt) {
+        PR_ERR("asset pack open failed %d, use the built-in assets", rt);
+        return rt;
+    }
+
+    ai_asset_pack_default_set(pack);
+
+    return OPRT_OK;
+}
+#endif
+
 OPERATE_RET app_chat_bot_init(void)
 {
     OPERATE_RET rt = OPRT_OK;
     AI_AUDIO_CONFIG_T ai_audio_cfg;
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+    // before the display and the audio, they look up their images and alerts in the pack
+    __app_open_asset_pack();
+#endif
+
 #if defined(ENABLE_CHAT_DISPLAY) && (ENABLE_CHAT_DISPLAY == 1)
     app_display_init();
 #endif
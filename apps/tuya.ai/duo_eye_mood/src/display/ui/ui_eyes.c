@@ -11,9 +11,19 @@
 
 #include "lvgl.h"
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+#include "ai_asset_lvgl.h"
+#endif
+
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+// the eye images of an asset pack have the name of the built-in image they replace
+#if defined(ENABLE_AI_ASSET_PACK_IMAGE) && (ENABLE_AI_ASSET_PACK_IMAGE == 1)
+#define UI_EYES_IMG(img) NULL, #img
+#else
+#define UI_EYES_IMG(img) &img, #img
+#endif
 
 /***********************************************************
 ***********************typedef define***********************
@@ -21,11 +31,13 @@
 typedef struct {
     char *name;
     const lv_img_dsc_t *img;
+    const char *asset;
 } UI_EYES_EMOJI_T;
 
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
+#if !defined(ENABLE_AI_ASSET_PACK_IMAGE) || (ENABLE_AI_ASSET_PACK_IMAGE == 0)
 LV_IMG_DECLARE(Nature128);
 LV_IMG_DECLARE(Touch128);
 LV_IMG_DECLARE(Angry128);
@@ -36,61 +48,95 @@ LV_IMG_DECLARE(Think128);
 LV_IMG_DECLARE(Happy128);
 LV_IMG_DECLARE(Confused128);
 LV_IMG_DECLARE(Disappointed128);
+#endif
 
 static const UI_EYES_EMOJI_T cEYES_EMOJI_LIST[] = {
-    {EMOJI_NEUTRAL, &Nature128},    {EMOJI_SURPRISE, &Surprise128},
-    {EMOJI_ANGRY, &Angry128},       {EMOJI_FEARFUL, &Fearful128},
-    {EMOJI_TOUCH, &Touch128},       {EMOJI_SAD, &Sad128},
-    {EMOJI_THINKING, &Think128},    {EMOJI_HAPPY, &Happy128},
-    {EMOJI_CONFUSED, &Confused128}, {EMOJI_DISAPPOINTED, &Disappointed128},
+    {EMOJI_NEUTRAL, UI_EYES_IMG(Nature128)},    {EMOJI_SURPRISE, UI_EYES_IMG(Surprise128)},
+    {EMOJI_ANGRY, UI_EYES_IMG(Angry128)},       {EMOJI_FEARFUL, UI_EYES_IMG(Fearful128)},
+    {EMOJI_TOUCH, UI_EYES_IMG(Touch128)},       {EMOJI_SAD, UI_EYES_IMG(Sad128)},
+    {EMOJI_THINKING, UI_EYES_IMG(Think128)},    {EMOJI_HAPPY, UI_EYES_IMG(Happy128)},
+    {EMOJI_CONFUSED, UI_EYES_IMG(Confused128)}, {EMOJI_DISAPPOINTED, UI_EYES_IMG(Disappointed128)},
 };
 
 static lv_obj_t *sg_eyes_gif;
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+// the gif is decoded from this data while it plays, it is released once another image replaces it
+static lv_image_dsc_t sg_eyes_pack_img;
+#endif
+
 /***********************************************************
 ***********************function define**********************
 ***********************************************************/
-static lv_img_dsc_t *__ui_eyes_get_img(char *name)
+static const UI_EYES_EMOJI_T *__ui_eyes_get_emoji(char *name)
 {
     int i = 0;
 
     for (i = 0; i < CNTSOF(cEYES_EMOJI_LIST); i++) {
         if (0 == strcasecmp(cEYES_EMOJI_LIST[i].name, name)) {
-            return (lv_img_dsc_t *)cEYES_EMOJI_LIST[i].img;
+            return &cEYES_EMOJI_LIST[i];
         }
     }
 
     return NULL;
 }
 
+static OPERATE_RET __ui_eyes_set_src(const UI_EYES_EMOJI_T *emoji)
+{
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+    AI_ASSET_PACK_HANDLE pack = ai_asset_pack_default_get();
+    lv_image_dsc_t shown = sg_eyes_pack_img;
+
+    if (pack && OPRT_OK == ai_asset_lv_image_load(pack, emoji->asset, &sg_eyes_pack_img)) {
+        // the previous gif is closed by lv_gif_set_src, its data can be released after
+        lv_gif_set_src(sg_eyes_gif, &sg_eyes_pack_img);
+        ai_asset_lv_image_release(pack, &shown);
+        return OPRT_OK;
+    }
+#endif
+
+    if (NULL == emoji->img) {
+        PR_ERR("eyes image %s not found", emoji->asset);
+        return OPRT_NOT_FOUND;
+    }
+
+    lv_gif_set_src(sg_eyes_gif, emoji->img);
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+    ai_asset_lv_image_release(pack, &sg_eyes_pack_img);
+#endif
+
+    return OPRT_OK;
+}
+
 int ui_init(UI_FONT_T *ui_font)
 {
-    lv_img_dsc_t *img = NULL;
+    OPERATE_RET rt = OPRT_OK;
+    const UI_EYES_EMOJI_T *emoji = NULL;
 
     sg_eyes_gif = lv_gif_create(lv_scr_act());
-    img = __ui_eyes_get_img(EMOJI_NEUTRAL);
-    if (NULL == img) {
+    emoji = __ui_eyes_get_emoji(EMOJI_NEUTRAL);
+    if (NULL == emoji) {
         PR_ERR("invalid emotion: %s", EMOJI_NEUTRAL);
         return OPRT_INVALID_PARM;
     }
 
-    lv_gif_set_src(sg_eyes_gif, img);
+    rt = __ui_eyes_set_src(emoji);
     lv_obj_align(sg_eyes_gif, LV_ALIGN_CENTER, 0, 0);
 
-    return OPRT_OK;
+    return rt;
 }
 
 void ui_set_emotion(const char *emotion)
 {
-    lv_img_dsc_t *img = NULL;
+    const UI_EYES_EMOJI_T *emoji = NULL;
 
-    img = __ui_eyes_get_img((char *)emotion);
-    if (NULL == img) {
+    emoji = __ui_eyes_get_emoji((char *)emotion);
+    if (NULL == emoji) {
         PR_ERR("invalid emotion: %s", emotion);
         return;
     }
 
-    lv_gif_set_src(sg_eyes_gif, img);
+    __ui_eyes_set_src(emoji);
 
     return;
 }
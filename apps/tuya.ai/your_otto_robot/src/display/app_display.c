@@ -27,9 +27,19 @@
 
 #include "lvgl.h"
 
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+#include "ai_asset_lvgl.h"
+#endif
+
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+// the text fonts of an asset pack have the name of the built-in font they replace
+#if defined(ENABLE_AI_ASSET_PACK_FONT) && (ENABLE_AI_ASSET_PACK_FONT == 1)
+#define UI_TEXT_FONT(font) __get_text_font(NULL, #font)
+#else
+#define UI_TEXT_FONT(font) __get_text_font(&font, #font)
+#endif
 
 /***********************************************************
 ***********************typedef define***********************
@@ -50,10 +60,12 @@ typedef struct {
 /***********************************************************
 ********************function declaration********************
 ***********************************************************/
+#if !defined(ENABLE_AI_ASSET_PACK_FONT) || (ENABLE_AI_ASSET_PACK_FONT == 0)
 LV_FONT_DECLARE(font_puhui_14_1);
 LV_FONT_DECLARE(font_puhui_18_2);
 LV_FONT_DECLARE(font_puhui_20_4);
 LV_FONT_DECLARE(font_puhui_30_4);
+#endif
 LV_FONT_DECLARE(font_awesome_14_1);
 LV_FONT_DECLARE(font_awesome_16_4);
 LV_FONT_DECLARE(font_awesome_20_4);
@@ -86,6 +98,27 @@ static TUYA_DISPLAY_T sg_display = {0};
 ***********************function define**********************
 ***********************************************************/
 
+static lv_font_t *__get_text_font(const lv_font_t *builtin, const char *name)
+{
+    lv_font_t *font = NULL;
+
+#if defined(ENABLE_AI_ASSET_PACK) && (ENABLE_AI_ASSET_PACK == 1)
+    font = ai_asset_lv_font_create(ai_asset_pack_default_get(), name);
+    if (font) {
+        PR_NOTICE("text font %s loaded from the asset pack", name);
+        return font;
+    }
+#endif
+
+    if (NULL == builtin) {
+        PR_ERR("text font %s not found, use the default font", name);
+        builtin = LV_FONT_DEFAULT;
+    }
+    font = (lv_font_t *)builtin;
+
+    return font;
+}
+
 static OPERATE_RET __get_ui_font(UI_FONT_T *ui_font)
 {
     OPERATE_RET rt = OPRT_OK;
@@ -97,28 +130,28 @@ static OPERATE_RET __get_ui_font(UI_FONT_T *ui_font)
 #if (defined(BOARD_CHOICE_TUYA_T5AI_BOARD) || defined(BOARD_CHOICE_TUYA_T5AI_EVB) ||                                   \
      defined(BOARD_CHOICE_T5AI_MOJI_1_28) || defined(BOARD_CHOICE_T5AI_MINI) || defined(BOARD_CHOICE_DNESP32S3_BOX))
 #if defined(ENABLE_GUI_WECHAT)
-    ui_font->text = (lv_font_t *)&font_puhui_18_2;
+    ui_font->text = UI_TEXT_FONT(font_puhui_18_2);
     ui_font->icon = (lv_font_t *)&font_awesome_16_4;
     ui_font->emoji = (lv_font_t *)font_emoji_32_init();
     ui_font->emoji_list = sg_emo_list;
 #elif defined(ENABLE_GUI_CHATBOT)
-    ui_font->text = (lv_font_t *)&font_puhui_18_2;
+    ui_font->text = UI_TEXT_FONT(font_puhui_18_2);
     ui_font->icon = (lv_font_t *)&font_awesome_16_4;
     ui_font->emoji = (lv_font_t *)font_emoji_64_init();
     ui_font->emoji_list = sg_emo_list;
 #endif
 #elif defined(BOARD_CHOICE_BREAD_COMPACT_WIFI)
-    ui_font->text = (lv_font_t *)&font_puhui_14_1;
+    ui_font->text = UI_TEXT_FONT(font_puhui_14_1);
     ui_font->icon = (lv_font_t *)&font_awesome_14_1;
     ui_font->emoji = (lv_font_t *)&font_awesome_30_1;
     ui_font->emoji_list = sg_awesome_emo_list;
 #elif defined(BOARD_CHOICE_XINGZHI_CUBE_0_96_OLED_WIFI)
-    ui_font->text = (lv_font_t *)&font_puhui_14_1;
+    ui_font->text = UI_TEXT_FONT(font_puhui_14_1);
     ui_font->icon = (lv_font_t *)&font_awesome_14_1;
     ui_font->emoji = (lv_font_t *)&font_awesome_30_1;
     ui_font->emoji_list = sg_awesome_emo_list;
 #elif defined(BOARD_CHOICE_WAVESHARE_ESP32_S3_TOUCH_AMOLED_1_8)
-    ui_font->text = (lv_font_t *)&font_puhui_30_4;
+    ui_font->text = UI_TEXT_FONT(font_puhui_30_4);
     ui_font->icon = (lv_font_t *)&font_awesome_30_4;
 #if defined(ENABLE_GUI_WECHAT)
     ui_font->emoji = font_emoji_32_init();
@@ -127,7 +160,7 @@ static OPERATE_RET __get_ui_font(UI_FONT_T *ui_font)
 #endif
     ui_font->emoji_list = sg_emo_list;
 #elif defined(BOARD_CHOICE_DNESP32S3)
-    ui_font->text = (lv_font_t *)&font_puhui_20_4;
+    ui_font->text = UI_TEXT_FONT(font_puhui_20_4);
     ui_font->icon = (lv_font_t *)&font_awesome_20_4;
 #if defined(ENABLE_GUI_WECHAT)
     ui_font->emoji = font_emoji_32_init();
@@ -0,0 +1,351 @@
+/**
+ * @file example_asset_pack_bench.c
+ * @brief Benchmark of the asset packs, the fonts, images and sounds kept out of the firmware image.
+ *
+ * The example opens a pack built by ai_asset_pack.py, read from the file and mapped in memory, and reports the
+ * open time, the RAM used by the pack, the size of each asset against the C arrays it replaces, the time to draw a
+ * text with every font (cache cold and warm) and the time to load the images and the sounds.
+ *
+ * Usage on Linux: ./asset_pack_bench assets.bin
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "ai_asset_font.h"
+#include "ai_asset_pack.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <stdio.h>
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_GLYPH_BUF_LEN (256 * 256)
+#define BENCH_TEXT_LOOP     3
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+// the texts shown by the chat bot, mostly CJK letters spread over the whole font
+static const char *sg_bench_text = "你好，我是你的智能聊天助手。今天天气怎么样？正在聆听，请说话。"
+                                   "网络已连接，配网模式，设备未激活，电量低。Hello TuyaOpen 0123456789!";
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static const char *__bench_type_name(uint8_t type)
+{
+    switch (type) {
+    case AI_ASSET_TYPE_FONT:
+        return "font";
+    case AI_ASSET_TYPE_IMAGE:
+        return "image";
+    case AI_ASSET_TYPE_MEDIA:
+        return "media";
+    default:
+        return "raw";
+    }
+}
+
+static uint32_t __bench_utf8_next(const char **text)
+{
+    const uint8_t *p = (const uint8_t *)*text;
+    uint32_t letter = 0;
+
+    if (p[0] < 0x80) {
+        letter = p[0];
+        *text += 1;
+    } else if ((p[0] & 0xE0) == 0xC0 && p[1]) {
+        letter = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        *text += 2;
+    } else if ((p[0] & 0xF0) == 0xE0 && p[1] && p[2]) {
+        letter = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        *text += 3;
+    } else {
+        *text += 1;
+    }
+
+    return letter;
+}
+
+// draws the text glyph by glyph as LVGL does, returns the glyphs drawn
+static uint32_t __bench_text_draw(AI_ASSET_FONT_HANDLE font, uint8_t *buf)
+{
+    AI_ASSET_GLYPH_DSC_T dsc;
+    const char *text = sg_bench_text;
+    uint32_t letter = __bench_utf8_next(&text), letter_next = 0, glyphs = 0;
+
+    while (letter) {
+        letter_next = *text ? __bench_utf8_next(&text) : 0;
+
+        if (ai_asset_font_glyph_dsc_get(font, letter, letter_next, &dsc) && dsc.box_w && dsc.box_h &&
+            OPRT_OK == ai_asset_font_glyph_bitmap_get(font, dsc.gid, buf, dsc.box_w)) {
+            glyphs++;
+        }
+
+        letter = letter_next;
+    }
+
+    return glyphs;
+}
+
+static void __bench_font(AI_ASSET_PACK_HANDLE pack, const AI_ASSET_ENTRY_T *entry, uint8_t *buf)
+{
+    AI_ASSET_FONT_HANDLE font = NULL;
+    AI_ASSET_PACK_STATS_T before, after;
+    AI_ASSET_FONT_STATS_T font_stats;
+    uint64_t t0 = 0, open_cost = 0, cold = 0, warm = 0;
+    uint32_t glyphs = 0, miss_cold = 0, hit = 0, miss = 0, i = 0;
+
+    ai_asset_pack_stats_get(pack, &before);
+
+    t0 = __bench_time_ns();
+    if (OPRT_OK != ai_asset_font_open(pack, entry->name, &font)) {
+        PR_ERR("open font %s failed", entry->name);
+        return;
+    }
+    open_cost = __bench_time_ns() - t0;
+
+    t0 = __bench_time_ns();
+    glyphs = __bench_text_draw(font, buf);
+    cold = __bench_time_ns() - t0;
+
+    ai_asset_pack_stats_get(pack, &after);
+    miss_cold = after.cache_miss - before.cache_miss;
+
+    t0 = __bench_time_ns();
+    for (i = 0; i < BENCH_TEXT_LOOP; i++) {
+        __bench_text_draw(font, buf);
+    }
+    warm = (__bench_time_ns() - t0) / BENCH_TEXT_LOOP;
+
+    ai_asset_pack_stats_get(pack, &after);
+    ai_asset_font_stats_get(font, &font_stats);
+    hit = after.cache_hit - before.cache_hit;
+    miss = after.cache_miss - before.cache_miss;
+
+    PR_NOTICE("%-30s open:%.1fus ram:+%uB glyphs:%u cold:%.2fus/glyph (%u blocks) warm:%.2fus/glyph "
+              "block hit:%u/%u letter hit:%u/%u",
+              entry->name, (double)open_cost / 1000, after.ram_bytes - before.ram_bytes, glyphs,
+              (double)cold / 1000 / (glyphs ? glyphs : 1), miss_cold, (double)warm / 1000 / (glyphs ? glyphs : 1),
+              hit, hit + miss, font_stats.lookup_hit, font_stats.lookups);
+
+    ai_asset_font_close(font);
+}
+
+static void __bench_load(AI_ASSET_PACK_HANDLE pack, const AI_ASSET_ENTRY_T *entry)
+{
+    const uint8_t *data = NULL;
+    uint32_t len = 0;
+    uint64_t t0 = 0, cost = 0;
+
+    t0 = __bench_time_ns();
+    if (OPRT_OK != ai_asset_load(pack, entry, &data, &len)) {
+        PR_ERR("load %s failed", entry->name);
+        return;
+    }
+    cost = __bench_time_ns() - t0;
+
+    PR_NOTICE("%-30s load:%.1fus %uB %s", entry->name, (double)cost / 1000, len,
+              (AI_ASSET_COMP_LZ4 == entry->comp) ? "decompressed" : "stored as is");
+
+    ai_asset_release(pack, data);
+}
+
+static void __bench_run(const char *title, AI_ASSET_PACK_HANDLE pack, uint64_t open_cost)
+{
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    AI_ASSET_PACK_STATS_T stats;
+    uint64_t stored = 0, builtin = 0;
+    uint8_t *buf = NULL;
+    uint32_t i = 0;
+
+    ai_asset_pack_stats_get(pack, &stats);
+    PR_NOTICE("---- %s: open %.1fus, %u assets, ram %uB", title, (double)open_cost / 1000, ai_asset_num_get(pack),
+              stats.ram_bytes);
+
+    buf = (uint8_t *)tal_malloc(BENCH_GLYPH_BUF_LEN);
+    if (NULL == buf) {
+        return;
+    }
+
+    for (i = 0; i < ai_asset_num_get(pack); i++) {
+        entry = ai_asset_get(pack, i);
+        if (AI_ASSET_TYPE_FONT == entry->type) {
+            __bench_font(pack, entry, buf);
+        } else {
+            __bench_load(pack, entry);
+        }
+    }
+
+    tal_free(buf);
+
+    for (i = 0; i < ai_asset_num_get(pack); i++) {
+        entry = ai_asset_get(pack, i);
+        stored += entry->size;
+        builtin += entry->raw_size;
+    }
+
+    ai_asset_pack_stats_get(pack, &stats);
+    PR_NOTICE("%s: built-in %lluB stored %lluB (%.1f%%), ram %uB, read %uB, decompressed %uB, cache hit:%u miss:%u",
+              title, (unsigned long long)builtin, (unsigned long long)stored, 100.0 * stored / (builtin ? builtin : 1),
+              stats.ram_bytes, stats.read_bytes, stats.decomp_bytes, stats.cache_hit, stats.cache_miss);
+}
+
+static void __bench_index(AI_ASSET_PACK_HANDLE pack)
+{
+    const AI_ASSET_ENTRY_T *entry = NULL;
+    uint32_t i = 0;
+
+    PR_NOTICE("%-30s %-6s %-5s %10s %10s %7s", "name", "type", "comp", "built-in", "stored", "ratio");
+    for (i = 0; i < ai_asset_num_get(pack); i++) {
+        entry = ai_asset_get(pack, i);
+        PR_NOTICE("%-30s %-6s %-5s %10u %10u %6.1f%%", entry->name, __bench_type_name(entry->type),
+                  (AI_ASSET_COMP_LZ4 == entry->comp) ? "lz4" : "none", entry->raw_size, entry->size,
+                  100.0 * entry->size / (entry->raw_size ? entry->raw_size : 1));
+    }
+}
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static uint8_t *__bench_file_load(const char *path, uint32_t *len)
+{
+    FILE *fp = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long size = 0;
+
+    if (NULL == fp) {
+        PR_ERR("open %s failed", path);
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    data = (size > 0) ? (uint8_t *)tal_malloc(size) : NULL;
+    if (data && fread(data, 1, size, fp) != (size_t)size) {
+        tal_free(data);
+        data = NULL;
+    }
+    fclose(fp);
+
+    *len = (uint32_t)size;
+    return data;
+}
+#endif
+
+static void __bench_main(const char *path)
+{
+    AI_ASSET_PACK_HANDLE pack = NULL;
+    AI_ASSET_PACK_CFG_T cfg = {AI_ASSET_CACHE_NUM_DEFAULT, 0};
+    uint64_t t0 = 0, cost = 0;
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    uint8_t *data = NULL;
+    uint32_t len = 0;
+#endif
+
+    /* basic init */
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    if (NULL == path) {
+        PR_ERR("usage: asset_pack_bench assets.bin, build the pack with ai_asset_pack.py");
+        return;
+    }
+
+    // read from the file as from a flash partition, tables and blocks are copied in RAM
+    t0 = __bench_time_ns();
+    if (OPRT_OK != ai_asset_pack_open_file(path, &cfg, &pack)) {
+        PR_ERR("open %s failed", path);
+        return;
+    }
+    cost = __bench_time_ns() - t0;
+
+    __bench_index(pack);
+    __bench_run("file", pack, cost);
+    ai_asset_pack_close(pack);
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    // mapped in memory as an XIP flash, the tables and the assets stored as is are used in place
+    data = __bench_file_load(path, &len);
+    if (NULL == data) {
+        return;
+    }
+
+    t0 = __bench_time_ns();
+    if (OPRT_OK == ai_asset_pack_open_mem(data, len, &cfg, &pack)) {
+        cost = __bench_time_ns() - t0;
+        __bench_run("mapped", pack, cost);
+        ai_asset_pack_close(pack);
+    }
+
+    tal_free(data);
+#endif
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main(NULL);
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    __bench_main((argc > 1) ? argv[1] : NULL);
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
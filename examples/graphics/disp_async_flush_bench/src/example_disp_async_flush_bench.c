@@ -0,0 +1,413 @@
+/**
+ * @file example_disp_async_flush_bench.c
+ * @brief Frame rate of the synchronous and asynchronous display flush with a stand-in SPI backend.
+ *
+ * The example registers a display driver that stands in for a SPI panel: flush and flush_area copy the pixels into
+ * a simulated panel and then sleep for the time the bytes take on a 40 MHz bus. A render loop moves two widgets over
+ * a 320x480 RGB565 frame buffer, spending a fixed CPU time per widget draw as a MCU would, and sends every frame in
+ * three ways: tdl_disp_dev_flush_area, tdl_disp_dev_flush_async with one frame buffer (the next frame waits for the
+ * transfer), and tdl_disp_dev_flush_async with two frame buffers (the next frame is drawn while the other one is
+ * sent). It reports the frame rate of each and checks that the panel ends up with the last frame. The device is
+ * then closed and opened again a few times with flushes in flight to exercise the start and the stop of the
+ * transfer task.
+ *
+ * Usage on Linux: ./disp_async_flush_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdl_display_manage.h"
+#include "tdl_display_driver.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_DISP_NAME   "bench_disp"
+#define BENCH_DISP_WIDTH  320
+#define BENCH_DISP_HEIGHT 480
+#define BENCH_PIXEL_BYTES 2
+#define BENCH_FB_LEN      (BENCH_DISP_WIDTH * BENCH_DISP_HEIGHT * BENCH_PIXEL_BYTES)
+
+// CASET and RASET with 4 parameter bytes each, then RAMWR
+#define BENCH_WINDOW_BYTES 11
+#define BENCH_SPI_CLK_HZ   40000000
+
+#define BENCH_WIDGET_SIZE    96
+#define BENCH_WIDGET_DRAW_US 1500
+#define BENCH_FRAMES         100
+#define BENCH_REOPEN_CNT     5
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef enum {
+    BENCH_MODE_SYNC = 0,
+    BENCH_MODE_ASYNC_ONE_FB,
+    BENCH_MODE_ASYNC_TWO_FB,
+} BENCH_MODE_E;
+
+typedef struct {
+    uint8_t *panel;
+    uint64_t bytes;
+} BENCH_DISP_DEV_T;
+
+typedef struct {
+    TDL_DISP_FRAME_BUFF_T *fb;
+    SEM_HANDLE done_sem;
+} BENCH_FB_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const char *sg_mode_name[] = {"sync", "async 1 fb", "async 2 fb"};
+
+static BENCH_DISP_DEV_T sg_bench_disp;
+static BENCH_FB_T sg_bench_fb[2];
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_us(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000ULL;
+#endif
+}
+
+/* the SPI transfer, the bytes leave at the bus clock */
+static void __bench_spi_send(uint32_t len)
+{
+    uint32_t us = (uint32_t)((uint64_t)len * 8 * 1000000 / BENCH_SPI_CLK_HZ);
+
+    sg_bench_disp.bytes += len;
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    usleep(us);
+#else
+    tal_system_sleep((us + 999) / 1000);
+#endif
+}
+
+static OPERATE_RET __bench_disp_flush(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff)
+{
+    BENCH_DISP_DEV_T *dev = (BENCH_DISP_DEV_T *)device;
+
+    memcpy(dev->panel, frame_buff->frame, frame_buff->len);
+    __bench_spi_send(BENCH_WINDOW_BYTES + frame_buff->len);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __bench_disp_flush_area(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                           TDL_DISP_AREA_T *area)
+{
+    BENCH_DISP_DEV_T *dev = (BENCH_DISP_DEV_T *)device;
+    uint32_t stride = frame_buff->width * BENCH_PIXEL_BYTES;
+    uint32_t line_len = (area->x1 - area->x0 + 1) * BENCH_PIXEL_BYTES;
+    uint32_t offset = 0;
+    uint16_t y = 0;
+
+    for (y = area->y0; y <= area->y1; y++) {
+        offset = y * stride + area->x0 * BENCH_PIXEL_BYTES;
+        memcpy(dev->panel + offset, frame_buff->frame + offset, line_len);
+    }
+    __bench_spi_send(BENCH_WINDOW_BYTES + line_len * (area->y1 - area->y0 + 1));
+
+    return OPRT_OK;
+}
+
+static void __bench_flush_done(TDL_DISP_FRAME_BUFF_T *frame_buff, OPERATE_RET result, void *arg)
+{
+    BENCH_FB_T *bench_fb = (BENCH_FB_T *)arg;
+
+    if (OPRT_OK != result) {
+        PR_ERR("flush failed, rt: %d", result);
+    }
+    tal_semaphore_post(bench_fb->done_sem);
+}
+
+/* fills an area with a color, spending the CPU time a MCU would take to render it */
+static void __bench_fill(TDL_DISP_FRAME_BUFF_T *fb, const TDL_DISP_AREA_T *area, uint16_t color, bool render)
+{
+    uint64_t start = __bench_time_us();
+    uint16_t *pixel = NULL;
+    uint16_t x, y;
+
+    for (y = area->y0; y <= area->y1; y++) {
+        pixel = (uint16_t *)fb->frame + y * BENCH_DISP_WIDTH;
+        for (x = area->x0; x <= area->x1; x++) {
+            pixel[x] = color;
+        }
+    }
+
+    while (render && __bench_time_us() - start < BENCH_WIDGET_DRAW_US) {
+    }
+}
+
+static void __bench_copy_area(TDL_DISP_FRAME_BUFF_T *dst, TDL_DISP_FRAME_BUFF_T *src, const TDL_DISP_AREA_T *area)
+{
+    uint32_t stride = BENCH_DISP_WIDTH * BENCH_PIXEL_BYTES;
+    uint32_t offset = 0;
+    uint16_t y = 0;
+
+    for (y = area->y0; y <= area->y1; y++) {
+        offset = y * stride + area->x0 * BENCH_PIXEL_BYTES;
+        memcpy(dst->frame + offset, src->frame + offset, (area->x1 - area->x0 + 1) * BENCH_PIXEL_BYTES);
+    }
+}
+
+static void __bench_widget_area(uint32_t frame, uint8_t widget, TDL_DISP_AREA_T *area)
+{
+    uint16_t x_range = BENCH_DISP_WIDTH - BENCH_WIDGET_SIZE;
+    uint16_t y_range = BENCH_DISP_HEIGHT - BENCH_WIDGET_SIZE;
+    uint32_t step = frame * 4 + widget * 150;
+
+    area->x0 = (step % (2 * x_range) < x_range) ? step % x_range : x_range - step % x_range;
+    area->y0 = (step * 3 % (2 * y_range) < y_range) ? step * 3 % y_range : y_range - step * 3 % y_range;
+    area->x1 = area->x0 + BENCH_WIDGET_SIZE - 1;
+    area->y1 = area->y0 + BENCH_WIDGET_SIZE - 1;
+}
+
+static OPERATE_RET __bench_run(TDL_DISP_HANDLE_T disp_hdl, BENCH_MODE_E mode)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDL_DISP_AREA_T full = {0, 0, BENCH_DISP_WIDTH - 1, BENCH_DISP_HEIGHT - 1};
+    TDL_DISP_AREA_T widget[2], last_widget[2];
+    TDL_DISP_DIRTY_LIST_T dirty, last_dirty;
+    BENCH_FB_T *cur = &sg_bench_fb[0];
+    uint64_t start = 0, elapsed = 0;
+    uint32_t frame = 0;
+    uint8_t i = 0, fb_cnt = (BENCH_MODE_ASYNC_TWO_FB == mode) ? 2 : 1;
+
+    for (i = 0; i < 2; i++) {
+        __bench_fill(sg_bench_fb[i].fb, &full, 0x0000, false);
+        __bench_widget_area(0, i, &last_widget[i]);
+    }
+    tdl_disp_dirty_list_reset(&last_dirty);
+    TUYA_CALL_ERR_RETURN(tdl_disp_dev_flush(disp_hdl, cur->fb));
+    sg_bench_disp.bytes = 0;
+
+    start = __bench_time_us();
+    for (frame = 1; frame <= BENCH_FRAMES; frame++) {
+        if (BENCH_MODE_SYNC != mode) {
+            // The buffer may be drawn again once its last transfer is done
+            tal_semaphore_wait(cur->done_sem, SEM_WAIT_FOREVER);
+        }
+
+        // A buffer that missed the last frame gets its areas from the other one first
+        if (2 == fb_cnt) {
+            for (i = 0; i < last_dirty.cnt; i++) {
+                __bench_copy_area(cur->fb, sg_bench_fb[(cur == &sg_bench_fb[0]) ? 1 : 0].fb, &last_dirty.area[i]);
+            }
+        }
+
+        tdl_disp_dirty_list_reset(&dirty);
+        for (i = 0; i < 2; i++) {
+            __bench_fill(cur->fb, &last_widget[i], 0x0000, true);
+            tdl_disp_dirty_list_add(&dirty, &last_widget[i]);
+        }
+        for (i = 0; i < 2; i++) {
+            __bench_widget_area(frame, i, &widget[i]);
+            __bench_fill(cur->fb, &widget[i], (0 == i) ? 0xF800 : 0x07E0, true);
+            tdl_disp_dirty_list_add(&dirty, &widget[i]);
+            last_widget[i] = widget[i];
+        }
+
+        if (BENCH_MODE_SYNC == mode) {
+            TUYA_CALL_ERR_RETURN(tdl_disp_dev_flush_area(disp_hdl, cur->fb, &dirty));
+        } else {
+            TUYA_CALL_ERR_RETURN(tdl_disp_dev_flush_async(disp_hdl, cur->fb, &dirty, __bench_flush_done, cur));
+        }
+
+        last_dirty = dirty;
+        if (2 == fb_cnt) {
+            cur = (cur == &sg_bench_fb[0]) ? &sg_bench_fb[1] : &sg_bench_fb[0];
+        }
+    }
+
+    // Wait for the transfers still in flight, the buffers are then released again for the next run
+    if (BENCH_MODE_SYNC != mode) {
+        for (i = 0; i < fb_cnt; i++) {
+            tal_semaphore_wait(sg_bench_fb[i].done_sem, SEM_WAIT_FOREVER);
+            tal_semaphore_post(sg_bench_fb[i].done_sem);
+        }
+    }
+    elapsed = __bench_time_us() - start;
+
+    cur = (2 == fb_cnt && cur == &sg_bench_fb[0]) ? &sg_bench_fb[1] : &sg_bench_fb[0];
+    if (memcmp(sg_bench_disp.panel, cur->fb->frame, BENCH_FB_LEN)) {
+        PR_ERR("%s: panel does not match the last frame", sg_mode_name[mode]);
+        return OPRT_COM_ERROR;
+    }
+
+    PR_NOTICE("%-10s %3u frames in %4u ms, %2u.%u FPS, bus busy %u%%", sg_mode_name[mode], BENCH_FRAMES,
+              (uint32_t)(elapsed / 1000), (uint32_t)(BENCH_FRAMES * 1000000ULL / elapsed),
+              (uint32_t)(BENCH_FRAMES * 10000000ULL / elapsed % 10),
+              (uint32_t)(sg_bench_disp.bytes * 8 * 1000000 / BENCH_SPI_CLK_HZ * 100 / elapsed));
+
+    return OPRT_OK;
+}
+
+/* closes the device with flushes still queued, then opens it again */
+static OPERATE_RET __bench_reopen(TDL_DISP_HANDLE_T disp_hdl)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint8_t n = 0, i = 0;
+
+    for (n = 0; n < BENCH_REOPEN_CNT; n++) {
+        for (i = 0; i < 2; i++) {
+            tal_semaphore_wait(sg_bench_fb[i].done_sem, SEM_WAIT_FOREVER);
+            TUYA_CALL_ERR_RETURN(
+                tdl_disp_dev_flush_async(disp_hdl, sg_bench_fb[i].fb, NULL, __bench_flush_done, &sg_bench_fb[i]));
+        }
+        TUYA_CALL_ERR_RETURN(tdl_disp_dev_close(disp_hdl));
+        TUYA_CALL_ERR_RETURN(tdl_disp_dev_open(disp_hdl));
+    }
+
+    // Closing sends the queued flushes first, so every buffer has been released again
+    for (i = 0; i < 2; i++) {
+        if (OPRT_OK != tal_semaphore_wait(sg_bench_fb[i].done_sem, 0)) {
+            PR_ERR("flush of buffer %u was dropped by close", i);
+            return OPRT_COM_ERROR;
+        }
+        tal_semaphore_post(sg_bench_fb[i].done_sem);
+    }
+    PR_NOTICE("reopen     %u close and open cycles with queued flushes, all flushes done", BENCH_REOPEN_CNT);
+
+    return OPRT_OK;
+}
+
+static void __bench_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDL_DISP_HANDLE_T disp_hdl = NULL;
+    uint8_t i = 0;
+    TDD_DISP_DEV_INFO_T dev_info = {
+        .type = TUYA_DISPLAY_SPI,
+        .width = BENCH_DISP_WIDTH,
+        .height = BENCH_DISP_HEIGHT,
+        .fmt = TUYA_PIXEL_FMT_RGB565,
+        .rotation = TUYA_DISPLAY_ROTATION_0,
+        .bl.type = TUYA_DISP_BL_TP_NONE,
+        .power.pin = TUYA_GPIO_NUM_MAX,
+    };
+    TDD_DISP_INTFS_T intfs = {
+        .flush = __bench_disp_flush,
+        .flush_area = __bench_disp_flush_area,
+    };
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    sg_bench_disp.panel = tal_malloc(BENCH_FB_LEN);
+    if (NULL == sg_bench_disp.panel) {
+        PR_ERR("malloc failed");
+        return;
+    }
+
+    for (i = 0; i < 2; i++) {
+        sg_bench_fb[i].fb = tdl_disp_create_frame_buff(DISP_FB_TP_SRAM, BENCH_FB_LEN);
+        if (NULL == sg_bench_fb[i].fb) {
+            PR_ERR("malloc failed");
+            goto __EXIT;
+        }
+        sg_bench_fb[i].fb->fmt = TUYA_PIXEL_FMT_RGB565;
+        sg_bench_fb[i].fb->width = BENCH_DISP_WIDTH;
+        sg_bench_fb[i].fb->height = BENCH_DISP_HEIGHT;
+        TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_bench_fb[i].done_sem, 1, 1), __EXIT);
+    }
+
+    TUYA_CALL_ERR_GOTO(tdl_disp_device_register(BENCH_DISP_NAME, &sg_bench_disp, &intfs, &dev_info), __EXIT);
+    disp_hdl = tdl_disp_find_dev(BENCH_DISP_NAME);
+    TUYA_CALL_ERR_GOTO(tdl_disp_dev_open(disp_hdl), __EXIT);
+
+    PR_NOTICE("two %ux%u widgets, %u us per widget draw, %u MHz SPI", BENCH_WIDGET_SIZE, BENCH_WIDGET_SIZE,
+              BENCH_WIDGET_DRAW_US, BENCH_SPI_CLK_HZ / 1000000);
+
+    TUYA_CALL_ERR_GOTO(__bench_run(disp_hdl, BENCH_MODE_SYNC), __EXIT);
+    TUYA_CALL_ERR_GOTO(__bench_run(disp_hdl, BENCH_MODE_ASYNC_ONE_FB), __EXIT);
+    TUYA_CALL_ERR_GOTO(__bench_run(disp_hdl, BENCH_MODE_ASYNC_TWO_FB), __EXIT);
+    TUYA_CALL_ERR_GOTO(__bench_reopen(disp_hdl), __EXIT);
+
+__EXIT:
+    if (disp_hdl) {
+        tdl_disp_dev_close(disp_hdl);
+    }
+    for (i = 0; i < 2; i++) {
+        if (sg_bench_fb[i].done_sem) {
+            tal_semaphore_release(sg_bench_fb[i].done_sem);
+            sg_bench_fb[i].done_sem = NULL;
+        }
+        if (sg_bench_fb[i].fb) {
+            tdl_disp_free_frame_buff(sg_bench_fb[i].fb);
+            sg_bench_fb[i].fb = NULL;
+        }
+    }
+    tal_free(sg_bench_disp.panel);
+    sg_bench_disp.panel = NULL;
+    if (OPRT_OK != rt) {
+        PR_ERR("disp async flush bench FAIL, rt: %d", rt);
+    }
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
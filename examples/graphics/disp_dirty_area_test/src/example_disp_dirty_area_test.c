@@ -0,0 +1,293 @@
+/**
+ * @file example_disp_dirty_area_test.c
+ * @brief Test of the dirty area flush of the TDL display layer with a byte-counting display driver.
+ *
+ * The example registers a test display driver that implements flush and flush_area like the TDL SPI driver does,
+ * but only counts the bytes that would go over the bus (CASET, RASET and RAMWR with their parameters, then the
+ * pixels) and copies the pixels into a simulated panel. It then draws a few typical frames into a 320x480 RGB565
+ * frame buffer, sends them with tdl_disp_dev_flush_area, checks that the panel matches the frame buffer and reports
+ * the bytes per frame against a full flush.
+ *
+ * Usage on Linux: ./disp_dirty_area_test
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdl_display_manage.h"
+#include "tdl_display_driver.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_DISP_NAME   "test_disp"
+#define TEST_DISP_WIDTH  320
+#define TEST_DISP_HEIGHT 480
+#define TEST_PIXEL_BYTES 2
+
+// CASET and RASET with 4 parameter bytes each, then RAMWR
+#define TEST_WINDOW_BYTES (1 + 4 + 1 + 4 + 1)
+
+#define TEST_RANDOM_FRAMES 300
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    uint32_t bytes;
+    uint32_t windows;
+    uint8_t *panel;
+} TEST_DISP_DEV_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static TEST_DISP_DEV_T sg_test_disp;
+static TDL_DISP_FRAME_BUFF_T *sg_fb = NULL;
+static TDL_DISP_DIRTY_LIST_T sg_dirty;
+static uint32_t sg_draws = 0;
+static uint32_t sg_seed = 1;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static OPERATE_RET __test_disp_flush(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff)
+{
+    TEST_DISP_DEV_T *dev = (TEST_DISP_DEV_T *)device;
+
+    dev->bytes += TEST_WINDOW_BYTES + frame_buff->len;
+    dev->windows++;
+    memcpy(dev->panel, frame_buff->frame, frame_buff->len);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_disp_flush_area(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                          TDL_DISP_AREA_T *area)
+{
+    TEST_DISP_DEV_T *dev = (TEST_DISP_DEV_T *)device;
+    uint32_t stride = frame_buff->width * TEST_PIXEL_BYTES;
+    uint32_t line_len = (area->x1 - area->x0 + 1) * TEST_PIXEL_BYTES;
+    uint32_t offset = 0;
+    uint16_t y = 0;
+
+    dev->bytes += TEST_WINDOW_BYTES;
+    dev->windows++;
+    for (y = area->y0; y <= area->y1; y++) {
+        offset = y * stride + area->x0 * TEST_PIXEL_BYTES;
+        memcpy(dev->panel + offset, frame_buff->frame + offset, line_len);
+        dev->bytes += line_len;
+    }
+
+    return OPRT_OK;
+}
+
+static uint32_t __test_rand(void)
+{
+    sg_seed = sg_seed * 1103515245 + 12345;
+    return (sg_seed >> 16) & 0x7FFF;
+}
+
+/* draws a rectangle into the frame buffer and records it, as the LVGL port does for every rendered area */
+static void __test_draw(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color)
+{
+    TDL_DISP_AREA_T area = {.x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1};
+    uint16_t *pixel = NULL;
+    uint16_t x, y;
+
+    for (y = y0; y <= y1; y++) {
+        pixel = (uint16_t *)sg_fb->frame + y * TEST_DISP_WIDTH;
+        for (x = x0; x <= x1; x++) {
+            pixel[x] = color;
+        }
+    }
+
+    tdl_disp_dirty_list_add(&sg_dirty, &area);
+    sg_draws++;
+}
+
+static OPERATE_RET __test_frame(TDL_DISP_HANDLE_T disp_hdl, const char *name)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t draws = sg_draws;
+
+    sg_test_disp.bytes = 0;
+    sg_test_disp.windows = 0;
+
+    TUYA_CALL_ERR_RETURN(tdl_disp_dev_flush_area(disp_hdl, sg_fb, &sg_dirty));
+    tdl_disp_dirty_list_reset(&sg_dirty);
+    sg_draws = 0;
+
+    if (memcmp(sg_test_disp.panel, sg_fb->frame, sg_fb->len)) {
+        PR_ERR("%s: panel does not match the frame buffer", name ? name : "random areas");
+        return OPRT_COM_ERROR;
+    }
+
+    if (name) {
+        PR_NOTICE("%-16s %2u draws -> %2u windows, %6u bytes, full flush %6u bytes", name, draws,
+                  sg_test_disp.windows, sg_test_disp.bytes, TEST_WINDOW_BYTES + sg_fb->len);
+    }
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_random_frames(TDL_DISP_HANDLE_T disp_hdl)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint64_t bytes = 0;
+    uint32_t frame, n, cnt;
+    uint16_t x0, y0, w, h;
+
+    for (frame = 0; frame < TEST_RANDOM_FRAMES; frame++) {
+        cnt = 1 + __test_rand() % 40;
+        for (n = 0; n < cnt; n++) {
+            w = 1 + __test_rand() % 64;
+            h = 1 + __test_rand() % 64;
+            x0 = __test_rand() % (TEST_DISP_WIDTH - w + 1);
+            y0 = __test_rand() % (TEST_DISP_HEIGHT - h + 1);
+            __test_draw(x0, y0, x0 + w - 1, y0 + h - 1, (uint16_t)__test_rand());
+        }
+        TUYA_CALL_ERR_RETURN(__test_frame(disp_hdl, NULL));
+        bytes += sg_test_disp.bytes;
+    }
+
+    PR_NOTICE("%-16s %u frames, panel matched after each, %u bytes per frame on average", "random areas",
+              TEST_RANDOM_FRAMES, (uint32_t)(bytes / TEST_RANDOM_FRAMES));
+
+    return OPRT_OK;
+}
+
+static void __test_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDL_DISP_HANDLE_T disp_hdl = NULL;
+    uint16_t y;
+    TDD_DISP_DEV_INFO_T dev_info = {
+        .type = TUYA_DISPLAY_SPI,
+        .width = TEST_DISP_WIDTH,
+        .height = TEST_DISP_HEIGHT,
+        .fmt = TUYA_PIXEL_FMT_RGB565,
+        .rotation = TUYA_DISPLAY_ROTATION_0,
+        .bl.type = TUYA_DISP_BL_TP_NONE,
+        .power.pin = TUYA_GPIO_NUM_MAX,
+    };
+    TDD_DISP_INTFS_T intfs = {
+        .flush = __test_disp_flush,
+        .flush_area = __test_disp_flush_area,
+    };
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    sg_test_disp.panel = tal_malloc(TEST_DISP_WIDTH * TEST_DISP_HEIGHT * TEST_PIXEL_BYTES);
+    sg_fb = tdl_disp_create_frame_buff(DISP_FB_TP_SRAM, TEST_DISP_WIDTH * TEST_DISP_HEIGHT * TEST_PIXEL_BYTES);
+    if (NULL == sg_test_disp.panel || NULL == sg_fb) {
+        PR_ERR("malloc failed");
+        goto __EXIT;
+    }
+    sg_fb->fmt = TUYA_PIXEL_FMT_RGB565;
+    sg_fb->width = TEST_DISP_WIDTH;
+    sg_fb->height = TEST_DISP_HEIGHT;
+
+    TUYA_CALL_ERR_GOTO(tdl_disp_device_register(TEST_DISP_NAME, &sg_test_disp, &intfs, &dev_info), __EXIT);
+    disp_hdl = tdl_disp_find_dev(TEST_DISP_NAME);
+    TUYA_CALL_ERR_GOTO(tdl_disp_dev_open(disp_hdl), __EXIT);
+
+    // First frame, the whole screen
+    __test_draw(0, 0, TEST_DISP_WIDTH - 1, TEST_DISP_HEIGHT - 1, 0xFFFF);
+    TUYA_CALL_ERR_GOTO(__test_frame(disp_hdl, "background"), __EXIT);
+
+    // A blinking text cursor
+    __test_draw(100, 200, 101, 219, 0x0000);
+    TUYA_CALL_ERR_GOTO(__test_frame(disp_hdl, "cursor"), __EXIT);
+
+    // A clock label and a progress bar changing in the same frame
+    __test_draw(8, 8, 87, 31, 0x001F);
+    __test_draw(20, 440, 180, 451, 0x07E0);
+    TUYA_CALL_ERR_GOTO(__test_frame(disp_hdl, "label + bar"), __EXIT);
+
+    // A line of text rendered glyph by glyph, neighbouring glyphs merge into one window
+    for (y = 0; y < 12; y++) {
+        __test_draw(40 + y * 10, 300, 49 + y * 10, 315, 0xF800);
+    }
+    TUYA_CALL_ERR_GOTO(__test_frame(disp_hdl, "text line"), __EXIT);
+
+    // A screen change rendered by LVGL in partial mode, ten full width bands
+    for (y = 0; y < TEST_DISP_HEIGHT; y += TEST_DISP_HEIGHT / 10) {
+        __test_draw(0, y, TEST_DISP_WIDTH - 1, y + TEST_DISP_HEIGHT / 10 - 1, 0x7BEF);
+    }
+    TUYA_CALL_ERR_GOTO(__test_frame(disp_hdl, "screen bands"), __EXIT);
+
+    TUYA_CALL_ERR_GOTO(__test_random_frames(disp_hdl), __EXIT);
+
+    PR_NOTICE("disp dirty area test PASS");
+
+__EXIT:
+    if (disp_hdl) {
+        tdl_disp_dev_close(disp_hdl);
+    }
+    if (sg_fb) {
+        tdl_disp_free_frame_buff(sg_fb);
+        sg_fb = NULL;
+    }
+    if (sg_test_disp.panel) {
+        tal_free(sg_test_disp.panel);
+        sg_test_disp.panel = NULL;
+    }
+    if (OPRT_OK != rt) {
+        PR_ERR("disp dirty area test FAIL, rt: %d", rt);
+    }
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
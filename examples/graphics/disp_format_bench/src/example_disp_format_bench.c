@@ -0,0 +1,338 @@
+/**
+ * @file example_disp_format_bench.c
+ * @brief Benchmark of the display format conversion kernels against the per-pixel path.
+ *
+ * The kernels of tdl_display_format build packed bytes in a register a row at a time. The example runs each of them
+ * next to a per-pixel version that reads and writes the frame buffer for every pixel, as the LVGL port and the
+ * display drivers used to: RGB565 to monochrome and to 2-bit grey (also with a 180 degree rotated source), SSD1306
+ * page packing and the ST7305 line pair interleave. It checks that both produce the same bytes and reports the
+ * time per frame of each.
+ *
+ * Usage on Linux: ./disp_format_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdl_display_format.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_MONO_WIDTH   168
+#define BENCH_MONO_HEIGHT  384
+#define BENCH_I2_WIDTH     300
+#define BENCH_I2_HEIGHT    400
+#define BENCH_PAGES_WIDTH  128
+#define BENCH_PAGES_HEIGHT 64
+
+#define BENCH_MAX_PIXELS (BENCH_I2_WIDTH * BENCH_I2_HEIGHT)
+#define BENCH_ROUNDS     200
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void (*BENCH_KERNEL_CB)(bool per_pixel, uint8_t *out);
+
+typedef struct {
+    const char *name;
+    BENCH_KERNEL_CB kernel;
+    uint32_t out_len;
+    uint32_t pixels;
+} BENCH_CASE_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static uint16_t sg_rgb565[BENCH_MAX_PIXELS];
+static uint8_t sg_mono[(BENCH_MONO_WIDTH + 7) / 8 * BENCH_MONO_HEIGHT];
+static uint8_t sg_out[2][BENCH_MAX_PIXELS / 2];
+
+static TDL_DISP_FRAME_BUFF_T sg_fb;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static uint8_t __pixel_luma(uint16_t px)
+{
+    return (uint8_t)(((px >> 11) * 630 + ((px >> 5) & 0x3F) * 608 + (px & 0x1F) * 240) >> 8);
+}
+
+static void __frame_init(uint8_t *frame, TUYA_DISPLAY_PIXEL_FMT_E fmt, uint16_t width, uint16_t height)
+{
+    sg_fb.frame = frame;
+    sg_fb.fmt = fmt;
+    sg_fb.width = width;
+    sg_fb.height = height;
+}
+
+static void __mono_write_point(uint32_t x, uint32_t y, bool enable, uint8_t *frame, uint32_t width)
+{
+    uint32_t index = y * ((width + 7) / 8) + x / 8;
+
+    if (enable) {
+        frame[index] |= (1 << (x % 8));
+    } else {
+        frame[index] &= ~(1 << (x % 8));
+    }
+}
+
+static void __i2_write_point(uint32_t x, uint32_t y, uint8_t color, uint8_t *frame, uint32_t width)
+{
+    uint32_t index = y * ((width + 3) / 4) + x / 4;
+    uint8_t shift = (x % 4) * 2;
+
+    frame[index] = (frame[index] & ~(0x03 << shift)) | ((color & 0x03) << shift);
+}
+
+static void __bench_mono(bool per_pixel, uint8_t *out, bool rotate)
+{
+    TDL_DISP_AREA_T area = {0, 0, BENCH_MONO_WIDTH - 1, BENCH_MONO_HEIGHT - 1};
+    TDL_DISP_RGB565_SRC_T src = {sg_rgb565, 1, BENCH_MONO_WIDTH};
+    uint32_t x, y, offset = 0;
+
+    if (rotate) {
+        src.base = sg_rgb565 + BENCH_MONO_WIDTH * BENCH_MONO_HEIGHT - 1;
+        src.col_step = -1;
+        src.row_step = -BENCH_MONO_WIDTH;
+    }
+
+    if (false == per_pixel) {
+        __frame_init(out, TUYA_PIXEL_FMT_MONOCHROME, BENCH_MONO_WIDTH, BENCH_MONO_HEIGHT);
+        tdl_disp_rgb565_to_mono(&sg_fb, &area, &src, TDL_DISP_MONO_MODE_THRESHOLD);
+        return;
+    }
+
+    for (y = 0; y < BENCH_MONO_HEIGHT; y++) {
+        for (x = 0; x < BENCH_MONO_WIDTH; x++) {
+            offset = rotate ? BENCH_MONO_WIDTH * BENCH_MONO_HEIGHT - 1 - (y * BENCH_MONO_WIDTH + x)
+                            : y * BENCH_MONO_WIDTH + x;
+            __mono_write_point(x, y, __pixel_luma(sg_rgb565[offset]) < TDL_DISP_MONO_THRESHOLD, out,
+                               BENCH_MONO_WIDTH);
+        }
+    }
+}
+
+static void __bench_i2(bool per_pixel, uint8_t *out, bool rotate)
+{
+    TDL_DISP_AREA_T area = {0, 0, BENCH_I2_WIDTH - 1, BENCH_I2_HEIGHT - 1};
+    TDL_DISP_RGB565_SRC_T src = {sg_rgb565, 1, BENCH_I2_WIDTH};
+    uint32_t x, y, offset = 0;
+
+    if (rotate) {
+        src.base = sg_rgb565 + BENCH_I2_WIDTH * BENCH_I2_HEIGHT - 1;
+        src.col_step = -1;
+        src.row_step = -BENCH_I2_WIDTH;
+    }
+
+    if (false == per_pixel) {
+        __frame_init(out, TUYA_PIXEL_FMT_I2, BENCH_I2_WIDTH, BENCH_I2_HEIGHT);
+        tdl_disp_rgb565_to_i2(&sg_fb, &area, &src);
+        return;
+    }
+
+    for (y = 0; y < BENCH_I2_HEIGHT; y++) {
+        for (x = 0; x < BENCH_I2_WIDTH; x++) {
+            offset = rotate ? BENCH_I2_WIDTH * BENCH_I2_HEIGHT - 1 - (y * BENCH_I2_WIDTH + x) : y * BENCH_I2_WIDTH + x;
+            __i2_write_point(x, y, (255 - __pixel_luma(sg_rgb565[offset])) >> 6, out, BENCH_I2_WIDTH);
+        }
+    }
+}
+
+static void __bench_mono_fill(bool per_pixel, uint8_t *out)
+{
+    __bench_mono(per_pixel, out, false);
+}
+
+static void __bench_mono_rotate(bool per_pixel, uint8_t *out)
+{
+    __bench_mono(per_pixel, out, true);
+}
+
+static void __bench_i2_fill(bool per_pixel, uint8_t *out)
+{
+    __bench_i2(per_pixel, out, false);
+}
+
+static void __bench_i2_rotate(bool per_pixel, uint8_t *out)
+{
+    __bench_i2(per_pixel, out, true);
+}
+
+static void __bench_pages(bool per_pixel, uint8_t *out)
+{
+    uint32_t width_bytes = (BENCH_PAGES_WIDTH + 7) / 8;
+    uint32_t i, j, m;
+    uint8_t mix = 0;
+
+    if (false == per_pixel) {
+        tdl_disp_mono_to_pages(sg_mono, BENCH_PAGES_WIDTH, BENCH_PAGES_HEIGHT, out);
+        return;
+    }
+
+    for (i = 0; i < BENCH_PAGES_HEIGHT; i += 8) {
+        for (j = 0; j < BENCH_PAGES_WIDTH; j++) {
+            mix = 0;
+            for (m = 0; m < 8 && i + m < BENCH_PAGES_HEIGHT; m++) {
+                mix |= ((sg_mono[(i + m) * width_bytes + j / 8] >> (j % 8)) & 0x01) << m;
+            }
+            out[(i / 8) * BENCH_PAGES_WIDTH + j] = mix;
+        }
+    }
+}
+
+static void __bench_interleave(bool per_pixel, uint8_t *out)
+{
+    uint32_t width_bytes = (BENCH_MONO_WIDTH + 7) / 8;
+    uint32_t i, j, k = 0;
+    uint8_t b1, b2, n;
+
+    for (i = 0; i < BENCH_MONO_HEIGHT; i += 2) {
+        if (false == per_pixel) {
+            tdl_disp_interleave_lines(sg_mono + i * width_bytes, sg_mono + (i + 1) * width_bytes, width_bytes,
+                                      out + k);
+            k += width_bytes * 2;
+            continue;
+        }
+
+        for (j = 0; j < width_bytes; j++) {
+            b1 = sg_mono[i * width_bytes + j];
+            b2 = sg_mono[(i + 1) * width_bytes + j];
+            for (n = 0; n < 2; n++) {
+                out[k++] = ((b1 & 0x01) << 7) | ((b2 & 0x01) << 6) | ((b1 & 0x02) << 4) | ((b2 & 0x02) << 3) |
+                           ((b1 & 0x04) << 1) | ((b2 & 0x04)) | ((b1 & 0x08) >> 2) | ((b2 & 0x08) >> 3);
+                b1 >>= 4;
+                b2 >>= 4;
+            }
+        }
+    }
+}
+
+static const BENCH_CASE_T sg_bench_case[] = {
+    {"mono 168x384", __bench_mono_fill, (BENCH_MONO_WIDTH + 7) / 8 * BENCH_MONO_HEIGHT,
+     BENCH_MONO_WIDTH * BENCH_MONO_HEIGHT},
+    {"mono 168x384 r180", __bench_mono_rotate, (BENCH_MONO_WIDTH + 7) / 8 * BENCH_MONO_HEIGHT,
+     BENCH_MONO_WIDTH * BENCH_MONO_HEIGHT},
+    {"i2 300x400", __bench_i2_fill, (BENCH_I2_WIDTH + 3) / 4 * BENCH_I2_HEIGHT, BENCH_I2_WIDTH * BENCH_I2_HEIGHT},
+    {"i2 300x400 r180", __bench_i2_rotate, (BENCH_I2_WIDTH + 3) / 4 * BENCH_I2_HEIGHT,
+     BENCH_I2_WIDTH * BENCH_I2_HEIGHT},
+    {"pages 128x64", __bench_pages, BENCH_PAGES_WIDTH * BENCH_PAGES_HEIGHT / 8,
+     BENCH_PAGES_WIDTH * BENCH_PAGES_HEIGHT},
+    {"interleave 168x384", __bench_interleave, (BENCH_MONO_WIDTH + 7) / 8 * BENCH_MONO_HEIGHT,
+     BENCH_MONO_WIDTH * BENCH_MONO_HEIGHT},
+};
+
+static void __bench_main(void)
+{
+    const BENCH_CASE_T *c = NULL;
+    uint64_t start, pixel_ns, kernel_ns;
+    uint32_t i, n, seed = 1;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    // A gradient with noise, so both grey levels and the threshold are exercised
+    for (i = 0; i < BENCH_MAX_PIXELS; i++) {
+        seed = seed * 1103515245 + 12345;
+        sg_rgb565[i] = (uint16_t)((i * 7) ^ (seed >> 16));
+    }
+    __frame_init(sg_mono, TUYA_PIXEL_FMT_MONOCHROME, BENCH_MONO_WIDTH, BENCH_MONO_HEIGHT);
+    tdl_disp_rgb565_to_mono(&sg_fb, &(TDL_DISP_AREA_T){0, 0, BENCH_MONO_WIDTH - 1, BENCH_MONO_HEIGHT - 1},
+                            &(TDL_DISP_RGB565_SRC_T){sg_rgb565, 1, BENCH_MONO_WIDTH}, TDL_DISP_MONO_MODE_DITHER);
+
+    for (n = 0; n < CNTSOF(sg_bench_case); n++) {
+        c = &sg_bench_case[n];
+
+        memset(sg_out, 0, sizeof(sg_out));
+        c->kernel(true, sg_out[0]);
+        c->kernel(false, sg_out[1]);
+        if (memcmp(sg_out[0], sg_out[1], c->out_len)) {
+            PR_ERR("%s: kernel output differs from the per-pixel path", c->name);
+            return;
+        }
+
+        start = __bench_time_ns();
+        for (i = 0; i < BENCH_ROUNDS; i++) {
+            c->kernel(true, sg_out[0]);
+        }
+        pixel_ns = (__bench_time_ns() - start) / BENCH_ROUNDS;
+
+        start = __bench_time_ns();
+        for (i = 0; i < BENCH_ROUNDS; i++) {
+            c->kernel(false, sg_out[1]);
+        }
+        kernel_ns = (__bench_time_ns() - start) / BENCH_ROUNDS;
+
+        PR_NOTICE("%-18s per-pixel %7u ns, kernel %7u ns, %u.%02u ns/px, x%u.%02u", c->name, (uint32_t)pixel_ns,
+                  (uint32_t)kernel_ns, (uint32_t)(kernel_ns / c->pixels), (uint32_t)(kernel_ns * 100 / c->pixels % 100),
+                  (uint32_t)(pixel_ns / kernel_ns), (uint32_t)(pixel_ns * 100 / kernel_ns % 100));
+    }
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,459 @@
+/**
+ * @file example_ai_audio_file_test.c
+ * @brief Test of the ai_audio player and input tasks with a file-backed microphone and speaker.
+ *
+ * A stand-in audio codec is registered under AUDIO_CODEC_NAME. Its microphone sends 10 ms PCM frames read from a
+ * file in real time, and its speaker appends the PCM it is given to a file, blocking for the play time of the
+ * samples like a codec DMA. The test measures the process wake-ups while the pipeline is idle, the VAD start
+ * latency of the input task, the time from ai_audio_player_start to the first audio of a streamed MP3 and the
+ * run time of a synchronous alert. The VAD and ASR are energy based stand-ins, used when the platform has none.
+ *
+ * Usage on Linux: ./ai_audio_file_test, writes ai_audio_mic.pcm and ai_audio_spk.pcm in the working directory
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+#include "tkl_asr.h"
+#include "tkl_vad.h"
+
+#include "tdl_audio_driver.h"
+#include "ai_audio.h"
+#include "ai_media_alert.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <stdio.h>
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_MIC_FILE "ai_audio_mic.pcm"
+#define TEST_SPK_FILE "ai_audio_spk.pcm"
+
+#define TEST_BYTES_PER_MS  32 // 16 kHz, 16 bit, mono
+#define TEST_MIC_FRAMES    200
+#define TEST_SPEECH_START  100 // First frame of the noise burst standing in for speech
+#define TEST_SPEECH_FRAMES 50
+#define TEST_VAD_LEVEL     1000000 // Mean square of a speech frame
+
+#define TEST_IDLE_MS      2000
+#define TEST_TTS_RUNS     5
+#define TEST_TTS_CHUNK    512
+#define TEST_TTS_CHUNK_MS 5
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+typedef struct {
+    TDL_AUDIO_MIC_CB mic_cb;
+    FILE *spk_file;
+    uint32_t spk_bytes;
+    uint32_t play_calls;
+    uint64_t first_play_us;
+} TEST_CODEC_T;
+#endif
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static TEST_CODEC_T sg_codec;
+static THREAD_HANDLE sg_mic_thrd;
+static SEM_HANDLE sg_mic_done_sem;
+
+static uint64_t sg_speech_us;
+static uint64_t sg_vad_start_us;
+
+static BOOL_T sg_vad_on;
+static BOOL_T sg_vad_speech;
+#endif
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static uint64_t __test_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Voluntary context switches of the process, one per blocking wait of any task
+static uint32_t __test_wakeups(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return (uint32_t)usage.ru_nvcsw;
+}
+
+/* VAD and ASR stand-ins, replaced by the platform implementation when there is one */
+__attribute__((weak)) OPERATE_RET tkl_vad_init(TKL_VAD_CONFIG_T *config)
+{
+    return OPRT_OK;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_vad_feed(uint8_t *data, uint32_t len)
+{
+    int16_t *sample = (int16_t *)data;
+    uint64_t energy = 0;
+    uint32_t i = 0, num = len / 2;
+
+    for (i = 0; i < num; i++) {
+        energy += (int32_t)sample[i] * sample[i];
+    }
+    sg_vad_speech = sg_vad_on && num && (energy / num > TEST_VAD_LEVEL);
+
+    return OPRT_OK;
+}
+
+__attribute__((weak)) TKL_VAD_STATUS_T tkl_vad_get_status(void)
+{
+    return sg_vad_speech ? TKL_VAD_STATUS_SPEECH : TKL_VAD_STATUS_NONE;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_vad_start(void)
+{
+    sg_vad_on = TRUE;
+
+    return OPRT_OK;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_vad_stop(void)
+{
+    sg_vad_on = FALSE;
+    sg_vad_speech = FALSE;
+
+    return OPRT_OK;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_vad_deinit(void)
+{
+    return OPRT_OK;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_asr_init(void)
+{
+    return OPRT_OK;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_asr_wakeup_word_config(TKL_ASR_WAKEUP_WORD_E *wakeup_word_arr, uint8_t arr_cnt)
+{
+    return OPRT_OK;
+}
+
+__attribute__((weak)) uint32_t tkl_asr_get_process_uint_size(void)
+{
+    return AI_AUDIO_PCM_FRAME_SIZE;
+}
+
+__attribute__((weak)) TKL_ASR_WAKEUP_WORD_E tkl_asr_recognize_wakeup_word(uint8_t *data, uint32_t len)
+{
+    return TKL_ASR_WAKEUP_WORD_UNKNOWN;
+}
+
+__attribute__((weak)) OPERATE_RET tkl_asr_deinit(void)
+{
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_codec_open(TDD_AUDIO_HANDLE_T handle, TDL_AUDIO_MIC_CB mic_cb)
+{
+    TEST_CODEC_T *codec = (TEST_CODEC_T *)handle;
+
+    codec->mic_cb = mic_cb;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_codec_play(TDD_AUDIO_HANDLE_T handle, uint8_t *data, uint32_t len)
+{
+    TEST_CODEC_T *codec = (TEST_CODEC_T *)handle;
+
+    if (0 == codec->play_calls++) {
+        codec->first_play_us = __test_time_us();
+    }
+
+    if (codec->spk_file) {
+        fwrite(data, 1, len, codec->spk_file);
+    }
+    codec->spk_bytes += len;
+
+    // the codec takes the samples at the sample rate
+    tal_system_sleep(len / TEST_BYTES_PER_MS);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_codec_config(TDD_AUDIO_HANDLE_T handle, TDD_AUDIO_CMD_E cmd, void *args)
+{
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_codec_close(TDD_AUDIO_HANDLE_T handle)
+{
+    return OPRT_OK;
+}
+
+// 1 s of silence, 0.5 s of noise standing in for speech, 0.5 s of silence
+static OPERATE_RET __test_mic_file_create(void)
+{
+    FILE *fp = NULL;
+    int16_t frame[AI_AUDIO_PCM_FRAME_SIZE / 2];
+    uint32_t i = 0, k = 0, seed = 1;
+
+    fp = fopen(TEST_MIC_FILE, "wb");
+    if (NULL == fp) {
+        PR_ERR("open %s failed", TEST_MIC_FILE);
+        return OPRT_FILE_OPEN_FAILED;
+    }
+
+    for (i = 0; i < TEST_MIC_FRAMES; i++) {
+        for (k = 0; k < CNTSOF(frame); k++) {
+            frame[k] = 0;
+            if (i >= TEST_SPEECH_START && i < TEST_SPEECH_START + TEST_SPEECH_FRAMES) {
+                seed = seed * 1103515245 + 12345;
+                frame[k] = (int16_t)((seed >> 16) % 8000) - 4000;
+            }
+        }
+        fwrite(frame, 1, sizeof(frame), fp);
+    }
+    fclose(fp);
+
+    return OPRT_OK;
+}
+
+// Sends the microphone file as 10 ms frames in real time
+static void __test_mic_task(void *arg)
+{
+    FILE *fp = NULL;
+    uint8_t frame[AI_AUDIO_PCM_FRAME_SIZE];
+    uint64_t start = 0, due = 0, now = 0;
+    uint32_t i = 0;
+
+    fp = fopen(TEST_MIC_FILE, "rb");
+    if (fp) {
+        start = __test_time_us();
+        for (i = 0; sizeof(frame) == fread(frame, 1, sizeof(frame), fp); i++) {
+            if (TEST_SPEECH_START == i) {
+                sg_speech_us = __test_time_us();
+            }
+            sg_codec.mic_cb(TDL_AUDIO_FRAME_FORMAT_PCM, TDL_AUDIO_STATUS_RECEIVING, frame, sizeof(frame));
+
+            due = start + (uint64_t)(i + 1) * AI_AUDIO_PCM_FRAME_TM_MS * 1000;
+            now = __test_time_us();
+            if (due > now) {
+                tal_system_sleep((uint32_t)((due - now + 999) / 1000));
+            }
+        }
+        fclose(fp);
+    }
+
+    tal_semaphore_post(sg_mic_done_sem);
+    tal_thread_delete(sg_mic_thrd);
+    sg_mic_thrd = NULL;
+}
+
+static void __test_input_inform_cb(AI_AUDIO_INPUT_EVENT_E event, void *arg)
+{
+    if (AI_AUDIO_INPUT_EVT_GET_VALID_VOICE_START == event && 0 == sg_vad_start_us) {
+        sg_vad_start_us = __test_time_us();
+    }
+}
+
+static OPERATE_RET __test_open(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_AUDIO_INTFS_T intfs = {__test_codec_open, __test_codec_play, __test_codec_config, __test_codec_close};
+    AI_AUDIO_INPUT_CFG_T cfg = {AI_AUDIO_INPUT_VALID_METHOD_VAD};
+
+    TUYA_CALL_ERR_RETURN(__test_mic_file_create());
+    sg_codec.spk_file = fopen(TEST_SPK_FILE, "wb");
+    if (NULL == sg_codec.spk_file) {
+        PR_ERR("open %s failed", TEST_SPK_FILE);
+        return OPRT_FILE_OPEN_FAILED;
+    }
+
+    TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&sg_mic_done_sem, 0, 1));
+    TUYA_CALL_ERR_RETURN(tdl_audio_driver_register(AUDIO_CODEC_NAME, &intfs, (TDD_AUDIO_HANDLE_T)&sg_codec));
+    TUYA_CALL_ERR_RETURN(ai_audio_player_init());
+    TUYA_CALL_ERR_RETURN(ai_audio_input_init(&cfg, __test_input_inform_cb));
+    TUYA_CALL_ERR_RETURN(ai_audio_input_enable_get_valid_data(true));
+
+    return OPRT_OK;
+}
+
+static BOOL_T __test_idle(void)
+{
+    uint32_t wakeups = __test_wakeups();
+
+    tal_system_sleep(TEST_IDLE_MS);
+    wakeups = __test_wakeups() - wakeups;
+
+    PR_NOTICE("idle %u ms        %4u process wake-ups", TEST_IDLE_MS, wakeups);
+
+    return TRUE;
+}
+
+static BOOL_T __test_mic(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    THREAD_CFG_T thrd_cfg = {4096, THREAD_PRIO_1, "test_mic"};
+    uint32_t wakeups = __test_wakeups();
+
+    TUYA_CALL_ERR_RETURN_VAL(
+        tal_thread_create_and_start(&sg_mic_thrd, NULL, NULL, __test_mic_task, NULL, &thrd_cfg), FALSE);
+    tal_semaphore_wait_forever(sg_mic_done_sem);
+    wakeups = __test_wakeups() - wakeups;
+
+    if (0 == sg_vad_start_us) {
+        PR_NOTICE("mic %u frames     %4u process wake-ups, no VAD start", TEST_MIC_FRAMES, wakeups);
+        return FALSE;
+    }
+
+    PR_NOTICE("mic %u frames     %4u process wake-ups, VAD start %u.%02u ms after the speech frame",
+              TEST_MIC_FRAMES, wakeups, (uint32_t)((sg_vad_start_us - sg_speech_us) / 1000),
+              (uint32_t)((sg_vad_start_us - sg_speech_us) / 10 % 100));
+
+    return TRUE;
+}
+
+static BOOL_T __test_tts(void)
+{
+    const uint8_t *data = media_src_wakeup;
+    uint32_t len = sizeof(media_src_wakeup), off = 0, chunk = 0, run = 0;
+    uint64_t start = 0, first = 0;
+
+    for (run = 0; run < TEST_TTS_RUNS; run++) {
+        sg_codec.play_calls = 0;
+        start = __test_time_us();
+        ai_audio_player_start("tts");
+
+        // streamed like a TTS download, a chunk every few ms
+        for (off = 0; off < len; off += chunk) {
+            chunk = (len - off > TEST_TTS_CHUNK) ? TEST_TTS_CHUNK : len - off;
+            ai_audio_player_data_write("tts", (uint8_t *)data + off, chunk, off + chunk == len);
+            tal_system_sleep(TEST_TTS_CHUNK_MS);
+        }
+        while (ai_audio_player_is_playing()) {
+            tal_system_sleep(10);
+        }
+
+        if (0 == sg_codec.play_calls) {
+            PR_NOTICE("tts run %u played nothing", run);
+            return FALSE;
+        }
+        first += sg_codec.first_play_us - start;
+    }
+
+    PR_NOTICE("tts x%u              first audio %u.%02u ms after start on average", TEST_TTS_RUNS,
+              (uint32_t)(first / TEST_TTS_RUNS / 1000), (uint32_t)(first / TEST_TTS_RUNS / 10 % 100));
+
+    return TRUE;
+}
+
+static BOOL_T __test_alert(void)
+{
+    uint32_t wakeups = __test_wakeups(), bytes = sg_codec.spk_bytes;
+    uint64_t start = __test_time_us(), first = 0, done = 0;
+
+    sg_codec.play_calls = 0;
+    ai_audio_player_play_alert_syn(AI_AUDIO_ALERT_POWER_ON);
+    done = __test_time_us() - start;
+    first = sg_codec.first_play_us - start;
+    wakeups = __test_wakeups() - wakeups;
+    bytes = sg_codec.spk_bytes - bytes;
+
+    PR_NOTICE("alert syn         %4u process wake-ups, first audio %u.%02u ms, %u ms of audio done after %u ms",
+              wakeups, (uint32_t)(first / 1000), (uint32_t)(first / 10 % 100), bytes / TEST_BYTES_PER_MS,
+              (uint32_t)(done / 1000));
+
+    return (sg_codec.play_calls != 0);
+}
+#endif
+
+static void __test_main(void)
+{
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    BOOL_T pass = FALSE;
+
+    if (OPRT_OK != __test_open()) {
+        PR_ERR("ai audio open failed");
+        return;
+    }
+    tal_system_sleep(100);
+
+    pass = __test_idle();
+    pass = __test_mic() && pass;
+    pass = __test_tts() && pass;
+    pass = __test_alert() && pass;
+
+    fclose(sg_codec.spk_file);
+    sg_codec.spk_file = NULL;
+    PR_NOTICE("%u bytes of PCM written to %s", sg_codec.spk_bytes, TEST_SPK_FILE);
+    PR_NOTICE("ai audio file test %s", pass ? "PASS" : "FAIL");
+#else
+    PR_NOTICE("ai audio file test runs on Linux only");
+#endif
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
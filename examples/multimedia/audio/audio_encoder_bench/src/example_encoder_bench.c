@@ -0,0 +1,357 @@
+/**
+ * @file example_encoder_bench.c
+ * @brief Benchmark of the uplink audio encoders used by the cloud ASR module.
+ *
+ * The example encodes a 16-bit PCM WAV file (or a generated test signal) in 20ms frames with every built-in encoder
+ * and reports the CPU time per frame, the compression ratio and the bit rate. The ADPCM output is decoded again to
+ * report the signal to noise ratio.
+ *
+ * Usage on Linux: ./audio_encoder_bench [file.wav]
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+#include "tuya_ai_protocol.h"
+
+#include "ai_audio_encoder.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_TEST_SIGNAL_MS   (5 * 1000)
+#define BENCH_TEST_SAMPLE_RATE 16000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    char *name;
+    AI_AUDIO_ENCODER_INTFS_T *(*get)(void);
+} BENCH_ENCODER_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const BENCH_ENCODER_T sg_encoders[] = {
+    {"pcm", ai_audio_encoder_pcm_get},
+    {"adpcm", ai_audio_encoder_adpcm_get},
+};
+
+static const int16_t sg_step_table[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int8_t sg_index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_cpu_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+// reference decoder of one ADPCM frame, used to measure the coding noise
+static void __bench_adpcm_decode(const uint8_t *in, uint32_t samples, int16_t *out)
+{
+    int32_t predictor = (int16_t)(in[0] | (in[1] << 8));
+    int32_t index = in[2], step = 0, delta = 0;
+    uint8_t code = 0;
+    uint32_t i = 0;
+
+    in += AI_AUDIO_ADPCM_HEAD_LEN;
+
+    for (i = 0; i < samples; i++) {
+        code = (i & 0x01) ? (in[i / 2] >> 4) : (in[i / 2] & 0x0F);
+        step = sg_step_table[index];
+
+        delta = step >> 3;
+        if (code & 4) {
+            delta += step;
+        }
+        if (code & 2) {
+            delta += step >> 1;
+        }
+        if (code & 1) {
+            delta += step >> 2;
+        }
+
+        predictor += (code & 8) ? -delta : delta;
+        if (predictor > 32767) {
+            predictor = 32767;
+        } else if (predictor < -32768) {
+            predictor = -32768;
+        }
+
+        index += sg_index_table[code & 0x07];
+        if (index < 0) {
+            index = 0;
+        } else if (index > 88) {
+            index = 88;
+        }
+
+        out[i] = (int16_t)predictor;
+    }
+}
+
+static OPERATE_RET __bench_run(const BENCH_ENCODER_T *bench, const int16_t *pcm, uint32_t samples,
+                               uint32_t sample_rate)
+{
+    OPERATE_RET rt = OPRT_OK;
+    AI_AUDIO_ENCODER_INTFS_T *intfs = bench->get();
+    AI_AUDIO_ENCODER_CTX_T ctx = NULL;
+    AI_AUDIO_ENCODER_INFO_T info;
+    uint32_t frame_samples = sample_rate * AI_AUDIO_ENCODER_FRAME_MS / 1000;
+    uint32_t pos = 0, num = 0, out_len = 0, frames = 0;
+    uint64_t out_total = 0, t0 = 0, cost = 0, cost_total = 0, cost_max = 0;
+    double noise = 0, power = 0;
+    uint8_t *out = NULL;
+    int16_t *dec = NULL;
+    uint32_t i = 0;
+
+    memset(&info, 0, sizeof(AI_AUDIO_ENCODER_INFO_T));
+    TUYA_CALL_ERR_RETURN(intfs->open(sample_rate, frame_samples, &ctx, &info));
+
+    out = (uint8_t *)tal_malloc(info.frame_max);
+    dec = (int16_t *)tal_malloc(frame_samples * sizeof(int16_t));
+    if (NULL == out || NULL == dec) {
+        rt = OPRT_MALLOC_FAILED;
+        goto __EXIT;
+    }
+
+    intfs->reset(ctx);
+
+    for (pos = 0; pos < samples; pos += num) {
+        num = (samples - pos < frame_samples) ? (samples - pos) : frame_samples;
+
+        t0 = __bench_cpu_time_ns();
+        TUYA_CALL_ERR_GOTO(intfs->encode(ctx, pcm + pos, num, out, &out_len), __EXIT);
+        cost = __bench_cpu_time_ns() - t0;
+
+        cost_total += cost;
+        if (cost > cost_max) {
+            cost_max = cost;
+        }
+        out_total += out_len;
+        frames++;
+
+        if (AUDIO_CODEC_ADPCM == info.codec_type) {
+            __bench_adpcm_decode(out, num, dec);
+            for (i = 0; i < num; i++) {
+                power += (double)pcm[pos + i] * pcm[pos + i];
+                noise += (double)(pcm[pos + i] - dec[i]) * (pcm[pos + i] - dec[i]);
+            }
+        }
+    }
+
+    PR_NOTICE("%-6s frames:%u cpu/frame avg:%.2fus max:%.2fus in:%u out:%llu ratio:%.2f bitrate:%.1fkbps", bench->name,
+              frames, (double)cost_total / frames / 1000, (double)cost_max / 1000, samples * 2,
+              (unsigned long long)out_total, (double)samples * 2 / out_total,
+              (double)out_total * 8 * sample_rate / samples / 1000);
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    if (noise > 0) {
+        PR_NOTICE("%-6s snr:%.1fdB", bench->name, 10 * log10(power / noise));
+    }
+#endif
+
+__EXIT:
+    if (out) {
+        tal_free(out);
+    }
+    if (dec) {
+        tal_free(dec);
+    }
+    intfs->close(ctx);
+
+    return rt;
+}
+
+// a voiced tone with a syllable envelope and some noise, close enough to speech for timing and ratio
+static int16_t *__bench_test_signal(uint32_t samples, uint32_t sample_rate)
+{
+    int16_t *pcm = (int16_t *)tal_malloc(samples * sizeof(int16_t));
+    uint32_t i = 0, seed = 1, phase = 0;
+    int32_t v = 0, env = 0;
+
+    if (NULL == pcm) {
+        return NULL;
+    }
+
+    for (i = 0; i < samples; i++) {
+        phase = (phase + 65536 * 180 / sample_rate) & 0xFFFF;
+        env = (int32_t)((i * 4 / (sample_rate / 1000)) % 1000);
+        env = (env < 500) ? env : 1000 - env;
+
+        v = (phase < 32768) ? (int32_t)phase - 16384 : 49152 - (int32_t)phase;
+        seed = seed * 1103515245 + 12345;
+        v = v * env / 500 + (int32_t)((seed >> 16) & 0x3FF) - 512;
+
+        pcm[i] = (int16_t)v;
+    }
+
+    return pcm;
+}
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static int16_t *__bench_load_wav(const char *path, uint32_t *samples, uint32_t *sample_rate)
+{
+    FILE *fp = fopen(path, "rb");
+    uint8_t head[12], chunk[8], fmt[16] = {0};
+    uint32_t chunk_len = 0, channels = 0, bits = 0, frames = 0, i = 0;
+    int16_t *pcm = NULL;
+
+    if (NULL == fp) {
+        PR_ERR("open %s failed", path);
+        return NULL;
+    }
+
+    if (fread(head, 1, 12, fp) != 12 || memcmp(head, "RIFF", 4) || memcmp(head + 8, "WAVE", 4)) {
+        PR_ERR("%s is not a wav file", path);
+        goto __EXIT;
+    }
+
+    while (fread(chunk, 1, 8, fp) == 8) {
+        chunk_len = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+
+        if (0 == memcmp(chunk, "fmt ", 4) && chunk_len >= 16) {
+            if (fread(fmt, 1, 16, fp) != 16) {
+                break;
+            }
+            channels = fmt[2] | (fmt[3] << 8);
+            *sample_rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            bits = fmt[14] | (fmt[15] << 8);
+            fseek(fp, (chunk_len - 16 + 1) & ~1UL, SEEK_CUR);
+        } else if (0 == memcmp(chunk, "data", 4)) {
+            if ((fmt[0] | (fmt[1] << 8)) != 1 || 16 != bits || 0 == channels) {
+                PR_ERR("only 16-bit PCM wav files are supported");
+                break;
+            }
+
+            frames = chunk_len / (channels * sizeof(int16_t));
+            pcm = (int16_t *)tal_malloc(frames * channels * sizeof(int16_t));
+            if (NULL == pcm) {
+                break;
+            }
+            frames = fread(pcm, channels * sizeof(int16_t), frames, fp);
+
+            // the uplink is mono, keep the first channel
+            for (i = 0; i < frames; i++) {
+                pcm[i] = pcm[i * channels];
+            }
+            *samples = frames;
+            break;
+        } else {
+            fseek(fp, (chunk_len + 1) & ~1UL, SEEK_CUR);
+        }
+    }
+
+__EXIT:
+    fclose(fp);
+
+    return pcm;
+}
+#endif
+
+static void __bench_main(const char *path)
+{
+    int16_t *pcm = NULL;
+    uint32_t samples = 0, sample_rate = BENCH_TEST_SAMPLE_RATE, i = 0;
+
+    /* basic init */
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    if (path) {
+        pcm = __bench_load_wav(path, &samples, &sample_rate);
+        if (NULL == pcm) {
+            return;
+        }
+        PR_NOTICE("%s: %u samples at %uHz", path, samples, sample_rate);
+    }
+#endif
+
+    if (NULL == pcm) {
+        samples = sample_rate / 1000 * BENCH_TEST_SIGNAL_MS;
+        pcm = __bench_test_signal(samples, sample_rate);
+        if (NULL == pcm) {
+            return;
+        }
+        PR_NOTICE("test signal: %u samples at %uHz", samples, sample_rate);
+    }
+
+    for (i = 0; i < CNTSOF(sg_encoders); i++) {
+        __bench_run(&sg_encoders[i], pcm, samples, sample_rate);
+    }
+
+    tal_free(pcm);
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main(NULL);
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    __bench_main((argc > 1) ? argv[1] : NULL);
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,274 @@
+/**
+ * @file example_button_wakeup_test.c
+ * @brief Wake-up count test of the interrupt mode button engine with simulated GPIO edges.
+ *
+ * A stand-in button driver is registered in interrupt mode. The test sets its level and calls the edge interrupt
+ * callback the way a GPIO interrupt would, with a few milliseconds of contact bounce on every press and release.
+ * Each wake-up of the button task reads the button once, so the driver counts the reads as wake-ups. For click,
+ * double click, triple click, long press, a short glitch and idle time, the test checks the events against the
+ * expected sequence and prints the wake-ups it took, including one second of idle time after the scenario.
+ *
+ * Usage on Linux: ./button_wakeup_test
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdl_button_driver.h"
+#include "tdl_button_manage.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_BUTTON_NAME "edge_key"
+#define TEST_EVENT_MAX   16
+#define TEST_SETTLE_MS   1000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    const char *expect; // Events in order, one letter each, see sg_event_code
+} TEST_SCENARIO_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+static void __test_idle(void);
+static void __test_click(void);
+static void __test_double(void);
+static void __test_triple(void);
+static void __test_long(void);
+static void __test_glitch(void);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+// D down, U up, S single, W double, R repeat, L long press start, H hold, V recover up
+static const char sg_event_code[TDL_BUTTON_PRESS_MAX] = {'D', 'U', 'S', 'W', 'R', 'L', 'H', 'V'};
+
+static const TEST_SCENARIO_T sg_scenario[] = {
+    {"idle 3s", __test_idle, ""},
+    {"click", __test_click, "DUS"},
+    {"double click", __test_double, "DUDUW"},
+    {"triple click", __test_triple, "DUDUDUR"},
+    {"long 2.1s", __test_long, "DLHHU"},
+    {"glitch 20ms", __test_glitch, ""},
+};
+
+static TDL_BUTTON_CB sg_irq_cb;
+static volatile uint8_t sg_level;
+static volatile uint32_t sg_reads;
+
+static MUTEX_HANDLE sg_event_mutex;
+static char sg_event[TEST_EVENT_MAX + 1];
+static uint32_t sg_event_num;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static OPERATE_RET __test_drv_create(TDL_BUTTON_OPRT_INFO *dev)
+{
+    sg_irq_cb = dev->irq_cb;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_drv_delete(TDL_BUTTON_OPRT_INFO *dev)
+{
+    sg_irq_cb = NULL;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_drv_read(TDL_BUTTON_OPRT_INFO *dev, uint8_t *value)
+{
+    *value = sg_level;
+    sg_reads++;
+
+    return OPRT_OK;
+}
+
+static void __test_event_cb(char *name, TDL_BUTTON_TOUCH_EVENT_E event, void *argc)
+{
+    tal_mutex_lock(sg_event_mutex);
+    if (sg_event_num < TEST_EVENT_MAX && event < TDL_BUTTON_PRESS_MAX) {
+        sg_event[sg_event_num++] = sg_event_code[event];
+    }
+    tal_mutex_unlock(sg_event_mutex);
+}
+
+static void __test_edge(uint8_t level)
+{
+    sg_level = level;
+    if (sg_irq_cb) {
+        sg_irq_cb(NULL);
+    }
+}
+
+// An edge with contact bounce: level, 2 ms back, 3 ms level again
+static void __test_bounce(uint8_t level)
+{
+    __test_edge(level);
+    tal_system_sleep(2);
+    __test_edge(!level);
+    tal_system_sleep(3);
+    __test_edge(level);
+}
+
+static void __test_idle(void)
+{
+    tal_system_sleep(3000);
+}
+
+static void __test_click(void)
+{
+    __test_bounce(1);
+    tal_system_sleep(120);
+    __test_bounce(0);
+}
+
+static void __test_double(void)
+{
+    __test_click();
+    tal_system_sleep(150);
+    __test_click();
+}
+
+static void __test_triple(void)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < 3; i++) {
+        __test_bounce(1);
+        tal_system_sleep(80);
+        __test_bounce(0);
+        tal_system_sleep(120);
+    }
+}
+
+static void __test_long(void)
+{
+    __test_bounce(1);
+    tal_system_sleep(2100);
+    __test_bounce(0);
+}
+
+static void __test_glitch(void)
+{
+    __test_edge(1);
+    tal_system_sleep(20);
+    __test_edge(0);
+}
+
+static void __test_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    const TEST_SCENARIO_T *s = NULL;
+    TDL_BUTTON_HANDLE handle = NULL;
+    TDL_BUTTON_CTRL_INFO ctrl_info = {__test_drv_create, __test_drv_delete, __test_drv_read};
+    TDL_BUTTON_DEVICE_INFO_T dev_info = {NULL, BUTTON_IRQ_MODE, FALSE};
+    TDL_BUTTON_CFG_T cfg = {.long_start_valid_time = 1500,
+                            .long_keep_timer = 250,
+                            .button_debounce_time = 50,
+                            .button_repeat_valid_count = 3,
+                            .button_repeat_valid_time = 300};
+    uint32_t n = 0, reads = 0;
+    BOOL_T match = FALSE, pass = TRUE;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    TUYA_CALL_ERR_GOTO(tal_mutex_create_init(&sg_event_mutex), __EXIT);
+    TUYA_CALL_ERR_GOTO(tdl_button_register(TEST_BUTTON_NAME, &ctrl_info, &dev_info), __EXIT);
+    TUYA_CALL_ERR_GOTO(tdl_button_create(TEST_BUTTON_NAME, &cfg, &handle), __EXIT);
+    for (n = 0; n < TDL_BUTTON_PRESS_MAX; n++) {
+        tdl_button_event_register(handle, (TDL_BUTTON_TOUCH_EVENT_E)n, __test_event_cb);
+    }
+    tal_system_sleep(TEST_SETTLE_MS);
+
+    for (n = 0; n < CNTSOF(sg_scenario); n++) {
+        s = &sg_scenario[n];
+
+        tal_mutex_lock(sg_event_mutex);
+        sg_event_num = 0;
+        tal_mutex_unlock(sg_event_mutex);
+        reads = sg_reads;
+
+        s->run();
+        tal_system_sleep(TEST_SETTLE_MS);
+
+        tal_mutex_lock(sg_event_mutex);
+        sg_event[sg_event_num] = '\0';
+        match = (0 == strcmp(sg_event, s->expect));
+        tal_mutex_unlock(sg_event_mutex);
+        reads = sg_reads - reads;
+
+        PR_NOTICE("%-12s events %-8s %s, %3u wake-ups", s->name, sg_event, match ? "ok" : "MISMATCH", reads);
+        if (!match || (s->run == __test_idle && reads != 0)) {
+            pass = FALSE;
+        }
+    }
+
+    PR_NOTICE("button wake-up test: %s", pass ? "PASS" : "FAIL");
+
+    tdl_button_delete(handle);
+
+__EXIT:
+    return;
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
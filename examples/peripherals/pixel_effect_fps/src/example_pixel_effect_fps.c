@@ -0,0 +1,365 @@
+/**
+ * @file example_pixel_effect_fps.c
+ * @brief Frame rate test of the LED pixel effect engine on a simulated strip.
+ *
+ * A stand-in pixel driver is registered in place of a real chip driver. It keeps a copy of every frame it is given,
+ * and can wait for the time a 800 kHz WS2812 strip takes to shift the frame out. The example reports the CPU time
+ * each effect needs to render and map a frame, runs each effect on the scheduler task and prints the frame rate it
+ * reaches, then checks that a frame is sent again in full after the pixel buffer was written through the tdl_pixel
+ * color APIs, so that the strip shows the effect and not what the API call left in the buffer.
+ *
+ * Usage on Linux: ./pixel_effect_fps
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdl_pixel_dev_manage.h"
+#include "tdl_pixel_color_manage.h"
+#include "tdl_pixel_driver.h"
+#include "tdl_pixel_effect.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_DEV_NAME   "fps_strip"
+#define TEST_PIXEL_NUM  300
+#define TEST_COLOR_NUM  3
+#define TEST_COLOR_MAX  255
+#define TEST_PIXEL_US   30 // 24 bits of 1.25 us per pixel at 800 kHz
+#define TEST_CPU_FRAMES 2000
+#define TEST_FPS        60
+#define TEST_RUN_MS     2000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    const char *name;
+    PIXEL_EFFECT_T effect;
+} TEST_EFFECT_T;
+
+typedef struct {
+    const char *name;
+    OPERATE_RET (*write)(PIXEL_HANDLE_T handle);
+} TEST_WRITE_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+static OPERATE_RET __test_write_multi(PIXEL_HANDLE_T handle);
+static OPERATE_RET __test_write_all(PIXEL_HANDLE_T handle);
+static OPERATE_RET __test_write_shift(PIXEL_HANDLE_T handle);
+static OPERATE_RET __test_write_copy(PIXEL_HANDLE_T handle);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const PIXEL_EFFECT_RGB_T sg_palette[] = {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}};
+
+static const TEST_EFFECT_T sg_test_effect[] = {
+    {"gradient", {.type = PIXEL_EFFECT_GRADIENT, .param.gradient = {{255, 40, 0}, {0, 40, 255}, 256}}},
+    {"chase", {.type = PIXEL_EFFECT_CHASE, .param.chase = {{255, 255, 255}, {0, 0, 16}, 12, 512}}},
+    {"breathe", {.type = PIXEL_EFFECT_BREATHE, .param.breathe = {{255, 120, 0}, 120}}},
+    {"palette fade", {.type = PIXEL_EFFECT_PALETTE_FADE, .param.palette = {sg_palette, 3, 30, 60}}},
+};
+
+static const TEST_WRITE_T sg_test_write[] = {
+    {"tdl_pixel_set_multi_color", __test_write_multi},
+    {"tdl_pixel_set_single_color_all", __test_write_all},
+    {"tdl_pixel_cycle_shift_color", __test_write_shift},
+    {"tdl_pixel_copy_color", __test_write_copy},
+};
+
+static unsigned short sg_strip[TEST_PIXEL_NUM * TEST_COLOR_NUM]; // Last frame the driver was given
+static unsigned short sg_expect[TEST_PIXEL_NUM * TEST_COLOR_NUM];
+static uint32_t sg_outputs;
+static BOOL_T sg_bus_wait;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __test_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static int __test_drv_open(DRIVER_HANDLE_T *handle, unsigned short pixel_num)
+{
+    *handle = (DRIVER_HANDLE_T)sg_strip;
+
+    return (pixel_num <= TEST_PIXEL_NUM) ? OPRT_OK : OPRT_INVALID_PARM;
+}
+
+static int __test_drv_close(DRIVER_HANDLE_T *handle)
+{
+    *handle = NULL;
+
+    return OPRT_OK;
+}
+
+static int __test_drv_output(DRIVER_HANDLE_T handle, unsigned short *data_buf, unsigned int buf_len)
+{
+    memcpy(sg_strip, data_buf, buf_len * sizeof(unsigned short));
+    sg_outputs++;
+
+    if (sg_bus_wait) {
+        tal_system_sleep(buf_len / TEST_COLOR_NUM * TEST_PIXEL_US / 1000);
+    }
+
+    return OPRT_OK;
+}
+
+static int __test_drv_config(DRIVER_HANDLE_T handle, unsigned char cmd, void *arg)
+{
+    return OPRT_OK;
+}
+
+static OPERATE_RET __test_write_multi(PIXEL_HANDLE_T handle)
+{
+    PIXEL_COLOR_T color[8];
+    uint32_t i = 0;
+
+    for (i = 0; i < CNTSOF(color); i++) {
+        memset(&color[i], 0, sizeof(PIXEL_COLOR_T));
+        color[i].red = TEST_COLOR_MAX;
+        color[i].blue = i * 30;
+    }
+
+    return tdl_pixel_set_multi_color(handle, 100, CNTSOF(color), color);
+}
+
+static OPERATE_RET __test_write_all(PIXEL_HANDLE_T handle)
+{
+    PIXEL_COLOR_T color;
+
+    memset(&color, 0, sizeof(PIXEL_COLOR_T));
+    color.green = TEST_COLOR_MAX;
+
+    return tdl_pixel_set_single_color_all(handle, &color);
+}
+
+static OPERATE_RET __test_write_shift(PIXEL_HANDLE_T handle)
+{
+    return tdl_pixel_cycle_shift_color(handle, PIXEL_SHIFT_RIGHT, 0, TEST_PIXEL_NUM - 1, 5);
+}
+
+static OPERATE_RET __test_write_copy(PIXEL_HANDLE_T handle)
+{
+    return tdl_pixel_copy_color(handle, 0, 150, 20);
+}
+
+static OPERATE_RET __test_open(PIXEL_HANDLE_T *handle)
+{
+    OPERATE_RET rt = OPRT_OK;
+    PIXEL_DRIVER_INTFS_T intfs = {__test_drv_open, __test_drv_close, __test_drv_output, __test_drv_config};
+    PIXEL_ATTR_T attr = {PIXEL_COLOR_TP_RGB, TEST_COLOR_MAX, FALSE};
+    PIXEL_DEV_CONFIG_T config = {TEST_PIXEL_NUM, 0};
+
+    TUYA_CALL_ERR_RETURN(tdl_pixel_driver_register(TEST_DEV_NAME, &intfs, &attr, NULL));
+    TUYA_CALL_ERR_RETURN(tdl_pixel_dev_find(TEST_DEV_NAME, handle));
+    TUYA_CALL_ERR_RETURN(tdl_pixel_dev_open(*handle, &config));
+
+    return OPRT_OK;
+}
+
+// Start an effect and take it over from the scheduler task, frames are then sent with tdl_pixel_effect_render_frame
+static OPERATE_RET __test_start_manual(PIXEL_EFFECT_HANDLE_T effect, PIXEL_EFFECT_T *param)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    TUYA_CALL_ERR_RETURN(tdl_pixel_effect_start(effect, param));
+    TUYA_CALL_ERR_RETURN(tdl_pixel_effect_stop(effect));
+
+    return OPRT_OK;
+}
+
+static void __test_cpu_time(PIXEL_EFFECT_HANDLE_T effect)
+{
+    const TEST_EFFECT_T *t = NULL;
+    PIXEL_EFFECT_T param;
+    PIXEL_EFFECT_STATS_T stats;
+    uint64_t start = 0, cost = 0, scaled = 0;
+    uint32_t n = 0, i = 0;
+
+    sg_bus_wait = FALSE;
+    for (n = 0; n < CNTSOF(sg_test_effect); n++) {
+        t = &sg_test_effect[n];
+        param = t->effect;
+        if (OPRT_OK != __test_start_manual(effect, &param)) {
+            PR_ERR("%s: start failed", t->name);
+            return;
+        }
+
+        scaled = 0;
+        start = __test_time_ns();
+        for (i = 0; i < TEST_CPU_FRAMES; i++) {
+            tdl_pixel_effect_render_frame(effect);
+            tdl_pixel_effect_get_stats(effect, &stats);
+            scaled += stats.scaled_pixels;
+        }
+        cost = __test_time_ns() - start;
+
+        PR_NOTICE("%-12s cpu %3u.%u us/frame, %3u pixels mapped/frame", t->name,
+                  (uint32_t)(cost / TEST_CPU_FRAMES / 1000), (uint32_t)(cost / TEST_CPU_FRAMES / 100 % 10),
+                  (uint32_t)(scaled / TEST_CPU_FRAMES));
+    }
+}
+
+static void __test_fps(PIXEL_EFFECT_HANDLE_T effect)
+{
+    const TEST_EFFECT_T *t = NULL;
+    PIXEL_EFFECT_T param;
+    PIXEL_EFFECT_STATS_T stats;
+    uint32_t n = 0;
+
+    sg_bus_wait = TRUE;
+    for (n = 0; n < CNTSOF(sg_test_effect); n++) {
+        t = &sg_test_effect[n];
+        param = t->effect;
+        if (OPRT_OK != tdl_pixel_effect_start(effect, &param)) {
+            PR_ERR("%s: start failed", t->name);
+            return;
+        }
+
+        tal_system_sleep(TEST_RUN_MS);
+        tdl_pixel_effect_stop(effect);
+        tdl_pixel_effect_get_stats(effect, &stats);
+
+        PR_NOTICE("%-12s target %u fps, %3u.%02u fps, %3u frames, %u dropped", t->name, TEST_FPS,
+                  stats.fps_x100 / 100, stats.fps_x100 % 100, stats.frames, stats.dropped);
+    }
+    sg_bus_wait = FALSE;
+}
+
+static BOOL_T __test_repaint(PIXEL_HANDLE_T handle, PIXEL_EFFECT_HANDLE_T effect)
+{
+    const TEST_WRITE_T *w = NULL;
+    PIXEL_EFFECT_STATS_T stats;
+    PIXEL_EFFECT_T param = {.type = PIXEL_EFFECT_CHASE, .param.chase = {{255, 255, 255}, {0, 0, 16}, 12, 0}};
+    uint32_t n = 0;
+    BOOL_T pass = TRUE;
+
+    // A chase that does not move, every frame after the first is the same
+    if (OPRT_OK != __test_start_manual(effect, &param)) {
+        PR_ERR("chase start failed");
+        return FALSE;
+    }
+    tdl_pixel_effect_render_frame(effect);
+    memcpy(sg_expect, sg_strip, sizeof(sg_expect));
+
+    tdl_pixel_effect_render_frame(effect);
+    tdl_pixel_effect_get_stats(effect, &stats);
+    PR_NOTICE("%-30s -> %3u pixels mapped", "unchanged frame", stats.scaled_pixels);
+
+    for (n = 0; n < CNTSOF(sg_test_write); n++) {
+        w = &sg_test_write[n];
+        if (OPRT_OK != w->write(handle)) {
+            PR_ERR("%s failed", w->name);
+            return FALSE;
+        }
+
+        tdl_pixel_effect_render_frame(effect);
+        tdl_pixel_effect_get_stats(effect, &stats);
+        if (memcmp(sg_strip, sg_expect, sizeof(sg_expect))) {
+            pass = FALSE;
+        }
+
+        PR_NOTICE("%-30s -> %3u pixels mapped, strip %s", w->name, stats.scaled_pixels,
+                  memcmp(sg_strip, sg_expect, sizeof(sg_expect)) ? "STALE" : "repainted");
+    }
+
+    return pass;
+}
+
+static void __test_main(void)
+{
+    PIXEL_HANDLE_T handle = NULL;
+    PIXEL_EFFECT_HANDLE_T effect = NULL;
+    PIXEL_EFFECT_CFG_T cfg = {TEST_FPS, 200, 0};
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    if (OPRT_OK != __test_open(&handle)) {
+        PR_ERR("pixel device open failed");
+        return;
+    }
+
+    if (OPRT_OK != tdl_pixel_effect_create(handle, &cfg, &effect)) {
+        PR_ERR("pixel effect create failed");
+        return;
+    }
+
+    PR_NOTICE("%u pixels, %u us bus time per frame", TEST_PIXEL_NUM, TEST_PIXEL_NUM * TEST_PIXEL_US);
+    __test_cpu_time(effect);
+    __test_fps(effect);
+    PR_NOTICE("repaint after write APIs: %s", __test_repaint(handle, effect) ? "PASS" : "FAIL");
+    PR_NOTICE("%u frames sent to the driver", sg_outputs);
+
+    tdl_pixel_effect_destroy(effect);
+    tdl_pixel_dev_close(handle);
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file example_pixel_encode_bench.c
+ * @brief Benchmark of the table-driven SPI encoder of the LED pixel drivers.
+ *
+ * tdd_pixel_spi_encode converts a whole color buffer to the SPI stream of a pixel chip with a nibble table built
+ * from the protocol descriptor. The example encodes a 1024 pixel strip with the 8bit WS2812 codes, the 4bit codes of
+ * the *_opt drivers with their 0~10000 color scale, and 3bit codes, next to the per-pixel loops the drivers used
+ * before (line sequence swap, then a bit loop or an if/else chain per color byte). It checks that both give the
+ * same stream for every line sequence and reports the encode time per pixel.
+ *
+ * Usage on Linux: ./pixel_encode_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "tdd_pixel_basic.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_PIXEL_NUM 1024
+#define BENCH_COLOR_NUM 3
+#define BENCH_ROUNDS    2000
+
+#define BENCH_SCALE_MAX 10000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void (*BENCH_LOOP_CB)(const unsigned short *data_buf, RGB_ORDER_MODE_E line_seq, unsigned char *spi_buf);
+
+typedef struct {
+    const char *name;
+    PIXEL_SPI_PROTOCOL_T protocol;
+    BENCH_LOOP_CB loop; // Per-pixel path of the drivers, NULL when there is none
+} BENCH_CASE_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+static void __bench_loop_8bit(const unsigned short *data_buf, RGB_ORDER_MODE_E line_seq, unsigned char *spi_buf);
+static void __bench_loop_4bit(const unsigned short *data_buf, RGB_ORDER_MODE_E line_seq, unsigned char *spi_buf);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const BENCH_CASE_T sg_bench_case[] = {
+    {"8bit ws2812", {PIXEL_SPI_CODE_8BIT, 0xC0, 0xF0, BENCH_COLOR_NUM, 255}, __bench_loop_8bit},
+    {"4bit opt 0~10000", {PIXEL_SPI_CODE_4BIT, 0x08, 0x0E, BENCH_COLOR_NUM, BENCH_SCALE_MAX}, __bench_loop_4bit},
+    {"3bit", {PIXEL_SPI_CODE_3BIT, 0x04, 0x06, BENCH_COLOR_NUM, 255}, NULL},
+};
+
+static unsigned short sg_color[BENCH_PIXEL_NUM * BENCH_COLOR_NUM];
+static unsigned char sg_spi[2][BENCH_PIXEL_NUM * BENCH_COLOR_NUM * PIXEL_SPI_CODE_8BIT];
+static volatile unsigned int sg_sink;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+/* tdd_pixel_ws2812.c before the encoder */
+static void __bench_loop_8bit(const unsigned short *data_buf, RGB_ORDER_MODE_E line_seq, unsigned char *spi_buf)
+{
+    unsigned short swap_buf[BENCH_COLOR_NUM] = {0};
+    unsigned int i = 0, j = 0, idx = 0;
+
+    for (j = 0; j < BENCH_PIXEL_NUM; j++) {
+        memset(swap_buf, 0, sizeof(swap_buf));
+        tdd_rgb_line_seq_transform((unsigned short *)&data_buf[j * BENCH_COLOR_NUM], swap_buf, line_seq);
+        for (i = 0; i < BENCH_COLOR_NUM; i++) {
+            tdd_rgb_transform_spi_data((unsigned char)swap_buf[i], 0xC0, 0xF0, &spi_buf[idx]);
+            idx += ONE_BYTE_LEN;
+        }
+    }
+}
+
+static void __bench_4bit_transform(unsigned char color_data, unsigned char *spi_data_buf)
+{
+    unsigned char i = 0;
+
+    for (i = 0; i < PIXEL_SPI_CODE_4BIT; i++) {
+        if ((color_data & 0xc0) == 0) {
+            spi_data_buf[i] = 0x88;
+        } else if ((color_data & 0xc0) == 0x40) {
+            spi_data_buf[i] = 0x8e;
+        } else if ((color_data & 0xc0) == 0x80) {
+            spi_data_buf[i] = 0xe8;
+        } else {
+            spi_data_buf[i] = 0xee;
+        }
+        color_data = color_data << 2;
+    }
+}
+
+/* tdd_pixel_ws2812_opt.c before the encoder */
+static void __bench_loop_4bit(const unsigned short *data_buf, RGB_ORDER_MODE_E line_seq, unsigned char *spi_buf)
+{
+    unsigned short swap_buf[BENCH_COLOR_NUM] = {0};
+    unsigned int i = 0, j = 0, idx = 0;
+
+    for (j = 0; j < BENCH_PIXEL_NUM; j++) {
+        memset(swap_buf, 0, sizeof(swap_buf));
+        tdd_rgb_line_seq_transform((unsigned short *)&data_buf[j * BENCH_COLOR_NUM], swap_buf, line_seq);
+        for (i = 0; i < BENCH_COLOR_NUM; i++) {
+            __bench_4bit_transform((unsigned char)(swap_buf[i] * 255 / BENCH_SCALE_MAX), &spi_buf[idx]);
+            idx += PIXEL_SPI_CODE_4BIT;
+        }
+    }
+}
+
+static void __bench_main(void)
+{
+    const BENCH_CASE_T *c = NULL;
+    PIXEL_SPI_ENCODER_T encoder;
+    RGB_ORDER_MODE_E line_seq;
+    uint64_t start, loop_ns, encode_ns;
+    unsigned int i, n, len, seed = 1;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    for (n = 0; n < CNTSOF(sg_bench_case); n++) {
+        c = &sg_bench_case[n];
+
+        if (OPRT_OK != tdd_pixel_spi_encoder_init(&c->protocol, &encoder)) {
+            PR_ERR("%s: encoder init failed", c->name);
+            return;
+        }
+        len = tdd_pixel_spi_encode_len(&c->protocol, BENCH_PIXEL_NUM);
+
+        for (i = 0; i < CNTSOF(sg_color); i++) {
+            seed = seed * 1103515245 + 12345;
+            sg_color[i] = (seed >> 8) % (c->protocol.color_max + 1);
+        }
+
+        if (c->loop) {
+            for (line_seq = RGB_ORDER; line_seq <= BGR_ORDER; line_seq++) {
+                c->loop(sg_color, line_seq, sg_spi[0]);
+                tdd_pixel_spi_encode(&encoder, sg_color, BENCH_PIXEL_NUM, BENCH_COLOR_NUM, line_seq, sg_spi[1]);
+                if (memcmp(sg_spi[0], sg_spi[1], len)) {
+                    PR_ERR("%s: encoder output differs from the per-pixel loop, line sequence %u", c->name,
+                           line_seq);
+                    return;
+                }
+            }
+        }
+
+        loop_ns = 0;
+        if (c->loop) {
+            start = __bench_time_ns();
+            for (i = 0; i < BENCH_ROUNDS; i++) {
+                c->loop(sg_color, GRB_ORDER, sg_spi[0]);
+                sg_sink += sg_spi[0][i % len];
+            }
+            loop_ns = __bench_time_ns() - start;
+        }
+
+        start = __bench_time_ns();
+        for (i = 0; i < BENCH_ROUNDS; i++) {
+            sg_sink += tdd_pixel_spi_encode(&encoder, sg_color, BENCH_PIXEL_NUM, BENCH_COLOR_NUM, GRB_ORDER, sg_spi[1]);
+        }
+        encode_ns = __bench_time_ns() - start;
+
+        if (c->loop) {
+            PR_NOTICE("%-16s %5u B/frame, loop %3u.%u ns/pixel, encoder %3u.%u ns/pixel, x%u.%u", c->name, len,
+                      (uint32_t)(loop_ns / BENCH_ROUNDS / BENCH_PIXEL_NUM),
+                      (uint32_t)(loop_ns * 10 / BENCH_ROUNDS / BENCH_PIXEL_NUM % 10),
+                      (uint32_t)(encode_ns / BENCH_ROUNDS / BENCH_PIXEL_NUM),
+                      (uint32_t)(encode_ns * 10 / BENCH_ROUNDS / BENCH_PIXEL_NUM % 10), (uint32_t)(loop_ns / encode_ns),
+                      (uint32_t)(loop_ns * 10 / encode_ns % 10));
+        } else {
+            PR_NOTICE("%-16s %5u B/frame, encoder %3u.%u ns/pixel", c->name, len,
+                      (uint32_t)(encode_ns / BENCH_ROUNDS / BENCH_PIXEL_NUM),
+                      (uint32_t)(encode_ns * 10 / BENCH_ROUNDS / BENCH_PIXEL_NUM % 10));
+        }
+    }
+    PR_NOTICE("encoder output matched the per-pixel loops for all %u line sequences", BGR_ORDER + 1);
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,351 @@
+/**
+ * @file example_uart_pty_test.c
+ * @brief Test of tal_uart bulk transfer and rx overflow on a Linux pseudo terminal.
+ *
+ * UART 0 of the Linux platform reads and writes stdin. The example points stdin at the slave side of a pty and plays
+ * the peer on the master side:
+ * - rx: the peer sends a counting pattern and keeps no more than half the rx buffer in flight, the way RTS flow
+ *   control would. tal_uart_read must return the pattern in order and nothing may be dropped.
+ * - overflow: the peer sends far more than the rx buffer holds while nobody reads. The rx buffer keeps the first
+ *   bytes, the rest is dropped and counted, and the rx callback must not spin on the pending data.
+ * - tx: tal_uart_write sends a pattern, the peer must receive it in order.
+ *
+ * Usage on Linux: ./uart_pty_test
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+/* posix_openpt and ptsname */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tal_uart.h"
+#include "tkl_output.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_UART_NUM       TUYA_UART_NUM_0
+#define TEST_RX_BUFFER_SIZE (16 * 1024)
+#define TEST_RX_WINDOW      (TEST_RX_BUFFER_SIZE / 2)
+#define TEST_RX_BYTES       (4 * 1024 * 1024)
+#define TEST_OVERFLOW_BYTES (256 * 1024)
+#define TEST_TX_BYTES       (256 * 1024)
+#define TEST_CHUNK          4096
+
+/* cpu time allowed while the rx buffer is full and the line idle */
+#define TEST_IDLE_MS     500
+#define TEST_IDLE_CPU_MS 50
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static int sg_master_fd = -1;
+static volatile uint32_t sg_peer_bytes;
+static volatile uint32_t sg_peer_window; // bytes the peer may send ahead of sg_read_bytes, 0 for no limit
+static volatile uint32_t sg_read_bytes;
+static uint32_t sg_peer_errors;
+static THREAD_HANDLE sg_peer_thread;
+static SEM_HANDLE sg_peer_sem;
+static SEM_HANDLE sg_window_sem;
+static uint8_t sg_buf[TEST_CHUNK];
+static uint8_t sg_tx_buf[TEST_TX_BYTES];
+#endif
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+static uint64_t __test_time_ms(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+/* stdin becomes the slave side of a raw pty, the master side is the peer */
+static OPERATE_RET __pty_open(void)
+{
+    struct termios term;
+    int slave_fd;
+
+    sg_master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (sg_master_fd < 0 || grantpt(sg_master_fd) || unlockpt(sg_master_fd)) {
+        return OPRT_COM_ERROR;
+    }
+
+    slave_fd = open(ptsname(sg_master_fd), O_RDWR | O_NOCTTY);
+    if (slave_fd < 0) {
+        return OPRT_COM_ERROR;
+    }
+    tcgetattr(slave_fd, &term);
+    cfmakeraw(&term);
+    tcsetattr(slave_fd, TCSANOW, &term);
+
+    dup2(slave_fd, STDIN_FILENO);
+    close(slave_fd);
+
+    return OPRT_OK;
+}
+
+/* the peer sends arg bytes of the counting pattern */
+static void __peer_send_task(void *arg)
+{
+    uint32_t total = (uint32_t)(uintptr_t)arg, i, len;
+    uint8_t buf[TEST_CHUNK];
+    int ret;
+
+    sg_peer_bytes = 0;
+    while (sg_peer_bytes < total) {
+        len = total - sg_peer_bytes < TEST_CHUNK ? total - sg_peer_bytes : TEST_CHUNK;
+        if (sg_peer_window && sg_peer_bytes + len - sg_read_bytes > sg_peer_window) {
+            tal_semaphore_wait(sg_window_sem, 10);
+            continue;
+        }
+        for (i = 0; i < len; i++) {
+            buf[i] = (uint8_t)(sg_peer_bytes + i);
+        }
+        ret = write(sg_master_fd, buf, len);
+        if (ret <= 0) {
+            break;
+        }
+        sg_peer_bytes += ret;
+    }
+
+    tal_semaphore_post(sg_peer_sem);
+    tal_thread_delete(sg_peer_thread);
+    sg_peer_thread = NULL;
+}
+
+/* the peer receives arg bytes and checks the counting pattern */
+static void __peer_recv_task(void *arg)
+{
+    uint32_t total = (uint32_t)(uintptr_t)arg;
+    uint8_t buf[TEST_CHUNK];
+    int ret, i;
+
+    sg_peer_bytes = 0;
+    sg_peer_errors = 0;
+    while (sg_peer_bytes < total) {
+        ret = read(sg_master_fd, buf, sizeof(buf));
+        if (ret <= 0) {
+            break;
+        }
+        for (i = 0; i < ret; i++) {
+            if (buf[i] != (uint8_t)(sg_peer_bytes + i)) {
+                sg_peer_errors++;
+            }
+        }
+        sg_peer_bytes += ret;
+    }
+
+    tal_semaphore_post(sg_peer_sem);
+    tal_thread_delete(sg_peer_thread);
+    sg_peer_thread = NULL;
+}
+
+static void __peer_start(void (*task)(void *), uint32_t bytes)
+{
+    THREAD_CFG_T cfg = {8192, THREAD_PRIO_2, "uart_peer"};
+
+    tal_thread_create_and_start(&sg_peer_thread, NULL, NULL, task, (void *)(uintptr_t)bytes, &cfg);
+}
+
+static BOOL_T __test_rx(void)
+{
+    uint32_t got = 0, errors = 0, i;
+    uint64_t start, ms;
+    int ret;
+
+    sg_read_bytes = 0;
+    sg_peer_window = TEST_RX_WINDOW;
+    __peer_start(__peer_send_task, TEST_RX_BYTES);
+    start = __test_time_ms(CLOCK_MONOTONIC);
+    while (got < TEST_RX_BYTES) {
+        ret = tal_uart_read(TEST_UART_NUM, sg_buf, sizeof(sg_buf));
+        if (ret < 0) {
+            break;
+        }
+        for (i = 0; i < (uint32_t)ret; i++) {
+            if (sg_buf[i] != (uint8_t)(got + i)) {
+                errors++;
+            }
+        }
+        got += ret;
+        sg_read_bytes = got;
+        tal_semaphore_post(sg_window_sem);
+    }
+    ms = __test_time_ms(CLOCK_MONOTONIC) - start;
+    tal_semaphore_wait(sg_peer_sem, SEM_WAIT_FOREVER);
+    sg_peer_window = 0;
+
+    PR_NOTICE("rx: %u bytes in %u ms, %u KB/s, %u mismatches, %d dropped", got, (uint32_t)ms,
+              ms ? (uint32_t)(got / ms * 1000 / 1024) : 0, errors, tal_uart_get_rx_overflow(TEST_UART_NUM));
+
+    return (got == TEST_RX_BYTES) && (errors == 0) && (tal_uart_get_rx_overflow(TEST_UART_NUM) == 0);
+}
+
+static BOOL_T __test_overflow(void)
+{
+    uint32_t kept = 0, errors = 0, dropped, i;
+    uint64_t cpu_ms;
+    int ret;
+
+    /* nobody reads, the peer must still get rid of everything */
+    __peer_start(__peer_send_task, TEST_OVERFLOW_BYTES);
+    if (tal_semaphore_wait(sg_peer_sem, 5000) != OPRT_OK) {
+        PR_ERR("overflow: the peer is blocked, the rx callback does not drain the line");
+        return FALSE;
+    }
+
+    /* the line is idle and the rx buffer full, the rx callback must be quiet */
+    cpu_ms = __test_time_ms(CLOCK_PROCESS_CPUTIME_ID);
+    tal_system_sleep(TEST_IDLE_MS);
+    cpu_ms = __test_time_ms(CLOCK_PROCESS_CPUTIME_ID) - cpu_ms;
+
+    while (tal_uart_get_rx_data_size(TEST_UART_NUM) > 0) {
+        ret = tal_uart_read(TEST_UART_NUM, sg_buf, sizeof(sg_buf));
+        for (i = 0; i < (uint32_t)ret; i++) {
+            if (sg_buf[i] != (uint8_t)(kept + i)) {
+                errors++;
+            }
+        }
+        kept += ret;
+    }
+    dropped = tal_uart_get_rx_overflow(TEST_UART_NUM);
+
+    PR_NOTICE("overflow: sent %u, kept %u, dropped %u, %u mismatches, cpu %u ms in %u ms idle", sg_peer_bytes, kept,
+              dropped, errors, (uint32_t)cpu_ms, TEST_IDLE_MS);
+
+    return (kept + dropped == TEST_OVERFLOW_BYTES) && (errors == 0) && (cpu_ms < TEST_IDLE_CPU_MS);
+}
+
+static BOOL_T __test_tx(void)
+{
+    uint32_t sent = 0, calls = 0, i;
+    int ret;
+
+    for (i = 0; i < sizeof(sg_tx_buf); i++) {
+        sg_tx_buf[i] = (uint8_t)i;
+    }
+
+    __peer_start(__peer_recv_task, TEST_TX_BYTES);
+    while (sent < TEST_TX_BYTES) {
+        // the pty is non-blocking, a full pty buffer ends the write early
+        ret = tal_uart_write(TEST_UART_NUM, &sg_tx_buf[sent], TEST_TX_BYTES - sent);
+        calls++;
+        if (ret < 0) {
+            break;
+        }
+        if (ret == 0) {
+            tal_system_sleep(1);
+        }
+        sent += ret;
+    }
+    if (tal_semaphore_wait(sg_peer_sem, 5000) != OPRT_OK) {
+        PR_ERR("tx: the peer did not receive everything");
+        return FALSE;
+    }
+
+    PR_NOTICE("tx: %u bytes in %u tal_uart_write calls, peer got %u, %u mismatches", sent, calls, sg_peer_bytes,
+              sg_peer_errors);
+
+    return (sg_peer_bytes == TEST_TX_BYTES) && (sg_peer_errors == 0);
+}
+#endif
+
+static void __test_main(void)
+{
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    OPERATE_RET rt = OPRT_OK;
+    TAL_UART_CFG_T cfg = {0};
+    BOOL_T pass;
+
+    TUYA_CALL_ERR_GOTO(__pty_open(), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_peer_sem, 0, 1), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_semaphore_create_init(&sg_window_sem, 0, 1), __EXIT);
+
+    cfg.base_cfg.baudrate = 921600;
+    cfg.base_cfg.databits = TUYA_UART_DATA_LEN_8BIT;
+    cfg.base_cfg.stopbits = TUYA_UART_STOP_LEN_1BIT;
+    cfg.base_cfg.parity = TUYA_UART_PARITY_TYPE_NONE;
+    cfg.rx_buffer_size = TEST_RX_BUFFER_SIZE;
+    cfg.open_mode = O_BLOCK;
+    TUYA_CALL_ERR_GOTO(tal_uart_init(TEST_UART_NUM, &cfg), __EXIT);
+
+    pass = __test_rx();
+    pass = __test_overflow() && pass;
+    pass = __test_tx() && pass;
+    PR_NOTICE("uart pty test %s", pass ? "PASS" : "FAIL");
+
+__EXIT:
+    return;
+#else
+    PR_NOTICE("uart pty test runs on Linux only");
+#endif
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file example_matop_tracker_bench.c
+ * @brief Benchmark of the MATOP outstanding message tracker.
+ *
+ * The example tracks N outstanding requests with the deadline heap and the id hash buckets of the MATOP service and
+ * reports the cost of an idle yield, of matching a response by id and of expiring every request at once. The same
+ * operations on a plain list, walked from the head, are reported next to them for comparison.
+ *
+ * Usage on Linux: ./matop_tracker_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#include "matop_service.h"
+#include "matop_tracker.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_MAX_MESSAGES 4096
+#define BENCH_ROUNDS       20000
+#define BENCH_DEADLINE_MS  (60 * 1000)
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint32_t sg_counts[] = {16, 64, 256, 1024, 4096};
+
+static mqtt_atop_message_t *sg_list[BENCH_MAX_MESSAGES];
+static uint32_t sg_expired;
+static volatile uint32_t sg_sink;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static void __bench_notify_cb(atop_base_response_t *response, void *user_data)
+{
+    sg_expired++;
+}
+
+static mqtt_atop_message_t *__bench_message_new(uint16_t id, SYS_TIME_T timeout)
+{
+    mqtt_atop_message_t *message = tal_malloc(sizeof(mqtt_atop_message_t));
+    if (NULL == message) {
+        return NULL;
+    }
+    memset(message, 0, sizeof(mqtt_atop_message_t));
+    message->id = id;
+    message->timeout = timeout;
+    message->notify_cb = __bench_notify_cb;
+    return message;
+}
+
+/* the list baseline: every yield checks every message, every response searches from the head */
+static uint32_t __bench_list_yield(uint32_t count, SYS_TIME_T now)
+{
+    uint32_t overdue = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (sg_list[i]->timeout < now) {
+            overdue++;
+        }
+    }
+    return overdue;
+}
+
+static uint32_t __bench_list_take(uint32_t count, uint16_t id)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (sg_list[i]->id == id) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static void __bench_run(uint32_t count)
+{
+    matop_context_t ctx;
+    uint64_t start, heap_yield_ns, heap_take_ns, heap_expire_ns, list_yield_ns, list_take_ns;
+    SYS_TIME_T now = tal_system_get_millisecond();
+    uint32_t i, tracked = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    sg_expired = 0;
+
+    for (i = 0; i < count; i++) {
+        mqtt_atop_message_t *message = __bench_message_new(i + 1, now + BENCH_DEADLINE_MS + i);
+        if (NULL == message) {
+            PR_ERR("message malloc fail");
+            goto __EXIT;
+        }
+        if (OPRT_OK != matop_message_track(&ctx, message)) {
+            PR_ERR("message track fail");
+            tal_free(message);
+            goto __EXIT;
+        }
+        sg_list[tracked++] = message;
+    }
+
+    /* nothing is due: the tracker only looks at the top of the heap */
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        matop_serice_yield(&ctx);
+    }
+    heap_yield_ns = __bench_time_ns() - start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sg_sink += __bench_list_yield(count, now);
+    }
+    list_yield_ns = __bench_time_ns() - start;
+
+    /* a response arrives for a random outstanding request, which is then reissued */
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        mqtt_atop_message_t *message = matop_message_take(&ctx, (uint16_t)(1 + (i * 2654435761U) % count));
+        if (message) {
+            message->timeout = now + BENCH_DEADLINE_MS + count + i;
+            matop_message_track(&ctx, message);
+        }
+    }
+    heap_take_ns = __bench_time_ns() - start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sg_sink += __bench_list_take(count, (uint16_t)(1 + (i * 2654435761U) % count));
+    }
+    list_take_ns = __bench_time_ns() - start;
+
+    /* everything is overdue: one yield expires it all */
+    for (i = 0; i < ctx.message_count; i++) {
+        ctx.message_heap[i]->timeout = 0;
+    }
+    start = __bench_time_ns();
+    matop_serice_yield(&ctx);
+    heap_expire_ns = __bench_time_ns() - start;
+    tracked = 0;
+
+    PR_NOTICE("%5u msgs | yield %6llu ns (list %8llu ns) | take+track %6llu ns (list %8llu ns) | expire %6llu ns/msg, "
+              "%u expired",
+              count, heap_yield_ns / BENCH_ROUNDS, list_yield_ns / BENCH_ROUNDS, heap_take_ns / BENCH_ROUNDS,
+              list_take_ns / BENCH_ROUNDS, heap_expire_ns / count, sg_expired);
+
+__EXIT:
+    /* the bench context has no MQTT client, so it is torn down by hand instead of matop_serice_destory */
+    for (i = 0; i < tracked; i++) {
+        mqtt_atop_message_t *message = matop_message_take(&ctx, sg_list[i]->id);
+        if (message) {
+            tal_free(message);
+        }
+    }
+    if (ctx.message_heap) {
+        tal_free(ctx.message_heap);
+    }
+}
+
+static void __bench_main(void)
+{
+    uint32_t i;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    PR_NOTICE("matop tracker benchmark, %d rounds", BENCH_ROUNDS);
+    for (i = 0; i < CNTSOF(sg_counts); i++) {
+        __bench_run(sg_counts[i]);
+    }
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
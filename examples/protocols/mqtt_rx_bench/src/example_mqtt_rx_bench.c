@@ -0,0 +1,290 @@
+/**
+ * @file example_mqtt_rx_bench.c
+ * @brief Receive throughput benchmark of the MQTT client over loopback.
+ *
+ * The MQTT client serves coreMQTT's small reads (fixed header, remaining length, payload) from a receive buffer that
+ * is filled by one transport read. The example runs a minimal MQTT broker on the loopback interface which sends bursts
+ * of QoS 0 PUBLISH packets, and reports the CPU time of the receiving task per message for several payload sizes.
+ *
+ * Usage on Linux: ./mqtt_rx_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tal_network.h"
+#include "tkl_output.h"
+
+#include "core_mqtt_config.h"
+#include "mqtt_client_interface.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_BROKER_PORT 18831
+#define BENCH_MSG_CNT     20000
+#define BENCH_BURST_BYTES (16 * 1024)
+#define BENCH_TOPIC       "bench/rx"
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint32_t sg_sizes[] = {16, 64, 256, 1024};
+
+static THREAD_HANDLE sg_broker_thread;
+static volatile uint32_t sg_rx_cnt;
+static volatile uint32_t sg_rx_bytes;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static uint32_t __mqtt_len_encode(uint8_t *out, uint32_t len)
+{
+    uint32_t n = 0;
+
+    do {
+        out[n] = len & 0x7F;
+        len >>= 7;
+        if (len) {
+            out[n] |= 0x80;
+        }
+        n++;
+    } while (len);
+    return n;
+}
+
+static int __broker_packet_read(int fd, uint8_t *type, uint8_t *body, uint32_t size)
+{
+    uint8_t byte;
+    uint32_t len = 0, shift = 0;
+
+    if (tal_net_recv_nd_size(fd, type, 1, 1) != 1) {
+        return -1;
+    }
+    do {
+        if (tal_net_recv_nd_size(fd, &byte, 1, 1) != 1) {
+            return -1;
+        }
+        len |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while ((byte & 0x80) && shift < 28);
+    if (len > size || (len && tal_net_recv_nd_size(fd, body, size, len) != (int)len)) {
+        return -1;
+    }
+    return len;
+}
+
+/* blast BENCH_MSG_CNT publishes, many packets per send like a busy cloud connection */
+static void __broker_blast(int fd, uint32_t payload_len)
+{
+    uint8_t *burst = tal_malloc(BENCH_BURST_BYTES + 2048);
+    uint32_t topic_len = strlen(BENCH_TOPIC);
+    uint32_t sent = 0, fill = 0;
+
+    if (NULL == burst) {
+        return;
+    }
+
+    while (sent < BENCH_MSG_CNT) {
+        uint8_t *p = burst + fill;
+        *p++ = 0x30;
+        p += __mqtt_len_encode(p, 2 + topic_len + payload_len);
+        *p++ = topic_len >> 8;
+        *p++ = topic_len & 0xFF;
+        memcpy(p, BENCH_TOPIC, topic_len);
+        p += topic_len;
+        memset(p, 'x', payload_len);
+        p += payload_len;
+        fill = p - burst;
+        sent++;
+        if (fill >= BENCH_BURST_BYTES || sent == BENCH_MSG_CNT) {
+            if (tal_net_send(fd, burst, fill) != (int)fill) {
+                break;
+            }
+            fill = 0;
+        }
+    }
+    tal_free(burst);
+}
+
+static void __broker_task(void *arg)
+{
+    int listen_fd = (int)(intptr_t)arg;
+    static uint8_t body[2048];
+    TUYA_IP_ADDR_T addr;
+    uint16_t port;
+    uint8_t type;
+    int len;
+
+    int fd = tal_net_accept(listen_fd, &addr, &port);
+    while (fd >= 0 && (len = __broker_packet_read(fd, &type, body, sizeof(body))) >= 0) {
+        switch (type & 0xF0) {
+        case 0x10: // CONNECT
+            tal_net_send(fd, (uint8_t[]){0x20, 0x02, 0x00, 0x00}, 4);
+            break;
+
+        case 0x80: // SUBSCRIBE, the requested payload size follows the topic filter
+            tal_net_send(fd, (uint8_t[]){0x90, 0x03, body[0], body[1], 0x00}, 5);
+            __broker_blast(fd, (uint32_t)atoi((char *)body + 4 + strlen(BENCH_TOPIC) + 1));
+            break;
+
+        case 0xA0: // UNSUBSCRIBE
+            tal_net_send(fd, (uint8_t[]){0xB0, 0x02, body[0], body[1]}, 4);
+            break;
+
+        case 0xC0: // PINGREQ
+            tal_net_send(fd, (uint8_t[]){0xD0, 0x00}, 2);
+            break;
+
+        default:
+            break;
+        }
+        if ((type & 0xF0) == 0xE0) { // DISCONNECT
+            break;
+        }
+    }
+    if (fd >= 0) {
+        tal_net_close(fd);
+    }
+    tal_net_close(listen_fd);
+    tal_thread_delete(sg_broker_thread);
+}
+
+static void __on_message(void *client, uint16_t msgid, const mqtt_client_message_t *msg, void *userdata)
+{
+    sg_rx_cnt++;
+    sg_rx_bytes += msg->length;
+}
+
+static void __bench_main(void)
+{
+    THREAD_CFG_T cfg = {4096, THREAD_PRIO_2, "bench_broker"};
+    char topic[32];
+    uint32_t i;
+    void *client = NULL;
+
+    tal_log_init(TAL_LOG_LEVEL_NOTICE, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    int listen_fd = tal_net_socket_create(PROTOCOL_TCP);
+    if (listen_fd < 0 || OPRT_OK != tal_net_set_reuse(listen_fd) ||
+        OPRT_OK != tal_net_bind(listen_fd, TY_IPADDR_LOOPBACK, BENCH_BROKER_PORT) ||
+        OPRT_OK != tal_net_listen(listen_fd, 1)) {
+        PR_ERR("broker listen on port %d fail", BENCH_BROKER_PORT);
+        return;
+    }
+    tal_thread_create_and_start(&sg_broker_thread, NULL, NULL, __broker_task, (void *)(intptr_t)listen_fd, &cfg);
+
+    client = mqtt_client_new();
+    if (NULL == client) {
+        return;
+    }
+    const mqtt_client_config_t config = {.host = "127.0.0.1",
+                                         .port = BENCH_BROKER_PORT,
+                                         .keepalive = 60,
+                                         .timeout_ms = 2000,
+                                         .clientid = "bench",
+                                         .username = "bench",
+                                         .password = "bench",
+                                         .on_message = __on_message};
+    if (MQTT_STATUS_SUCCESS != mqtt_client_init(client, &config) ||
+        MQTT_STATUS_SUCCESS != mqtt_client_connect(client)) {
+        PR_ERR("mqtt connect fail");
+        mqtt_client_free(client);
+        return;
+    }
+
+    PR_NOTICE("mqtt rx benchmark, %d messages per size, rx buffer %d bytes", BENCH_MSG_CNT,
+              MQTT_CLIENT_RX_BUFFER_SIZE);
+    for (i = 0; i < CNTSOF(sg_sizes); i++) {
+        uint32_t start_ms = tal_system_get_millisecond();
+        uint64_t start;
+
+        sg_rx_cnt = 0;
+        sg_rx_bytes = 0;
+        snprintf(topic, sizeof(topic), "%s/%u", BENCH_TOPIC, sg_sizes[i]);
+        start = __bench_time_ns();
+        mqtt_client_subscribe(client, topic, 0);
+        while (sg_rx_cnt < BENCH_MSG_CNT && tal_system_get_millisecond() - start_ms < 10000) {
+            if (MQTT_STATUS_SUCCESS != mqtt_client_yield(client)) {
+                break;
+            }
+        }
+        uint64_t cpu_ns = __bench_time_ns() - start;
+        uint32_t wall_ms = tal_system_get_millisecond() - start_ms;
+
+        PR_NOTICE("payload %4u: %u msgs in %u ms, cpu %llu ns/msg, %u KB/s", sg_sizes[i], sg_rx_cnt, wall_ms,
+                  sg_rx_cnt ? cpu_ns / sg_rx_cnt : 0, wall_ms ? sg_rx_bytes / wall_ms : 0);
+    }
+
+    mqtt_client_disconnect(client);
+    mqtt_client_deinit(client);
+    mqtt_client_free(client);
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
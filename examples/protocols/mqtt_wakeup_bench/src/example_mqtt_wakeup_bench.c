@@ -0,0 +1,613 @@
+/**
+ * @file example_mqtt_wakeup_bench.c
+ * @brief Latency and wake-up test of the Tuya MQTT loop and the Tuya IoT task.
+ *
+ * The loop task of the MQTT service sleeps on the socket and is woken by tuya_mqtt_wakeup when a publish is queued
+ * from another task. The example runs a minimal MQTT broker on the loopback interface, connects the MQTT service to it
+ * and reports:
+ *  - how often the idle loop task wakes up,
+ *  - the time from queuing an asynchronous publish to its first byte at the broker,
+ *  - the time from queuing it to the PUBACK callback, the loop task is woken by socket readiness.
+ *
+ * It then runs the whole Tuya IoT client against the same broker, over TLS with a self-signed certificate stored as
+ * the endpoint certificate, and reports:
+ *  - how often the IoT task wakes up in tuya_iot_yield before tuya_iot_start and while online and idle,
+ *  - the time from tuya_iot_start to the TLS handshake, the MQTT CONNECT and the TUYA_EVENT_MQTT_CONNECTED event.
+ * The client is seeded as an activated device with an unchanged version, so the start does not need the cloud.
+ *
+ * Usage on Linux: ./mqtt_wakeup_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tal_network.h"
+#include "tkl_output.h"
+#include "tuya_config_defaults.h"
+
+#include "mqtt_service.h"
+#include "tuya_endpoint.h"
+#include "tuya_iot.h"
+#include "tuya_tls.h"
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_BROKER_PORT 18830
+#define BENCH_PUBLISH_CNT 50
+#define BENCH_IDLE_MS     (6 * 1000)
+#define BENCH_GAP_MS      100
+
+#define BENCH_IOT_NAMESPACE "bench_iot"
+#define BENCH_IOT_SCHEMA_ID "bench_schema"
+#define BENCH_IOT_SOFT_VER  "1.0.0"
+#define BENCH_IOT_CERT_CN   "CN=127.0.0.1"
+
+/* MQTT control packet types */
+#define BENCH_MQTT_CONNECT     0x10
+#define BENCH_MQTT_PUBLISH     0x30
+#define BENCH_MQTT_SUBSCRIBE   0x80
+#define BENCH_MQTT_UNSUBSCRIBE 0xA0
+#define BENCH_MQTT_PINGREQ     0xC0
+#define BENCH_MQTT_DISCONNECT  0xE0
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    int fd;
+    mbedtls_ssl_context *ssl; // NULL on plain TCP
+} BENCH_CONN_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static tuya_mqtt_context_t sg_mqctx;
+static THREAD_HANDLE sg_broker_thread;
+static THREAD_HANDLE sg_loop_thread;
+static volatile bool sg_running;
+static volatile uint32_t sg_loop_cnt;
+
+static SEM_HANDLE sg_broker_sem;
+static SEM_HANDLE sg_ack_sem;
+static volatile uint64_t sg_broker_rx_ns;
+static volatile uint64_t sg_ack_ns;
+
+/* Tuya IoT run: the broker speaks TLS with a self-signed certificate */
+static bool sg_broker_tls;
+static mbedtls_pk_context sg_tls_key;
+static mbedtls_x509_crt sg_tls_crt;
+static mbedtls_ssl_config sg_tls_conf;
+static uint8_t sg_tls_der[1024];
+static size_t sg_tls_der_len;
+
+static tuya_iot_client_t sg_iot_client;
+static THREAD_HANDLE sg_iot_thread;
+static volatile uint32_t sg_iot_cnt;
+static SEM_HANDLE sg_online_sem;
+static volatile uint64_t sg_tls_ns;
+static volatile uint64_t sg_connect_ns;
+static volatile uint64_t sg_online_ns;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static int __broker_recv(BENCH_CONN_T *conn, uint8_t *buf, uint32_t len)
+{
+    uint32_t got = 0;
+
+    if (conn->ssl == NULL) {
+        return tal_net_recv_nd_size(conn->fd, buf, len, len);
+    }
+    while (got < len) {
+        int ret = mbedtls_ssl_read(conn->ssl, buf + got, len - got);
+        if (ret <= 0) {
+            return ret;
+        }
+        got += ret;
+    }
+    return got;
+}
+
+static int __broker_reply(BENCH_CONN_T *conn, uint8_t type, uint8_t *body, uint8_t len)
+{
+    uint8_t pkt[8] = {type, len};
+
+    memcpy(pkt + 2, body, len);
+    if (conn->ssl == NULL) {
+        return tal_net_send(conn->fd, pkt, len + 2);
+    }
+    return mbedtls_ssl_write(conn->ssl, pkt, len + 2);
+}
+
+/* one connection, one packet at a time: just enough protocol for the client under test */
+static void __broker_session(BENCH_CONN_T *conn)
+{
+    static uint8_t body[2048];
+    uint8_t byte;
+    uint32_t len, shift;
+
+    while (sg_running) {
+        if (__broker_recv(conn, &byte, 1) != 1) {
+            break;
+        }
+        uint8_t type = byte;
+        uint64_t rx_ns = __bench_time_ns(); // first byte on the wire
+        len = 0;
+        shift = 0;
+        do {
+            if (__broker_recv(conn, &byte, 1) != 1) {
+                return;
+            }
+            len |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while ((byte & 0x80) && shift < 28);
+        if (len > sizeof(body) || (len && __broker_recv(conn, body, len) != (int)len)) {
+            PR_ERR("broker: bad packet 0x%02x len %u", type, len);
+            break;
+        }
+
+        switch (type & 0xF0) {
+        case BENCH_MQTT_CONNECT:
+            sg_connect_ns = rx_ns;
+            __broker_reply(conn, 0x20, (uint8_t[]){0x00, 0x00}, 2);
+            break;
+
+        case BENCH_MQTT_SUBSCRIBE:
+            __broker_reply(conn, 0x90, (uint8_t[]){body[0], body[1], 0x01}, 3);
+            break;
+
+        case BENCH_MQTT_UNSUBSCRIBE:
+            __broker_reply(conn, 0xB0, body, 2);
+            break;
+
+        case BENCH_MQTT_PINGREQ:
+            __broker_reply(conn, 0xD0, NULL, 0);
+            break;
+
+        case BENCH_MQTT_PUBLISH: {
+            sg_broker_rx_ns = rx_ns;
+            tal_semaphore_post(sg_broker_sem);
+            if ((type >> 1) & 0x03) {
+                uint32_t topic_len = (body[0] << 8) | body[1];
+                __broker_reply(conn, 0x40, body + 2 + topic_len, 2);
+            }
+            break;
+        }
+
+        case BENCH_MQTT_DISCONNECT:
+            return;
+
+        default:
+            break;
+        }
+    }
+}
+
+static int __broker_tls_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    return tal_net_send(*(int *)ctx, buf, len);
+}
+
+static int __broker_tls_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    return tal_net_recv(*(int *)ctx, buf, len);
+}
+
+static void __broker_task(void *arg)
+{
+    int listen_fd = (int)(intptr_t)arg;
+    TUYA_IP_ADDR_T addr;
+    uint16_t port;
+
+    BENCH_CONN_T conn = {.fd = tal_net_accept(listen_fd, &addr, &port)};
+    if (conn.fd >= 0) {
+        tal_net_disable_nagle(conn.fd);
+        if (sg_broker_tls) {
+            mbedtls_ssl_context ssl;
+            mbedtls_ssl_init(&ssl);
+            int ret = mbedtls_ssl_setup(&ssl, &sg_tls_conf);
+            if (ret == 0) {
+                mbedtls_ssl_set_bio(&ssl, &conn.fd, __broker_tls_send, __broker_tls_recv, NULL);
+                ret = mbedtls_ssl_handshake(&ssl);
+            }
+            if (ret == 0) {
+                sg_tls_ns = __bench_time_ns();
+                conn.ssl = &ssl;
+                __broker_session(&conn);
+                mbedtls_ssl_close_notify(&ssl);
+            } else {
+                PR_ERR("broker: tls handshake fail -0x%04x", -ret);
+            }
+            mbedtls_ssl_free(&ssl);
+        } else {
+            __broker_session(&conn);
+        }
+        tal_net_close(conn.fd);
+    }
+    tal_net_close(listen_fd);
+    tal_thread_delete(sg_broker_thread);
+}
+
+static int __broker_listen(void)
+{
+    THREAD_CFG_T cfg = {8192, THREAD_PRIO_2, "bench_broker"};
+
+    int listen_fd = tal_net_socket_create(PROTOCOL_TCP);
+    if (listen_fd < 0 || OPRT_OK != tal_net_set_reuse(listen_fd) ||
+        OPRT_OK != tal_net_bind(listen_fd, TY_IPADDR_LOOPBACK, BENCH_BROKER_PORT) ||
+        OPRT_OK != tal_net_listen(listen_fd, 1)) {
+        PR_ERR("broker listen on port %d fail", BENCH_BROKER_PORT);
+        if (listen_fd >= 0) {
+            tal_net_close(listen_fd);
+        }
+        return OPRT_SOCK_ERR;
+    }
+    return tal_thread_create_and_start(&sg_broker_thread, NULL, NULL, __broker_task, (void *)(intptr_t)listen_fd,
+                                       &cfg);
+}
+
+static void __loop_task(void *arg)
+{
+    while (sg_running) {
+        tuya_mqtt_loop(&sg_mqctx);
+        sg_loop_cnt++;
+    }
+    tal_thread_delete(sg_loop_thread);
+}
+
+static void __publish_notify_cb(int result, void *user_data)
+{
+    sg_ack_ns = __bench_time_ns();
+    tal_semaphore_post(sg_ack_sem);
+}
+
+static void __bench_mqtt(void)
+{
+    THREAD_CFG_T cfg = {4096, THREAD_PRIO_2, "bench_loop"};
+    uint64_t rx_sum = 0, rx_max = 0, ack_sum = 0, ack_max = 0;
+    uint32_t loops, i, ok = 0;
+
+    sg_broker_tls = false;
+    sg_running = true;
+    if (OPRT_OK != __broker_listen()) {
+        sg_running = false;
+        return;
+    }
+
+    if (OPRT_OK != tuya_mqtt_init(&sg_mqctx, &(const tuya_mqtt_config_t){
+                                                 .host = "127.0.0.1",
+                                                 .port = BENCH_BROKER_PORT,
+                                                 .timeout = MQTT_RECV_BLOCK_TIME_MS,
+                                                 .devid = "bench_devid",
+                                                 .seckey = "bench_seckey",
+                                                 .localkey = "bench_localkey00",
+                                             }) ||
+        OPRT_OK != tuya_mqtt_start(&sg_mqctx)) {
+        PR_ERR("mqtt start fail");
+        sg_running = false;
+        return;
+    }
+
+    tal_thread_create_and_start(&sg_loop_thread, NULL, NULL, __loop_task, NULL, &cfg);
+
+    /* nothing to do: the loop task only wakes up for the receive timeout */
+    tal_system_sleep(1000);
+    loops = sg_loop_cnt;
+    tal_system_sleep(BENCH_IDLE_MS);
+    loops = sg_loop_cnt - loops;
+    PR_NOTICE("idle: %u loop wake-ups in %d ms, receive timeout %d ms", loops, BENCH_IDLE_MS, MQTT_RECV_BLOCK_TIME_MS);
+
+    /* queue from this task, the loop task sends it and reads the PUBACK */
+    loops = sg_loop_cnt;
+    for (i = 0; i < BENCH_PUBLISH_CNT; i++) {
+        const char *payload = "{\"bench\":1}";
+        uint64_t start = __bench_time_ns();
+
+        if (OPRT_OK != tuya_mqtt_client_publish_common(&sg_mqctx, sg_mqctx.signature.topic_out,
+                                                       (const uint8_t *)payload, strlen(payload), __publish_notify_cb,
+                                                       NULL, 5000, true)) {
+            PR_ERR("publish %u fail", i);
+            continue;
+        }
+        if (OPRT_OK != tal_semaphore_wait(sg_broker_sem, 5000) || OPRT_OK != tal_semaphore_wait(sg_ack_sem, 5000)) {
+            PR_ERR("publish %u timeout", i);
+            continue;
+        }
+
+        uint64_t rx = sg_broker_rx_ns - start;
+        uint64_t ack = sg_ack_ns - start;
+        rx_sum += rx;
+        ack_sum += ack;
+        rx_max = MAX(rx_max, rx);
+        ack_max = MAX(ack_max, ack);
+        ok++;
+        tal_system_sleep(BENCH_GAP_MS);
+    }
+    loops = sg_loop_cnt - loops;
+
+    if (ok) {
+        PR_NOTICE("publish -> on the wire: avg %llu us, max %llu us", rx_sum / ok / 1000, rx_max / 1000);
+        PR_NOTICE("publish -> PUBACK callback: avg %llu us, max %llu us", ack_sum / ok / 1000, ack_max / 1000);
+    }
+    PR_NOTICE("%u/%d publishes, %u loop wake-ups", ok, BENCH_PUBLISH_CNT, loops);
+
+    sg_running = false;
+    tuya_mqtt_stop(&sg_mqctx);
+    tuya_mqtt_wakeup(&sg_mqctx);
+    tal_system_sleep(100);
+}
+
+static int __bench_rng(void *ctx, unsigned char *buf, size_t len)
+{
+    return tuya_tls_random(buf, len);
+}
+
+/* self-signed P-256 certificate for 127.0.0.1, its DER goes to the endpoint certificate of the client */
+static int __broker_tls_init(void)
+{
+    mbedtls_x509write_cert crt;
+    mbedtls_mpi serial;
+    int ret;
+
+    mbedtls_pk_init(&sg_tls_key);
+    mbedtls_x509_crt_init(&sg_tls_crt);
+    mbedtls_ssl_config_init(&sg_tls_conf);
+    mbedtls_x509write_crt_init(&crt);
+    mbedtls_mpi_init(&serial);
+
+    if ((ret = mbedtls_pk_setup(&sg_tls_key, mbedtls_pk_info_from_type(MBEDTLS_PK_ECKEY))) != 0 ||
+        (ret = mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_SECP256R1, mbedtls_pk_ec(sg_tls_key), __bench_rng, NULL)) != 0 ||
+        (ret = mbedtls_mpi_lset(&serial, 1)) != 0) {
+        goto __exit;
+    }
+    mbedtls_x509write_crt_set_version(&crt, MBEDTLS_X509_CRT_VERSION_3);
+    mbedtls_x509write_crt_set_md_alg(&crt, MBEDTLS_MD_SHA256);
+    mbedtls_x509write_crt_set_subject_key(&crt, &sg_tls_key);
+    mbedtls_x509write_crt_set_issuer_key(&crt, &sg_tls_key);
+    if ((ret = mbedtls_x509write_crt_set_subject_name(&crt, BENCH_IOT_CERT_CN)) != 0 ||
+        (ret = mbedtls_x509write_crt_set_issuer_name(&crt, BENCH_IOT_CERT_CN)) != 0 ||
+        (ret = mbedtls_x509write_crt_set_serial(&crt, &serial)) != 0 ||
+        (ret = mbedtls_x509write_crt_set_validity(&crt, "20200101000000", "20991231235959")) != 0) {
+        goto __exit;
+    }
+
+    /* written at the end of the buffer */
+    ret = mbedtls_x509write_crt_der(&crt, sg_tls_der, sizeof(sg_tls_der), __bench_rng, NULL);
+    if (ret < 0) {
+        goto __exit;
+    }
+    sg_tls_der_len = ret;
+    memmove(sg_tls_der, sg_tls_der + sizeof(sg_tls_der) - sg_tls_der_len, sg_tls_der_len);
+
+    if ((ret = mbedtls_x509_crt_parse_der(&sg_tls_crt, sg_tls_der, sg_tls_der_len)) != 0 ||
+        (ret = mbedtls_ssl_config_defaults(&sg_tls_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                           MBEDTLS_SSL_PRESET_DEFAULT)) != 0 ||
+        (ret = mbedtls_ssl_conf_own_cert(&sg_tls_conf, &sg_tls_crt, &sg_tls_key)) != 0) {
+        goto __exit;
+    }
+    mbedtls_ssl_conf_rng(&sg_tls_conf, __bench_rng, NULL);
+
+__exit:
+    mbedtls_mpi_free(&serial);
+    mbedtls_x509write_crt_free(&crt);
+    if (ret != 0) {
+        PR_ERR("broker tls init fail -0x%04x", -ret);
+    }
+    return ret;
+}
+
+static void __broker_tls_deinit(void)
+{
+    mbedtls_ssl_config_free(&sg_tls_conf);
+    mbedtls_x509_crt_free(&sg_tls_crt);
+    mbedtls_pk_free(&sg_tls_key);
+}
+
+/* what an activated device keeps in the KV, the endpoint points to the loopback broker */
+static void __iot_seed_activation(void)
+{
+    const char *activate = "{\"devId\":\"bench_devid\",\"secKey\":\"bench_seckey0000\","
+                           "\"localKey\":\"bench_localkey00\",\"schemaId\":\"" BENCH_IOT_SCHEMA_ID "\","
+                           "\"stdTimeZone\":\"+08:00\"}";
+    const char *schema = "[{\"mode\":\"rw\",\"property\":{\"type\":\"bool\"},\"id\":1,\"type\":\"obj\"}]";
+
+    tal_kv_set(BENCH_IOT_NAMESPACE, (const uint8_t *)activate, strlen(activate));
+    tal_kv_set(BENCH_IOT_SCHEMA_ID, (const uint8_t *)schema, strlen(schema));
+}
+
+static void __iot_seed_endpoint(void)
+{
+    tuya_endpoint_t endpoint = {
+        .atop = {.host = "127.0.0.1", .port = BENCH_BROKER_PORT + 1, .path = "/d.json"},
+        .mqtt = {.host = "127.0.0.1", .port = BENCH_BROKER_PORT},
+        .cert = sg_tls_der,
+        .cert_len = sg_tls_der_len,
+    };
+    char version[128];
+
+    tuya_endpoint_cert_set(&endpoint);
+    tuya_endpoint_domain_set(&endpoint);
+
+    /* the string tuya_iot_version_update_sync saves, an unchanged version is not posted to ATOP */
+    snprintf(version, sizeof(version),
+             "[{\\\"otaChannel\\\":%d,\\\"protocolVer\\\":\\\"%s\\\","
+             "\\\"baselineVer\\\":\\\"%s\\\",\\\"softVer\\\":\\\"%s\\\"}]",
+             0, PV_VERSION, BS_VERSION, BENCH_IOT_SOFT_VER);
+    tal_kv_set(BENCH_IOT_NAMESPACE ".ver", (const uint8_t *)version, strlen(version));
+}
+
+static bool __iot_network_check(void)
+{
+    return true;
+}
+
+static void __iot_event_cb(tuya_iot_client_t *client, tuya_event_msg_t *event)
+{
+    if (event->id == TUYA_EVENT_MQTT_CONNECTED) {
+        sg_online_ns = __bench_time_ns();
+        tal_semaphore_post(sg_online_sem);
+    }
+}
+
+static void __iot_task(void *arg)
+{
+    while (sg_running) {
+        tuya_iot_yield(&sg_iot_client);
+        sg_iot_cnt++;
+    }
+    tal_thread_delete(sg_iot_thread);
+}
+
+static void __bench_iot(void)
+{
+    THREAD_CFG_T cfg = {8192, THREAD_PRIO_2, "bench_iot"};
+    uint32_t wakeups;
+
+    tal_semaphore_create_init(&sg_online_sem, 0, 1);
+    __iot_seed_activation();
+    if (OPRT_OK != tuya_iot_init(&sg_iot_client, &(const tuya_iot_config_t){
+                                                     .software_ver = BENCH_IOT_SOFT_VER,
+                                                     .productkey = "bench_productkey",
+                                                     .uuid = "bench_uuid",
+                                                     .authkey = "bench_authkey",
+                                                     .storage_namespace = BENCH_IOT_NAMESPACE,
+                                                     .event_handler = __iot_event_cb,
+                                                     .network_check = __iot_network_check,
+                                                 })) {
+        PR_ERR("tuya iot init fail");
+        return;
+    }
+    /* the random generator is seeded by tuya_iot_init */
+    if (0 != __broker_tls_init()) {
+        return;
+    }
+    __iot_seed_endpoint();
+
+    sg_broker_tls = true;
+    sg_running = true;
+    if (OPRT_OK != __broker_listen()) {
+        sg_running = false;
+        __broker_tls_deinit();
+        return;
+    }
+    tal_thread_create_and_start(&sg_iot_thread, NULL, NULL, __iot_task, NULL, &cfg);
+
+    /* not started yet: the IoT task blocks until tuya_iot_start */
+    tal_system_sleep(1000);
+    wakeups = sg_iot_cnt;
+    tal_system_sleep(BENCH_IDLE_MS);
+    PR_NOTICE("iot before start: %u task wake-ups in %d ms", sg_iot_cnt - wakeups, BENCH_IDLE_MS);
+
+    uint64_t start = __bench_time_ns();
+    tuya_iot_start(&sg_iot_client);
+    if (OPRT_OK != tal_semaphore_wait(sg_online_sem, 30 * 1000)) {
+        PR_ERR("iot not online");
+    } else {
+        PR_NOTICE("tuya_iot_start -> TLS handshake done: %llu us", (sg_tls_ns - start) / 1000);
+        PR_NOTICE("tuya_iot_start -> MQTT CONNECT at the broker: %llu us", (sg_connect_ns - start) / 1000);
+        PR_NOTICE("tuya_iot_start -> TUYA_EVENT_MQTT_CONNECTED: %llu us", (sg_online_ns - start) / 1000);
+
+        /* online, nothing to report: the task only wakes up for the receive timeout */
+        tal_system_sleep(2000);
+        wakeups = sg_iot_cnt;
+        tal_system_sleep(BENCH_IDLE_MS);
+        PR_NOTICE("iot online idle: %u task wake-ups in %d ms", sg_iot_cnt - wakeups, BENCH_IDLE_MS);
+    }
+
+    /* back to idle, then let the task leave the loop */
+    tuya_iot_stop(&sg_iot_client);
+    tal_system_sleep(500);
+    sg_running = false;
+    tuya_iot_wakeup(&sg_iot_client);
+    tal_system_sleep(100);
+
+    tuya_iot_activated_data_remove(&sg_iot_client);
+    tal_kv_del(BENCH_IOT_NAMESPACE ".ver");
+    __broker_tls_deinit();
+}
+
+static void __bench_main(void)
+{
+    tal_log_init(TAL_LOG_LEVEL_NOTICE, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+    tal_kv_init(&(tal_kv_cfg_t){
+        .seed = "vmlkasdh93dlvlcy",
+        .key = "dflfuap134ddlduq",
+    });
+    tal_sw_timer_init();
+    tal_workq_init();
+    tal_semaphore_create_init(&sg_broker_sem, 0, BENCH_PUBLISH_CNT);
+    tal_semaphore_create_init(&sg_ack_sem, 0, BENCH_PUBLISH_CNT);
+
+    __bench_mqtt();
+    __bench_iot();
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file example_cipher_bench.c
+ * @brief Benchmark of the tal_cipher context against the one-shot tal_aes128_cbc API.
+ *
+ * The example encrypts and decrypts values of several sizes with AES-128-CBC and PKCS7 padding, the way tal_kv stores
+ * them. The one-shot path calls tal_aes128_cbc_encode and tal_aes128_cbc_decode, which allocate the output and expand
+ * the key on every call. The context path expands the key once with tal_cipher_setup and runs tal_cipher_crypt in
+ * place. Both must give the same cipher text, the example reports the time of one encrypt and decrypt pair, which is
+ * the crypto cost of one tal_kv_set and tal_kv_get.
+ *
+ * Usage on Linux: ./cipher_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+#include "tal_symmetry.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_MAX_SIZE    4096
+#define BENCH_TOTAL_BYTES (16 * 1024 * 1024)
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint32_t sg_sizes[] = {16, 64, 256, 1024, 4096};
+
+static const uint8_t sg_key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                   0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+static const uint8_t sg_iv[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+static uint8_t sg_plain[BENCH_MAX_SIZE];
+static uint8_t sg_buf[BENCH_MAX_SIZE + TAL_CIPHER_BLOCK_SIZE];
+static TAL_CIPHER_CTX_T sg_enc_ctx;
+static TAL_CIPHER_CTX_T sg_dec_ctx;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+/* encrypt and decrypt size bytes with the one-shot API, the iv is updated by the call so it is copied each time */
+static OPERATE_RET __oneshot_round(uint32_t size, uint8_t *cipher, uint32_t *cipher_len)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint8_t iv[16];
+    uint8_t *ec_data = NULL, *dec_data = NULL;
+    uint32_t ec_len = 0, dec_len = 0;
+
+    memcpy(iv, sg_iv, sizeof(iv));
+    TUYA_CALL_ERR_RETURN(tal_aes128_cbc_encode(sg_plain, size, (uint8_t *)sg_key, iv, &ec_data, &ec_len));
+    if (cipher) {
+        memcpy(cipher, ec_data, ec_len);
+        *cipher_len = ec_len;
+    }
+
+    memcpy(iv, sg_iv, sizeof(iv));
+    rt = tal_aes128_cbc_decode(ec_data, ec_len, (uint8_t *)sg_key, iv, &dec_data, &dec_len);
+    tal_aes_free_data(ec_data);
+    if (OPRT_OK != rt) {
+        return rt;
+    }
+    // the one-shot decode keeps the padding, strip it as the previous tal_kv_get did
+    dec_len = tal_aes_get_actual_length(dec_data, dec_len);
+    if (dec_len != size || memcmp(dec_data, sg_plain, size)) {
+        rt = OPRT_COM_ERROR;
+    }
+    tal_aes_free_data(dec_data);
+
+    return rt;
+}
+
+/* the same round with the keyed contexts, in place in sg_buf */
+static OPERATE_RET __ctx_round(uint32_t size, uint8_t *cipher, uint32_t *cipher_len)
+{
+    OPERATE_RET rt = OPRT_OK;
+    size_t len = 0;
+
+    memcpy(sg_buf, sg_plain, size);
+    TUYA_CALL_ERR_RETURN(tal_cipher_crypt(&sg_enc_ctx, sg_iv, sg_buf, size, sg_buf, &len));
+    if (cipher) {
+        memcpy(cipher, sg_buf, len);
+        *cipher_len = len;
+    }
+
+    TUYA_CALL_ERR_RETURN(tal_cipher_crypt(&sg_dec_ctx, sg_iv, sg_buf, len, sg_buf, &len));
+    if (len != size || memcmp(sg_buf, sg_plain, size)) {
+        return OPRT_COM_ERROR;
+    }
+
+    return rt;
+}
+
+/* ns per encrypt and decrypt pair over BENCH_TOTAL_BYTES */
+static uint32_t __bench_run(OPERATE_RET (*round)(uint32_t, uint8_t *, uint32_t *), uint32_t size)
+{
+    uint32_t i, rounds = BENCH_TOTAL_BYTES / size;
+    uint64_t start, ns;
+
+    start = __bench_time_ns();
+    for (i = 0; i < rounds; i++) {
+        if (OPRT_OK != round(size, NULL, NULL)) {
+            return 0;
+        }
+    }
+    ns = __bench_time_ns() - start;
+
+    return (uint32_t)(ns / rounds);
+}
+
+static void __bench_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t i, seed = 1;
+    static uint8_t ref[BENCH_MAX_SIZE + 16], out[BENCH_MAX_SIZE + 16];
+    uint32_t ref_len = 0, out_len = 0;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    for (i = 0; i < sizeof(sg_plain); i++) {
+        seed = seed * 1103515245 + 12345;
+        sg_plain[i] = seed >> 16;
+    }
+
+    TUYA_CALL_ERR_GOTO(tal_cipher_setup(&sg_enc_ctx, TAL_CIPHER_AES_CBC, SYMMETRY_ENCRYPT, sg_key, 128), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_cipher_set_padding(&sg_enc_ctx, TRUE), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_cipher_setup(&sg_dec_ctx, TAL_CIPHER_AES_CBC, SYMMETRY_DECRYPT, sg_key, 128), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_cipher_set_padding(&sg_dec_ctx, TRUE), __EXIT);
+
+    /* both paths must round trip and give the same cipher text on every length */
+    for (i = 1; i <= 1024; i++) {
+        TUYA_CALL_ERR_GOTO(__oneshot_round(i, ref, &ref_len), __EXIT);
+        TUYA_CALL_ERR_GOTO(__ctx_round(i, out, &out_len), __EXIT);
+        if (ref_len != out_len || memcmp(ref, out, ref_len)) {
+            PR_ERR("cipher text mismatch at length %u", i);
+            goto __EXIT;
+        }
+    }
+    PR_NOTICE("check: lengths 1..1024 agree");
+
+    for (i = 0; i < CNTSOF(sg_sizes); i++) {
+        uint32_t oneshot = __bench_run(__oneshot_round, sg_sizes[i]);
+        uint32_t ctx = __bench_run(__ctx_round, sg_sizes[i]);
+        PR_NOTICE("%4u bytes: tal_cipher %7u ns, tal_aes128_cbc %7u ns, x%u.%02u", sg_sizes[i], ctx, oneshot,
+                  ctx ? oneshot / ctx : 0, ctx ? oneshot * 100 / ctx % 100 : 0);
+    }
+
+__EXIT:
+    tal_cipher_free(&sg_enc_ctx);
+    tal_cipher_free(&sg_dec_ctx);
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
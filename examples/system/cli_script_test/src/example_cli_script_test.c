@@ -0,0 +1,327 @@
+/**
+ * @file example_cli_script_test.c
+ * @brief Headless test of the CLI engine, driven by scripted input through tal_cli_input.
+ *
+ * The CLI is initialized with tal_cli_init_with_output, so no UART and no thread are used. The test feeds key
+ * sequences to the engine, split in chunks of 1 to 7 bytes so lines and escape sequences cross the chunk borders.
+ * It checks command dispatch and arguments, unknown commands, tab completion of a unique and of a shared prefix,
+ * the command list, history recall with the up and down keys and registration from several threads at once. The
+ * CLI output is captured by the output callback and checked for the expected text.
+ *
+ * Usage: ./cli_script_test
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tal_cli.h"
+#include "tkl_output.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define TEST_OUTPUT_SIZE   4096
+#define TEST_CALL_SIZE     64
+#define TEST_THREAD_NUM    4
+#define TEST_THREAD_CMD    32
+#define TEST_CMD_NAME_LEN  12
+
+#define TEST_KEY_UP   "\x1b[A"
+#define TEST_KEY_DOWN "\x1b[B"
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    const char *name;
+    const char *script;   // keys fed to the CLI
+    const char *call;     // expected calls, "name arg..;" each, NULL for none
+    const char *output;   // text expected in the output, NULL for none
+    const char *no_output; // text that must not be in the output, NULL for none
+} TEST_CASE_T;
+
+typedef struct {
+    uint32_t id;
+    SEM_HANDLE done;
+    OPERATE_RET rt;
+} TEST_THREAD_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+static void __test_cmd(int argc, char *argv[]);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const cli_cmd_t sg_cmd[] = {
+    {.name = "wifi_scan", .help = "scan the access points", .func = __test_cmd},
+    {.name = "wifi_connect", .help = "connect to an access point", .func = __test_cmd},
+    {.name = "kv_get", .help = "read a key", .func = __test_cmd},
+    {.name = "reboot", .help = "restart the device", .func = __test_cmd},
+};
+
+static const TEST_CASE_T sg_case[] = {
+    {"dispatch", "wifi_connect  home_ap secret\r", "wifi_connect home_ap secret;", NULL, NULL},
+    {"lf and crlf", "kv_get a\nkv_get b\r\n", "kv_get a;kv_get b;", NULL, NULL},
+    {"unknown", "wifi\r", NULL, "No command or file name", NULL},
+    {"backspace", "kv_gexx\b\x7ft b\r", "kv_get b;", NULL, NULL},
+    {"complete one", "reb\t\r", "reboot;", "tuya>reboot", NULL},
+    {"complete some", "wifi_\tscan\r", "wifi_scan;", "wifi_connect", "kv_get"},
+    {"complete none", "zz\t\b\b\r", NULL, NULL, "No command"},
+    {"list", "\t", NULL, "kv_get", NULL},
+    {"history up", TEST_KEY_UP "\r", "wifi_scan;", NULL, NULL},
+    {"history up x3", TEST_KEY_UP TEST_KEY_UP TEST_KEY_UP "\r", "kv_get b;", NULL, NULL},
+    {"history down", TEST_KEY_UP TEST_KEY_UP TEST_KEY_UP TEST_KEY_DOWN "\r", "wifi_scan;", NULL, NULL},
+    {"edit recalled", TEST_KEY_UP TEST_KEY_UP "\x1b[Dx\r", "kv_get xb;", NULL, NULL},
+};
+
+static char sg_output[TEST_OUTPUT_SIZE + 1];
+static uint32_t sg_output_len;
+static char sg_call[TEST_CALL_SIZE + 1];
+static uint32_t sg_call_len;
+
+static cli_cmd_t sg_thread_cmd[TEST_THREAD_NUM][TEST_THREAD_CMD];
+static char sg_thread_name[TEST_THREAD_NUM][TEST_THREAD_CMD][TEST_CMD_NAME_LEN];
+static uint32_t sg_thread_hit;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static int __test_output(const char *data, uint32_t len, void *arg)
+{
+    if (len > TEST_OUTPUT_SIZE - sg_output_len) {
+        len = TEST_OUTPUT_SIZE - sg_output_len;
+    }
+    memcpy(sg_output + sg_output_len, data, len);
+    sg_output_len += len;
+    sg_output[sg_output_len] = '\0';
+
+    return len;
+}
+
+// Records the call as "name arg..;"
+static void __test_cmd(int argc, char *argv[])
+{
+    int i = 0;
+    uint32_t len = 0;
+
+    for (i = 0; i < argc; i++) {
+        len = strlen(argv[i]);
+        if (sg_call_len + len + 1 > TEST_CALL_SIZE) {
+            return;
+        }
+        memcpy(sg_call + sg_call_len, argv[i], len);
+        sg_call_len += len;
+        sg_call[sg_call_len++] = (i + 1 < argc) ? ' ' : ';';
+    }
+    sg_call[sg_call_len] = '\0';
+}
+
+static void __test_thread_cmd(int argc, char *argv[])
+{
+    sg_thread_hit++;
+}
+
+static void __test_reset(void)
+{
+    sg_output_len = 0;
+    sg_output[0] = '\0';
+    sg_call_len = 0;
+    sg_call[0] = '\0';
+}
+
+// Feeds the script in chunks of 1 to 7 bytes
+static OPERATE_RET __test_feed(const char *script)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t len = strlen(script), ofs = 0, chunk = 0, n = 0;
+
+    while (ofs < len) {
+        chunk = 1 + (n++ % 7);
+        if (chunk > len - ofs) {
+            chunk = len - ofs;
+        }
+        TUYA_CALL_ERR_RETURN(tal_cli_input((const uint8_t *)script + ofs, chunk));
+        ofs += chunk;
+    }
+
+    return rt;
+}
+
+static BOOL_T __test_case(const TEST_CASE_T *c)
+{
+    BOOL_T pass = TRUE;
+
+    __test_reset();
+    if (OPRT_OK != __test_feed(c->script)) {
+        pass = FALSE;
+    }
+    if (0 != strcmp(sg_call, c->call ? c->call : "")) {
+        pass = FALSE;
+    }
+    if (c->output && NULL == strstr(sg_output, c->output)) {
+        pass = FALSE;
+    }
+    if (c->no_output && strstr(sg_output, c->no_output)) {
+        pass = FALSE;
+    }
+
+    PR_NOTICE("%-14s calls %-30s %s", c->name, sg_call, pass ? "ok" : "FAIL");
+    if (!pass) {
+        PR_NOTICE("output: %s", sg_output);
+    }
+
+    return pass;
+}
+
+static void __test_register_task(void *arg)
+{
+    TEST_THREAD_T *t = (TEST_THREAD_T *)arg;
+    uint32_t i = 0;
+
+    t->rt = OPRT_OK;
+    for (i = 0; i < TEST_THREAD_CMD && OPRT_OK == t->rt; i++) {
+        t->rt = tal_cli_cmd_register(&sg_thread_cmd[t->id][i], 1);
+    }
+    tal_semaphore_post(t->done);
+}
+
+// Registers TEST_THREAD_NUM x TEST_THREAD_CMD commands from several threads, then runs each of them once
+static BOOL_T __test_register_threads(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TEST_THREAD_T t[TEST_THREAD_NUM];
+    THREAD_HANDLE thread = NULL;
+    THREAD_CFG_T cfg = {4096, THREAD_PRIO_3, "cli_reg"};
+    char line[TEST_CMD_NAME_LEN + 1];
+    uint32_t i = 0, j = 0;
+    BOOL_T pass = TRUE;
+
+    memset(t, 0, sizeof(t));
+    for (i = 0; i < TEST_THREAD_NUM; i++) {
+        for (j = 0; j < TEST_THREAD_CMD; j++) {
+            snprintf(sg_thread_name[i][j], TEST_CMD_NAME_LEN, "t%u_%02u", i, j);
+            sg_thread_cmd[i][j].name = sg_thread_name[i][j];
+            sg_thread_cmd[i][j].help = "registered from a thread";
+            sg_thread_cmd[i][j].func = __test_thread_cmd;
+        }
+        t[i].id = i;
+        TUYA_CALL_ERR_RETURN_VAL(tal_semaphore_create_init(&t[i].done, 0, 1), FALSE);
+    }
+
+    for (i = 0; i < TEST_THREAD_NUM; i++) {
+        TUYA_CALL_ERR_RETURN_VAL(tal_thread_create_and_start(&thread, NULL, NULL, __test_register_task, &t[i], &cfg),
+                                 FALSE);
+    }
+    for (i = 0; i < TEST_THREAD_NUM; i++) {
+        tal_semaphore_wait(t[i].done, SEM_WAIT_FOREVER);
+        tal_semaphore_release(t[i].done);
+        if (OPRT_OK != t[i].rt) {
+            pass = FALSE;
+        }
+    }
+
+    __test_reset();
+    sg_thread_hit = 0;
+    for (i = 0; i < TEST_THREAD_NUM; i++) {
+        for (j = 0; j < TEST_THREAD_CMD; j++) {
+            snprintf(line, sizeof(line), "%s\r", sg_thread_name[i][j]);
+            __test_feed(line);
+        }
+    }
+    if (sg_thread_hit != TEST_THREAD_NUM * TEST_THREAD_CMD || strstr(sg_output, "No command")) {
+        pass = FALSE;
+    }
+
+    PR_NOTICE("%-14s %u threads, %u of %u commands found %s", "threads", TEST_THREAD_NUM, sg_thread_hit,
+              TEST_THREAD_NUM * TEST_THREAD_CMD, pass ? "ok" : "FAIL");
+
+    return pass;
+}
+
+static void __test_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t i = 0;
+    BOOL_T pass = TRUE;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    // Registering before the CLI is initialized is refused
+    rt = tal_cli_cmd_register(sg_cmd, CNTSOF(sg_cmd));
+    PR_NOTICE("%-14s rt %d %s", "before init", rt, (OPRT_RESOURCE_NOT_READY == rt) ? "ok" : "FAIL");
+    if (OPRT_RESOURCE_NOT_READY != rt) {
+        pass = FALSE;
+    }
+
+    TUYA_CALL_ERR_GOTO(tal_cli_init_with_output(__test_output, NULL), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_cli_cmd_register(sg_cmd, CNTSOF(sg_cmd)), __EXIT);
+
+    for (i = 0; i < CNTSOF(sg_case); i++) {
+        if (!__test_case(&sg_case[i])) {
+            pass = FALSE;
+        }
+    }
+
+    if (!__test_register_threads()) {
+        pass = FALSE;
+    }
+
+    PR_NOTICE("cli script test: %s", pass ? "PASS" : "FAIL");
+    return;
+
+__EXIT:
+    PR_NOTICE("cli script test: FAIL, rt %d", rt);
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __test_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
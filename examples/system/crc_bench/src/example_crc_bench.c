@@ -0,0 +1,224 @@
+/**
+ * @file example_crc_bench.c
+ * @brief Benchmark of the tuya_crc module against the byte-wise table CRC.
+ *
+ * The example computes CRC-32/IEEE and CRC-32C over buffers of several sizes with tuya_crc and with a byte-wise table
+ * implementation, one table lookup per byte as the previous crc32i code did, checks that both agree and reports the
+ * throughput of each. CRC-16/MODBUS is byte-wise in both and only reported for reference.
+ *
+ * Usage on Linux: ./crc_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+#include "tuya_crc.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_BUF_SIZE    4096
+#define BENCH_TOTAL_BYTES (64 * 1024 * 1024)
+
+#define BENCH_CRC32_POLY  0xEDB88320UL
+#define BENCH_CRC32C_POLY 0x82F63B78UL
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef uint32_t (*BENCH_CRC_FN)(const void *data, size_t size);
+
+typedef struct {
+    char *name;
+    BENCH_CRC_FN tuya;
+    BENCH_CRC_FN bytewise;
+} BENCH_CRC_T;
+
+/***********************************************************
+***********************function declare*********************
+***********************************************************/
+static uint32_t __crc32_bytewise(const void *data, size_t size);
+static uint32_t __crc32c_bytewise(const void *data, size_t size);
+static uint32_t __crc16_tuya(const void *data, size_t size);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint32_t sg_sizes[] = {16, 64, 256, 1024, 4096};
+
+static const BENCH_CRC_T sg_crcs[] = {
+    {"crc32", tuya_crc32, __crc32_bytewise},
+    {"crc32c", tuya_crc32c, __crc32c_bytewise},
+    {"crc16", __crc16_tuya, NULL},
+};
+
+static uint32_t sg_crc32_table[256];
+static uint32_t sg_crc32c_table[256];
+static uint8_t sg_buf[BENCH_BUF_SIZE + 8]; // room for the unaligned starts
+static volatile uint32_t sg_sink;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static void __table_init(uint32_t table[256], uint32_t poly)
+{
+    uint32_t i, j, crc;
+
+    for (i = 0; i < 256; i++) {
+        crc = i;
+        for (j = 0; j < 8; j++) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+        table[i] = crc;
+    }
+}
+
+static uint32_t __crc_bytewise(const uint32_t table[256], const void *data, size_t size)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (size--) {
+        crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static uint32_t __crc32_bytewise(const void *data, size_t size)
+{
+    return __crc_bytewise(sg_crc32_table, data, size);
+}
+
+static uint32_t __crc32c_bytewise(const void *data, size_t size)
+{
+    return __crc_bytewise(sg_crc32c_table, data, size);
+}
+
+static uint32_t __crc16_tuya(const void *data, size_t size)
+{
+    return tuya_crc16(data, size);
+}
+
+/* MB/s over BENCH_TOTAL_BYTES in size byte calls */
+static uint32_t __bench_run(BENCH_CRC_FN fn, uint32_t size)
+{
+    uint32_t i, rounds = BENCH_TOTAL_BYTES / size;
+    uint64_t start, ns;
+
+    start = __bench_time_ns();
+    for (i = 0; i < rounds; i++) {
+        sg_sink += fn(sg_buf + (i & 7), size);
+    }
+    ns = __bench_time_ns() - start;
+
+    return ns ? (uint32_t)((uint64_t)rounds * size * 1000 / ns) : 0;
+}
+
+static void __bench_main(void)
+{
+    uint32_t i, j, seed = 1;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    __table_init(sg_crc32_table, BENCH_CRC32_POLY);
+    __table_init(sg_crc32c_table, BENCH_CRC32C_POLY);
+    for (i = 0; i < sizeof(sg_buf); i++) {
+        seed = seed * 1103515245 + 12345;
+        sg_buf[i] = seed >> 16;
+    }
+
+    /* check values of the catalogue, then agreement on every length and alignment */
+    PR_NOTICE("check \"123456789\": crc32 %08x crc32c %08x crc16 %04x", tuya_crc32("123456789", 9),
+              tuya_crc32c("123456789", 9), tuya_crc16("123456789", 9));
+    for (i = 0; i < CNTSOF(sg_crcs) - 1; i++) {
+        for (j = 0; j < 1024; j++) {
+            if (sg_crcs[i].tuya(sg_buf + (j & 7), j) != sg_crcs[i].bytewise(sg_buf + (j & 7), j)) {
+                PR_ERR("%s mismatch at length %u", sg_crcs[i].name, j);
+                return;
+            }
+        }
+    }
+
+    for (i = 0; i < CNTSOF(sg_crcs); i++) {
+        for (j = 0; j < CNTSOF(sg_sizes); j++) {
+            uint32_t size = sg_sizes[j];
+            if (sg_crcs[i].bytewise) {
+                uint32_t tuya = __bench_run(sg_crcs[i].tuya, size);
+                uint32_t bytewise = __bench_run(sg_crcs[i].bytewise, size);
+                PR_NOTICE("%-6s %4u bytes: tuya_crc %5u MB/s, bytewise %5u MB/s, x%u.%02u", sg_crcs[i].name,
+                          size, tuya, bytewise, bytewise ? tuya / bytewise : 0,
+                          bytewise ? tuya * 100 / bytewise % 100 : 0);
+            } else {
+                PR_NOTICE("%-6s %4u bytes: tuya_crc %5u MB/s", sg_crcs[i].name, size,
+                          __bench_run(sg_crcs[i].tuya, size));
+            }
+        }
+    }
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
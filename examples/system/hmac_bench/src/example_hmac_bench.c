@@ -0,0 +1,370 @@
+/**
+ * @file example_hmac_bench.c
+ * @brief Benchmark of the tal_security hashes, HMAC paths and AES modes.
+ *
+ * The example processes messages of 16 bytes to 64 KB and reports the time of one message and the throughput for:
+ * - SHA1, SHA256 and MD5 with the one-shot tal_sha1_ret, tal_sha256_ret and tal_md5_ret;
+ * - HMAC-SHA256 and HMAC-SHA1 with a 32 byte key. The one-shot tal_sha256_mac and tal_sha1_mac pad and hash the key
+ *   for every message. tal_hmac continues every message from the pad state absorbed once by tal_hmac_key_init, and
+ *   tal_hmac_multi also shares one hash context between the messages of a batch. All paths must give the same MAC;
+ * - AES-128 ECB, CBC and CTR and AES-256 CBC and CTR with a keyed tal_cipher context, encryption and decryption.
+ *   Decryption must give back the plain text.
+ *
+ * Usage on Linux: ./hmac_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+#include "tal_hash.h"
+#include "tal_symmetry.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_MAX_SIZE    (64 * 1024)
+#define BENCH_BATCH       8
+#define BENCH_BATCH_STEP  64 // messages of a batch start BENCH_BATCH_STEP bytes apart in sg_msg
+#define BENCH_TOTAL_BYTES (4 * 1024 * 1024)
+#define BENCH_MIN_ROUNDS  16
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef OPERATE_RET (*BENCH_HASH_FN)(const uint8_t *input, size_t ilen, uint8_t *output);
+
+typedef OPERATE_RET (*BENCH_MAC_FN)(const uint8_t *key, size_t keylen, const uint8_t *input, size_t ilen,
+                                    uint8_t *output);
+
+typedef struct {
+    char *name;
+    BENCH_HASH_FN hash;
+} BENCH_HASH_T;
+
+typedef struct {
+    char *name;
+    TAL_HMAC_TYPE_E type;
+    BENCH_MAC_FN oneshot;
+    uint32_t mac_len;
+} BENCH_HMAC_T;
+
+typedef struct {
+    char *name;
+    TAL_CIPHER_MODE_E mode;
+    uint32_t keybits;
+} BENCH_AES_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+static OPERATE_RET __sha1(const uint8_t *input, size_t ilen, uint8_t *output);
+static OPERATE_RET __sha256(const uint8_t *input, size_t ilen, uint8_t *output);
+static OPERATE_RET __md5(const uint8_t *input, size_t ilen, uint8_t *output);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint32_t sg_sizes[] = {16, 64, 256, 1024, 4 * 1024, 16 * 1024, 64 * 1024};
+
+static const BENCH_HASH_T sg_hashes[] = {
+    {"sha1", __sha1},
+    {"sha256", __sha256},
+    {"md5", __md5},
+};
+
+static const BENCH_HMAC_T sg_hmacs[] = {
+    {"hmac-sha256", TAL_HMAC_SHA256, tal_sha256_mac, 32},
+    {"hmac-sha1", TAL_HMAC_SHA1, tal_sha1_mac, 20},
+};
+
+static const BENCH_AES_T sg_aes[] = {
+    {"aes128-ecb", TAL_CIPHER_AES_ECB, 128}, {"aes128-cbc", TAL_CIPHER_AES_CBC, 128},
+    {"aes128-ctr", TAL_CIPHER_AES_CTR, 128}, {"aes256-cbc", TAL_CIPHER_AES_CBC, 256},
+    {"aes256-ctr", TAL_CIPHER_AES_CTR, 256},
+};
+
+static uint8_t sg_key[32];
+static uint8_t sg_iv[TAL_CIPHER_BLOCK_SIZE];
+static uint8_t sg_msg[BENCH_MAX_SIZE + BENCH_BATCH * BENCH_BATCH_STEP];
+static uint8_t sg_out[BENCH_MAX_SIZE];
+static uint8_t sg_back[BENCH_MAX_SIZE];
+static uint8_t sg_mac[BENCH_BATCH][32];
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static OPERATE_RET __sha1(const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    return tal_sha1_ret(input, ilen, output);
+}
+
+static OPERATE_RET __sha256(const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    return tal_sha256_ret(input, ilen, output, 0);
+}
+
+static OPERATE_RET __md5(const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    return tal_md5_ret(input, ilen, output);
+}
+
+static uint32_t __bench_rounds(uint32_t size)
+{
+    uint32_t rounds = BENCH_TOTAL_BYTES / size;
+
+    return (rounds < BENCH_MIN_ROUNDS) ? BENCH_MIN_ROUNDS : rounds;
+}
+
+/* prints ns per message and MB/s (10^6 bytes per second) */
+static void __bench_report(const char *name, const char *path, uint32_t size, uint64_t ns, uint32_t count)
+{
+    uint64_t op_ns = ns / count;
+    uint64_t mbps = ns ? (uint64_t)size * count * 100000ULL / ns : 0; // MB/s x100
+
+    PR_NOTICE("%-11s %-14s %5u bytes: %9u ns/op %6u.%02u MB/s", name, path, size, (uint32_t)op_ns,
+              (uint32_t)(mbps / 100), (uint32_t)(mbps % 100));
+}
+
+static void __bench_hash(const BENCH_HASH_T *hash, uint32_t size)
+{
+    uint32_t i, rounds = __bench_rounds(size);
+    uint64_t start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < rounds; i++) {
+        hash->hash(sg_msg, size, sg_mac[0]);
+    }
+    __bench_report(hash->name, "one-shot", size, __bench_time_ns() - start, rounds);
+}
+
+static void __hmac_msgs(TAL_HMAC_MSG_T *msgs, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_BATCH; i++) {
+        msgs[i].input = sg_msg + i * BENCH_BATCH_STEP;
+        msgs[i].ilen = size;
+        msgs[i].output = sg_mac[i];
+    }
+}
+
+/* every message of the batch with the one-shot MAC, the keyed MAC and tal_hmac_multi must agree */
+static OPERATE_RET __hmac_check(const BENCH_HMAC_T *hmac, const TAL_HMAC_KEY_T *hkey, uint32_t size)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t i;
+    uint8_t ref[32], out[32];
+    TAL_HMAC_MSG_T msgs[BENCH_BATCH];
+
+    __hmac_msgs(msgs, size);
+    TUYA_CALL_ERR_RETURN(tal_hmac_multi(hkey, msgs, BENCH_BATCH));
+
+    for (i = 0; i < BENCH_BATCH; i++) {
+        TUYA_CALL_ERR_RETURN(hmac->oneshot(sg_key, sizeof(sg_key), msgs[i].input, size, ref));
+        TUYA_CALL_ERR_RETURN(tal_hmac(hkey, msgs[i].input, size, out));
+        if (memcmp(ref, out, hmac->mac_len) || memcmp(ref, sg_mac[i], hmac->mac_len)) {
+            return OPRT_COM_ERROR;
+        }
+    }
+
+    return rt;
+}
+
+/* mode 0 one-shot, 1 keyed, 2 batched */
+static void __bench_hmac(const BENCH_HMAC_T *hmac, const TAL_HMAC_KEY_T *hkey, uint32_t size, int mode)
+{
+    static const char *path[] = {"one-shot", "tal_hmac", "tal_hmac_multi"};
+    uint32_t i, j, rounds = (__bench_rounds(size) + BENCH_BATCH - 1) / BENCH_BATCH;
+    uint64_t start;
+    TAL_HMAC_MSG_T msgs[BENCH_BATCH];
+
+    __hmac_msgs(msgs, size);
+
+    start = __bench_time_ns();
+    for (i = 0; i < rounds; i++) {
+        if (2 == mode) {
+            tal_hmac_multi(hkey, msgs, BENCH_BATCH);
+            continue;
+        }
+        for (j = 0; j < BENCH_BATCH; j++) {
+            if (0 == mode) {
+                hmac->oneshot(sg_key, sizeof(sg_key), msgs[j].input, size, sg_mac[j]);
+            } else {
+                tal_hmac(hkey, msgs[j].input, size, sg_mac[j]);
+            }
+        }
+    }
+    __bench_report(hmac->name, path[mode], size, __bench_time_ns() - start, rounds * BENCH_BATCH);
+}
+
+/* encrypts and decrypts one message, the plain text must come back */
+static OPERATE_RET __aes_check(TAL_CIPHER_CTX_T *enc, TAL_CIPHER_CTX_T *dec, uint32_t size)
+{
+    OPERATE_RET rt = OPRT_OK;
+    size_t olen = 0;
+
+    TUYA_CALL_ERR_RETURN(tal_cipher_crypt(enc, sg_iv, sg_msg, size, sg_out, &olen));
+    if (olen != size) {
+        return OPRT_COM_ERROR;
+    }
+    TUYA_CALL_ERR_RETURN(tal_cipher_crypt(dec, sg_iv, sg_out, size, sg_back, &olen));
+    if (olen != size || memcmp(sg_msg, sg_back, size)) {
+        return OPRT_COM_ERROR;
+    }
+
+    return rt;
+}
+
+static void __bench_aes(const BENCH_AES_T *aes, TAL_CIPHER_CTX_T *ctx, const char *path, uint32_t size)
+{
+    uint32_t i, rounds = __bench_rounds(size);
+    uint64_t start;
+    size_t olen = 0;
+
+    start = __bench_time_ns();
+    for (i = 0; i < rounds; i++) {
+        tal_cipher_crypt(ctx, sg_iv, sg_msg, size, sg_out, &olen);
+    }
+    __bench_report(aes->name, path, size, __bench_time_ns() - start, rounds);
+}
+
+static void __bench_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint32_t i, j, seed = 1;
+    TAL_HMAC_KEY_T hkey;
+    TAL_CIPHER_CTX_T enc, dec;
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    for (i = 0; i < sizeof(sg_msg); i++) {
+        seed = seed * 1103515245 + 12345;
+        sg_msg[i] = seed >> 16;
+    }
+    memcpy(sg_key, sg_msg, sizeof(sg_key));
+    memcpy(sg_iv, sg_msg + sizeof(sg_key), sizeof(sg_iv));
+
+    for (i = 0; i < CNTSOF(sg_hashes); i++) {
+        for (j = 0; j < CNTSOF(sg_sizes); j++) {
+            __bench_hash(&sg_hashes[i], sg_sizes[j]);
+        }
+    }
+
+    for (i = 0; i < CNTSOF(sg_hmacs); i++) {
+        const BENCH_HMAC_T *hmac = &sg_hmacs[i];
+
+        memset(&hkey, 0, sizeof(hkey));
+        TUYA_CALL_ERR_LOG(tal_hmac_key_init(&hkey, hmac->type, sg_key, sizeof(sg_key)));
+        if (OPRT_OK != rt) {
+            continue;
+        }
+        // without a platform clone the keyed path restarts from the stored pads
+        PR_NOTICE("%s: keyed messages continue from %s", hmac->name, hkey.inner ? "a cloned state" : "the pads");
+
+        for (j = 0; j < CNTSOF(sg_sizes); j++) {
+            if (OPRT_OK != __hmac_check(hmac, &hkey, sg_sizes[j])) {
+                PR_ERR("%s mac mismatch at %u bytes", hmac->name, sg_sizes[j]);
+                break;
+            }
+            __bench_hmac(hmac, &hkey, sg_sizes[j], 0);
+            __bench_hmac(hmac, &hkey, sg_sizes[j], 1);
+            __bench_hmac(hmac, &hkey, sg_sizes[j], 2);
+        }
+
+        tal_hmac_key_free(&hkey);
+    }
+
+    for (i = 0; i < CNTSOF(sg_aes); i++) {
+        const BENCH_AES_T *aes = &sg_aes[i];
+
+        memset(&enc, 0, sizeof(enc));
+        memset(&dec, 0, sizeof(dec));
+        TUYA_CALL_ERR_LOG(tal_cipher_setup(&enc, aes->mode, SYMMETRY_ENCRYPT, sg_key, aes->keybits));
+        if (OPRT_OK == rt) {
+            TUYA_CALL_ERR_LOG(tal_cipher_setup(&dec, aes->mode, SYMMETRY_DECRYPT, sg_key, aes->keybits));
+        }
+
+        for (j = 0; OPRT_OK == rt && j < CNTSOF(sg_sizes); j++) {
+            if (OPRT_OK != __aes_check(&enc, &dec, sg_sizes[j])) {
+                PR_ERR("%s round trip error at %u bytes", aes->name, sg_sizes[j]);
+                break;
+            }
+            __bench_aes(aes, &enc, "encrypt", sg_sizes[j]);
+            // CTR decryption is the same operation as encryption
+            if (TAL_CIPHER_AES_CTR != aes->mode) {
+                __bench_aes(aes, &dec, "decrypt", sg_sizes[j]);
+            }
+        }
+
+        tal_cipher_free(&enc);
+        tal_cipher_free(&dec);
+    }
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file example_kv_serialize_bench.c
+ * @brief Benchmark of the binary tal_kv record format against the JSON one.
+ *
+ * tal_kv_serialize_set writes kv_db_t tables as binary records, ENABLE_KV_SERIALIZE_JSON keeps the JSON records. The
+ * example encodes a schedule and a scene record in both formats, checks that the binary record decodes back to the
+ * same table, with an empty raw property too, and reports the size and the encode and decode time of each format.
+ *
+ * Usage on Linux: ./kv_serialize_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tal_kv.h"
+#include "tkl_output.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_ROUNDS 100000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    int id;
+    BOOL_T enable;
+    char time[8];
+    uint8_t loops;
+    uint8_t dps[24];
+    char name[32];
+    int16_t tz;
+    uint16_t count;
+    char level;
+} BENCH_SCHEDULE_T;
+
+typedef struct {
+    char sid[24];
+    uint16_t gid;
+    char name[32];
+    char icon[48];
+    uint8_t actions[96];
+    BOOL_T on;
+    int ts;
+} BENCH_SCENE_T;
+
+/***********************************************************
+***********************function declare*********************
+***********************************************************/
+extern int kv_serialize(const kv_db_t *db, const uint32_t dbcnt, char **out, uint32_t *out_len);
+extern int kv_deserialize(const char *in, kv_db_t *db, const uint32_t dbcnt);
+extern int kv_serialize_bin(const kv_db_t *db, const uint32_t dbcnt, uint8_t **out, uint32_t *out_len);
+extern int kv_deserialize_bin(const uint8_t *in, const uint32_t in_len, kv_db_t *db, const uint32_t dbcnt);
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static BENCH_SCHEDULE_T sg_schedule = {123456, TRUE, "08:30", 0x7F, {0}, "morning lights", -480, 3, -5};
+static BENCH_SCHEDULE_T sg_schedule_out;
+static BENCH_SCENE_T sg_scene = {"scene_0012ab34cd", 0x1203, "movie night", "https://images.example.com/i/123.png",
+                                 {0},                FALSE,  1700000000};
+static BENCH_SCENE_T sg_scene_out;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+static void __schedule_db(BENCH_SCHEDULE_T *s, kv_db_t db[9])
+{
+    kv_db_t tmp[9] = {
+        {"id", KV_INT, &s->id, sizeof(s->id)},
+        {"enable", KV_BOOL, &s->enable, sizeof(s->enable)},
+        {"time", KV_STRING, s->time, sizeof(s->time)},
+        {"loops", KV_BYTE, &s->loops, sizeof(s->loops)},
+        {"dps", KV_RAW, s->dps, sizeof(s->dps)},
+        {"name", KV_STRING, s->name, sizeof(s->name)},
+        {"tz", KV_SHORT, &s->tz, sizeof(s->tz)},
+        {"cnt", KV_USHORT, &s->count, sizeof(s->count)},
+        {"lvl", KV_CHAR, &s->level, sizeof(s->level)},
+    };
+
+    memcpy(db, tmp, sizeof(tmp));
+}
+
+static void __scene_db(BENCH_SCENE_T *s, kv_db_t db[7])
+{
+    kv_db_t tmp[7] = {
+        {"sid", KV_STRING, s->sid, sizeof(s->sid)},
+        {"gid", KV_USHORT, &s->gid, sizeof(s->gid)},
+        {"name", KV_STRING, s->name, sizeof(s->name)},
+        {"icon", KV_STRING, s->icon, sizeof(s->icon)},
+        {"actions", KV_RAW, s->actions, sizeof(s->actions)},
+        {"on", KV_BOOL, &s->on, sizeof(s->on)},
+        {"ts", KV_INT, &s->ts, sizeof(s->ts)},
+    };
+
+    memcpy(db, tmp, sizeof(tmp));
+}
+
+/* the binary record must give back every property, an empty raw property comes back with len 0 */
+static OPERATE_RET __schedule_check(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    kv_db_t db[9], out[9];
+    uint8_t *buf = NULL;
+    uint32_t len = 0;
+
+    __schedule_db(&sg_schedule, db);
+    __schedule_db(&sg_schedule_out, out);
+    TUYA_CALL_ERR_RETURN(kv_serialize_bin(db, CNTSOF(db), &buf, &len));
+    rt = kv_deserialize_bin(buf, len, out, CNTSOF(out));
+    tal_free(buf);
+    if (OPRT_OK != rt || memcmp(&sg_schedule, &sg_schedule_out, sizeof(sg_schedule)) || out[4].len != db[4].len) {
+        PR_ERR("schedule round trip fails %d", rt);
+        return OPRT_COM_ERROR;
+    }
+
+    db[4].len = 0;
+    TUYA_CALL_ERR_RETURN(kv_serialize_bin(db, CNTSOF(db), &buf, &len));
+    rt = kv_deserialize_bin(buf, len, out, CNTSOF(out));
+    tal_free(buf);
+    if (OPRT_OK != rt || out[4].len != 0) {
+        PR_ERR("empty raw property comes back with len %d, %d", out[4].len, rt);
+        return OPRT_COM_ERROR;
+    }
+
+    return OPRT_OK;
+}
+
+static void __bench_record(const char *name, kv_db_t *db, kv_db_t *out, uint32_t cnt)
+{
+    uint32_t i, json_len = 0, bin_len = 0;
+    char *json = NULL;
+    uint8_t *bin = NULL;
+    uint64_t start, json_enc, bin_enc, json_dec, bin_dec;
+    int rt = OPRT_OK;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        tal_free(json);
+        kv_serialize(db, cnt, &json, &json_len);
+    }
+    json_enc = (__bench_time_ns() - start) / BENCH_ROUNDS;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        tal_free(bin);
+        kv_serialize_bin(db, cnt, &bin, &bin_len);
+    }
+    bin_enc = (__bench_time_ns() - start) / BENCH_ROUNDS;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        kv_deserialize_bin(bin, bin_len, out, cnt);
+    }
+    bin_dec = (__bench_time_ns() - start) / BENCH_ROUNDS;
+
+    PR_NOTICE("%-8s json %3u B encode %5u ns | bin %3u B encode %5u ns decode %5u ns", name, json_len,
+              (uint32_t)json_enc, bin_len, (uint32_t)bin_enc, (uint32_t)bin_dec);
+
+    rt = kv_deserialize(json, out, cnt);
+    if (OPRT_OK == rt) {
+        start = __bench_time_ns();
+        for (i = 0; i < BENCH_ROUNDS; i++) {
+            kv_deserialize(json, out, cnt);
+        }
+        json_dec = (__bench_time_ns() - start) / BENCH_ROUNDS;
+        PR_NOTICE("%-8s json decode %5u ns", name, (uint32_t)json_dec);
+    } else {
+        PR_NOTICE("%-8s json decode fails %d", name, rt);
+    }
+
+    tal_free(json);
+    tal_free(bin);
+}
+
+static void __bench_main(void)
+{
+    uint32_t i;
+    kv_db_t db[9], out[9];
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    for (i = 0; i < sizeof(sg_schedule.dps); i++) {
+        sg_schedule.dps[i] = i * 11;
+    }
+    for (i = 0; i < sizeof(sg_scene.actions); i++) {
+        sg_scene.actions[i] = i * 3;
+    }
+
+    if (OPRT_OK != __schedule_check()) {
+        return;
+    }
+    PR_NOTICE("check: binary round trip ok, empty raw property has len 0");
+
+    __schedule_db(&sg_schedule, db);
+    __schedule_db(&sg_schedule_out, out);
+    __bench_record("schedule", db, out, 9);
+
+    __scene_db(&sg_scene, db);
+    __scene_db(&sg_scene_out, out);
+    __bench_record("scene", db, out, 7);
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
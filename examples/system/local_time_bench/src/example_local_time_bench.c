@@ -0,0 +1,202 @@
+/**
+ * @file example_local_time_bench.c
+ * @brief Benchmark of the cached local time against the full calendar conversion.
+ *
+ * tal_time_get_local_now and tal_time_get_local_now_str keep the broken-down date of the local day and the time zone
+ * offset, and only work out the time of day per call. The uncached path adds the time zone, scans the summer time
+ * table and runs tal_time_gmtime_r on every call, and the log used snprintf on top of it. The example checks that
+ * both agree over three days that cross a summer time change, then reports the time per call of each.
+ *
+ * Usage on Linux: ./local_time_bench
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+
+#include "tal_api.h"
+#include "tkl_output.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#define BENCH_ROUNDS    1000000
+#define BENCH_TIME_ZONE 3600
+
+/* 2024-10-24 12:00:00 UTC, summer time ends 2024-10-27 01:00:00 UTC */
+#define BENCH_CHECK_START 1729771200
+#define BENCH_CHECK_SPAN  (3 * 86400)
+#define BENCH_CHECK_STEP  37
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const SUM_ZONE_S sg_sum_zone[] = {
+    {1711846800, 1729990800},
+    {1743296400, 1761440400},
+};
+
+static volatile int sg_sink;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static uint64_t __bench_time_ns(void)
+{
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+    return (uint64_t)tal_system_get_millisecond() * 1000000ULL;
+#endif
+}
+
+/* the uncached path: time zone, summer time table and a full calendar conversion per call */
+static void __local_time_full(TIME_T utc, POSIX_TM_S *tm)
+{
+    int time_zone = 0;
+    TIME_T local_time = 0;
+
+    tal_time_get_time_zone_seconds(&time_zone);
+    local_time = utc + time_zone;
+    if (tal_time_is_in_sum_zone(utc)) {
+        local_time += 3600;
+    }
+    tal_time_gmtime_r(&local_time, tm);
+}
+
+static OPERATE_RET __local_time_check(void)
+{
+    TIME_T t;
+    POSIX_TM_S cached, full;
+    uint32_t checked = 0;
+
+    for (t = BENCH_CHECK_START; t < BENCH_CHECK_START + BENCH_CHECK_SPAN; t += BENCH_CHECK_STEP) {
+        tal_time_set_posix(t, 0);
+        memset(&cached, 0, sizeof(cached));
+        memset(&full, 0, sizeof(full));
+        tal_time_get_local_time_custom(0, &cached);
+        __local_time_full(tal_time_get_posix(), &full);
+        if (memcmp(&cached, &full, sizeof(cached))) {
+            PR_ERR("mismatch at %u: %02d-%02d %02d:%02d:%02d vs %02d-%02d %02d:%02d:%02d", (uint32_t)t,
+                   cached.tm_mon + 1, cached.tm_mday, cached.tm_hour, cached.tm_min, cached.tm_sec, full.tm_mon + 1,
+                   full.tm_mday, full.tm_hour, full.tm_min, full.tm_sec);
+            return OPRT_COM_ERROR;
+        }
+        checked++;
+    }
+    PR_NOTICE("check: %u timestamps over 3 days across the summer time end agree", checked);
+
+    return OPRT_OK;
+}
+
+static void __bench_main(void)
+{
+    uint32_t i;
+    uint64_t start, full_ns, cached_ns, full_str_ns, cached_str_ns;
+    POSIX_TM_S tm;
+    char str[24];
+
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    tal_time_service_init();
+    tal_time_set_time_zone_seconds(BENCH_TIME_ZONE);
+    tal_time_set_sum_zone_tbl(sg_sum_zone, CNTSOF(sg_sum_zone));
+
+    if (OPRT_OK != __local_time_check()) {
+        return;
+    }
+
+    tal_time_set_posix(BENCH_CHECK_START, 0);
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        __local_time_full(tal_time_get_posix(), &tm);
+        sg_sink += tm.tm_sec;
+    }
+    full_ns = __bench_time_ns() - start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        tal_time_get_local_now(&tm, NULL);
+        sg_sink += tm.tm_sec;
+    }
+    cached_ns = __bench_time_ns() - start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        SYS_TICK_T ms = tal_time_get_posix_ms();
+        __local_time_full((TIME_T)(ms / 1000), &tm);
+        sg_sink += snprintf(str, sizeof(str), "%02d-%02d %02d:%02d:%02d.%03d", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                            tm.tm_min, tm.tm_sec, (int)(ms % 1000));
+    }
+    full_str_ns = __bench_time_ns() - start;
+
+    start = __bench_time_ns();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sg_sink += tal_time_get_local_now_str(str, sizeof(str), TRUE);
+    }
+    cached_str_ns = __bench_time_ns() - start;
+
+    PR_NOTICE("local time: full %4u ns, tal_time_get_local_now     %4u ns, x%u.%02u",
+              (uint32_t)(full_ns / BENCH_ROUNDS), (uint32_t)(cached_ns / BENCH_ROUNDS),
+              (uint32_t)(full_ns / cached_ns), (uint32_t)(full_ns * 100 / cached_ns % 100));
+    PR_NOTICE("log stamp : full %4u ns, tal_time_get_local_now_str %4u ns, x%u.%02u, \"%s\"",
+              (uint32_t)(full_str_ns / BENCH_ROUNDS), (uint32_t)(cached_str_ns / BENCH_ROUNDS),
+              (uint32_t)(full_str_ns / cached_str_ns), (uint32_t)(full_str_ns * 100 / cached_str_ns % 100), str);
+}
+
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    __bench_main();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
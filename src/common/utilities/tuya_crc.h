@@ -0,0 +1,120 @@
+/**
+ * @file tuya_crc.h
+ * @brief Header file for the CRC calculation functions.
+ *
+ * This file declares incremental and one-shot functions for CRC-32/IEEE,
+ * CRC-32C/Castagnoli and CRC-16/MODBUS. The software implementation uses
+ * slicing-by-8 tables for the 32-bit variants. Platforms with a CRC engine
+ * can provide tkl_crc.h and enable ENABLE_PLATFORM_CRC, the software
+ * implementation is used for the variants the platform does not support.
+ *
+ * The *_update functions work on the raw CRC register: start with the
+ * *_INIT value, feed the data in any number of pieces, and finish with
+ * *_final. The one-shot functions do all three steps.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TUYA_CRC_H__
+#define __TUYA_CRC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TUYA_CRC32_INIT  0xFFFFFFFFUL
+#define TUYA_CRC32C_INIT 0xFFFFFFFFUL
+#define TUYA_CRC16_INIT  0xFFFF
+
+/**
+ * @brief Feed data into a CRC-32/IEEE calculation.
+ *
+ * @param[in] crc: current CRC register, TUYA_CRC32_INIT for the first piece
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @return the updated CRC register
+ */
+uint32_t tuya_crc32_update(uint32_t crc, const void *data, size_t size);
+
+/**
+ * @brief Finish a CRC-32/IEEE calculation.
+ *
+ * @param[in] crc: CRC register
+ *
+ * @return the CRC-32 value
+ */
+uint32_t tuya_crc32_final(uint32_t crc);
+
+/**
+ * @brief Calculate the CRC-32/IEEE value of data.
+ *
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @return the CRC-32 value
+ */
+uint32_t tuya_crc32(const void *data, size_t size);
+
+/**
+ * @brief Feed data into a CRC-32C/Castagnoli calculation.
+ *
+ * @param[in] crc: current CRC register, TUYA_CRC32C_INIT for the first piece
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @return the updated CRC register
+ */
+uint32_t tuya_crc32c_update(uint32_t crc, const void *data, size_t size);
+
+/**
+ * @brief Finish a CRC-32C/Castagnoli calculation.
+ *
+ * @param[in] crc: CRC register
+ *
+ * @return the CRC-32C value
+ */
+uint32_t tuya_crc32c_final(uint32_t crc);
+
+/**
+ * @brief Calculate the CRC-32C/Castagnoli value of data.
+ *
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @return the CRC-32C value
+ */
+uint32_t tuya_crc32c(const void *data, size_t size);
+
+/**
+ * @brief Feed data into a CRC-16/MODBUS calculation.
+ *
+ * @param[in] crc: current CRC register, TUYA_CRC16_INIT for the first piece
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @note CRC-16/MODBUS has no final xor, the register is the CRC value.
+ *
+ * @return the updated CRC register
+ */
+uint16_t tuya_crc16_update(uint16_t crc, const void *data, size_t size);
+
+/**
+ * @brief Calculate the CRC-16/MODBUS value of data.
+ *
+ * @param[in] data: data to be calculated
+ * @param[in] size: size of data in bytes
+ *
+ * @return the CRC-16 value
+ */
+uint16_t tuya_crc16(const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TUYA_CRC_H__ */
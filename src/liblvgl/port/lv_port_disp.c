@@ -16,6 +16,7 @@
 #include "tkl_memory.h"
 #include "tal_api.h"
 #include "tdl_display_manage.h"
+#include "tdl_display_format.h"
 /*********************
  *      DEFINES
  *********************/
@@ -29,6 +30,18 @@
 #define LV_MEM_CUSTOM_REALLOC tkl_system_realloc
 #endif
 
+#if defined(LVGL_ENABLE_ASYNC_FLUSH) && (LVGL_ENABLE_ASYNC_FLUSH == 1)
+#define DISP_FLUSH_ASYNC 1
+#else
+#define DISP_FLUSH_ASYNC 0
+#endif
+
+#if defined(LVGL_MONO_DITHER) && (LVGL_MONO_DITHER == 1)
+#define DISP_MONO_MODE TDL_DISP_MONO_MODE_DITHER
+#else
+#define DISP_MONO_MODE TDL_DISP_MONO_MODE_THRESHOLD
+#endif
+
 
 /**********************
  *      TYPEDEFS
@@ -49,6 +62,10 @@ static lv_color_format_t __disp_get_lv_color_format(TUYA_DISPLAY_PIXEL_FMT_E pix
 
 static uint8_t __disp_get_pixels_size_bytes(TUYA_DISPLAY_PIXEL_FMT_E pixel_fmt);
 
+#if DISP_FLUSH_ASYNC
+static void disp_flush_wait(lv_display_t * disp);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -56,6 +73,21 @@ static TDL_DISP_HANDLE_T sg_tdl_disp_hdl = NULL;
 static TDL_DISP_DEV_INFO_T sg_display_info;
 static TDL_DISP_FRAME_BUFF_T *sg_p_display_fb = NULL;
 static uint8_t *sg_rotate_buf = NULL;
+static TDL_DISP_DIRTY_LIST_T sg_dirty_list;
+
+#if DISP_FLUSH_ASYNC
+/*sg_p_display_fb is the buffer being drawn, the other one may still be on the bus*/
+static TDL_DISP_FRAME_BUFF_T *sg_display_fb[2] = {NULL, NULL};
+static uint8_t sg_display_fb_idx = 0;
+static volatile bool sg_display_fb_busy[2] = {false, false};
+/*Areas drawn into the other buffer that this one is still missing*/
+static TDL_DISP_DIRTY_LIST_T sg_sync_list;
+static bool sg_frame_started = false;
+/*With a single frame buffer LVGL is told the flush is ready when the transfer ends*/
+static volatile bool sg_flush_ready_deferred = false;
+static SEM_HANDLE sg_flush_done_sem = NULL;
+static lv_display_t *sg_disp = NULL;
+#endif
 /**********************
  *      MACROS
  **********************/
@@ -78,6 +110,10 @@ void lv_port_disp_init(char *device)
      * -----------------------------------*/
     lv_display_t * disp = lv_display_create(sg_display_info.width, sg_display_info.height);
     lv_display_set_flush_cb(disp, disp_flush);
+#if DISP_FLUSH_ASYNC
+    sg_disp = disp;
+    lv_display_set_flush_wait_cb(disp, disp_flush_wait);
+#endif
 
     lv_color_format_t color_format = __disp_get_lv_color_format(sg_display_info.fmt);
     PR_NOTICE("lv_color_format:%d", color_format);
@@ -116,9 +152,12 @@ void lv_port_disp_init(char *device)
 
         PR_NOTICE("rotation:%d", sg_display_info.rotation);
 
-        sg_rotate_buf = __disp_draw_buf_align_alloc(buf_len);
-        if (sg_rotate_buf == NULL) {
-            PR_ERR("lvgl rotate buffer malloc fail!\n");
+        /*Monochrome and I2 are converted straight from the unrotated draw buffer*/
+        if (sg_display_info.fmt != TUYA_PIXEL_FMT_MONOCHROME && sg_display_info.fmt != TUYA_PIXEL_FMT_I2) {
+            sg_rotate_buf = __disp_draw_buf_align_alloc(buf_len);
+            if (sg_rotate_buf == NULL) {
+                PR_ERR("lvgl rotate buffer malloc fail!\n");
+            }
         }
     }
 }
@@ -180,6 +219,27 @@ static void disp_init(char *device)
     sg_p_display_fb->fmt    = sg_display_info.fmt;
     sg_p_display_fb->width  = sg_display_info.width;
     sg_p_display_fb->height = sg_display_info.height;
+
+#if DISP_FLUSH_ASYNC
+    rt = tal_semaphore_create_init(&sg_flush_done_sem, 0, 1);
+    if(rt != OPRT_OK) {
+        PR_ERR("create flush semaphore failed, rt: %d", rt);
+        return;
+    }
+
+    sg_display_fb[0] = sg_p_display_fb;
+
+#if defined(LVGL_ASYNC_FLUSH_DOUBLE_FB) && (LVGL_ASYNC_FLUSH_DOUBLE_FB == 1)
+    sg_display_fb[1] = tdl_disp_create_frame_buff(DISP_FB_TP_PSRAM, frame_len);
+    if(NULL == sg_display_fb[1]) {
+        PR_ERR("create second display frame buff failed, use one frame buff");
+    } else {
+        sg_display_fb[1]->fmt    = sg_display_info.fmt;
+        sg_display_fb[1]->width  = sg_display_info.width;
+        sg_display_fb[1]->height = sg_display_info.height;
+    }
+#endif
+#endif
 }
 
 static uint8_t *__disp_draw_buf_align_alloc(uint32_t size_bytes)
@@ -230,41 +290,51 @@ static uint8_t __disp_get_pixels_size_bytes(TUYA_DISPLAY_PIXEL_FMT_E pixel_fmt)
     }
 }
 
-static void __disp_mono_write_point(uint32_t x, uint32_t y, bool enable, TDL_DISP_FRAME_BUFF_T *fb)
+/*area is the area on the display, px_map is still drawn in the orientation before the rotation*/
+static void __disp_get_rgb565_src(const lv_area_t * area, uint8_t * px_map, lv_display_rotation_t rotation,
+                                  TDL_DISP_RGB565_SRC_T *src)
 {
-    if(NULL == fb || x >= fb->width || y >= fb->height) {
-        PR_ERR("Point (%d, %d) out of bounds", x, y);
-        return;
+    const uint16_t *px = (const uint16_t *)px_map;
+    int32_t src_w = lv_area_get_width(area);
+    int32_t src_h = lv_area_get_height(area);
+    int32_t stride = 0;
+
+    if(LV_DISPLAY_ROTATION_90 == rotation || LV_DISPLAY_ROTATION_270 == rotation) {
+        src_w = lv_area_get_height(area);
+        src_h = lv_area_get_width(area);
     }
 
-    uint32_t write_byte_index = y * (fb->width/8) + x/8;
-    uint8_t write_bit = x%8;
-
-    if (enable) {
-        fb->frame[write_byte_index] |= (1 << write_bit);
-    } else {
-        fb->frame[write_byte_index] &= ~(1 << write_bit);
-    }
-}
-
-static void __disp_i2_write_point(uint32_t x, uint32_t y, uint8_t color, TDL_DISP_FRAME_BUFF_T *fb)
-{
-    if(NULL == fb || x >= fb->width || y >= fb->height) {
-        PR_ERR("Point (%d, %d) out of bounds", x, y);
-        return;
+    stride = lv_draw_buf_width_to_stride(src_w, LV_COLOR_FORMAT_RGB565) / sizeof(uint16_t);
+
+    /*Same mapping as lv_draw_sw_rotate*/
+    switch(rotation) {
+        case LV_DISPLAY_ROTATION_90:
+            src->base     = px + src_w - 1;
+            src->col_step = stride;
+            src->row_step = -1;
+            break;
+        case LV_DISPLAY_ROTATION_180:
+            src->base     = px + (src_h - 1) * stride + src_w - 1;
+            src->col_step = -1;
+            src->row_step = -stride;
+            break;
+        case LV_DISPLAY_ROTATION_270:
+            src->base     = px + (src_h - 1) * stride;
+            src->col_step = -stride;
+            src->row_step = 1;
+            break;
+        default:
+            src->base     = px;
+            src->col_step = 1;
+            src->row_step = stride;
+            break;
     }
-
-    uint32_t write_byte_index = y * (fb->width/4) + x/4;
-    uint8_t write_bit = (x%4)*2;
-    uint8_t cleared = fb->frame[write_byte_index] & (~(0x03 << write_bit)); // Clear the bits we are going to write
-
-    fb->frame[write_byte_index] = cleared | ((color & 0x03) << write_bit);
 }
 
-static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px_map, \
-                                            lv_color_format_t cf, TDL_DISP_FRAME_BUFF_T *fb)
+static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px_map, lv_color_format_t cf,\
+                                            lv_display_rotation_t rotation, TDL_DISP_FRAME_BUFF_T *fb)
 {
-    uint32_t offset = 0, x = 0, y = 0;
+    uint32_t offset = 0, y = 0;
     uint8_t *disp_buf = NULL;
     int32_t width = 0;
 
@@ -277,23 +347,21 @@ static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px
 
     disp_buf = fb->frame;
     
-    if(fb->fmt == TUYA_PIXEL_FMT_MONOCHROME) {
-        for(y = area->y1 ; y <= area->y2; y++) {
-            for(x = area->x1; x <= area->x2; x++) {
-                uint16_t *px_map_u16 = (uint16_t *)px_map;
-                bool enable = (px_map_u16[offset++]> 0x8FFF) ? false : true;
-                __disp_mono_write_point(x, y, enable, fb);
-            }
-        }
-    }else if(fb->fmt == TUYA_PIXEL_FMT_I2) { 
-        for(y = area->y1 ; y <= area->y2; y++) {
-            for(x = area->x1; x <= area->x2; x++) {
-                lv_color16_t *px_map_color16 = (lv_color16_t *)px_map;
-                uint8_t grey2 = ~((px_map_color16[offset].red + px_map_color16[offset].green*2 +\
-                                 px_map_color16[offset].blue) >> 2);
-                offset++;
-                __disp_i2_write_point(x, y, grey2, fb);
-            }
+    if(fb->fmt == TUYA_PIXEL_FMT_MONOCHROME || fb->fmt == TUYA_PIXEL_FMT_I2) {
+        TDL_DISP_RGB565_SRC_T src;
+        TDL_DISP_AREA_T fb_area = {
+            .x0 = area->x1,
+            .y0 = area->y1,
+            .x1 = area->x2,
+            .y1 = area->y2,
+        };
+
+        __disp_get_rgb565_src(area, px_map, rotation, &src);
+
+        if(fb->fmt == TUYA_PIXEL_FMT_MONOCHROME) {
+            tdl_disp_rgb565_to_mono(fb, &fb_area, &src, DISP_MONO_MODE);
+        }else {
+            tdl_disp_rgb565_to_i2(fb, &fb_area, &src);
         }
     }else {
         if(LV_COLOR_FORMAT_RGB565 == cf) {
@@ -314,6 +382,103 @@ static void __disp_fill_display_framebuffer(const lv_area_t * area, uint8_t * px
     }
 }
 
+#if DISP_FLUSH_ASYNC
+static void __disp_flush_done_cb(TDL_DISP_FRAME_BUFF_T *frame_buff, OPERATE_RET result, void *arg)
+{
+    volatile bool *is_busy = (volatile bool *)arg;
+
+    if(result != OPRT_OK) {
+        PR_ERR("display flush failed, rt: %d", result);
+    }
+
+    *is_busy = false;
+
+    if(sg_flush_ready_deferred) {
+        sg_flush_ready_deferred = false;
+        lv_display_flush_ready(sg_disp);
+    }
+
+    tal_semaphore_post(sg_flush_done_sem);
+}
+
+/*Called by LVGL before it reuses a draw buffer or ends the refresh*/
+static void disp_flush_wait(lv_display_t * disp)
+{
+    while(sg_flush_ready_deferred) {
+        tal_semaphore_wait(sg_flush_done_sem, SEM_WAIT_FOREVER);
+    }
+}
+
+static void __disp_copy_fb_area(TDL_DISP_FRAME_BUFF_T *dst, TDL_DISP_FRAME_BUFF_T *src, TDL_DISP_AREA_T *area)
+{
+    uint32_t stride = src->len / src->height;
+    uint32_t offset = 0, len = stride, y = 0;
+    uint8_t per_pixel_byte = __disp_get_pixels_size_bytes(src->fmt);
+
+    /*Monochrome and I2 pack several pixels into a byte, copy whole lines*/
+    offset = area->y0 * stride;
+    if(per_pixel_byte) {
+        offset += area->x0 * per_pixel_byte;
+        len = (area->x1 - area->x0 + 1) * per_pixel_byte;
+    }
+
+    for(y = area->y0; y <= area->y1; y++) {
+        memcpy(dst->frame + offset, src->frame + offset, len);
+        offset += stride;
+    }
+}
+
+/*Make the buffer about to be drawn hold the whole current screen*/
+static void __disp_frame_begin(void)
+{
+    TDL_DISP_FRAME_BUFF_T *front = sg_display_fb[sg_display_fb_idx ^ 1];
+    uint8_t i = 0;
+
+    while(sg_display_fb_busy[sg_display_fb_idx]) {
+        tal_semaphore_wait(sg_flush_done_sem, SEM_WAIT_FOREVER);
+    }
+
+    if(front) {
+        for(i = 0; i < sg_sync_list.cnt; i++) {
+            __disp_copy_fb_area(sg_p_display_fb, front, &sg_sync_list.area[i]);
+        }
+    }
+    tdl_disp_dirty_list_reset(&sg_sync_list);
+
+    sg_frame_started = true;
+}
+
+/*Queue the frame to the transfer task, returns true if lv_display_flush_ready is left to the task*/
+static bool __disp_frame_submit(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    uint8_t idx = sg_display_fb_idx;
+    TDL_DISP_FRAME_BUFF_T *back = sg_display_fb[idx ^ 1];
+
+    sg_display_fb_busy[idx] = true;
+    sg_flush_ready_deferred = (NULL == back);
+
+    rt = tdl_disp_dev_flush_async(sg_tdl_disp_hdl, sg_p_display_fb, &sg_dirty_list,\
+                                  __disp_flush_done_cb, (void *)&sg_display_fb_busy[idx]);
+    if(rt != OPRT_OK) {
+        PR_ERR("queue display flush failed, rt: %d", rt);
+        sg_display_fb_busy[idx] = false;
+        sg_flush_ready_deferred = false;
+    }
+
+    if(back) {
+        memcpy(&sg_sync_list, &sg_dirty_list, sizeof(TDL_DISP_DIRTY_LIST_T));
+        sg_display_fb_idx = idx ^ 1;
+        sg_p_display_fb = back;
+    }
+
+    tdl_disp_dirty_list_reset(&sg_dirty_list);
+    sg_frame_started = false;
+
+    return sg_flush_ready_deferred;
+}
+#endif
+
 static void disp_deinit(void)
 {
 
@@ -343,6 +508,9 @@ static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px
 {
     uint8_t *color_ptr = px_map;
     lv_area_t *target_area = (lv_area_t *)area;
+    lv_area_t rotated_area;
+    lv_display_rotation_t src_rotation = LV_DISPLAY_ROTATION_0;
+    bool is_ready_deferred = false;
 
     if (disp_flush_enabled) {
 
@@ -350,7 +518,6 @@ static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px
 
         if(sg_rotate_buf) {
             lv_display_rotation_t rotation = lv_display_get_rotation(disp);
-            lv_area_t rotated_area;
 
             rotated_area.x1 = area->x1;
             rotated_area.x2 = area->x2;
@@ -374,16 +541,45 @@ static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px
 
             color_ptr = sg_rotate_buf;
             target_area = &rotated_area;
+        }else if(sg_p_display_fb->fmt == TUYA_PIXEL_FMT_MONOCHROME || sg_p_display_fb->fmt == TUYA_PIXEL_FMT_I2) {
+            /*Rotated while converting, px_map is read in place*/
+            src_rotation = lv_display_get_rotation(disp);
+            lv_area_copy(&rotated_area, area);
+            lv_display_rotate_area(disp, &rotated_area);
+            target_area = &rotated_area;
+        }
+
+#if DISP_FLUSH_ASYNC
+        if(false == sg_frame_started) {
+            __disp_frame_begin();
         }
+#endif
+
+        __disp_fill_display_framebuffer(target_area, color_ptr, cf, src_rotation, sg_p_display_fb);
 
-        __disp_fill_display_framebuffer(target_area, color_ptr, cf, sg_p_display_fb);
+        TDL_DISP_AREA_T dirty_area = {
+            .x0 = target_area->x1,
+            .y0 = target_area->y1,
+            .x1 = target_area->x2,
+            .y1 = target_area->y2,
+        };
+        tdl_disp_dirty_list_add(&sg_dirty_list, &dirty_area);
 
+        /*Only send the areas redrawn in this frame*/
         if (lv_disp_flush_is_last(disp)) {
-            tdl_disp_dev_flush(sg_tdl_disp_hdl, sg_p_display_fb);
+#if DISP_FLUSH_ASYNC
+            /*px_map is already copied, LVGL can draw the next frame while this one is sent*/
+            is_ready_deferred = __disp_frame_submit();
+#else
+            tdl_disp_dev_flush_area(sg_tdl_disp_hdl, sg_p_display_fb, &sg_dirty_list);
+            tdl_disp_dirty_list_reset(&sg_dirty_list);
+#endif
         }
     }
 
-    lv_disp_flush_ready(disp);
+    if (false == is_ready_deferred) {
+        lv_disp_flush_ready(disp);
+    }
 }
 
 #else /*Enable this file at the top*/
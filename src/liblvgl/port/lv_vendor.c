@@ -11,25 +11,191 @@
 #include "tkl_mutex.h"
 #include "tkl_semaphore.h"
 
+#if defined(LVGL_ENABLE_TASK_STATS) && (LVGL_ENABLE_TASK_STATS == 1)
+#define LV_VENDOR_STATS 1
+#else
+#define LV_VENDOR_STATS 0
+#endif
+
+typedef enum {
+    WAKE_UPDATE,
+    WAKE_INVALIDATE,
+    WAKE_INDEV,
+    WAKE_MAX
+} lvgl_wake_reason_t;
+
 static TKL_THREAD_HANDLE g_disp_thread_handle = NULL;
 static TKL_MUTEX_HANDLE g_disp_mutex = NULL;
 static TKL_SEM_HANDLE lvgl_sem = NULL;
+static TKL_SEM_HANDLE lvgl_wake_sem = NULL;
+/*One flag per reason, a byte store is atomic so they can be set from an interrupt*/
+static volatile bool lvgl_wake_flag[WAKE_MAX];
+/*Set while the LVGL task holds g_disp_mutex*/
+static volatile bool lvgl_in_handler = false;
 static uint8_t lvgl_task_state = STATE_INIT;
 static bool lv_vendor_initialized = false;
 
+#if LV_VENDOR_STATS
+static lv_vendor_stats_t lvgl_stats;
+static uint32_t lvgl_lock_start = 0;
+static uint32_t lvgl_refr_start = 0;
+#endif
+
 static uint32_t lv_tick_get_callback(void)
 {
     return (uint32_t)tkl_system_get_millisecond();
 }
 
+#if LV_VENDOR_STATS
+static void lv_vendor_stats_add(uint32_t *sum, uint32_t *max, uint32_t value)
+{
+    *sum += value;
+    if (value > *max) {
+        *max = value;
+    }
+}
+#endif
+
+static void lv_vendor_wake(lvgl_wake_reason_t reason)
+{
+    lvgl_wake_flag[reason] = true;
+
+    if (lvgl_wake_sem) {
+        tkl_semaphore_post(lvgl_wake_sem);
+    }
+}
+
+/*Clear the wake flags, returns true if an input device asked to be read*/
+static bool lv_vendor_take_wake(void)
+{
+    bool is_indev = lvgl_wake_flag[WAKE_INDEV];
+    bool is_woken = false;
+    uint8_t i;
+
+    for (i = 0; i < WAKE_MAX; i++) {
+        if (lvgl_wake_flag[i]) {
+            lvgl_wake_flag[i] = false;
+            is_woken = true;
+#if LV_VENDOR_STATS
+            if (i == WAKE_UPDATE) {
+                lvgl_stats.wakeup_update++;
+            } else if (i == WAKE_INVALIDATE) {
+                lvgl_stats.wakeup_invalidate++;
+            } else {
+                lvgl_stats.wakeup_indev++;
+            }
+#endif
+        }
+    }
+
+#if LV_VENDOR_STATS
+    lvgl_stats.wakeup_cnt++;
+    if (false == is_woken) {
+        lvgl_stats.wakeup_timer++;
+    }
+#else
+    (void)is_woken;
+#endif
+
+    return is_indev;
+}
+
+static void lv_vendor_read_event_indev(void)
+{
+    lv_indev_t *indev = lv_indev_get_next(NULL);
+
+    while (indev) {
+        if (lv_indev_get_mode(indev) == LV_INDEV_MODE_EVENT) {
+            lv_indev_read(indev);
+        }
+        indev = lv_indev_get_next(indev);
+    }
+}
+
+static void lv_vendor_refr_request_cb(lv_event_t *e)
+{
+    /*The LVGL task renders its own invalidations with the refresh timer*/
+    if (false == lvgl_in_handler) {
+        lv_vendor_wake(WAKE_INVALIDATE);
+    }
+}
+
+#if LV_VENDOR_STATS
+static void lv_vendor_refr_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    uint32_t now = (uint32_t)tkl_system_get_millisecond();
+
+    if (code == LV_EVENT_REFR_START) {
+        lvgl_refr_start = now;
+    } else if (code == LV_EVENT_RENDER_READY) {
+        /*Only refreshes that rendered something are frames*/
+        lvgl_stats.frame_cnt++;
+        lv_vendor_stats_add(&lvgl_stats.frame_time_sum, &lvgl_stats.frame_time_max, now - lvgl_refr_start);
+    }
+}
+#endif
+
 void lv_vendor_disp_lock(void)
 {
     tkl_mutex_lock(g_disp_mutex);
+
+#if LV_VENDOR_STATS
+    if (false == lvgl_in_handler) {
+        lvgl_lock_start = (uint32_t)tkl_system_get_millisecond();
+    }
+#endif
 }
 
 void lv_vendor_disp_unlock(void)
 {
+    /*Called from an LVGL callback, the task is running already*/
+    if (lvgl_in_handler) {
+        tkl_mutex_unlock(g_disp_mutex);
+        return;
+    }
+
+#if LV_VENDOR_STATS
+    lvgl_stats.lock_cnt++;
+    lv_vendor_stats_add(&lvgl_stats.lock_hold_sum, &lvgl_stats.lock_hold_max,
+                        (uint32_t)tkl_system_get_millisecond() - lvgl_lock_start);
+#endif
+
     tkl_mutex_unlock(g_disp_mutex);
+
+    /*Render the changes made under the lock without waiting for the next LVGL timer*/
+    lv_vendor_wake(WAKE_UPDATE);
+}
+
+void lv_vendor_wakeup(void)
+{
+    lv_vendor_wake(WAKE_UPDATE);
+}
+
+void lv_vendor_indev_wakeup(void)
+{
+    lv_vendor_wake(WAKE_INDEV);
+}
+
+void lv_vendor_get_stats(lv_vendor_stats_t *stats)
+{
+    if (NULL == stats) {
+        return;
+    }
+
+#if LV_VENDOR_STATS
+    /*Not locked so it can be called from LVGL callbacks too, the counters are only informative*/
+    memcpy(stats, &lvgl_stats, sizeof(lv_vendor_stats_t));
+#else
+    memset(stats, 0, sizeof(lv_vendor_stats_t));
+#endif
+}
+
+void lv_vendor_reset_stats(void)
+{
+#if LV_VENDOR_STATS
+    memset(&lvgl_stats, 0, sizeof(lv_vendor_stats_t));
+#endif
 }
 
 void lv_vendor_init(void *device)
@@ -57,6 +223,20 @@ void lv_vendor_init(void *device)
         return;
     }
 
+    if (OPRT_OK != tkl_semaphore_create_init(&lvgl_wake_sem, 0, 1)) {
+        LV_LOG_ERROR("%s wake semaphore init failed\n", __func__);
+        return;
+    }
+
+    lv_display_t *disp = lv_display_get_default();
+    if (disp) {
+        lv_display_add_event_cb(disp, lv_vendor_refr_request_cb, LV_EVENT_REFR_REQUEST, NULL);
+#if LV_VENDOR_STATS
+        lv_display_add_event_cb(disp, lv_vendor_refr_event_cb, LV_EVENT_REFR_START, NULL);
+        lv_display_add_event_cb(disp, lv_vendor_refr_event_cb, LV_EVENT_RENDER_READY, NULL);
+#endif
+    }
+
     lv_vendor_initialized = true;
 
     LV_LOG_INFO("%s complete\n", __func__);
@@ -65,28 +245,48 @@ void lv_vendor_init(void *device)
 static void lv_tast_entry(void *arg)
 {
     uint32_t sleep_time;
+    bool is_indev = false;
+#if LV_VENDOR_STATS
+    uint32_t start;
+#endif
 
     lvgl_task_state = STATE_RUNNING;
 
     tkl_semaphore_post(lvgl_sem);
 
     while(lvgl_task_state == STATE_RUNNING) {
-        lv_vendor_disp_lock();
+        tkl_mutex_lock(g_disp_mutex);
+        lvgl_in_handler = true;
+#if LV_VENDOR_STATS
+        start = (uint32_t)tkl_system_get_millisecond();
+#endif
+
+        if (is_indev) {
+            lv_vendor_read_event_indev();
+        }
         sleep_time = lv_task_handler();
-        lv_vendor_disp_unlock();
+
+#if LV_VENDOR_STATS
+        lv_vendor_stats_add(&lvgl_stats.handler_time_sum, &lvgl_stats.handler_time_max,
+                            (uint32_t)tkl_system_get_millisecond() - start);
+#endif
+        lvgl_in_handler = false;
+        tkl_mutex_unlock(g_disp_mutex);
 
         #if CONFIG_LVGL_TASK_SLEEP_TIME_CUSTOMIZE
             sleep_time = CONFIG_LVGL_TASK_SLEEP_TIME;
         #else
-            if (sleep_time > 500) {
-                sleep_time = 500;
-            } else if (sleep_time < 4) {
-                sleep_time = 4;
+            /*Sleep until the next LVGL timer is due, wake-ups cut the sleep short*/
+            if (sleep_time == LV_NO_TIMER_READY) {
+                sleep_time = TKL_SEM_WAIT_FOREVER;
+            } else if (sleep_time == 0) {
+                sleep_time = 1; // let the lower priority tasks run
             }
         #endif
 
-        tkl_system_sleep(sleep_time);
+        tkl_semaphore_wait(lvgl_wake_sem, sleep_time);
 
+        is_indev = lv_vendor_take_wake();
     }
 
     tkl_semaphore_post(lvgl_sem);
@@ -121,6 +321,8 @@ void lv_vendor_stop(void)
 
     lvgl_task_state = STATE_STOP;
 
+    tkl_semaphore_post(lvgl_wake_sem);
+
     tkl_semaphore_wait(lvgl_sem, TKL_SEM_WAIT_FOREVER);
 
 
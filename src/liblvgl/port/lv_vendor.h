@@ -17,11 +17,34 @@ typedef enum{
     STATE_STOP
 } lvgl_task_state_t;
 
+/*Counters of the LVGL task, times in ms. Filled when LVGL_ENABLE_TASK_STATS is enabled*/
+typedef struct {
+    uint32_t wakeup_cnt;          /*Loops of the LVGL task*/
+    uint32_t wakeup_timer;        /*Woken by an LVGL timer deadline only*/
+    uint32_t wakeup_update;       /*Woken by lv_vendor_disp_unlock() or lv_vendor_wakeup()*/
+    uint32_t wakeup_invalidate;   /*Woken by an invalidation from another task*/
+    uint32_t wakeup_indev;        /*Woken by lv_vendor_indev_wakeup()*/
+    uint32_t frame_cnt;           /*Refreshes that rendered something*/
+    uint32_t frame_time_sum;
+    uint32_t frame_time_max;
+    uint32_t handler_time_sum;    /*The LVGL task holds the lock while in lv_task_handler()*/
+    uint32_t handler_time_max;
+    uint32_t lock_cnt;            /*lv_vendor_disp_lock() by other tasks*/
+    uint32_t lock_hold_sum;
+    uint32_t lock_hold_max;
+} lv_vendor_stats_t;
+
 void lv_vendor_init(void *device);
 void lv_vendor_start(void);
 void lv_vendor_stop(void);
 void lv_vendor_disp_lock(void);
 void lv_vendor_disp_unlock(void);
+/*Render pending changes now, lv_vendor_disp_unlock() already does it*/
+void lv_vendor_wakeup(void);
+/*For input drivers with an interrupt: reads the indevs set to LV_INDEV_MODE_EVENT, can be called from an ISR*/
+void lv_vendor_indev_wakeup(void);
+void lv_vendor_get_stats(lv_vendor_stats_t *stats);
+void lv_vendor_reset_stats(void);
 int lv_vendor_display_frame_cnt(void);
 int lv_vendor_draw_buffer_cnt(void);
 
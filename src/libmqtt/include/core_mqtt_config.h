@@ -39,4 +39,12 @@
  */
 #define CORE_MQTT_BUFFER_SIZE (2048U)
 
+/**
+ * @brief Receive buffer of the MQTT client connection, one transport read
+ * fills it and several small packets are parsed from it.
+ */
+#ifndef MQTT_CLIENT_RX_BUFFER_SIZE
+#define MQTT_CLIENT_RX_BUFFER_SIZE (512U)
+#endif
+
 #endif /* ifndef CORE_MQTT_CONFIG_H_ */
@@ -73,10 +73,15 @@ mqtt_client_status_t mqtt_client_disconnect(void *client);
 
 mqtt_client_status_t mqtt_client_yield(void *client);
 
+mqtt_client_status_t mqtt_client_wakeup(void *client);
+
 uint16_t mqtt_client_subscribe(void *client, const char *topic, uint8_t qos);
 
 uint16_t mqtt_client_unsubscribe(void *client, const char *topic, uint8_t qos);
 
 uint16_t mqtt_client_publish(void *client, const char *topic, const uint8_t *payload, size_t length, uint8_t qos);
 
+uint16_t mqtt_client_republish(void *client, uint16_t msgid, const char *topic, const uint8_t *payload, size_t length,
+                               uint8_t qos);
+
 #endif /* ifndef MQTT_CLIENT_INTERFACE_H */
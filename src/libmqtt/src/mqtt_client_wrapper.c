@@ -9,6 +9,7 @@
 #include "tal_log.h"
 #include "tal_system.h"
 #include "tal_memory.h"
+#include "tal_network_evloop.h"
 
 #define log_debug PR_DEBUG
 #define log_error PR_ERR
@@ -17,6 +18,15 @@ typedef struct {
     mqtt_client_config_t config;
     MQTTContext_t mqclient;
     tuya_transporter_t network;
+    int read_timeout; // resolved once per connection
+    TAL_NET_EVLOOP_HANDLE evloop; // socket readiness and mqtt_client_wakeup
+    int socket_fd;
+    bool rx_nowait; // in mqtt_client_yield, no blocking read between packets
+    bool rx_more;   // the last TLS read was full, more may be decrypted already
+    uint32_t process_time; // last process loop, for the keep alive
+    size_t rx_head;
+    size_t rx_tail;
+    uint8_t rxbuffer[MQTT_CLIENT_RX_BUFFER_SIZE];
     uint8_t mqttbuffer[CORE_MQTT_BUFFER_SIZE];
 } mqtt_client_context_t;
 
@@ -93,29 +103,117 @@ void mqtt_client_free(void *client)
 
 static int network_write(NetworkContext_t *pNetwork, const unsigned char *pMsg, size_t len)
 {
-    tuya_transporter_t transporter = *pNetwork;
+    mqtt_client_context_t *context = (mqtt_client_context_t *)pNetwork;
 
-    return tuya_transporter_write(transporter, (uint8_t *)pMsg, len, 0);
+    return tuya_transporter_write(context->network, (uint8_t *)pMsg, len, 0);
 }
 
-static int network_read(NetworkContext_t *pNetwork, unsigned char *pMsg, size_t len)
+static void network_read_reset(mqtt_client_context_t *context)
 {
-    tuya_transporter_t transporter = *pNetwork;
-
     tuya_tls_config_t *tls_config = NULL;
 
-    tuya_transporter_ctrl(transporter, TUYA_TRANSPORTER_GET_TLS_CONFIG, &tls_config);
+    tuya_transporter_ctrl(context->network, TUYA_TRANSPORTER_GET_TLS_CONFIG, &tls_config);
+
+    context->read_timeout = tls_config ? tls_config->timeout : 5000;
+    context->rx_more = false;
+    context->rx_head = 0;
+    context->rx_tail = 0;
+}
+
+static bool network_read_ready(mqtt_client_context_t *context)
+{
+    TAL_NET_EVENT_T events[2];
+    int i, cnt;
 
-    int timeout = tls_config ? tls_config->timeout : 5000;
+    if (context->rx_more) {
+        return true;
+    }
 
-    int result = tuya_transporter_read(transporter, (uint8_t *)pMsg, len, timeout);
+    cnt = tal_net_evloop_wait(context->evloop, events, CNTSOF(events), 0);
+    for (i = 0; i < cnt; i++) {
+        if (events[i].fd == context->socket_fd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void network_close(mqtt_client_context_t *context)
+{
+    if (context->evloop && context->socket_fd >= 0) {
+        tal_net_evloop_del(context->evloop, context->socket_fd);
+    }
+    context->socket_fd = -1;
+    tuya_transporter_close(context->network);
+}
+
+static int network_read_once(mqtt_client_context_t *context, unsigned char *pMsg, size_t len)
+{
+    size_t avail = context->rx_tail - context->rx_head;
+    bool is_tls = (context->config.cacert != NULL);
+    int result = 0;
+
+    /* large read, bypass the buffer */
+    if (avail == 0 && len >= sizeof(context->rxbuffer)) {
+        result = tuya_transporter_read(context->network, (uint8_t *)pMsg, len, context->read_timeout);
+        if (result == OPRT_RESOURCE_NOT_READY) {
+            return 0;
+        }
+        context->rx_more = is_tls && (result == (int)len);
+        return result;
+    }
 
-    if (result == OPRT_RESOURCE_NOT_READY) {
+    /* one transport read feeds the following small reads */
+    if (avail == 0) {
+        result = tuya_transporter_read(context->network, context->rxbuffer, sizeof(context->rxbuffer),
+                                       context->read_timeout);
+        if (result == OPRT_RESOURCE_NOT_READY) {
+            return 0;
+        }
+        if (result <= 0) {
+            return result;
+        }
+        context->rx_more = is_tls && (result == (int)sizeof(context->rxbuffer));
+        context->rx_head = 0;
+        context->rx_tail = result;
+        avail = result;
+    }
+
+    if (len > avail) {
+        len = avail;
+    }
+    memcpy(pMsg, context->rxbuffer + context->rx_head, len);
+    context->rx_head += len;
+
+    return len;
+}
+
+static int network_read(NetworkContext_t *pNetwork, unsigned char *pMsg, size_t len)
+{
+    mqtt_client_context_t *context = (mqtt_client_context_t *)pNetwork;
+    size_t done = 0;
+    int result = 0;
+
+    /* between two packets nothing has arrived, do not block the yield */
+    if (context->rx_head == context->rx_tail && context->rx_nowait && !network_read_ready(context)) {
         return 0;
     }
 
-    return result;
+    /* the yield gives coreMQTT no time to complete a packet, so read all of it here */
+    while (done < len) {
+        result = network_read_once(context, pMsg + done, len - done);
+        if (result < 0) {
+            return result;
+        }
+        if (result == 0) {
+            break;
+        }
+        done += result;
+    }
+
+    return done;
 }
+
 static uint32_t __mqtt_client_get_current_time(void)
 {
     return (uint32_t)tal_system_get_millisecond();
@@ -127,6 +225,7 @@ mqtt_client_status_t mqtt_client_init(void *client, const mqtt_client_config_t *
 
     /* Clean memory */
     memset(context, 0, sizeof(mqtt_client_context_t));
+    context->socket_fd = -1;
 
     /* Setting data */
     TUYA_TRANSPORT_TYPE_E transport_type = (config->cacert == NULL) ? TRANSPORT_TYPE_TCP : TRANSPORT_TYPE_TLS;
@@ -157,7 +256,7 @@ mqtt_client_status_t mqtt_client_init(void *client, const mqtt_client_config_t *
      * For this demo, TCP sockets are used to send and receive data
      * from network. Network context is SSL context for OpenSSL.*/
     TransportInterface_t transport;
-    transport.pNetworkContext = &context->network;
+    transport.pNetworkContext = (NetworkContext_t *)context;
     transport.send = (TransportSend_t)network_write;
     transport.recv = (TransportRecv_t)network_read;
 
@@ -177,6 +276,12 @@ mqtt_client_status_t mqtt_client_init(void *client, const mqtt_client_config_t *
         return OPRT_COM_ERROR;
     }
 
+    /* without the event loop the yield falls back to a timed process loop */
+    if (OPRT_OK != tal_net_evloop_create(&context->evloop, 1)) {
+        log_error("mqtt evloop create fail");
+        context->evloop = NULL;
+    }
+
     return MQTT_STATUS_SUCCESS;
 }
 
@@ -184,8 +289,12 @@ mqtt_client_status_t mqtt_client_deinit(void *client)
 {
     mqtt_client_context_t *context = (mqtt_client_context_t *)client;
 
-    tuya_transporter_close(context->network);
+    network_close(context);
     tuya_transporter_destroy(context->network);
+    if (context->evloop) {
+        tal_net_evloop_release(context->evloop);
+        context->evloop = NULL;
+    }
     return MQTT_STATUS_SUCCESS;
 }
 
@@ -201,6 +310,13 @@ mqtt_client_status_t mqtt_client_connect(void *client)
         return MQTT_STATUS_NETWORK_CONNECT_FAILED;
     }
 
+    network_read_reset(context);
+    if (context->evloop &&
+        OPRT_OK == tuya_transporter_ctrl(context->network, TUYA_TRANSPORTER_GET_TCP_SOCKET, &context->socket_fd) &&
+        OPRT_OK != tal_net_evloop_add(context->evloop, context->socket_fd, TAL_NET_EV_READ, NULL)) {
+        context->socket_fd = -1;
+    }
+
     bool pSessionPresent = false;
 
     /* Send MQTT CONNECT packet to broker. */
@@ -216,7 +332,7 @@ mqtt_client_status_t mqtt_client_connect(void *client)
                                NULL, context->config.timeout_ms, &pSessionPresent);
     if (MQTTSuccess != mqtt_status) {
         log_error("mqtt connect err: %s(%d)", MQTT_Status_strerror(mqtt_status), mqtt_status);
-        tuya_transporter_close(context->network);
+        network_close(context);
         if (MQTTNotAuthorized == mqtt_status) {
             return MQTT_STATUS_NOT_AUTHORIZED;
         }
@@ -240,7 +356,7 @@ mqtt_client_status_t mqtt_client_disconnect(void *client)
         log_error("mqtt disconnect err: %s(%d)", MQTT_Status_strerror(mqtt_status), mqtt_status);
     }
 
-    tuya_transporter_close(context->network);
+    network_close(context);
 
     if (context->config.on_disconnected) {
         context->config.on_disconnected(context, context->config.userdata);
@@ -249,6 +365,17 @@ mqtt_client_status_t mqtt_client_disconnect(void *client)
     return MQTT_STATUS_SUCCESS;
 }
 
+mqtt_client_status_t mqtt_client_wakeup(void *client)
+{
+    mqtt_client_context_t *context = (mqtt_client_context_t *)client;
+
+    if (context->evloop == NULL) {
+        return MQTT_STATUS_INVALID_PARAM;
+    }
+    tal_net_evloop_wakeup(context->evloop);
+    return MQTT_STATUS_SUCCESS;
+}
+
 uint16_t mqtt_client_subscribe(void *client, const char *topic, uint8_t qos)
 {
     mqtt_client_context_t *context = (mqtt_client_context_t *)client;
@@ -308,12 +435,55 @@ uint16_t mqtt_client_publish(void *client, const char *topic, const uint8_t *pay
     return msgid;
 }
 
+uint16_t mqtt_client_republish(void *client, uint16_t msgid, const char *topic, const uint8_t *payload, size_t length,
+                               uint8_t qos)
+{
+    mqtt_client_context_t *context = (mqtt_client_context_t *)client;
+    MQTTStatus_t mqtt_status;
+
+    /* same packet id with dup flag, the state record is already reserved */
+    mqtt_status = MQTT_Publish(&context->mqclient,
+                               &(const MQTTPublishInfo_t){.qos = qos,
+                                                          .dup = true,
+                                                          .pTopicName = topic,
+                                                          .topicNameLength = strlen(topic),
+                                                          .pPayload = payload,
+                                                          .payloadLength = length},
+                               msgid);
+
+    if (MQTTSuccess != mqtt_status) {
+        return 0;
+    }
+    return msgid;
+}
+
 mqtt_client_status_t mqtt_client_yield(void *client)
 {
     mqtt_client_context_t *context = (mqtt_client_context_t *)client;
     MQTTStatus_t mqtt_status;
+    uint32_t timeout_ms = context->config.timeout_ms;
+
+    if (context->evloop && context->socket_fd >= 0) {
+        /* sleep until the socket is readable, mqtt_client_wakeup or the timeout, then handle what arrived */
+        if (context->rx_head == context->rx_tail && !context->rx_more) {
+            TAL_NET_EVENT_T events[2];
+            bool readable = false;
+            int i, cnt = tal_net_evloop_wait(context->evloop, events, CNTSOF(events), timeout_ms);
+            for (i = 0; i < cnt; i++) {
+                readable |= (events[i].fd == context->socket_fd);
+            }
+            /* only woken up, the caller has work to do, the keep alive can wait */
+            if (!readable && __mqtt_client_get_current_time() - context->process_time < timeout_ms) {
+                return MQTT_STATUS_SUCCESS;
+            }
+        }
+        context->rx_nowait = true;
+        timeout_ms = 0;
+    }
 
-    mqtt_status = MQTT_ProcessLoop(&context->mqclient, context->config.timeout_ms);
+    mqtt_status = MQTT_ProcessLoop(&context->mqclient, timeout_ms);
+    context->rx_nowait = false;
+    context->process_time = __mqtt_client_get_current_time();
     if (mqtt_status != MQTTSuccess) {
         log_error("MQTT_ProcessLoop returned with status = %s.", MQTT_Status_strerror(mqtt_status));
         mqtt_client_disconnect(context);
@@ -180,6 +180,7 @@ OPERATE_RET tdd_gpio_button_register(char *name, BUTTON_GPIO_CFG_T *gpio_cfg)
     TDL_BUTTON_DEVICE_INFO_T device_info;
 
     memset(&ctrl_info, 0, sizeof(TDL_BUTTON_CTRL_INFO));
+    memset(&device_info, 0, sizeof(TDL_BUTTON_DEVICE_INFO_T));
 
     ctrl_info.button_create = __tdd_create_gpio_button;
     ctrl_info.button_delete = __tdd_delete_gpio_button;
@@ -195,6 +196,8 @@ OPERATE_RET tdd_gpio_button_register(char *name, BUTTON_GPIO_CFG_T *gpio_cfg)
     if (NULL != handle) {
         device_info.dev_handle = handle;
         device_info.mode = gpio_cfg->mode;
+        device_info.irq_both_edge = (gpio_cfg->mode == BUTTON_IRQ_MODE) &&
+                                    (gpio_cfg->pin_type.irq_edge == TUYA_GPIO_IRQ_RISE_FALL);
     }
 
     ret = tdl_button_register(name, &ctrl_info, &device_info);
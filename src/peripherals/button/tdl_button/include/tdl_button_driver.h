@@ -53,6 +53,7 @@ typedef struct {
 typedef struct {
     void *dev_handle;
     TDL_BUTTON_MODE_E mode;
+    uint8_t irq_both_edge; // BUTTON_IRQ_MODE: the interrupt fires on press and on release
 } TDL_BUTTON_DEVICE_INFO_T;
 
 // Button software configuration
@@ -77,6 +77,7 @@ typedef struct {
 
 typedef struct {
     TDL_BUTTON_MODE_E button_mode; // Button driver mode: scan, interrupt
+    uint8_t irq_both_edge;         // Interrupt on press and release, no need to read a held button
 } TDL_BUTTON_HARDWARE_CFG_T;
 
 typedef struct {
@@ -89,6 +90,13 @@ typedef struct {
     uint8_t repeat;        // Repeat press count
     uint8_t ready;         // Flag indicating if the button is ready after power-on
     uint8_t init_flag;     // Button initialized successfully
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+    uint8_t debounce_armed;   // Level differs from status, waiting for debounce_expire
+    uint8_t state_armed;      // Waiting for state_expire
+    uint32_t debounce_expire; // Debounce timer expiry (ms)
+    uint32_t state_expire;    // Long press, hold or click timer expiry (ms)
+    uint32_t state_time;      // Press time in state 1/5, release time in state 2/3 (ms)
+#endif
 
     TDL_BUTTON_CTRL_INFO ctrl_info;    // Driver mount information
     DEVICE_BUTTON_HANDLE dev_handle;   // Driver handle
@@ -342,6 +350,7 @@ static TDL_BUTTON_LIST_NODE_T *__tdl_button_add_node(char *name, TDL_BUTTON_CTRL
     memcpy(p_node->name, name, name_len);
     memcpy(&(p_node->device_data.ctrl_info), info, sizeof(TDL_BUTTON_CTRL_INFO));
     p_node->device_data.dev_cfg.button_mode = cfg->mode;
+    p_node->device_data.dev_cfg.irq_both_edge = cfg->irq_both_edge;
     p_node->device_data.dev_handle = cfg->dev_handle;
 
     // Add new node
@@ -578,12 +587,191 @@ static void __tdl_button_state_handle(TDL_BUTTON_LIST_NODE_T *p_node)
     return;
 }
 
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+// TRUE if time a is at or after time b, safe across the 32 bit wrap
+#define TDL_BUTTON_TIME_AFTER_EQ(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)) >= 0)
+
+static void __tdl_button_state_timer_start(BUTTON_DRIVER_DATA_T *dev, uint32_t expire)
+{
+    dev->state_expire = expire;
+    dev->state_armed = TRUE;
+}
+
+// Event driven state machine, runs on a debounced level change or on state timer expiry at time t
+static void __tdl_button_tickless_state_handle(TDL_BUTTON_LIST_NODE_T *p_node, uint32_t t, uint8_t timeout)
+{
+    BUTTON_DRIVER_DATA_T *dev = &p_node->device_data;
+    TDL_BUTTON_CFG_T *cfg = &p_node->user_data.button_cfg;
+    TDL_BUTTON_TOUCH_EVENT_E event = TDL_BUTTON_PRESS_NONE;
+    void *arg = NULL;
+    uint32_t keep = 0;
+
+    switch (dev->flag) {
+    case 0: {
+        if (!timeout && dev->status != 0) {
+            dev->repeat = 1;
+            dev->flag = 1;
+            dev->state_time = t;
+            event = TDL_BUTTON_PRESS_DOWN;
+            arg = (void *)(uintptr_t)dev->repeat;
+            if (cfg->long_start_valid_time != 0) {
+                __tdl_button_state_timer_start(dev, t + cfg->long_start_valid_time);
+            }
+        }
+    } break;
+
+    case 1: {
+        if (timeout) {
+            /*Trigger long press start event*/
+            dev->flag = 5;
+            event = TDL_BUTTON_LONG_PRESS_START;
+            arg = (void *)(uintptr_t)(t - dev->state_time);
+            // Hold events are sent at multiples of long_keep_timer from the press, like the scan engine
+            keep = (cfg->long_keep_timer > tdl_button_scan_time) ? cfg->long_keep_timer : tdl_button_scan_time;
+            __tdl_button_state_timer_start(dev, dev->state_time + ((t - dev->state_time) / keep + 1) * keep);
+        } else if (dev->status == 0) {
+            /*Trigger release event*/
+            dev->flag = 2;
+            dev->state_time = t;
+            event = TDL_BUTTON_PRESS_UP;
+            arg = (void *)(uintptr_t)dev->repeat;
+            __tdl_button_state_timer_start(dev, t + cfg->button_repeat_valid_time);
+        }
+    } break;
+
+    case 2: {
+        if (timeout) {
+            /*Release timeout triggers single, double or repeat click*/
+            dev->flag = 0;
+            arg = (void *)(uintptr_t)dev->repeat;
+            if (dev->repeat == 1) {
+                event = TDL_BUTTON_PRESS_SINGLE_CLICK;
+            } else if (dev->repeat == 2) {
+                event = TDL_BUTTON_PRESS_DOUBLE_CLICK;
+            } else if (dev->repeat == cfg->button_repeat_valid_count && cfg->button_repeat_valid_count > 2) {
+                event = TDL_BUTTON_PRESS_REPEAT;
+            }
+        } else if (dev->status != 0) {
+            /*press again, the click timer keeps running from the last release*/
+            dev->repeat++;
+            dev->flag = 3;
+            event = TDL_BUTTON_PRESS_DOWN;
+            arg = (void *)(uintptr_t)dev->repeat;
+            dev->state_armed = FALSE;
+        }
+    } break;
+
+    case 3: {
+        if (!timeout && dev->status == 0) {
+            /*repeat up*/
+            event = TDL_BUTTON_PRESS_UP;
+            arg = (void *)(uintptr_t)dev->repeat;
+            if (TDL_BUTTON_TIME_AFTER_EQ(t, dev->state_time + cfg->button_repeat_valid_time)) {
+                dev->flag = 0;
+            } else {
+                dev->flag = 2;
+                dev->state_time = t;
+                __tdl_button_state_timer_start(dev, t + cfg->button_repeat_valid_time);
+            }
+        }
+    } break;
+
+    case 5: {
+        if (timeout) {
+            /*Trigger long press hold event*/
+            event = TDL_BUTTON_LONG_PRESS_HOLD;
+            arg = (void *)(uintptr_t)(t - dev->state_time);
+            keep = (cfg->long_keep_timer > tdl_button_scan_time) ? cfg->long_keep_timer : tdl_button_scan_time;
+            __tdl_button_state_timer_start(dev, t + keep);
+        } else if (dev->status == 0) {
+            /*hold release*/
+            dev->flag = 0;
+            event = TDL_BUTTON_PRESS_UP;
+            arg = (void *)(uintptr_t)(t - dev->state_time);
+            dev->state_armed = FALSE;
+        }
+    } break;
+
+    default:
+        dev->flag = 0;
+        dev->state_armed = FALSE;
+        break;
+    }
+
+    if (event != TDL_BUTTON_PRESS_NONE) {
+        dev->pre_event = dev->now_event;
+        dev->now_event = event;
+        PUT_EVENT_CB(p_node->user_data, p_node->name, event, arg);
+    }
+}
+
+// Reads the button, runs the expired timers in time order and returns the ms until the next one
+static uint32_t __tdl_button_tickless_handle(TDL_BUTTON_LIST_NODE_T *p_node, uint32_t now)
+{
+    BUTTON_DRIVER_DATA_T *dev = &p_node->device_data;
+    TDL_BUTTON_OPRT_INFO button_oprt;
+    uint8_t level = 0;
+    uint8_t debounce_due = FALSE, state_due = FALSE;
+    uint32_t wait = SEM_WAIT_FOREVER;
+
+    if (dev->init_flag != TRUE || OPRT_OK != __tdl_get_operate_info(p_node, &button_oprt)) {
+        return SEM_WAIT_FOREVER;
+    }
+
+    if (OPRT_OK != dev->ctrl_info.read_value(&button_oprt, &level)) {
+        level = dev->status;
+    }
+
+    // An edge arms the debounce timer, the level is taken when it expires unless it bounced back before
+    if (level != dev->status) {
+        if (!dev->debounce_armed) {
+            dev->debounce_expire = now + p_node->user_data.button_cfg.button_debounce_time;
+            dev->debounce_armed = TRUE;
+        }
+    } else {
+        dev->debounce_armed = FALSE;
+    }
+
+    while (1) {
+        debounce_due = dev->debounce_armed && TDL_BUTTON_TIME_AFTER_EQ(now, dev->debounce_expire);
+        state_due = dev->state_armed && TDL_BUTTON_TIME_AFTER_EQ(now, dev->state_expire);
+        if (debounce_due && (!state_due || TDL_BUTTON_TIME_AFTER_EQ(dev->state_expire, dev->debounce_expire))) {
+            dev->debounce_armed = FALSE;
+            dev->status = level;
+            __tdl_button_tickless_state_handle(p_node, dev->debounce_expire, FALSE);
+        } else if (state_due) {
+            dev->state_armed = FALSE;
+            __tdl_button_tickless_state_handle(p_node, dev->state_expire, TRUE);
+        } else {
+            break;
+        }
+    }
+
+    if (dev->debounce_armed) {
+        wait = dev->debounce_expire - now;
+    }
+    if (dev->state_armed && dev->state_expire - now < wait) {
+        wait = dev->state_expire - now;
+    }
+    // Single edge interrupts do not report the release, a held button is read every scan time
+    if (dev->status != 0 && !dev->dev_cfg.irq_both_edge && !dev->debounce_armed && tdl_button_scan_time < wait) {
+        wait = tdl_button_scan_time;
+    }
+
+    return wait;
+}
+#endif
+
 // Button interrupt callback function
 static void __tdl_button_irq_cb(void *arg)
 {
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+    tal_semaphore_post(tdl_button_local.irq_semaphore);
+#else
     if (tdl_button_local.irq_scan_cnt >= TDL_BUTTON_IRQ_SCAN_CNT) {
         tal_semaphore_post(tdl_button_local.irq_semaphore);
     }
+#endif
     return;
 }
 
@@ -673,6 +861,10 @@ OPERATE_RET tdl_button_create(char *name, TDL_BUTTON_CFG_T *button_cfg, TDL_BUTT
             PR_ERR("tdl create err");
             return OPRT_COM_ERROR;
         }
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+        // Sample the level once, a button held at power-on sends no edge
+        tal_semaphore_post(tdl_button_local.irq_semaphore);
+#endif
     } else {
         __tdl_button_scan_task(1);
         if (OPRT_OK != ret) {
@@ -808,6 +1000,10 @@ OPERATE_RET tdl_button_delete_without_hardware(TDL_BUTTON_HANDLE handle)
     p_node->device_data.repeat = 0;
     p_node->device_data.ready = 0;
     p_node->device_data.init_flag = 0;
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+    p_node->device_data.debounce_armed = FALSE;
+    p_node->device_data.state_armed = FALSE;
+#endif
 
     tal_mutex_unlock(p_node->button_mutex);
 
@@ -922,6 +1118,35 @@ static void __tdl_button_scan_thread(void *arg)
     }
 }
 
+#if defined(ENABLE_BUTTON_TICKLESS) && (ENABLE_BUTTON_TICKLESS == 1)
+// Button interrupt task: sleeps until an edge interrupt or the nearest button timer
+static void __tdl_button_irq_thread(void *arg)
+{
+    TDL_BUTTON_LIST_HEAD_T *p_head = p_button_list;
+    TDL_BUTTON_LIST_NODE_T *p_node = NULL;
+    LIST_HEAD *pos1 = NULL;
+    uint32_t timeout = SEM_WAIT_FOREVER, wait = 0, now = 0;
+
+    while (1) {
+        tal_semaphore_wait(tdl_button_local.irq_semaphore, timeout);
+
+        now = (uint32_t)tal_system_get_millisecond();
+        timeout = SEM_WAIT_FOREVER;
+        tuya_list_for_each(pos1, &p_head->hdr)
+        {
+            p_node = tuya_list_entry(pos1, TDL_BUTTON_LIST_NODE_T, hdr);
+            if ((p_node != NULL) && (p_node->device_data.dev_cfg.button_mode == BUTTON_IRQ_MODE)) {
+                tal_mutex_lock(p_node->button_mutex);
+                wait = __tdl_button_tickless_handle(p_node, now);
+                tal_mutex_unlock(p_node->button_mutex);
+                if (wait < timeout) {
+                    timeout = wait;
+                }
+            }
+        }
+    }
+}
+#else
 // Button interrupt scan task
 static void __tdl_button_irq_thread(void *arg)
 {
@@ -968,6 +1193,7 @@ static void __tdl_button_irq_thread(void *arg)
         }
     }
 }
+#endif
 
 // Enable and disable button scan task
 static OPERATE_RET __tdl_button_scan_task(uint8_t enable)
@@ -20,6 +20,7 @@
 #include "tkl_pinmux.h"
 #include "tdd_disp_ssd1306.h"
 #include "tdl_display_driver.h"
+#include "tdl_display_format.h"
 
 /***********************************************************
 ************************macro define************************
@@ -67,44 +68,6 @@ typedef struct {
 /***********************************************************
 ***********************function define**********************
 ***********************************************************/
-// pixels：
-// P0 P0 ...
-// P1 P1 ...
-// P2 P2 ...
-// P3 P3 ...
-// P4 P4 ...
-// P5 P5 ...
-// P6 P6 ...
-// P7 P7 ...
-// P0 P0 ...
-// ...
-static void __tdd_ssd1306_convert(uint32_t width, uint32_t height, uint8_t *in_buf, uint8_t *out_buf)
-{
-    uint32_t i=0, j=0, m=0, width_bytes = 0;
-    uint8_t b = 0, mix = 0;
-
-    if(NULL == in_buf || NULL == out_buf) {
-        return;
-    }
-
-    width_bytes = width / 8;
-
-    for(i=0; i<height; i+=8) { 
-        for(j=0; j<width; j++) {
-            for(m=0; m<8; m++) {
-                if(i + m >= height) {
-                    continue;
-                }
-                b = in_buf[(i+m)*width_bytes + j/8];
-                b = (b >> (j%8)) & 0x01;
-                mix |= (b << m);
-            }
-            out_buf[(i/8)*width + j] = mix;
-            mix = 0;
-        }
-    }
-}
-
 static OPERATE_RET __disp_i2c_init(TUYA_I2C_NUM_E port)
 {
     OPERATE_RET rt = OPRT_OK;
@@ -239,8 +202,9 @@ static OPERATE_RET __tdd_disp_i2c_ssd1306_flush(TDD_DISP_DEV_HANDLE_T device, TD
         return OPRT_INVALID_PARM;
     }
 
-    __tdd_ssd1306_convert(disp_spi_dev->disp_info.width, disp_spi_dev->disp_info.height,
-                          frame_buff->frame, disp_spi_dev->convert_fb->frame);
+    // SSD1306 RAM is made of pages of 8 lines, one byte per column
+    tdl_disp_mono_to_pages(frame_buff->frame, disp_spi_dev->disp_info.width, disp_spi_dev->disp_info.height,
+                           disp_spi_dev->convert_fb->frame);
 
     sizey = (disp_spi_dev->disp_info.height + 7) / 8;
 
@@ -17,6 +17,7 @@
 
 #include "tdd_disp_st7305.h"
 #include "tdl_display_driver.h"
+#include "tdl_display_format.h"
 
 /***********************************************************
 ***********************MACRO define**********************
@@ -76,42 +77,29 @@ static uint8_t ST7305_INIT_SEQ[] = {
 // BIT6 BIT4 BIT2 BIT0
 static void __tdd_st7305_convert(uint32_t width, uint32_t height, uint8_t *in_buf, uint8_t *out_buf)
 {
-    uint16_t k = 0, i = 0, j = 0, y = 0;
-    uint8_t b1 = 0, b2 = 0, mix = 0;
-    uint32_t width_bytes = 0, offset = 0;
+    uint32_t k = 0, i = 0;
+    uint32_t width_bytes = 0, line_bytes = 0, offset = 0;
+    uint8_t tail[2];
 
     if (NULL == in_buf || NULL == out_buf) {
         return;
     }
 
-    offset = GET_ROUND_UP_TO_MULTI_OF_3((width + 3) / 4) - (width/4);
-    width_bytes = width / 8;
+    // Input lines are (width + 7) / 8 bytes, every output byte holds 4 columns of a line pair
+    width_bytes = (width + 7) / 8;
+    line_bytes = (width + 3) / 4;
+    offset = GET_ROUND_UP_TO_MULTI_OF_3(line_bytes) - line_bytes;
     for (i = 0; i < height; i += 2) {
         k += offset;
-        for (j = 0; j < width_bytes; j += 3) {
-            for (y = 0; y < 3; y++) {
-                if ((j + y) >= width_bytes) {
-                    continue; // Avoid out of bounds
-                }
-
-                b1 = in_buf[i * width_bytes + j + y];
-                b2 = in_buf[(i + 1) * width_bytes + j + y];
-
-                // First 4 bits
-                mix = 0;
-                mix = ((b1 & 0x01) << 7) | ((b2 & 0x01) << 6) | ((b1 & 0x02) << 4) | ((b2 & 0x02) << 3) |
-                      ((b1 & 0x04) << 1) | ((b2 & 0x04)) | ((b1 & 0x08) >> 2) | ((b2 & 0x08) >> 3);
-                out_buf[k++] = mix;
-
-                // Second 4 bits
-                b1 >>= 4;
-                b2 >>= 4;
-                mix = 0;
-                mix = ((b1 & 0x01) << 7) | ((b2 & 0x01) << 6) | ((b1 & 0x02) << 4) | ((b2 & 0x02) << 3) |
-                      ((b1 & 0x04) << 1) | ((b2 & 0x04)) | ((b1 & 0x08) >> 2) | ((b2 & 0x08) >> 3);
-                out_buf[k++] = mix;
-            }
+        tdl_disp_interleave_lines(in_buf + i * width_bytes, in_buf + (i + 1) * width_bytes, line_bytes / 2,
+                                  out_buf + k);
+        // The last input byte only has a low nibble of pixels left
+        if (line_bytes % 2) {
+            tdl_disp_interleave_lines(in_buf + i * width_bytes + line_bytes / 2,
+                                      in_buf + (i + 1) * width_bytes + line_bytes / 2, 1, tail);
+            out_buf[k + line_bytes - 1] = tail[0];
         }
+        k += line_bytes;
     }
 }
 
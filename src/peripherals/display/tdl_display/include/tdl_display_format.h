@@ -0,0 +1,119 @@
+/**
+ * @file tdl_display_format.h
+ * @brief TDL display pixel format conversion header file
+ *
+ * This file provides the conversion routines used to fill packed frame buffers from
+ * RGB565 pixels and to repack frame buffers into the RAM layout of monochrome and
+ * grey-scale display controllers. All routines work a row (or a byte) at a time and
+ * build the packed bytes in a register instead of writing pixel by pixel.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_DISPLAY_FORMAT_H__
+#define __TDL_DISPLAY_FORMAT_H__
+
+#include "tuya_cloud_types.h"
+#include "tdl_display_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+// Pixels darker than this luma (0~255) are set in monochrome frame buffers
+#define TDL_DISP_MONO_THRESHOLD 128
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef enum {
+    TDL_DISP_MONO_MODE_THRESHOLD = 0,
+    TDL_DISP_MONO_MODE_DITHER, // 4x4 ordered dither, seamless across areas
+} TDL_DISP_MONO_MODE_E;
+
+/*
+ * RGB565 source of an area. The pixel of column c and row r of the area is
+ * base[r * row_step + c * col_step], so a rotated source is read in place by
+ * pointing base at the right corner and using negative or stride sized steps.
+ */
+typedef struct {
+    const uint16_t *base;
+    int32_t col_step;
+    int32_t row_step;
+} TDL_DISP_RGB565_SRC_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief Converts RGB565 pixels into an area of a monochrome frame buffer.
+ *
+ * The frame buffer holds (width + 7) / 8 bytes per line, the leftmost pixel in
+ * bit 0. A bit is set for dark pixels. Pixels outside the frame buffer are skipped.
+ *
+ * @param frame_buff Pointer to the monochrome frame buffer.
+ * @param area Pointer to the area to fill.
+ * @param src Pointer to the RGB565 source of the area.
+ * @param mode Threshold or ordered dither.
+ *
+ * @return None.
+ */
+void tdl_disp_rgb565_to_mono(TDL_DISP_FRAME_BUFF_T *frame_buff, const TDL_DISP_AREA_T *area,
+                             const TDL_DISP_RGB565_SRC_T *src, TDL_DISP_MONO_MODE_E mode);
+
+/**
+ * @brief Converts RGB565 pixels into an area of a 2-bit grey frame buffer.
+ *
+ * The frame buffer holds (width + 3) / 4 bytes per line, the leftmost pixel in
+ * bits 0~1. Level 3 is black and level 0 is white. Pixels outside the frame
+ * buffer are skipped.
+ *
+ * @param frame_buff Pointer to the I2 frame buffer.
+ * @param area Pointer to the area to fill.
+ * @param src Pointer to the RGB565 source of the area.
+ *
+ * @return None.
+ */
+void tdl_disp_rgb565_to_i2(TDL_DISP_FRAME_BUFF_T *frame_buff, const TDL_DISP_AREA_T *area,
+                           const TDL_DISP_RGB565_SRC_T *src);
+
+/**
+ * @brief Repacks a monochrome frame buffer into pages for SSD1306 style controllers.
+ *
+ * Each page covers 8 lines and holds one byte per column, bit n of the byte is
+ * line n of the page. Lines past the height read as 0.
+ *
+ * @param in_buf Monochrome frame buffer, (width + 7) / 8 bytes per line.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @param out_buf Output buffer of width * ((height + 7) / 8) bytes.
+ *
+ * @return None.
+ */
+void tdl_disp_mono_to_pages(const uint8_t *in_buf, uint32_t width, uint32_t height, uint8_t *out_buf);
+
+/**
+ * @brief Interleaves two lines nibble by nibble for ST7305/ST7306 style controllers.
+ *
+ * Every 4 bits of a line become one output byte, bits 0~3 of line0 go to bits
+ * 7, 5, 3, 1 and bits 0~3 of line1 go to bits 6, 4, 2, 0. The low nibble of an
+ * input byte comes first.
+ *
+ * @param line0 First line.
+ * @param line1 Second line.
+ * @param len Bytes in each line.
+ * @param out_buf Output buffer of len * 2 bytes.
+ *
+ * @return None.
+ */
+void tdl_disp_interleave_lines(const uint8_t *line0, const uint8_t *line1, uint32_t len, uint8_t *out_buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_DISPLAY_FORMAT_H__ */
@@ -23,6 +23,10 @@ extern "C" {
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+#define TDL_DISP_DIRTY_AREA_MAX 16
+
+// Max flushes waiting for the transfer task of a device
+#define TDL_DISP_FLUSH_QUEUE_LEN 4
 
 /***********************************************************
 ***********************typedef define***********************
@@ -64,6 +68,23 @@ typedef struct {
     TUYA_DISPLAY_PIXEL_FMT_E fmt;
 } TDL_DISP_DEV_INFO_T;
 
+/* Rectangle in frame buffer coordinates, both corners are inclusive */
+typedef struct {
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+} TDL_DISP_AREA_T;
+
+/* Areas of the frame buffer changed since the last flush */
+typedef struct {
+    uint8_t cnt;
+    TDL_DISP_AREA_T area[TDL_DISP_DIRTY_AREA_MAX];
+} TDL_DISP_DIRTY_LIST_T;
+
+/* Called from the transfer task when an asynchronous flush has finished */
+typedef void (*TDL_DISP_FLUSH_DONE_CB)(TDL_DISP_FRAME_BUFF_T *frame_buff, OPERATE_RET result, void *arg);
+
 /***********************************************************
 ********************function declaration********************
 ***********************************************************/
@@ -101,6 +122,64 @@ OPERATE_RET tdl_disp_dev_open(TDL_DISP_HANDLE_T disp_hdl);
  */
 OPERATE_RET tdl_disp_dev_flush(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff);
 
+/**
+ * @brief Flushes only the dirty areas of the frame buffer to the display device.
+ *
+ * Each area in the list is sent with its own display window. Devices without
+ * area support, or a list that covers the whole frame, fall back to a full flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the full frame buffer.
+ * @param dirty Pointer to the dirty area list, an empty list flushes nothing.
+ *
+ * @return Returns OPRT_OK on success, or an appropriate error code if flushing fails.
+ */
+OPERATE_RET tdl_disp_dev_flush_area(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                    TDL_DISP_DIRTY_LIST_T *dirty);
+
+/**
+ * @brief Queues a flush of the frame buffer to the transfer task of the display device.
+ *
+ * The function returns as soon as the request is queued, the transfer task of the
+ * device (created by the first call) sends the frame and then calls done_cb. The
+ * frame buffer must not be modified until done_cb is called. Flushes are sent in
+ * the order they are queued and are serialized with tdl_disp_dev_flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the full frame buffer.
+ * @param dirty Pointer to the dirty area list, it is copied. NULL flushes the whole frame.
+ * @param done_cb Callback invoked when the transfer has finished, can be NULL.
+ * @param arg User argument passed to done_cb.
+ *
+ * @return Returns OPRT_OK if the flush is queued, or an appropriate error code otherwise.
+ */
+OPERATE_RET tdl_disp_dev_flush_async(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                     TDL_DISP_DIRTY_LIST_T *dirty, TDL_DISP_FLUSH_DONE_CB done_cb, void *arg);
+
+/**
+ * @brief Clears a dirty area list.
+ *
+ * @param dirty Pointer to the dirty area list.
+ *
+ * @return None.
+ */
+void tdl_disp_dirty_list_reset(TDL_DISP_DIRTY_LIST_T *dirty);
+
+/**
+ * @brief Adds an area to a dirty area list.
+ *
+ * The area is merged with the areas already in the list whenever sending their
+ * bounding box costs no more pixels than sending them apart, so overlapping and
+ * adjacent areas of the same span become one. When the list is full the two
+ * areas whose bounding box wastes the fewest pixels are merged.
+ *
+ * @param dirty Pointer to the dirty area list.
+ * @param area Pointer to the area to add.
+ *
+ * @return None.
+ */
+void tdl_disp_dirty_list_add(TDL_DISP_DIRTY_LIST_T *dirty, const TDL_DISP_AREA_T *area);
+
 /**
  * @brief Retrieves information about a registered display device.
  *
@@ -0,0 +1,245 @@
+/**
+ * @file tdl_display_format.c
+ * @brief TDL display pixel format conversion implementation
+ *
+ * This file implements the conversion from RGB565 into monochrome and 2-bit grey
+ * frame buffers, and the repacking of those frame buffers into the RAM layouts of
+ * page based (SSD1306) and line-pair based (ST7305/ST7306) display controllers.
+ * Packed bytes are built in a register and written once, only the partial bytes at
+ * both ends of a line are read back.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tdl_display_format.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define DISP_MONO_PX_PER_BYTE 8
+#define DISP_I2_PX_PER_BYTE   4
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint8_t sg_mono_threshold[4] = {
+    TDL_DISP_MONO_THRESHOLD, TDL_DISP_MONO_THRESHOLD, TDL_DISP_MONO_THRESHOLD, TDL_DISP_MONO_THRESHOLD
+};
+
+// 4x4 Bayer matrix scaled to luma, indexed by [y & 3][x & 3]
+static const uint8_t sg_mono_bayer[4][4] = {
+    {  8, 136,  40, 168},
+    {200,  72, 232, 104},
+    { 56, 184,  24, 152},
+    {248, 120, 216,  88},
+};
+
+// bits 0~3 spread to bits 7, 5, 3, 1
+static const uint8_t sg_nibble_spread[16] = {
+    0x00, 0x80, 0x20, 0xA0, 0x08, 0x88, 0x28, 0xA8,
+    0x02, 0x82, 0x22, 0xA2, 0x0A, 0x8A, 0x2A, 0xAA,
+};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+// BT.601 luma of an RGB565 pixel, 0~254
+static inline uint8_t __disp_rgb565_luma(uint16_t px)
+{
+    return (uint8_t)(((px >> 11) * 630 + ((px >> 5) & 0x3F) * 608 + (px & 0x1F) * 240) >> 8);
+}
+
+static bool __disp_clip_area(TDL_DISP_FRAME_BUFF_T *frame_buff, const TDL_DISP_AREA_T *area,
+                             TDL_DISP_AREA_T *clip)
+{
+    if (area->x0 > area->x1 || area->y0 > area->y1 ||
+        area->x0 >= frame_buff->width || area->y0 >= frame_buff->height) {
+        return false;
+    }
+
+    *clip = *area;
+    if (clip->x1 >= frame_buff->width) {
+        clip->x1 = frame_buff->width - 1;
+    }
+    if (clip->y1 >= frame_buff->height) {
+        clip->y1 = frame_buff->height - 1;
+    }
+
+    return true;
+}
+
+void tdl_disp_rgb565_to_mono(TDL_DISP_FRAME_BUFF_T *frame_buff, const TDL_DISP_AREA_T *area,
+                             const TDL_DISP_RGB565_SRC_T *src, TDL_DISP_MONO_MODE_E mode)
+{
+    TDL_DISP_AREA_T clip;
+    const uint16_t *src_line = NULL, *px = NULL;
+    const uint8_t *threshold = sg_mono_threshold;
+    uint8_t *dst = NULL;
+    uint8_t bit = 0, acc = 0;
+    uint32_t stride = 0, x = 0, y = 0;
+
+    if (NULL == frame_buff || NULL == area || NULL == src || NULL == src->base) {
+        return;
+    }
+
+    if (false == __disp_clip_area(frame_buff, area, &clip)) {
+        return;
+    }
+
+    stride = (frame_buff->width + 7) / 8;
+    src_line = src->base;
+
+    for (y = clip.y0; y <= clip.y1; y++) {
+        if (TDL_DISP_MONO_MODE_DITHER == mode) {
+            threshold = sg_mono_bayer[y & 0x03];
+        }
+
+        px = src_line;
+        dst = frame_buff->frame + y * stride + clip.x0 / DISP_MONO_PX_PER_BYTE;
+        bit = clip.x0 % DISP_MONO_PX_PER_BYTE;
+        acc = *dst & ((1 << bit) - 1);
+
+        for (x = clip.x0; x <= clip.x1; x++) {
+            acc |= (uint8_t)(__disp_rgb565_luma(*px) < threshold[x & 0x03]) << bit;
+            px += src->col_step;
+
+            if (++bit == DISP_MONO_PX_PER_BYTE) {
+                *dst++ = acc;
+                acc = 0;
+                bit = 0;
+            }
+        }
+
+        if (bit) {
+            *dst = acc | (*dst & (uint8_t)(0xFF << bit));
+        }
+
+        src_line += src->row_step;
+    }
+}
+
+void tdl_disp_rgb565_to_i2(TDL_DISP_FRAME_BUFF_T *frame_buff, const TDL_DISP_AREA_T *area,
+                           const TDL_DISP_RGB565_SRC_T *src)
+{
+    TDL_DISP_AREA_T clip;
+    const uint16_t *src_line = NULL, *px = NULL;
+    uint8_t *dst = NULL;
+    uint8_t shift = 0, acc = 0;
+    uint32_t stride = 0, x = 0, y = 0;
+
+    if (NULL == frame_buff || NULL == area || NULL == src || NULL == src->base) {
+        return;
+    }
+
+    if (false == __disp_clip_area(frame_buff, area, &clip)) {
+        return;
+    }
+
+    stride = (frame_buff->width + 3) / 4;
+    src_line = src->base;
+
+    for (y = clip.y0; y <= clip.y1; y++) {
+        px = src_line;
+        dst = frame_buff->frame + y * stride + clip.x0 / DISP_I2_PX_PER_BYTE;
+        shift = (clip.x0 % DISP_I2_PX_PER_BYTE) * 2;
+        acc = *dst & ((1 << shift) - 1);
+
+        for (x = clip.x0; x <= clip.x1; x++) {
+            acc |= ((uint8_t)(255 - __disp_rgb565_luma(*px)) >> 6) << shift;
+            px += src->col_step;
+
+            shift += 2;
+            if (shift == 8) {
+                *dst++ = acc;
+                acc = 0;
+                shift = 0;
+            }
+        }
+
+        if (shift) {
+            *dst = acc | (*dst & (uint8_t)(0xFF << shift));
+        }
+
+        src_line += src->row_step;
+    }
+}
+
+// Transposes an 8x8 bit matrix, bit n of byte m moves to bit m of byte n
+static inline uint64_t __disp_transpose8x8(uint64_t x)
+{
+    uint64_t t = 0;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+
+    return x;
+}
+
+void tdl_disp_mono_to_pages(const uint8_t *in_buf, uint32_t width, uint32_t height, uint8_t *out_buf)
+{
+    const uint8_t *in = NULL;
+    uint8_t *out = NULL;
+    uint32_t stride = 0, page = 0, col = 0, lines = 0, cols = 0, m = 0;
+    uint64_t block = 0;
+
+    if (NULL == in_buf || NULL == out_buf) {
+        return;
+    }
+
+    stride = (width + 7) / 8;
+
+    for (page = 0; page * 8 < height; page++) {
+        lines = height - page * 8;
+        if (lines > 8) {
+            lines = 8;
+        }
+
+        in = in_buf + page * 8 * stride;
+        out = out_buf + page * width;
+
+        for (col = 0; col < width; col += 8) {
+            block = 0;
+            for (m = 0; m < lines; m++) {
+                block |= (uint64_t)in[m * stride] << (m * 8);
+            }
+            in++;
+
+            block = __disp_transpose8x8(block);
+
+            cols = width - col;
+            if (cols >= 8) {
+                for (m = 0; m < 8; m++) {
+                    out[m] = (uint8_t)(block >> (m * 8));
+                }
+                out += 8;
+            } else {
+                for (m = 0; m < cols; m++) {
+                    *out++ = (uint8_t)(block >> (m * 8));
+                }
+            }
+        }
+    }
+}
+
+void tdl_disp_interleave_lines(const uint8_t *line0, const uint8_t *line1, uint32_t len, uint8_t *out_buf)
+{
+    uint32_t i = 0;
+    uint8_t b1 = 0, b2 = 0;
+
+    if (NULL == line0 || NULL == line1 || NULL == out_buf) {
+        return;
+    }
+
+    for (i = 0; i < len; i++) {
+        b1 = line0[i];
+        b2 = line1[i];
+
+        *out_buf++ = sg_nibble_spread[b1 & 0x0F] | (sg_nibble_spread[b2 & 0x0F] >> 1);
+        *out_buf++ = sg_nibble_spread[b1 >> 4] | (sg_nibble_spread[b2 >> 4] >> 1);
+    }
+}
@@ -29,9 +29,20 @@
 ***********************************************************/
 #define TDL_DISP_DRAW_BUF_ALIGN 4
 
+#define TDL_DISP_FLUSH_TASK_STACK 4096
+
 /***********************************************************
 ***********************typedef define***********************
 ***********************************************************/
+typedef struct {
+    bool is_exit;
+    bool has_dirty;
+    TDL_DISP_FRAME_BUFF_T *frame_buff;
+    TDL_DISP_FLUSH_DONE_CB done_cb;
+    void *arg;
+    TDL_DISP_DIRTY_LIST_T dirty;
+} DISP_FLUSH_MSG_T;
+
 typedef struct {
     struct tuya_list_head node;
     bool is_open;
@@ -44,6 +55,10 @@ typedef struct {
 
     TDD_DISP_DEV_HANDLE_T tdd_hdl;
     TDD_DISP_INTFS_T intfs;
+
+    THREAD_HANDLE flush_task;
+    QUEUE_HANDLE flush_queue;
+    SEM_HANDLE flush_exit_sem;
 } DISPLAY_DEVICE_T;
 
 /***********************************************************
@@ -149,6 +164,171 @@ static void __tdl_blacklight_deinit(TUYA_DISPLAY_BL_CTRL_T *bl_cfg)
 }
 
 
+static uint32_t __disp_area_size(const TDL_DISP_AREA_T *area)
+{
+    return (uint32_t)(area->x1 - area->x0 + 1) * (area->y1 - area->y0 + 1);
+}
+
+static void __disp_area_join(const TDL_DISP_AREA_T *a, const TDL_DISP_AREA_T *b, TDL_DISP_AREA_T *out)
+{
+    out->x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+    out->y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+    out->x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+    out->y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+}
+
+static bool __disp_area_clip(TDL_DISP_AREA_T *area, uint16_t width, uint16_t height)
+{
+    if (area->x0 > area->x1 || area->y0 > area->y1 || area->x0 >= width || area->y0 >= height) {
+        return false;
+    }
+
+    if (area->x1 >= width) {
+        area->x1 = width - 1;
+    }
+    if (area->y1 >= height) {
+        area->y1 = height - 1;
+    }
+
+    return true;
+}
+
+static OPERATE_RET __disp_dev_flush(DISPLAY_DEVICE_T *display_dev, TDL_DISP_FRAME_BUFF_T *frame_buff)
+{
+    if (NULL == display_dev->intfs.flush) {
+        return OPRT_OK;
+    }
+
+    return display_dev->intfs.flush(display_dev->tdd_hdl, frame_buff);
+}
+
+static OPERATE_RET __disp_dev_flush_area(DISPLAY_DEVICE_T *display_dev, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                         TDL_DISP_DIRTY_LIST_T *dirty)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDL_DISP_AREA_T area;
+    uint32_t dirty_size = 0;
+    uint8_t i = 0;
+
+    if (0 == dirty->cnt) {
+        return OPRT_OK;
+    }
+
+    if (NULL == display_dev->intfs.flush_area) {
+        return __disp_dev_flush(display_dev, frame_buff);
+    }
+
+    for (i = 0; i < dirty->cnt; i++) {
+        dirty_size += __disp_area_size(&dirty->area[i]);
+    }
+    if (dirty_size >= (uint32_t)frame_buff->width * frame_buff->height) {
+        return __disp_dev_flush(display_dev, frame_buff);
+    }
+
+    for (i = 0; i < dirty->cnt; i++) {
+        area = dirty->area[i];
+        if (false == __disp_area_clip(&area, frame_buff->width, frame_buff->height)) {
+            continue;
+        }
+
+        rt = display_dev->intfs.flush_area(display_dev->tdd_hdl, frame_buff, &area);
+        if (OPRT_NOT_SUPPORTED == rt) {
+            return __disp_dev_flush(display_dev, frame_buff);
+        } else if (OPRT_OK != rt) {
+            PR_ERR("flush area (%d,%d)-(%d,%d) failed, rt: %d", area.x0, area.y0, area.x1, area.y1, rt);
+            return rt;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+static void __disp_flush_task(void *args)
+{
+    DISPLAY_DEVICE_T *display_dev = (DISPLAY_DEVICE_T *)args;
+    DISP_FLUSH_MSG_T msg;
+    OPERATE_RET rt = OPRT_OK;
+    THREAD_HANDLE task = NULL;
+
+    for (;;) {
+        if (OPRT_OK != tal_queue_fetch(display_dev->flush_queue, &msg, SEM_WAIT_FOREVER)) {
+            continue;
+        }
+
+        if (msg.is_exit) {
+            break;
+        }
+
+        tal_mutex_lock(display_dev->mutex);
+        if (msg.has_dirty) {
+            rt = __disp_dev_flush_area(display_dev, msg.frame_buff, &msg.dirty);
+        } else {
+            rt = __disp_dev_flush(display_dev, msg.frame_buff);
+        }
+        tal_mutex_unlock(display_dev->mutex);
+
+        if (msg.done_cb) {
+            msg.done_cb(msg.frame_buff, rt, msg.arg);
+        }
+    }
+
+    task = display_dev->flush_task;
+    display_dev->flush_task = NULL;
+    tal_semaphore_post(display_dev->flush_exit_sem);
+    tal_thread_delete(task);
+}
+
+static OPERATE_RET __disp_flush_task_start(DISPLAY_DEVICE_T *display_dev)
+{
+    OPERATE_RET rt = OPRT_OK;
+    THREAD_CFG_T thread_cfg = {TDL_DISP_FLUSH_TASK_STACK, THREAD_PRIO_1, "disp_flush"};
+
+    if (NULL == display_dev->flush_queue) {
+        TUYA_CALL_ERR_RETURN(
+            tal_queue_create_init(&display_dev->flush_queue, sizeof(DISP_FLUSH_MSG_T), TDL_DISP_FLUSH_QUEUE_LEN));
+    }
+
+    if (NULL == display_dev->flush_exit_sem) {
+        TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&display_dev->flush_exit_sem, 0, 1));
+    }
+
+    TUYA_CALL_ERR_RETURN(tal_thread_create_and_start(&display_dev->flush_task, NULL, NULL, __disp_flush_task,
+                                                     display_dev, &thread_cfg));
+
+    return OPRT_OK;
+}
+
+static void __disp_flush_task_stop(DISPLAY_DEVICE_T *display_dev)
+{
+    DISP_FLUSH_MSG_T msg;
+
+    if (NULL == display_dev->flush_task) {
+        return;
+    }
+
+    memset(&msg, 0, sizeof(DISP_FLUSH_MSG_T));
+    msg.is_exit = true;
+
+    // Queued flushes are sent before the task sees the exit request
+    tal_queue_post(display_dev->flush_queue, &msg, SEM_WAIT_FOREVER);
+    tal_semaphore_wait(display_dev->flush_exit_sem, SEM_WAIT_FOREVER);
+}
+
+static void __disp_flush_task_free(DISPLAY_DEVICE_T *display_dev)
+{
+    __disp_flush_task_stop(display_dev);
+
+    if (display_dev->flush_queue) {
+        tal_queue_free(display_dev->flush_queue);
+        display_dev->flush_queue = NULL;
+    }
+
+    if (display_dev->flush_exit_sem) {
+        tal_semaphore_release(display_dev->flush_exit_sem);
+        display_dev->flush_exit_sem = NULL;
+    }
+}
+
 /**
  * @brief Finds a registered display device by its name.
  *
@@ -229,11 +409,191 @@ OPERATE_RET tdl_disp_dev_flush(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T
         return OPRT_COM_ERROR;
     }
 
-    if (display_dev->intfs.flush) {
-        TUYA_CALL_ERR_RETURN(display_dev->intfs.flush(display_dev->tdd_hdl, frame_buff));
+    tal_mutex_lock(display_dev->mutex);
+    rt = __disp_dev_flush(display_dev, frame_buff);
+    tal_mutex_unlock(display_dev->mutex);
+
+    return rt;
+}
+
+/**
+ * @brief Flushes only the dirty areas of the frame buffer to the display device.
+ *
+ * Each area in the list is sent with its own display window. Devices without
+ * area support, or a list that covers the whole frame, fall back to a full flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the full frame buffer.
+ * @param dirty Pointer to the dirty area list, an empty list flushes nothing.
+ *
+ * @return Returns OPRT_OK on success, or an appropriate error code if flushing fails.
+ */
+OPERATE_RET tdl_disp_dev_flush_area(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                    TDL_DISP_DIRTY_LIST_T *dirty)
+{
+    OPERATE_RET rt = OPRT_OK;
+    DISPLAY_DEVICE_T *display_dev = NULL;
+
+    if (NULL == disp_hdl || NULL == frame_buff || NULL == dirty) {
+        return OPRT_INVALID_PARM;
     }
 
-    return OPRT_OK;
+    display_dev = (DISPLAY_DEVICE_T *)disp_hdl;
+
+    if (false == display_dev->is_open) {
+        return OPRT_COM_ERROR;
+    }
+
+    tal_mutex_lock(display_dev->mutex);
+    rt = __disp_dev_flush_area(display_dev, frame_buff, dirty);
+    tal_mutex_unlock(display_dev->mutex);
+
+    return rt;
+}
+
+/**
+ * @brief Queues a flush of the frame buffer to the transfer task of the display device.
+ *
+ * The function returns as soon as the request is queued, the transfer task of the
+ * device (created by the first call) sends the frame and then calls done_cb. The
+ * frame buffer must not be modified until done_cb is called. Flushes are sent in
+ * the order they are queued and are serialized with tdl_disp_dev_flush.
+ *
+ * @param disp_hdl Handle to the display device.
+ * @param frame_buff Pointer to the full frame buffer.
+ * @param dirty Pointer to the dirty area list, it is copied. NULL flushes the whole frame.
+ * @param done_cb Callback invoked when the transfer has finished, can be NULL.
+ * @param arg User argument passed to done_cb.
+ *
+ * @return Returns OPRT_OK if the flush is queued, or an appropriate error code otherwise.
+ */
+OPERATE_RET tdl_disp_dev_flush_async(TDL_DISP_HANDLE_T disp_hdl, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                     TDL_DISP_DIRTY_LIST_T *dirty, TDL_DISP_FLUSH_DONE_CB done_cb, void *arg)
+{
+    OPERATE_RET rt = OPRT_OK;
+    DISPLAY_DEVICE_T *display_dev = NULL;
+    DISP_FLUSH_MSG_T msg;
+
+    if (NULL == disp_hdl || NULL == frame_buff) {
+        return OPRT_INVALID_PARM;
+    }
+
+    display_dev = (DISPLAY_DEVICE_T *)disp_hdl;
+
+    if (false == display_dev->is_open) {
+        return OPRT_COM_ERROR;
+    }
+
+    // Two callers may queue the first flush at the same time, only one of them starts the task
+    if (NULL == display_dev->flush_task) {
+        tal_mutex_lock(display_dev->mutex);
+        if (NULL == display_dev->flush_task) {
+            rt = __disp_flush_task_start(display_dev);
+        }
+        tal_mutex_unlock(display_dev->mutex);
+        if (OPRT_OK != rt) {
+            PR_ERR("start flush task failed, rt: %d", rt);
+            return rt;
+        }
+    }
+
+    memset(&msg, 0, sizeof(DISP_FLUSH_MSG_T));
+    msg.frame_buff = frame_buff;
+    msg.done_cb = done_cb;
+    msg.arg = arg;
+    if (dirty) {
+        msg.has_dirty = true;
+        memcpy(&msg.dirty, dirty, sizeof(TDL_DISP_DIRTY_LIST_T));
+    }
+
+    // Blocks only when TDL_DISP_FLUSH_QUEUE_LEN flushes are already waiting
+    return tal_queue_post(display_dev->flush_queue, &msg, SEM_WAIT_FOREVER);
+}
+
+/**
+ * @brief Clears a dirty area list.
+ *
+ * @param dirty Pointer to the dirty area list.
+ *
+ * @return None.
+ */
+void tdl_disp_dirty_list_reset(TDL_DISP_DIRTY_LIST_T *dirty)
+{
+    if (dirty) {
+        dirty->cnt = 0;
+    }
+}
+
+/**
+ * @brief Adds an area to a dirty area list.
+ *
+ * The area is merged with the areas already in the list whenever sending their
+ * bounding box costs no more pixels than sending them apart, so overlapping and
+ * adjacent areas of the same span become one. When the list is full the two
+ * areas whose bounding box wastes the fewest pixels are merged.
+ *
+ * @param dirty Pointer to the dirty area list.
+ * @param area Pointer to the area to add.
+ *
+ * @return None.
+ */
+void tdl_disp_dirty_list_add(TDL_DISP_DIRTY_LIST_T *dirty, const TDL_DISP_AREA_T *area)
+{
+    TDL_DISP_AREA_T cur, join;
+    const TDL_DISP_AREA_T *b = NULL;
+    int32_t grow = 0, best_grow = 0;
+    uint32_t cur_size = 0, join_size = 0;
+    uint8_t i = 0, j = 0, best_i = 0, best_j = 0;
+
+    if (NULL == dirty || NULL == area || area->x0 > area->x1 || area->y0 > area->y1) {
+        return;
+    }
+
+    cur = *area;
+    cur_size = __disp_area_size(&cur);
+
+    // A merged area may now be worth merging with another one, so rescan after each merge
+    i = 0;
+    while (i < dirty->cnt) {
+        __disp_area_join(&dirty->area[i], &cur, &join);
+        join_size = __disp_area_size(&join);
+        if (join_size <= cur_size + __disp_area_size(&dirty->area[i])) {
+            cur = join;
+            cur_size = join_size;
+            dirty->area[i] = dirty->area[--dirty->cnt];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    if (dirty->cnt < TDL_DISP_DIRTY_AREA_MAX) {
+        dirty->area[dirty->cnt++] = cur;
+        return;
+    }
+
+    // List is full, merge the pair that wastes the fewest pixels, the new area is the last entry
+    best_grow = INT32_MAX;
+    for (i = 0; i < dirty->cnt; i++) {
+        for (j = i + 1; j <= dirty->cnt; j++) {
+            b = (j == dirty->cnt) ? &cur : &dirty->area[j];
+            __disp_area_join(&dirty->area[i], b, &join);
+            grow = (int32_t)(__disp_area_size(&join) - __disp_area_size(&dirty->area[i]) - __disp_area_size(b));
+            if (grow < best_grow) {
+                best_grow = grow;
+                best_i = i;
+                best_j = j;
+            }
+        }
+    }
+
+    b = (best_j == dirty->cnt) ? &cur : &dirty->area[best_j];
+    __disp_area_join(&dirty->area[best_i], b, &join);
+    if (best_j != dirty->cnt) {
+        dirty->area[best_j] = cur;
+    }
+    dirty->area[best_i] = dirty->area[--dirty->cnt];
+    tdl_disp_dirty_list_add(dirty, &join);
 }
 
 /**
@@ -335,6 +695,8 @@ OPERATE_RET tdl_disp_dev_close(TDL_DISP_HANDLE_T disp_hdl)
         return OPRT_OK;
     }
 
+    __disp_flush_task_free(display_dev);
+
     if (display_dev->intfs.close) {
         TUYA_CALL_ERR_RETURN(display_dev->intfs.close(display_dev->tdd_hdl));
     }
@@ -389,7 +751,7 @@ TDL_DISP_FRAME_BUFF_T *tdl_disp_create_frame_buff(DISP_FB_RAM_TP_E type, uint32_
 
     p_frame = (uint8_t *)fb + sizeof(TDL_DISP_FRAME_BUFF_T);
     p_frame += TDL_DISP_DRAW_BUF_ALIGN - 1;
-    p_frame = (uint8_t *)((uint32_t)p_frame & ~(TDL_DISP_DRAW_BUF_ALIGN - 1));
+    p_frame = (uint8_t *)((uintptr_t)p_frame & ~((uintptr_t)TDL_DISP_DRAW_BUF_ALIGN - 1));
 
     fb->type = fb_type;
     fb->frame = p_frame;
@@ -22,6 +22,8 @@
 /***********************************************************
 ************************macro define************************
 ***********************************************************/
+// Rows of a partial-width area are gathered into two buffers of this size before sending
+#define DISP_SPI_AREA_BUF_LEN 4096
 
 /***********************************************************
 ***********************typedef define***********************
@@ -34,6 +36,7 @@ typedef struct {
     DISP_SPI_BASE_CFG_T         cfg;
     const uint8_t              *init_seq;
     TDD_DISP_SPI_SET_WINDOW_CB  set_window_cb;
+    uint8_t                    *area_buf;
 }DISP_SPI_DEV_T;
 
 /***********************************************************
@@ -194,6 +197,122 @@ static OPERATE_RET __tdl_display_spi_flush(TDD_DISP_DEV_HANDLE_T device, TDL_DIS
     return rt;
 }
 
+static uint8_t __disp_spi_get_pixel_bytes(TUYA_DISPLAY_PIXEL_FMT_E fmt)
+{
+    switch (fmt) {
+    case TUYA_PIXEL_FMT_RGB565:
+        return 2;
+    case TUYA_PIXEL_FMT_RGB666:
+    case TUYA_PIXEL_FMT_RGB888:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+static OPERATE_RET __disp_spi_send_rows(DISP_SPI_DEV_T *disp_spi_dev, uint8_t *data, uint32_t line_len,
+                                        uint32_t stride, uint32_t lines)
+{
+    OPERATE_RET rt = OPRT_OK;
+    DISP_SPI_BASE_CFG_T *p_cfg = &disp_spi_dev->cfg;
+    uint32_t buf_len = DISP_SPI_AREA_BUF_LEN, fill = 0, i = 0;
+    uint8_t *buf = NULL, idx = 0;
+    bool is_sending = false;
+
+    if (buf_len > tkl_spi_get_max_dma_data_length()) {
+        buf_len = tkl_spi_get_max_dma_data_length();
+    }
+
+    if (NULL == disp_spi_dev->area_buf && line_len <= buf_len) {
+        disp_spi_dev->area_buf = tal_malloc(DISP_SPI_AREA_BUF_LEN * 2);
+    }
+
+    // Keep CS low for the whole area, the controller keeps writing memory until the next command
+    tkl_gpio_write(p_cfg->cs_pin, TUYA_GPIO_LEVEL_LOW);
+    tkl_gpio_write(p_cfg->dc_pin, TUYA_GPIO_LEVEL_HIGH);
+
+    if (NULL == disp_spi_dev->area_buf || line_len > buf_len) {
+        for (i = 0; i < lines; i++) {
+            TUYA_CALL_ERR_GOTO(__disp_spi_send(p_cfg->port, data, line_len), __EXIT);
+            data += stride;
+        }
+        goto __EXIT;
+    }
+
+    // Gather rows into one half of the buffer while the other half is on the bus
+    buf = disp_spi_dev->area_buf;
+    for (i = 0; i <= lines; i++) {
+        if (i == lines || fill + line_len > buf_len) {
+            if (is_sending) {
+                TUYA_CALL_ERR_GOTO(tal_semaphore_wait(sg_disp_spi_sync[p_cfg->port].tx_sem, 5000), __EXIT);
+                is_sending = false;
+            }
+            if (fill) {
+                TUYA_CALL_ERR_GOTO(tkl_spi_send(p_cfg->port, buf + idx * DISP_SPI_AREA_BUF_LEN, fill), __EXIT);
+                is_sending = true;
+                idx ^= 1;
+                fill = 0;
+            }
+        }
+
+        if (i < lines) {
+            memcpy(buf + idx * DISP_SPI_AREA_BUF_LEN + fill, data, line_len);
+            fill += line_len;
+            data += stride;
+        }
+    }
+
+    if (is_sending) {
+        rt = tal_semaphore_wait(sg_disp_spi_sync[p_cfg->port].tx_sem, 5000);
+    }
+
+__EXIT:
+    tkl_gpio_write(p_cfg->cs_pin, TUYA_GPIO_LEVEL_HIGH);
+
+    return rt;
+}
+
+static OPERATE_RET __tdl_display_spi_flush_area(TDD_DISP_DEV_HANDLE_T device, TDL_DISP_FRAME_BUFF_T *frame_buff,
+                                                TDL_DISP_AREA_T *area)
+{
+    DISP_SPI_DEV_T *disp_spi_dev = NULL;
+    uint8_t pixel_bytes = 0;
+    uint32_t stride = 0, line_len = 0, lines = 0;
+    uint8_t *data = NULL;
+
+    if (NULL == device || NULL == frame_buff || NULL == area) {
+        return OPRT_INVALID_PARM;
+    }
+
+    disp_spi_dev = (DISP_SPI_DEV_T *)device;
+
+    // Sub-byte formats can not start a window at any pixel
+    pixel_bytes = __disp_spi_get_pixel_bytes(frame_buff->fmt);
+    if (0 == pixel_bytes) {
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    if(disp_spi_dev->set_window_cb) {
+        disp_spi_dev->set_window_cb(&disp_spi_dev->cfg, area->x0, area->y0, area->x1, area->y1);
+    }else {
+        __disp_spi_set_window(&disp_spi_dev->cfg, area->x0, area->y0, area->x1, area->y1);
+    }
+
+    tdl_disp_spi_send_cmd(&disp_spi_dev->cfg, disp_spi_dev->cfg.cmd_ramwr);
+
+    stride   = frame_buff->width * pixel_bytes;
+    line_len = (area->x1 - area->x0 + 1) * pixel_bytes;
+    lines    = area->y1 - area->y0 + 1;
+    data     = frame_buff->frame + area->y0 * stride + area->x0 * pixel_bytes;
+
+    // Full-width areas are contiguous in the frame buffer
+    if (line_len == stride) {
+        return tdl_disp_spi_send_data(&disp_spi_dev->cfg, data, line_len * lines);
+    }
+
+    return __disp_spi_send_rows(disp_spi_dev, data, line_len, stride, lines);
+}
+
 static OPERATE_RET __tdl_display_spi_close(TDD_DISP_DEV_HANDLE_T device)
 {
     return OPRT_NOT_SUPPORTED;
@@ -413,6 +532,7 @@ OPERATE_RET tdl_disp_spi_device_register(char *name, TDD_DISP_SPI_CFG_T *spi)
     TDD_DISP_INTFS_T disp_spi_intfs = {
         .open = __tdl_display_spi_open,
         .flush = __tdl_display_spi_flush,
+        .flush_area = __tdl_display_spi_flush_area,
         .close = __tdl_display_spi_close,
     };
 
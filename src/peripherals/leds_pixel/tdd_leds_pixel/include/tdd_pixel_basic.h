@@ -0,0 +1,117 @@
+/**
+ * @file tdd_pixel_basic.h
+ * @brief TDD layer basic utilities header for LED pixel controllers
+ *
+ * This header file declares basic utility functions for LED pixel controllers,
+ * including color data transformation to SPI format, RGB color channel reordering,
+ * and transmission control buffer management. These functions provide common
+ * operations that are shared across different LED pixel controller drivers.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDD_PIXEL_BASIC_H__
+#define __TDD_PIXEL_BASIC_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define ONE_BYTE_LEN 8
+
+/* SPI bits sent for one data bit, a color byte takes the same number of SPI bytes */
+#define PIXEL_SPI_CODE_3BIT 3
+#define PIXEL_SPI_CODE_4BIT 4
+#define PIXEL_SPI_CODE_8BIT 8
+
+#define PIXEL_SPI_COLOR_NUM_MAX 5
+
+/***********************************************************
+****************************typedef define****************************
+*********************************************************************/
+
+typedef struct {
+    unsigned char *tx_buffer;   // Data -> buffer after data stream is converted to SPI data
+    unsigned int tx_buffer_len; // Data length -> length of buffer after data stream is converted to SPI data
+} DRV_PIXEL_TX_CTRL_T;
+
+/*
+ * SPI protocol of a pixel chip. Every data bit of a color byte is sent MSB first as
+ * the low code_bits bits of code_0 or code_1, e.g. 0xC0/0xF0 for 8bit WS2812 codes
+ * or 0x08/0x0E for 4bit codes. The first three channels of a pixel follow the line
+ * sequence, the others are sent in place.
+ */
+typedef struct {
+    unsigned char code_bits;  // PIXEL_SPI_CODE_xBIT
+    unsigned char code_0;     // SPI pattern of a 0 bit
+    unsigned char code_1;     // SPI pattern of a 1 bit
+    unsigned char color_num;  // Channels sent per pixel, at most PIXEL_SPI_COLOR_NUM_MAX
+    unsigned short color_max; // Above 255: values 0~color_max are scaled to 0~255, else the low byte is sent
+} PIXEL_SPI_PROTOCOL_T;
+
+typedef struct {
+    PIXEL_SPI_PROTOCOL_T protocol;
+    unsigned int scale;      // 0.32 fixed point factor of 255 / color_max, 0 -> no scaling
+    unsigned int nibble[16]; // SPI bits of 4 data bits, right aligned, first bit highest
+} PIXEL_SPI_ENCODER_T;
+
+/***********************************************************
+****************************function define***************************
+***********************************************************/
+
+void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_0, unsigned char chip_ic_1,
+                                unsigned char *spi_data_buf);
+
+OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short *spi_buf, RGB_ORDER_MODE_E rgb_order);
+
+/**
+ * @brief Builds the lookup table of an SPI protocol
+ *
+ * @param[in]   protocol            SPI protocol of the pixel chip
+ * @param[out]  encoder             Encoder to initialize
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_encoder_init(const PIXEL_SPI_PROTOCOL_T *protocol, PIXEL_SPI_ENCODER_T *encoder);
+
+/**
+ * @brief Gets the SPI buffer length needed for a number of pixels
+ *
+ * @param[in]   protocol            SPI protocol of the pixel chip
+ * @param[in]   pixel_num           Number of pixels
+ *
+ * @return length in bytes
+ */
+unsigned int tdd_pixel_spi_encode_len(const PIXEL_SPI_PROTOCOL_T *protocol, unsigned int pixel_num);
+
+/**
+ * @brief Converts a whole color buffer to the SPI stream in one pass
+ *
+ * @param[in]   encoder             Initialized encoder
+ * @param[in]   data_buf            Color data, color_step values per pixel
+ * @param[in]   pixel_num           Number of pixels
+ * @param[in]   color_step          Values per pixel in data_buf, not less than the channels sent
+ * @param[in]   line_seq            Order of the first three channels
+ * @param[out]  spi_buf             SPI stream, tdd_pixel_spi_encode_len() bytes
+ *
+ * @return number of bytes written, 0 on invalid parameters
+ */
+unsigned int tdd_pixel_spi_encode(const PIXEL_SPI_ENCODER_T *encoder, const unsigned short *data_buf,
+                                  unsigned int pixel_num, unsigned char color_step, RGB_ORDER_MODE_E line_seq,
+                                  unsigned char *spi_buf);
+
+OPERATE_RET tdd_pixel_create_tx_ctrl(unsigned int tx_buff_len, DRV_PIXEL_TX_CTRL_T **p_pixel_tx);
+
+OPERATE_RET tdd_pixel_tx_ctrl_release(DRV_PIXEL_TX_CTRL_T *tx_ctrl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_PIXEL_BASIC_H__ */
@@ -29,6 +29,11 @@
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
+// Source channel of each output channel, indexed by RGB_ORDER_MODE_E
+static const unsigned char sg_line_seq_idx[][3] = {
+    [RGB_ORDER] = {0, 1, 2}, [RBG_ORDER] = {0, 2, 1}, [GRB_ORDER] = {1, 0, 2},
+    [GBR_ORDER] = {1, 2, 0}, [BRG_ORDER] = {2, 0, 1}, [BGR_ORDER] = {2, 1, 0},
+};
 
 /***********************************************************
 ***********************function define**********************
@@ -112,6 +117,144 @@ OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short
     return OPRT_OK;
 }
 
+OPERATE_RET tdd_pixel_spi_encoder_init(const PIXEL_SPI_PROTOCOL_T *protocol, PIXEL_SPI_ENCODER_T *encoder)
+{
+    unsigned int i = 0, j = 0, code_mask = 0, bits = 0;
+
+    if (NULL == protocol || NULL == encoder) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if ((PIXEL_SPI_CODE_3BIT != protocol->code_bits && PIXEL_SPI_CODE_4BIT != protocol->code_bits &&
+         PIXEL_SPI_CODE_8BIT != protocol->code_bits) ||
+        0 == protocol->color_num || protocol->color_num > PIXEL_SPI_COLOR_NUM_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+
+    encoder->protocol = *protocol;
+    code_mask = (1u << protocol->code_bits) - 1;
+
+    for (i = 0; i < 16; i++) {
+        bits = 0;
+        for (j = 0; j < 4; j++) {
+            bits <<= protocol->code_bits;
+            bits |= ((i << j) & 0x08) ? (protocol->code_1 & code_mask) : (protocol->code_0 & code_mask);
+        }
+        encoder->nibble[i] = bits;
+    }
+
+    // ceil(255 * 2^32 / color_max) gives exact floor(value * 255 / color_max) for 16-bit values
+    if (protocol->color_max > 255) {
+        encoder->scale = (unsigned int)(((255ULL << 32) + protocol->color_max - 1) / protocol->color_max);
+    } else {
+        encoder->scale = 0;
+    }
+
+    return OPRT_OK;
+}
+
+unsigned int tdd_pixel_spi_encode_len(const PIXEL_SPI_PROTOCOL_T *protocol, unsigned int pixel_num)
+{
+    if (NULL == protocol) {
+        return 0;
+    }
+
+    return protocol->code_bits * protocol->color_num * pixel_num;
+}
+
+static inline __attribute__((always_inline)) unsigned char *
+__pixel_spi_put_color(const unsigned int *nibble, unsigned char code_bits, unsigned char color, unsigned char *out)
+{
+    unsigned int hi = nibble[color >> 4], lo = nibble[color & 0x0F];
+
+    switch (code_bits) {
+    case PIXEL_SPI_CODE_8BIT:
+        out[0] = (unsigned char)(hi >> 24);
+        out[1] = (unsigned char)(hi >> 16);
+        out[2] = (unsigned char)(hi >> 8);
+        out[3] = (unsigned char)hi;
+        out[4] = (unsigned char)(lo >> 24);
+        out[5] = (unsigned char)(lo >> 16);
+        out[6] = (unsigned char)(lo >> 8);
+        out[7] = (unsigned char)lo;
+        break;
+    case PIXEL_SPI_CODE_4BIT:
+        out[0] = (unsigned char)(hi >> 8);
+        out[1] = (unsigned char)hi;
+        out[2] = (unsigned char)(lo >> 8);
+        out[3] = (unsigned char)lo;
+        break;
+    default:
+        hi = (hi << 12) | lo;
+        out[0] = (unsigned char)(hi >> 16);
+        out[1] = (unsigned char)(hi >> 8);
+        out[2] = (unsigned char)hi;
+        break;
+    }
+
+    return out + code_bits;
+}
+
+// code_bits is a constant at every call site so the store pattern is resolved at compile time
+static inline __attribute__((always_inline)) unsigned char *
+__pixel_spi_encode_pixels(const PIXEL_SPI_ENCODER_T *encoder, unsigned char code_bits, const unsigned short *data_buf,
+                          unsigned int pixel_num, unsigned char color_step, const unsigned char *src_idx,
+                          unsigned char *out)
+{
+    const unsigned int *nibble = encoder->nibble;
+    unsigned int scale = encoder->scale;
+    unsigned char color_num = encoder->protocol.color_num;
+    unsigned int value = 0, i = 0, c = 0;
+
+    for (i = 0; i < pixel_num; i++) {
+        for (c = 0; c < color_num; c++) {
+            value = data_buf[src_idx[c]];
+            if (scale) {
+                value = (unsigned int)(((unsigned long long)value * scale) >> 32);
+            }
+            out = __pixel_spi_put_color(nibble, code_bits, (unsigned char)value, out);
+        }
+        data_buf += color_step;
+    }
+
+    return out;
+}
+
+unsigned int tdd_pixel_spi_encode(const PIXEL_SPI_ENCODER_T *encoder, const unsigned short *data_buf,
+                                  unsigned int pixel_num, unsigned char color_step, RGB_ORDER_MODE_E line_seq,
+                                  unsigned char *spi_buf)
+{
+    unsigned char src_idx[PIXEL_SPI_COLOR_NUM_MAX] = {0, 1, 2, 3, 4};
+    unsigned char *end = spi_buf;
+
+    if (NULL == encoder || NULL == data_buf || NULL == spi_buf || color_step < encoder->protocol.color_num) {
+        return 0;
+    }
+
+    if (line_seq < sizeof(sg_line_seq_idx) / sizeof(sg_line_seq_idx[0])) {
+        memcpy(src_idx, sg_line_seq_idx[line_seq], sizeof(sg_line_seq_idx[0]));
+    }
+
+    switch (encoder->protocol.code_bits) {
+    case PIXEL_SPI_CODE_8BIT:
+        end = __pixel_spi_encode_pixels(encoder, PIXEL_SPI_CODE_8BIT, data_buf, pixel_num, color_step, src_idx,
+                                        spi_buf);
+        break;
+    case PIXEL_SPI_CODE_4BIT:
+        end = __pixel_spi_encode_pixels(encoder, PIXEL_SPI_CODE_4BIT, data_buf, pixel_num, color_step, src_idx,
+                                        spi_buf);
+        break;
+    case PIXEL_SPI_CODE_3BIT:
+        end = __pixel_spi_encode_pixels(encoder, PIXEL_SPI_CODE_3BIT, data_buf, pixel_num, color_step, src_idx,
+                                        spi_buf);
+        break;
+    default:
+        break;
+    }
+
+    return (unsigned int)(end - spi_buf);
+}
+
 /**
  * @function:tdd_pixel_create_tx_ctrl
  * @brief: Create a buffer to store sending control parameters
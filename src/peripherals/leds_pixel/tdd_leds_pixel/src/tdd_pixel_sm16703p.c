@@ -41,6 +41,13 @@
 ****************************variable define***************************
 *********************************************************************/
 static PIXEL_DRIVER_CONFIG_T driver_info;
+static const PIXEL_SPI_PROTOCOL_T g_spi_protocol = {
+    .code_bits = PIXEL_SPI_CODE_8BIT,
+    .code_0 = DRVICE_DATA_0,
+    .code_1 = DRVICE_DATA_1,
+    .color_num = COLOR_PRIMARY_NUM,
+};
+static PIXEL_SPI_ENCODER_T g_spi_encoder;
 /*********************************************************************
 ****************************function define***************************
 *********************************************************************/
@@ -75,7 +82,12 @@ OPERATE_RET tdd_sm16703p_driver_open(DRIVER_HANDLE_T *handle, unsigned short pix
         return op_ret;
     }
 
-    tx_buf_len = ONE_BYTE_LEN * COLOR_PRIMARY_NUM * pixel_num;
+    op_ret = tdd_pixel_spi_encoder_init(&g_spi_protocol, &g_spi_encoder);
+    if (op_ret != OPRT_OK) {
+        return op_ret;
+    }
+
+    tx_buf_len = tdd_pixel_spi_encode_len(&g_spi_protocol, pixel_num);
     op_ret = tdd_pixel_create_tx_ctrl(tx_buf_len, &pixels_send);
     if (op_ret != OPRT_OK) {
         return op_ret;
@@ -97,8 +109,6 @@ OPERATE_RET tdd_sm16703p_driver_send_data(DRIVER_HANDLE_T handle, unsigned short
 {
     OPERATE_RET ret = OPRT_OK;
     DRV_PIXEL_TX_CTRL_T *tx_ctrl = NULL;
-    unsigned short swap_buf[COLOR_PRIMARY_NUM] = {0};
-    unsigned int i = 0, j = 0, idx = 0;
 
     if (NULL == handle || NULL == data_buf || 0 == buf_len) {
         return OPRT_INVALID_PARM;
@@ -106,15 +116,8 @@ OPERATE_RET tdd_sm16703p_driver_send_data(DRIVER_HANDLE_T handle, unsigned short
 
     tx_ctrl = (DRV_PIXEL_TX_CTRL_T *)handle;
 
-    for (j = 0; j < buf_len / COLOR_PRIMARY_NUM; j++) {
-        memset(swap_buf, 0, sizeof(swap_buf));
-        tdd_rgb_line_seq_transform(&data_buf[j * COLOR_PRIMARY_NUM], swap_buf, driver_info.line_seq);
-        for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
-            tdd_rgb_transform_spi_data((unsigned char)swap_buf[i], DRVICE_DATA_0, DRVICE_DATA_1,
-                                       &tx_ctrl->tx_buffer[idx]);
-            idx += ONE_BYTE_LEN;
-        }
-    }
+    tdd_pixel_spi_encode(&g_spi_encoder, data_buf, buf_len / COLOR_PRIMARY_NUM, COLOR_PRIMARY_NUM,
+                         driver_info.line_seq, tx_ctrl->tx_buffer);
 
     ret = tkl_spi_send(driver_info.port, tx_ctrl->tx_buffer, tx_ctrl->tx_buffer_len);
 
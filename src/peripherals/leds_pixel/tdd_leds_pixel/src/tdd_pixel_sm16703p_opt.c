@@ -32,13 +32,9 @@
 #define COLOR_PRIMARY_NUM 3 // 3 channels
 #define COLOR_RESOLUTION  10000
 
-// V2.0 return-to-zero code 4bit version
-#define LED_DRVICE_IC_DATA_00 0X88 // 00
-#define LED_DRVICE_IC_DATA_01 0X8e // 01
-#define LED_DRVICE_IC_DATA_10 0Xe8 // 10
-#define LED_DRVICE_IC_DATA_11 0Xee // 11
-
-#define ONE_BYTE_LEN_4BIT 4
+// V2.0 return-to-zero code 4bit version, two data bits per SPI byte
+#define LED_DRVICE_IC_DATA_0 0X08 // 1000
+#define LED_DRVICE_IC_DATA_1 0X0E // 1110
 /************************************************************
 ****************************typedef define****************************
 *********************************************************************/
@@ -48,37 +44,18 @@
 *********************************************************************/
 static PIXEL_DRIVER_CONFIG_T driver_info;
 static PIXEL_PWM_CFG_T *g_pwm_cfg = NULL;
+static const PIXEL_SPI_PROTOCOL_T g_spi_protocol = {
+    .code_bits = PIXEL_SPI_CODE_4BIT,
+    .code_0 = LED_DRVICE_IC_DATA_0,
+    .code_1 = LED_DRVICE_IC_DATA_1,
+    .color_num = COLOR_PRIMARY_NUM,
+    .color_max = COLOR_RESOLUTION,
+};
+static PIXEL_SPI_ENCODER_T g_spi_encoder;
 /*********************************************************************
 ****************************function define***************************
 *********************************************************************/
 
-static void __tdd_16703_4bit_rgb_transform_spi_data(unsigned char color_data, unsigned char *spi_data_buf)
-{
-    unsigned char i = 0;
-
-    for (i = 0; i < ONE_BYTE_LEN_4BIT; i++) {
-        if ((color_data & 0xc0) == 0) {
-            spi_data_buf[i] = LED_DRVICE_IC_DATA_00;
-
-        } else if ((color_data & 0xc0) == 0x40) {
-            spi_data_buf[i] = LED_DRVICE_IC_DATA_01;
-
-        } else if ((color_data & 0xc0) == 0x80) {
-            spi_data_buf[i] = LED_DRVICE_IC_DATA_10;
-
-        } else if ((color_data & 0xc0) == 0xc0) {
-            spi_data_buf[i] = LED_DRVICE_IC_DATA_11;
-
-        } else {
-            TAL_PR_ERR("SPI Send 1/0 Bit error\r\n");
-        }
-
-        color_data = color_data << 2;
-    }
-
-    return;
-}
-
 OPERATE_RET tdd_sm16703p_opt_driver_open(DRIVER_HANDLE_T *handle, unsigned short pixel_num)
 {
     OPERATE_RET op_ret = OPRT_OK;
@@ -103,7 +80,12 @@ OPERATE_RET tdd_sm16703p_opt_driver_open(DRIVER_HANDLE_T *handle, unsigned short
         return op_ret;
     }
 
-    tx_buf_len = ONE_BYTE_LEN_4BIT * COLOR_PRIMARY_NUM * pixel_num;
+    op_ret = tdd_pixel_spi_encoder_init(&g_spi_protocol, &g_spi_encoder);
+    if (op_ret != OPRT_OK) {
+        return op_ret;
+    }
+
+    tx_buf_len = tdd_pixel_spi_encode_len(&g_spi_protocol, pixel_num);
     op_ret = tdd_pixel_create_tx_ctrl(tx_buf_len, &pixels_send);
     if (op_ret != OPRT_OK) {
         return op_ret;
@@ -125,8 +107,6 @@ OPERATE_RET tdd_sm16703p_opt_driver_send_data(DRIVER_HANDLE_T handle, unsigned s
 {
     OPERATE_RET ret = OPRT_OK;
     DRV_PIXEL_TX_CTRL_T *tx_ctrl = NULL;
-    unsigned short swap_buf[COLOR_PRIMARY_NUM] = {0};
-    unsigned int i = 0, j = 0, idx = 0;
     unsigned char color_nums = COLOR_PRIMARY_NUM;
 
     if (NULL == handle || NULL == data_buf || 0 == buf_len) {
@@ -149,15 +129,8 @@ OPERATE_RET tdd_sm16703p_opt_driver_send_data(DRIVER_HANDLE_T handle, unsigned s
     }
 
     tx_ctrl = (DRV_PIXEL_TX_CTRL_T *)handle;
-    for (j = 0; j < buf_len / color_nums; j++) {
-        memset(swap_buf, 0, sizeof(swap_buf));
-        tdd_rgb_line_seq_transform(&data_buf[j * color_nums], swap_buf, driver_info.line_seq);
-        for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
-            __tdd_16703_4bit_rgb_transform_spi_data((unsigned char)(swap_buf[i] * 255 / COLOR_RESOLUTION),
-                                                    &tx_ctrl->tx_buffer[idx]);
-            idx += ONE_BYTE_LEN_4BIT;
-        }
-    }
+    tdd_pixel_spi_encode(&g_spi_encoder, data_buf, buf_len / color_nums, color_nums, driver_info.line_seq,
+                         tx_ctrl->tx_buffer);
 
     ret = tkl_spi_send(driver_info.port, tx_ctrl->tx_buffer, tx_ctrl->tx_buffer_len);
 
@@ -0,0 +1,177 @@
+/**
+ * @file tdl_pixel_effect.h
+ * @brief TDL layer frame based effect engine for LED pixel devices
+ *
+ * This header file provides a frame based effect engine for LED pixel devices.
+ * Effects are rendered as 8-bit RGB frames with fixed-point arithmetic, then mapped
+ * to the device color range through a per-strip gamma/brightness lookup table. Only
+ * the pixels that changed since the last frame are mapped again. A scheduler task
+ * renders and sends frames at a target frame rate, dropping frames to keep the
+ * animation on time when a frame takes too long.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_PIXEL_EFFECT_H__
+#define __TDL_PIXEL_EFFECT_H__
+
+#include "tdl_pixel_dev_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+******************************macro define****************************
+*********************************************************************/
+#define PIXEL_EFFECT_FPS_DEFAULT   30
+#define PIXEL_EFFECT_GAMMA_DEFAULT 22 // gamma 2.2
+#define PIXEL_EFFECT_GAMMA_LINEAR  10
+
+/*********************************************************************
+****************************typedef define****************************
+*********************************************************************/
+typedef void *PIXEL_EFFECT_HANDLE_T;
+
+typedef struct {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+} PIXEL_EFFECT_RGB_T;
+
+/**
+ * @brief Renders frame frame_idx of a custom effect into frame, pixel_num pixels
+ */
+typedef void (*PIXEL_EFFECT_RENDER_CB)(PIXEL_EFFECT_RGB_T *frame, uint32_t pixel_num, uint32_t frame_idx, void *arg);
+
+typedef unsigned char PIXEL_EFFECT_TYPE_E;
+#define PIXEL_EFFECT_GRADIENT     0x00 // Two color gradient, scrolling when speed is not 0
+#define PIXEL_EFFECT_CHASE        0x01 // Segment with a fading tail running over a background
+#define PIXEL_EFFECT_BREATHE      0x02 // Whole strip fading in and out
+#define PIXEL_EFFECT_PALETTE_FADE 0x03 // Whole strip fading through a list of colors
+#define PIXEL_EFFECT_CUSTOM       0x04 // Frames rendered by a callback
+
+/*
+ * Speeds are pixels per frame in 8.8 fixed point, 256 moves one pixel a frame.
+ * Periods are in frames.
+ */
+typedef struct {
+    PIXEL_EFFECT_TYPE_E type;
+    union {
+        struct {
+            PIXEL_EFFECT_RGB_T start;
+            PIXEL_EFFECT_RGB_T end;
+            uint16_t speed;
+        } gradient;
+        struct {
+            PIXEL_EFFECT_RGB_T color;
+            PIXEL_EFFECT_RGB_T back;
+            uint16_t len; // Segment length including the tail
+            uint16_t speed;
+        } chase;
+        struct {
+            PIXEL_EFFECT_RGB_T color;
+            uint16_t period;
+        } breathe;
+        struct {
+            const PIXEL_EFFECT_RGB_T *colors; // Must stay valid while the effect runs
+            uint8_t num;
+            uint16_t hold; // Frames each color is held
+            uint16_t fade; // Frames to fade to the next color
+        } palette;
+        struct {
+            PIXEL_EFFECT_RENDER_CB render;
+            void *arg;
+        } custom;
+    } param;
+} PIXEL_EFFECT_T;
+
+typedef struct {
+    uint16_t fps;       // Target frame rate, 0 -> PIXEL_EFFECT_FPS_DEFAULT
+    uint8_t brightness; // 0~255
+    uint8_t gamma;      // Gamma x10, 0 -> PIXEL_EFFECT_GAMMA_DEFAULT
+} PIXEL_EFFECT_CFG_T;
+
+typedef struct {
+    uint32_t frames;        // Frames sent since the effect started
+    uint32_t dropped;       // Frames skipped to keep up with the schedule
+    uint32_t fps_x100;      // Frame rate achieved over the last second, x100
+    uint32_t scaled_pixels; // Pixels mapped to the device range in the last frame
+} PIXEL_EFFECT_STATS_T;
+
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+/**
+ * @brief        Create an effect engine for an opened pixel device
+ *
+ * @param[in]    dev_handle       Device handle
+ * @param[in]    cfg              Frame rate, brightness and gamma
+ * @param[out]   handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_create(PIXEL_HANDLE_T dev_handle, PIXEL_EFFECT_CFG_T *cfg, PIXEL_EFFECT_HANDLE_T *handle);
+
+/**
+ * @brief        Start an effect from its first frame, the scheduler task is started if needed
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[in]    effect           Effect to run, copied
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_start(PIXEL_EFFECT_HANDLE_T handle, PIXEL_EFFECT_T *effect);
+
+/**
+ * @brief        Stop the scheduler task, the last frame stays on the strip
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_stop(PIXEL_EFFECT_HANDLE_T handle);
+
+/**
+ * @brief        Render and send the next frame of the current effect without the scheduler task
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_render_frame(PIXEL_EFFECT_HANDLE_T handle);
+
+/**
+ * @brief        Set the brightness, takes effect from the next frame
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[in]    brightness       0~255
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_set_brightness(PIXEL_EFFECT_HANDLE_T handle, uint8_t brightness);
+
+/**
+ * @brief        Get the frame statistics of the current effect
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[out]   stats            Statistics
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_get_stats(PIXEL_EFFECT_HANDLE_T handle, PIXEL_EFFECT_STATS_T *stats);
+
+/**
+ * @brief        Stop and release an effect engine
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_destroy(PIXEL_EFFECT_HANDLE_T handle);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /*__TDL_PIXEL_EFFECT_H__*/
@@ -31,7 +31,7 @@
 ***********************function define**********************
 ***********************************************************/
 static void_T __tdl_pixel_only_set_cw(PIXEL_HANDLE_T handle, USHORT_T *buff, PIXEL_COLOR_TP_E tp, uint8_t color_num,
-                                      index, PIXEL_COLOR_T *color)
+                                      uint32_t index, PIXEL_COLOR_T *color)
 {
     uint32_t pos = 0;
     PIXEL_DEV_NODE_T *device = (PIXEL_DEV_NODE_T *)handle;
@@ -258,6 +258,7 @@ int tdl_pixel_set_single_color(PIXEL_HANDLE_T handle, uint32_t index_start, uint
         __tdl_pixel_set_color(handle, device->pixel_buffer, device->pixel_color, device->color_num, index_start + i,
                               color);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
@@ -295,6 +296,7 @@ int tdl_pixel_set_multi_color(PIXEL_HANDLE_T handle, uint32_t index_start, uint3
         __tdl_pixel_set_color(handle, device->pixel_buffer, device->pixel_color, device->color_num, index_start + i,
                               &color_arr[i]);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
@@ -339,6 +341,7 @@ int tdl_pixel_set_single_color_with_backcolor(PIXEL_HANDLE_T handle, uint32_t in
         __tdl_pixel_set_color(handle, device->pixel_buffer, device->pixel_color, device->color_num, index_start + i,
                               color);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
@@ -379,6 +382,7 @@ int tdl_pixel_cycle_shift_color(PIXEL_HANDLE_T handle, PIXEL_SHIFT_DIR_T dir, ui
     } else {
         op_ret = __tdl_pixel_left_shift(device->pixel_buffer, device->color_num, index_start, index_end, move_step);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return op_ret;
@@ -445,6 +449,7 @@ int tdl_pixel_mirror_cycle_shift_color(PIXEL_HANDLE_T handle, PIXEL_M_SHIFT_DIR_
     }
 
 END:
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return op_ret;
@@ -505,6 +510,7 @@ int tdl_pixel_set_single_color_all(PIXEL_HANDLE_T handle, PIXEL_COLOR_T *color)
     for (i = 0; i < device->pixel_num; i++) {
         __tdl_pixel_set_color(handle, device->pixel_buffer, device->pixel_color, device->color_num, i, color);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
@@ -535,6 +541,7 @@ int tdl_pixel_set_single_white_all(PIXEL_HANDLE_T handle, PIXEL_COLOR_T *color)
     for (i = 0; i < device->pixel_num; i++) {
         __tdl_pixel_only_set_cw(handle, device->pixel_buffer, device->pixel_color, device->color_num, i, color);
     }
+    device->buffer_gen++;
     tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
@@ -571,8 +578,11 @@ int tdl_pixel_copy_color(PIXEL_HANDLE_T handle, uint32_t dst_idx, uint32_t src_i
 
     copy_len = device->color_num * sizeof(USHORT_T) * len;
 
+    tal_mutex_lock(device->mutex);
     memmove((unsigned char *)&device->pixel_buffer[dst_idx * device->color_num],
             (unsigned char *)&device->pixel_buffer[src_idx * device->color_num], copy_len);
+    device->buffer_gen++;
+    tal_mutex_unlock(device->mutex);
 
     return OPRT_OK;
 }
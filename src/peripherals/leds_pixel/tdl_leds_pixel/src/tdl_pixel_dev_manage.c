@@ -158,6 +158,7 @@ static int __tdl_pixel_dev_open(PIXEL_DEV_NODE_T *device, PIXEL_DEV_CONFIG_T *co
         return OPRT_COM_ERROR;
     }
     memset(device->pixel_buffer, 0, device->color_num * device->pixel_num * sizeof(USHORT_T));
+    device->buffer_gen++;
 
     device->flag.is_start = 1;
 
@@ -168,12 +169,19 @@ static int __tdl_pixel_dev_open(PIXEL_DEV_NODE_T *device, PIXEL_DEV_CONFIG_T *co
 
 static int __tdl_pixel_refresh(PIXEL_DEV_NODE_T *device)
 {
+    int op_ret = 0;
+    SYS_TIME_T now = tal_system_get_millisecond();
+
     // The interval between ws2812 frames is required to be >50us. To ensure the portability of the delay code, the
-    // system interface is called here to set it.
-    if (p_node->basic_info.drive_mode == TDD_PIXEL_DRIVE_SPI) {
+    // system interface is called here to set it. A gap of 2 ticks is at least 1ms, so paced frames skip the sleep.
+    if ((uint32_t)(now - device->last_refresh_ms) < 2) {
         tal_system_sleep(1);
     }
-    return device->intfs->output(device->drv_handle, device->pixel_buffer, device->pixel_num * device->color_num);
+
+    op_ret = device->intfs->output(device->drv_handle, device->pixel_buffer, device->pixel_num * device->color_num);
+    device->last_refresh_ms = tal_system_get_millisecond();
+
+    return op_ret;
 }
 
 static int __tdl_pixel_dev_close(PIXEL_DEV_NODE_T *device)
@@ -315,6 +323,7 @@ static OPERATE_RET __tdl_pixel_dev_num_set(PIXEL_HANDLE_T *handle, uint16_t num)
     device->pixel_buffer = (USHORT_T *)tal_malloc((device->color_num) * device->pixel_num * sizeof(USHORT_T));
     device->pixel_buffer_len = (device->color_num) * device->pixel_num;
     memset(device->pixel_buffer, 0, ((device->color_num) * device->pixel_num * sizeof(USHORT_T))); // Clear data
+    device->buffer_gen++;
 
     return OPRT_OK;
 }
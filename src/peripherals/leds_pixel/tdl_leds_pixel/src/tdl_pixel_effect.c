@@ -0,0 +1,669 @@
+/**
+ * @file tdl_pixel_effect.c
+ * @brief TDL layer frame based effect engine implementation for LED pixel devices
+ *
+ * This source file implements the effect engine for LED pixel devices. Frames are
+ * rendered as 8-bit RGB with fixed-point blending, compared with the frame on the
+ * strip, and only the changed pixels are mapped through the gamma/brightness table
+ * into the device pixel buffer. The scheduler task paces frames against the start
+ * time of the effect, so a slow frame shortens the next wait instead of delaying
+ * every following frame, and whole frames are dropped when it falls behind.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_thread.h"
+#include "tdl_pixel_effect.h"
+
+/***********************************************************
+*************************private include********************
+***********************************************************/
+#include "tdl_pixel_driver.h"
+#include "tdl_pixel_struct.h"
+
+/***********************************************************
+*************************micro define***********************
+***********************************************************/
+#ifndef PIXEL_EFFECT_TASK_STACK
+#define PIXEL_EFFECT_TASK_STACK 2048
+#endif
+
+#define PIXEL_EFFECT_FPS_WINDOW_MS 1000
+
+#define Q16_ONE (1u << 16)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    PIXEL_DEV_NODE_T *device;
+    MUTEX_HANDLE mutex;
+    SEM_HANDLE wake_sem;
+    SEM_HANDLE exit_sem;
+    THREAD_HANDLE task;
+    volatile BOOL_T is_running;
+    volatile BOOL_T is_restart;
+
+    PIXEL_EFFECT_T effect;
+    BOOL_T has_effect;
+    uint32_t frame_idx;
+
+    uint16_t fps;
+    uint8_t gamma;
+    uint16_t lut[256]; // 8-bit color -> device color range, gamma and brightness applied
+
+    BOOL_T full_update;
+    uint32_t pixel_num;
+    PIXEL_EFFECT_RGB_T *frame; // Frame being rendered
+    PIXEL_EFFECT_RGB_T *shown; // Frame in the device pixel buffer
+    USHORT_T *dev_buffer;      // Device pixel buffer the shown frame was written to
+    uint32_t dev_gen;          // Buffer generation of the device after the shown frame was written
+
+    PIXEL_EFFECT_STATS_T stats;
+    uint32_t fps_frames;
+    SYS_TIME_T fps_start;
+} PIXEL_EFFECT_CTX_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+// log2(x) of a Q16 value, x > 0, result in Q16
+static int32_t __pixel_effect_log2_q16(uint32_t x)
+{
+    int32_t y = 0;
+    uint32_t b = 0;
+
+    while (x >= 2 * Q16_ONE) {
+        x >>= 1;
+        y += Q16_ONE;
+    }
+    while (x < Q16_ONE) {
+        x <<= 1;
+        y -= Q16_ONE;
+    }
+
+    for (b = Q16_ONE >> 1; b; b >>= 1) {
+        x = (uint32_t)(((uint64_t)x * x) >> 16);
+        if (x >= 2 * Q16_ONE) {
+            x >>= 1;
+            y += b;
+        }
+    }
+
+    return y;
+}
+
+// 2^y of a Q16 value, y <= 0, result in Q16
+static uint32_t __pixel_effect_exp2_q16(int32_t y)
+{
+    int32_t n = -(y >> 16);
+    uint32_t f = (uint32_t)y & 0xFFFF, p = 0;
+
+    if (n >= 16) {
+        return 0;
+    }
+
+    // 2^f ~= 1 + f * (0.69589 + f * (0.22623 + f * 0.07789)) for f in [0, 1)
+    p = 5104;
+    p = (uint32_t)(((uint64_t)p * f) >> 16) + 14826;
+    p = (uint32_t)(((uint64_t)p * f) >> 16) + 45606;
+    p = (uint32_t)(((uint64_t)p * f) >> 16) + Q16_ONE;
+
+    return p >> n;
+}
+
+static void __pixel_effect_build_lut(PIXEL_EFFECT_CTX_T *ctx, uint8_t brightness)
+{
+    uint32_t v = 0, level = 0;
+    uint64_t scale = (uint64_t)brightness * ctx->device->color_maximum;
+
+    ctx->lut[0] = 0;
+    for (v = 1; v < 256; v++) {
+        level = (v << 16) / 255;
+        if (ctx->gamma != PIXEL_EFFECT_GAMMA_LINEAR) {
+            level = __pixel_effect_exp2_q16(__pixel_effect_log2_q16(level) * (int32_t)ctx->gamma / 10);
+        }
+        ctx->lut[v] = (uint16_t)((level * scale + (255u << 15)) / (255u << 16));
+    }
+
+    ctx->full_update = TRUE;
+}
+
+// w 0~256, 256 -> b
+static inline uint8_t __pixel_effect_blend(uint8_t a, uint8_t b, uint32_t w)
+{
+    return (uint8_t)((a * (256 - w) + b * w) >> 8);
+}
+
+static inline void __pixel_effect_blend_rgb(const PIXEL_EFFECT_RGB_T *a, const PIXEL_EFFECT_RGB_T *b, uint32_t w,
+                                            PIXEL_EFFECT_RGB_T *out)
+{
+    out->red = __pixel_effect_blend(a->red, b->red, w);
+    out->green = __pixel_effect_blend(a->green, b->green, w);
+    out->blue = __pixel_effect_blend(a->blue, b->blue, w);
+}
+
+static void __pixel_effect_fill(PIXEL_EFFECT_RGB_T *frame, uint32_t pixel_num, const PIXEL_EFFECT_RGB_T *color)
+{
+    uint32_t i = 0;
+
+    for (i = 0; i < pixel_num; i++) {
+        frame[i] = *color;
+    }
+}
+
+static void __pixel_effect_gradient(PIXEL_EFFECT_CTX_T *ctx, uint32_t frame_idx)
+{
+    PIXEL_EFFECT_RGB_T *frame = ctx->frame;
+    uint32_t n = ctx->pixel_num, i = 0, t = 0, step = 0, phase = 0, offset = 0;
+
+    // A start -> end -> start triangle over the strip, so the scrolling pattern wraps seamlessly
+    step = (512u << 16) / n;
+    offset = (uint32_t)(((uint64_t)frame_idx * ctx->effect.param.gradient.speed) % ((uint64_t)n << 8));
+    phase = 0 - (uint32_t)(((uint64_t)offset * step) >> 8);
+
+    for (i = 0; i < n; i++) {
+        t = (phase >> 16) & 511;
+        t = (t < 256) ? t : 511 - t;
+        __pixel_effect_blend_rgb(&ctx->effect.param.gradient.start, &ctx->effect.param.gradient.end, t + (t >> 7),
+                                 &frame[i]);
+        phase += step;
+    }
+}
+
+static void __pixel_effect_chase(PIXEL_EFFECT_CTX_T *ctx, uint32_t frame_idx)
+{
+    PIXEL_EFFECT_RGB_T *frame = ctx->frame;
+    uint32_t n = ctx->pixel_num, len = ctx->effect.param.chase.len, head = 0, k = 0;
+
+    __pixel_effect_fill(frame, n, &ctx->effect.param.chase.back);
+
+    if (len > n) {
+        len = n;
+    }
+
+    head = (uint32_t)((((uint64_t)frame_idx * ctx->effect.param.chase.speed) >> 8) % n);
+    for (k = 0; k < len; k++) {
+        __pixel_effect_blend_rgb(&ctx->effect.param.chase.back, &ctx->effect.param.chase.color,
+                                 ((len - k) << 8) / len, &frame[(head + n - k) % n]);
+    }
+}
+
+static void __pixel_effect_breathe(PIXEL_EFFECT_CTX_T *ctx, uint32_t frame_idx)
+{
+    PIXEL_EFFECT_RGB_T color, black = {0, 0, 0};
+    uint32_t period = ctx->effect.param.breathe.period, t = 0;
+
+    t = (frame_idx % period) * 512 / period;
+    t = (t < 256) ? t : 511 - t;
+    __pixel_effect_blend_rgb(&black, &ctx->effect.param.breathe.color, t + (t >> 7), &color);
+
+    __pixel_effect_fill(ctx->frame, ctx->pixel_num, &color);
+}
+
+static void __pixel_effect_palette_fade(PIXEL_EFFECT_CTX_T *ctx, uint32_t frame_idx)
+{
+    PIXEL_EFFECT_RGB_T color;
+    const PIXEL_EFFECT_RGB_T *colors = ctx->effect.param.palette.colors;
+    uint32_t num = ctx->effect.param.palette.num, hold = ctx->effect.param.palette.hold;
+    uint32_t fade = ctx->effect.param.palette.fade, cycle = hold + fade, idx = 0, t = 0;
+
+    idx = (frame_idx / cycle) % num;
+    t = frame_idx % cycle;
+    if (t < hold) {
+        color = colors[idx];
+    } else {
+        __pixel_effect_blend_rgb(&colors[idx], &colors[(idx + 1) % num], ((t - hold + 1) << 8) / fade, &color);
+    }
+
+    __pixel_effect_fill(ctx->frame, ctx->pixel_num, &color);
+}
+
+static void __pixel_effect_render(PIXEL_EFFECT_CTX_T *ctx, uint32_t frame_idx)
+{
+    switch (ctx->effect.type) {
+    case PIXEL_EFFECT_GRADIENT:
+        __pixel_effect_gradient(ctx, frame_idx);
+        break;
+    case PIXEL_EFFECT_CHASE:
+        __pixel_effect_chase(ctx, frame_idx);
+        break;
+    case PIXEL_EFFECT_BREATHE:
+        __pixel_effect_breathe(ctx, frame_idx);
+        break;
+    case PIXEL_EFFECT_PALETTE_FADE:
+        __pixel_effect_palette_fade(ctx, frame_idx);
+        break;
+    case PIXEL_EFFECT_CUSTOM:
+        ctx->effect.param.custom.render(ctx->frame, ctx->pixel_num, frame_idx, ctx->effect.param.custom.arg);
+        break;
+    default:
+        break;
+    }
+}
+
+// Maps the changed pixels into the device pixel buffer, returns the number of pixels mapped
+static uint32_t __pixel_effect_scale(PIXEL_EFFECT_CTX_T *ctx)
+{
+    PIXEL_DEV_NODE_T *device = ctx->device;
+    const PIXEL_EFFECT_RGB_T *px = ctx->frame;
+    PIXEL_EFFECT_RGB_T *shown = ctx->shown;
+    USHORT_T *dst = device->pixel_buffer;
+    uint32_t i = 0, cnt = 0;
+
+    // The shown frame is stale once the buffer is replaced or written through the tdl_pixel APIs
+    if (dst != ctx->dev_buffer || device->buffer_gen != ctx->dev_gen) {
+        ctx->dev_buffer = dst;
+        ctx->dev_gen = device->buffer_gen;
+        ctx->full_update = TRUE;
+    }
+
+    for (i = 0; i < ctx->pixel_num; i++, px++, shown++, dst += device->color_num) {
+        if (!ctx->full_update && px->red == shown->red && px->green == shown->green && px->blue == shown->blue) {
+            continue;
+        }
+
+        *shown = *px;
+        dst[0] = ctx->lut[px->red];
+        dst[1] = ctx->lut[px->green];
+        dst[2] = ctx->lut[px->blue];
+        cnt++;
+    }
+
+    ctx->full_update = FALSE;
+
+    return cnt;
+}
+
+static OPERATE_RET __pixel_effect_buffer_check(PIXEL_EFFECT_CTX_T *ctx)
+{
+    uint32_t pixel_num = ctx->device->pixel_num;
+    PIXEL_EFFECT_RGB_T *frame = NULL, *shown = NULL;
+
+    if (pixel_num == ctx->pixel_num && ctx->frame) {
+        return OPRT_OK;
+    }
+
+    if (0 == pixel_num) {
+        return OPRT_COM_ERROR;
+    }
+
+    frame = (PIXEL_EFFECT_RGB_T *)tal_malloc(2 * pixel_num * sizeof(PIXEL_EFFECT_RGB_T));
+    if (NULL == frame) {
+        TAL_PR_ERR("malloc failed !");
+        return OPRT_MALLOC_FAILED;
+    }
+    shown = frame + pixel_num;
+
+    if (ctx->frame) {
+        tal_free(ctx->frame);
+    }
+    ctx->frame = frame;
+    ctx->shown = shown;
+    ctx->pixel_num = pixel_num;
+    ctx->full_update = TRUE;
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __pixel_effect_send_frame(PIXEL_EFFECT_CTX_T *ctx)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    PIXEL_DEV_NODE_T *device = ctx->device;
+    SYS_TIME_T now = 0;
+    uint32_t elapsed = 0;
+
+    tal_mutex_lock(ctx->mutex);
+    if (!ctx->has_effect || 0 == device->flag.is_start) {
+        tal_mutex_unlock(ctx->mutex);
+        return OPRT_COM_ERROR;
+    }
+
+    tal_mutex_lock(device->mutex);
+    op_ret = __pixel_effect_buffer_check(ctx);
+    if (OPRT_OK == op_ret) {
+        __pixel_effect_render(ctx, ctx->frame_idx);
+        ctx->stats.scaled_pixels = __pixel_effect_scale(ctx);
+    }
+    tal_mutex_unlock(device->mutex);
+
+    if (op_ret != OPRT_OK) {
+        tal_mutex_unlock(ctx->mutex);
+        return op_ret;
+    }
+
+    ctx->frame_idx++;
+    ctx->stats.frames++;
+    ctx->fps_frames++;
+    now = tal_system_get_millisecond();
+    elapsed = (uint32_t)(now - ctx->fps_start);
+    if (elapsed >= PIXEL_EFFECT_FPS_WINDOW_MS) {
+        ctx->stats.fps_x100 = ctx->fps_frames * 100000 / elapsed;
+        ctx->fps_frames = 0;
+        ctx->fps_start = now;
+    }
+    tal_mutex_unlock(ctx->mutex);
+
+    return tdl_pixel_dev_refresh(device);
+}
+
+static void __pixel_effect_task(void *args)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)args;
+    SYS_TIME_T start = 0;
+    THREAD_HANDLE task = NULL;
+    uint32_t frame = 0, due = 0, elapsed = 0, late = 0;
+
+    while (ctx->is_running) {
+        if (ctx->is_restart) {
+            ctx->is_restart = FALSE;
+            start = tal_system_get_millisecond();
+            frame = 0;
+        }
+
+        __pixel_effect_send_frame(ctx);
+
+        // Frame n is due n / fps seconds after the start, late frames are dropped to keep the animation on time
+        frame++;
+        due = (uint32_t)((uint64_t)frame * 1000 / ctx->fps);
+        elapsed = (uint32_t)(tal_system_get_millisecond() - start);
+        if (elapsed >= due) {
+            late = (uint32_t)((uint64_t)(elapsed - due) * ctx->fps / 1000);
+            if (late) {
+                tal_mutex_lock(ctx->mutex);
+                ctx->frame_idx += late;
+                ctx->stats.dropped += late;
+                tal_mutex_unlock(ctx->mutex);
+                frame += late;
+            }
+            continue;
+        }
+
+        tal_semaphore_wait(ctx->wake_sem, due - elapsed);
+    }
+
+    task = ctx->task;
+    ctx->task = NULL;
+    tal_semaphore_post(ctx->exit_sem);
+    tal_thread_delete(task);
+}
+
+static OPERATE_RET __pixel_effect_check(PIXEL_EFFECT_T *effect)
+{
+    switch (effect->type) {
+    case PIXEL_EFFECT_GRADIENT:
+        break;
+    case PIXEL_EFFECT_CHASE:
+        if (0 == effect->param.chase.len) {
+            return OPRT_INVALID_PARM;
+        }
+        break;
+    case PIXEL_EFFECT_BREATHE:
+        if (effect->param.breathe.period < 2) {
+            return OPRT_INVALID_PARM;
+        }
+        break;
+    case PIXEL_EFFECT_PALETTE_FADE:
+        if (NULL == effect->param.palette.colors || 0 == effect->param.palette.num ||
+            0 == effect->param.palette.hold + effect->param.palette.fade) {
+            return OPRT_INVALID_PARM;
+        }
+        break;
+    case PIXEL_EFFECT_CUSTOM:
+        if (NULL == effect->param.custom.render) {
+            return OPRT_INVALID_PARM;
+        }
+        break;
+    default:
+        return OPRT_INVALID_PARM;
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Create an effect engine for an opened pixel device
+ *
+ * @param[in]    dev_handle       Device handle
+ * @param[in]    cfg              Frame rate, brightness and gamma
+ * @param[out]   handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_create(PIXEL_HANDLE_T dev_handle, PIXEL_EFFECT_CFG_T *cfg, PIXEL_EFFECT_HANDLE_T *handle)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    PIXEL_DEV_NODE_T *device = (PIXEL_DEV_NODE_T *)dev_handle;
+    PIXEL_EFFECT_CTX_T *ctx = NULL;
+
+    if (NULL == device || NULL == cfg || NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (0 == device->flag.is_start) {
+        return OPRT_COM_ERROR;
+    }
+
+    ctx = (PIXEL_EFFECT_CTX_T *)tal_malloc(sizeof(PIXEL_EFFECT_CTX_T));
+    if (NULL == ctx) {
+        TAL_PR_ERR("malloc failed !");
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(ctx, 0, sizeof(PIXEL_EFFECT_CTX_T));
+
+    ctx->device = device;
+    ctx->fps = cfg->fps ? cfg->fps : PIXEL_EFFECT_FPS_DEFAULT;
+    ctx->gamma = cfg->gamma ? cfg->gamma : PIXEL_EFFECT_GAMMA_DEFAULT;
+    __pixel_effect_build_lut(ctx, cfg->brightness);
+
+    op_ret = tal_mutex_create_init(&ctx->mutex);
+    if (op_ret != OPRT_OK) {
+        goto ERR_EXIT;
+    }
+
+    op_ret = tal_semaphore_create_init(&ctx->wake_sem, 0, 1);
+    if (op_ret != OPRT_OK) {
+        goto ERR_EXIT;
+    }
+
+    op_ret = tal_semaphore_create_init(&ctx->exit_sem, 0, 1);
+    if (op_ret != OPRT_OK) {
+        goto ERR_EXIT;
+    }
+
+    tal_mutex_lock(device->mutex);
+    op_ret = __pixel_effect_buffer_check(ctx);
+    tal_mutex_unlock(device->mutex);
+    if (op_ret != OPRT_OK) {
+        goto ERR_EXIT;
+    }
+
+    *handle = (PIXEL_EFFECT_HANDLE_T)ctx;
+
+    return OPRT_OK;
+
+ERR_EXIT:
+    if (ctx->exit_sem) {
+        tal_semaphore_release(ctx->exit_sem);
+    }
+    if (ctx->wake_sem) {
+        tal_semaphore_release(ctx->wake_sem);
+    }
+    if (ctx->mutex) {
+        tal_mutex_release(ctx->mutex);
+    }
+    tal_free(ctx);
+
+    return op_ret;
+}
+
+/**
+ * @brief        Start an effect from its first frame, the scheduler task is started if needed
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[in]    effect           Effect to run, copied
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_start(PIXEL_EFFECT_HANDLE_T handle, PIXEL_EFFECT_T *effect)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+    THREAD_CFG_T thread_cfg = {PIXEL_EFFECT_TASK_STACK, THREAD_PRIO_2, "pixel_effect"};
+
+    if (NULL == ctx || NULL == effect) {
+        return OPRT_INVALID_PARM;
+    }
+
+    op_ret = __pixel_effect_check(effect);
+    if (op_ret != OPRT_OK) {
+        return op_ret;
+    }
+
+    tal_mutex_lock(ctx->mutex);
+    memcpy(&ctx->effect, effect, sizeof(PIXEL_EFFECT_T));
+    ctx->has_effect = TRUE;
+    ctx->frame_idx = 0;
+    ctx->full_update = TRUE;
+    memset(&ctx->stats, 0, sizeof(PIXEL_EFFECT_STATS_T));
+    ctx->fps_frames = 0;
+    ctx->fps_start = tal_system_get_millisecond();
+    ctx->is_restart = TRUE;
+    tal_mutex_unlock(ctx->mutex);
+
+    if (ctx->task) {
+        tal_semaphore_post(ctx->wake_sem);
+        return OPRT_OK;
+    }
+
+    ctx->is_running = TRUE;
+    op_ret = tal_thread_create_and_start(&ctx->task, NULL, NULL, __pixel_effect_task, ctx, &thread_cfg);
+    if (op_ret != OPRT_OK) {
+        TAL_PR_ERR("pixel effect task create failed :%d", op_ret);
+        ctx->is_running = FALSE;
+    }
+
+    return op_ret;
+}
+
+/**
+ * @brief        Stop the scheduler task, the last frame stays on the strip
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_stop(PIXEL_EFFECT_HANDLE_T handle)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+
+    if (NULL == ctx) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (NULL == ctx->task) {
+        return OPRT_OK;
+    }
+
+    ctx->is_running = FALSE;
+    tal_semaphore_post(ctx->wake_sem);
+    tal_semaphore_wait(ctx->exit_sem, SEM_WAIT_FOREVER);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Render and send the next frame of the current effect without the scheduler task
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_render_frame(PIXEL_EFFECT_HANDLE_T handle)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+
+    if (NULL == ctx) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __pixel_effect_send_frame(ctx);
+}
+
+/**
+ * @brief        Set the brightness, takes effect from the next frame
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[in]    brightness       0~255
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_set_brightness(PIXEL_EFFECT_HANDLE_T handle, uint8_t brightness)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+
+    if (NULL == ctx) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(ctx->mutex);
+    __pixel_effect_build_lut(ctx, brightness);
+    tal_mutex_unlock(ctx->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Get the frame statistics of the current effect
+ *
+ * @param[in]    handle           Effect engine handle
+ * @param[out]   stats            Statistics
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_get_stats(PIXEL_EFFECT_HANDLE_T handle, PIXEL_EFFECT_STATS_T *stats)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+
+    if (NULL == ctx || NULL == stats) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(ctx->mutex);
+    memcpy(stats, &ctx->stats, sizeof(PIXEL_EFFECT_STATS_T));
+    tal_mutex_unlock(ctx->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief        Stop and release an effect engine
+ *
+ * @param[in]    handle           Effect engine handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+int tdl_pixel_effect_destroy(PIXEL_EFFECT_HANDLE_T handle)
+{
+    PIXEL_EFFECT_CTX_T *ctx = (PIXEL_EFFECT_CTX_T *)handle;
+
+    if (NULL == ctx) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tdl_pixel_effect_stop(handle);
+
+    tal_semaphore_release(ctx->exit_sem);
+    tal_semaphore_release(ctx->wake_sem);
+    tal_mutex_release(ctx->mutex);
+    if (ctx->frame) {
+        tal_free(ctx->frame);
+    }
+    tal_free(ctx);
+
+    return OPRT_OK;
+}
@@ -46,8 +46,10 @@ typedef struct pixel_dev_list {
     USHORT_T pixel_resolution;
     USHORT_T *pixel_buffer;    // Pixel buffer
     uint32_t pixel_buffer_len; // Pixel buffer size
+    uint32_t buffer_gen;       // Bumped by every API that writes the pixel buffer
 
     SEM_HANDLE send_sem;
+    SYS_TIME_T last_refresh_ms; // Time the last frame was sent
 
     uint8_t color_num; // Three/Four/Five channels
     PIXEL_COLOR_TP_E pixel_color;
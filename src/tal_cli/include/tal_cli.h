@@ -31,6 +31,17 @@ extern "C" {
  */
 typedef void (*cli_cmd_func_cb_t)(int argc, char *argv[]);
 
+/**
+ * @brief callback to write the cli output
+ *
+ * @param[in] data The output data
+ * @param[in] len The length of data
+ * @param[in] arg The user data given to tal_cli_init_with_output
+ *
+ * @return the length written, <0 on error
+ */
+typedef int (*cli_output_cb_t)(const char *data, uint32_t len, void *arg);
+
 typedef struct {
     /** cli command name */
     char *name;
@@ -55,6 +66,9 @@ int tal_cli_init(void);
  * @param[in] cmd Info of one command
  * @param[in] num Number
  *
+ * @note Call it after tal_cli_init, tal_cli_init_with_uart or
+ * tal_cli_init_with_output.
+ *
  * @return OPRT_OK on success. Others on error, please refer to
  * tuya_error_code.h
  *
@@ -72,6 +86,36 @@ int tal_cli_cmd_register(const cli_cmd_t *cmd, uint8_t num);
  */
 int tal_cli_init_with_uart(uint8_t uart_num);
 
+/**
+ * @brief cli init without transport, data is fed by tal_cli_input
+ *
+ * @param[in] output The callback to write the cli output
+ * @param[in] arg The user data of output
+ *
+ * @note No thread is created. The cli can be driven by any transport, e.g. a
+ * socket, a pipe or scripted input.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ *
+ */
+int tal_cli_init_with_output(cli_output_cb_t output, void *arg);
+
+/**
+ * @brief feed received data into the cli
+ *
+ * @param[in] data The received data, may be split at any byte
+ * @param[in] len The length of data
+ *
+ * @note Complete lines are executed before returning. Call it from one thread
+ * at a time.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ *
+ */
+int tal_cli_input(const uint8_t *data, uint32_t len);
+
 /**
  * @brief cli echo string
  *
@@ -16,11 +16,11 @@
 
 /*============================ INCLUDES ======================================*/
 #include <string.h>
-#include "tuya_slist.h"
 #include "tal_uart.h"
 #include "tal_log.h"
 #include "tal_cli.h"
 #include "tal_thread.h"
+#include "tal_mutex.h"
 #include "tal_memory.h"
 
 /*============================ MACROS ========================================*/
@@ -36,8 +36,12 @@
 #define CLI_ARGV_NUM 8
 #endif
 
-#ifndef CLI_CMD_TABLE_NUM
-#define CLI_CMD_TABLE_NUM 10
+#ifndef CLI_CMD_INDEX_INIT_SIZE
+#define CLI_CMD_INDEX_INIT_SIZE 16
+#endif
+
+#ifndef CLI_RX_CHUNK_SIZE
+#define CLI_RX_CHUNK_SIZE 64
 #endif
 
 #ifndef CLI_CMD_NAME_MAX
@@ -45,15 +49,18 @@
 #endif
 /*============================ MACROFIED FUNCTIONS ===========================*/
 /*============================ TYPES =========================================*/
+/**
+ * @brief registered commands, sorted by name
+ *
+ * Commands sharing a prefix are adjacent, so lookup and tab completion are a
+ * binary search instead of a scan over every registered table.
+ */
 typedef struct {
-    uint8_t num;
-    cli_cmd_t *cmd;
-} cli_cmd_table_t;
-
-typedef struct {
-    SLIST_HEAD next;
-    cli_cmd_table_t table;
-} cli_cmd_node_t;
+    MUTEX_HANDLE mutex;
+    uint16_t num;
+    uint16_t size;
+    cli_cmd_t **cmd;
+} cli_cmd_index_t;
 
 typedef enum {
     CLI_NULL_KEY = '\0',
@@ -80,11 +87,20 @@ typedef struct {
     history_data_t data[CLI_HISTORY_NUM];
 } cli_history_t;
 
+typedef enum {
+    CLI_KEY_STATE_KEY,
+    CLI_KEY_STATE_FUNC_TAG,
+    CLI_KEY_STATE_FUNC_KEY,
+} cli_key_state_t;
+
 typedef struct {
     TUYA_UART_NUM_E port_id;
     THREAD_HANDLE thread;
+    cli_output_cb_t output;
+    void *output_arg;
     char *prompt;
     uint8_t echo;
+    cli_key_state_t key_state;
     uint16_t index;
     uint16_t insert;
     cli_history_t history;
@@ -99,8 +115,7 @@ static void cli_print_prompt(cli_t *cli);
 
 /*============================ LOCAL VARIABLES ===============================*/
 static cli_t *s_cli_handle = NULL;
-static SLIST_HEAD s_cli_dynamic_table;
-static cli_cmd_table_t s_cli_static_table[CLI_CMD_TABLE_NUM];
+static cli_cmd_index_t s_cli_index;
 
 static const cli_cmd_t s_cli_cmd[] = {{
     .name = "hello",
@@ -109,17 +124,20 @@ static const cli_cmd_t s_cli_cmd[] = {{
 }};
 
 /*============================ IMPLEMENTATION ================================*/
-static int32_t cli_out_put(TUYA_UART_NUM_E port_id, char *out_str, uint32_t len)
+static int32_t cli_out_put(cli_t *cli, char *out_str, uint32_t len)
 {
-    return tal_uart_write(port_id, (const uint8_t *)out_str, len);
+    return cli->output(out_str, len, cli->output_arg);
+}
+
+static int cli_uart_output(const char *data, uint32_t len, void *arg)
+{
+    return tal_uart_write(((cli_t *)arg)->port_id, (const uint8_t *)data, len);
 }
 
 static void cli_print_string(cli_t *cli, char *string)
 {
-    cli_out_put(cli->port_id, "\r\n", 2);
-    while ('\0' != *string) {
-        cli_out_put(cli->port_id, string++, 1);
-    }
+    cli_out_put(cli, "\r\n", 2);
+    cli_out_put(cli, string, strlen(string));
 }
 
 static void cli_hello(int argc, char *argv[])
@@ -127,37 +145,40 @@ static void cli_hello(int argc, char *argv[])
     cli_print_string(s_cli_handle, "helo world");
 }
 
+/**
+ * @brief first (or past the last) index entry whose name starts with name[0..len)
+ *
+ * Pass len = strlen(name) + 1 to compare the whole name including the '\0'.
+ */
+static uint16_t cli_cmd_bound(const char *name, size_t len, int upper)
+{
+    uint16_t low = 0, high = s_cli_index.num, mid;
+    int cmp;
+
+    while (low < high) {
+        mid = (low + high) / 2;
+        cmp = strncmp(s_cli_index.cmd[mid]->name, name, len);
+        if (cmp < 0 || (upper && 0 == cmp)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
 static cli_cmd_t *cli_cmd_find_with_name(char *name)
 {
-    int i, j;
-    cli_cmd_t *cmd;
+    uint16_t i;
 
     if (NULL == name) {
         return NULL;
     }
 
-    for (i = 0; i < CLI_CMD_TABLE_NUM; i++) {
-        for (j = 0; j < s_cli_static_table[i].num; j++) {
-            cmd = s_cli_static_table[i].cmd + j;
-            if (0 != strcmp(cmd->name, name)) {
-                continue;
-            }
-            return cmd;
-        }
-    }
-
-    cli_cmd_node_t *node = NULL;
-    SLIST_HEAD *pos = NULL;
-
-    SLIST_FOR_EACH_ENTRY(node, cli_cmd_node_t, pos, &s_cli_dynamic_table, next)
-    {
-        for (i = 0; i < node->table.num; i++) {
-            cmd = node->table.cmd + i;
-            if (0 != strcmp(cmd->name, name)) {
-                continue;
-            }
-            return cmd;
-        }
+    i = cli_cmd_bound(name, strlen(name) + 1, 0);
+    if (i < s_cli_index.num && 0 == strcmp(s_cli_index.cmd[i]->name, name)) {
+        return s_cli_index.cmd[i];
     }
 
     return NULL;
@@ -174,34 +195,21 @@ static void cli_print_cmd(cli_t *cli, cli_cmd_t *cmd)
     len = strlen(cmd->name);
     len = len > CLI_CMD_NAME_MAX ? CLI_CMD_NAME_MAX : len;
     strncpy(name, cmd->name, len);
-    cli_out_put(cli->port_id, "\r\n", 2);
-    cli_out_put(cli->port_id, name, strlen(name));
-    cli_out_put(cli->port_id, "\t", 1);
-    cli_out_put(cli->port_id, cmd->help, strlen(cmd->help));
+    cli_out_put(cli, "\r\n", 2);
+    cli_out_put(cli, name, strlen(name));
+    cli_out_put(cli, "\t", 1);
+    cli_out_put(cli, cmd->help, strlen(cmd->help));
 }
 
 static void cli_print_all_cmd(cli_t *cli)
 {
-    int i, j;
-    cli_cmd_t *cmd;
-
-    for (i = 0; i < CLI_CMD_TABLE_NUM; i++) {
-        for (j = 0; j < s_cli_static_table[i].num; j++) {
-            cmd = s_cli_static_table[i].cmd + j;
-            cli_print_cmd(cli, cmd);
-        }
-    }
+    uint16_t i;
 
-    cli_cmd_node_t *node = NULL;
-    SLIST_HEAD *pos = NULL;
-
-    SLIST_FOR_EACH_ENTRY(node, cli_cmd_node_t, pos, &s_cli_dynamic_table, next)
-    {
-        for (i = 0; i < node->table.num; i++) {
-            cmd = node->table.cmd + i;
-            cli_print_cmd(cli, cmd);
-        }
+    tal_mutex_lock(s_cli_index.mutex);
+    for (i = 0; i < s_cli_index.num; i++) {
+        cli_print_cmd(cli, s_cli_index.cmd[i]);
     }
+    tal_mutex_unlock(s_cli_index.mutex);
 
     cli_print_prompt(cli);
 }
@@ -209,24 +217,21 @@ static void cli_print_all_cmd(cli_t *cli)
 static void cli_print_cmd_title(cli_t *cli)
 {
     int i;
+    char line[2 * CLI_CMD_NAME_MAX];
 
-    cli_out_put(cli->port_id, "\r\ncmd", 5);
-    for (i = 3; i < CLI_CMD_NAME_MAX; i++) {
-        cli_out_put(cli->port_id, " ", 1);
-    }
-    cli_out_put(cli->port_id, "\thelp\r\n", 7);
+    cli_out_put(cli, "\r\ncmd", 5);
+    memset(line, ' ', CLI_CMD_NAME_MAX - 3);
+    cli_out_put(cli, line, CLI_CMD_NAME_MAX - 3);
+    cli_out_put(cli, "\thelp\r\n", 7);
     for (i = 0; i < 2 * CLI_CMD_NAME_MAX; i++) {
-        cli_out_put(cli->port_id, "-", 1);
+        line[i] = '-';
     }
+    cli_out_put(cli, line, 2 * CLI_CMD_NAME_MAX);
 }
 
 static int cli_table_key(cli_t *cli)
 {
-    cli_cmd_t *cmd;
-    cli_cmd_t *match_cmd = NULL;
-
-    int i, j;
-    int count = 0;
+    uint16_t i, first, last;
 
     //! print all cmd
     if (0 == cli->index) {
@@ -235,62 +240,27 @@ static int cli_table_key(cli_t *cli)
         return OPRT_OK;
     }
 
-    //! match one or more
-    for (i = 0; i < CLI_CMD_TABLE_NUM; i++) {
-        for (j = 0; j < s_cli_static_table[i].num; j++) {
-            cmd = s_cli_static_table[i].cmd + j;
-            if (0 != strncmp(cmd->name, cli->buffer, cli->index)) {
-                continue;
-            }
-            match_cmd = cmd;
-            count++;
-        }
-    }
+    //! commands with the typed prefix are adjacent in the index
+    tal_mutex_lock(s_cli_index.mutex);
+    first = cli_cmd_bound(cli->buffer, cli->index, 0);
+    last = cli_cmd_bound(cli->buffer, cli->index, 1);
 
-    cli_cmd_node_t *node = NULL;
-    SLIST_HEAD *pos = NULL;
-
-    SLIST_FOR_EACH_ENTRY(node, cli_cmd_node_t, pos, &s_cli_dynamic_table, next)
-    {
-        for (i = 0; i < node->table.num; i++) {
-            cmd = node->table.cmd + i;
-            if (0 != strncmp(cmd->name, cli->buffer, cli->index)) {
-                continue;
-            }
-            match_cmd = cmd;
-            count++;
-        }
-    }
-
-    if (count > 1) { //! print more
+    if (last - first > 1) { //! print more
         cli_print_cmd_title(cli);
-        for (i = 0; i < CLI_CMD_TABLE_NUM; i++) {
-            for (j = 0; j < s_cli_static_table[i].num; j++) {
-                cmd = s_cli_static_table[i].cmd + j;
-                if (0 == strncmp(cmd->name, cli->buffer, cli->index)) {
-                    cli_print_cmd(cli, cmd);
-                }
-            }
-        }
-        SLIST_FOR_EACH_ENTRY(node, cli_cmd_node_t, pos, &s_cli_dynamic_table, next)
-        {
-            for (i = 0; i < node->table.num; i++) {
-                cmd = node->table.cmd + i;
-                if (0 == strncmp(cmd->name, cli->buffer, cli->index)) {
-                    cli_print_cmd(cli, cmd);
-                }
-            }
+        for (i = first; i < last; i++) {
+            cli_print_cmd(cli, s_cli_index.cmd[i]);
         }
-    } else if (count) { //! print one
-        strcpy(cli->buffer, match_cmd->name);
+    } else if (last > first) { //! print one
+        strcpy(cli->buffer, s_cli_index.cmd[first]->name);
         cli->index = strlen(cli->buffer);
         cli->insert = cli->index;
     } else {
         cli->insert = cli->index;
     }
+    tal_mutex_unlock(s_cli_index.mutex);
 
     cli_print_prompt(cli);
-    cli_out_put(cli->port_id, cli->buffer, cli->index);
+    cli_out_put(cli, cli->buffer, cli->index);
 
     return OPRT_OK;
 }
@@ -361,59 +331,47 @@ static int cli_histroy_data_save(cli_t *cli)
     return true;
 }
 
-static int cli_key_detect(TUYA_UART_NUM_E port_id, char *data, cli_key_t *key)
+static int cli_key_detect(cli_t *cli, char ch, cli_key_t *key)
 {
-    char ch;
-    enum {
-        CHECK_KEY,
-        CHECK_FUNC_TAG,
-        CHECK_FUNC_KEY,
-    } state = CHECK_KEY;
-
-    for (;;) {
-        tal_uart_read(port_id, (uint8_t *)&ch, 1);
-
-        switch (state) {
-
-        case CHECK_KEY:
-            if (CLI_ENTER_KEY == ch || CLI_ENTER2_KEY == ch || CLI_BACKSPACE_KEY == ch || CLI_BACKSPACE2_KEY == ch || CLI_TABLE_KEY == ch) {
-                *key = ch;
-                return OPRT_OK;
-            } else if (CLI_ESC_KEY == ch) {
-                state = CHECK_FUNC_TAG;
-            } else {
-                *data = ch;
-                *key = CLI_NULL_KEY;
-                return OPRT_OK;
-            }
-            break;
+    switch (cli->key_state) {
+
+    case CLI_KEY_STATE_KEY:
+        if (CLI_ENTER_KEY == ch || CLI_ENTER2_KEY == ch || CLI_BACKSPACE_KEY == ch || CLI_BACKSPACE2_KEY == ch || CLI_TABLE_KEY == ch) {
+            *key = ch;
+            return OPRT_OK;
+        } else if (CLI_ESC_KEY == ch) {
+            cli->key_state = CLI_KEY_STATE_FUNC_TAG;
+        } else {
+            *key = CLI_NULL_KEY;
+            return OPRT_OK;
+        }
+        break;
 
-        case CHECK_FUNC_TAG:
-            if (CLI_FUNC_TAG_KEY == ch) {
-                state = CHECK_FUNC_KEY;
-            } else {
-                state = CHECK_KEY;
-            }
-            break;
+    case CLI_KEY_STATE_FUNC_TAG:
+        if (CLI_FUNC_TAG_KEY == ch) {
+            cli->key_state = CLI_KEY_STATE_FUNC_KEY;
+        } else {
+            cli->key_state = CLI_KEY_STATE_KEY;
+        }
+        break;
 
-        case CHECK_FUNC_KEY:
-            if (CLI_UP_KEY == ch || CLI_DOWN_KEY == ch || CLI_LETF_KEY == ch || CLI_RIGHT_KEY == ch) {
-                *key = ch;
-                return OPRT_OK;
-            } else {
-                state = CHECK_KEY;
-            }
-            break;
+    case CLI_KEY_STATE_FUNC_KEY:
+        cli->key_state = CLI_KEY_STATE_KEY;
+        if (CLI_UP_KEY == ch || CLI_DOWN_KEY == ch || CLI_LETF_KEY == ch || CLI_RIGHT_KEY == ch) {
+            *key = ch;
+            return OPRT_OK;
         }
+        break;
     }
 
-    return OPRT_OK;
+    //! escape sequence not complete yet
+    return OPRT_RESOURCE_NOT_READY;
 }
 
 static void cli_print_prompt(cli_t *cli)
 {
-    cli_out_put(cli->port_id, "\r\n", 2);
-    cli_out_put(cli->port_id, cli->prompt, strlen(cli->prompt));
+    cli_out_put(cli, "\r\n", 2);
+    cli_out_put(cli, cli->prompt, strlen(cli->prompt));
 }
 
 static int cli_parse_buffer(char *buffer, int *argc, char **argv)
@@ -478,7 +436,9 @@ static int cli_cmd_exec(int argc, char **argv)
 {
     cli_cmd_t *cmd;
 
+    tal_mutex_lock(s_cli_index.mutex);
     cmd = cli_cmd_find_with_name(argv[0]);
+    tal_mutex_unlock(s_cli_index.mutex);
     if (cmd) {
         cmd->func(argc, argv);
         return OPRT_OK;
@@ -498,7 +458,7 @@ static void cli_enter_key(cli_t *cli)
     cli->buffer[cli->index] = 0;
     cli_histroy_data_save(cli);
     cli_parse_buffer(cli->buffer, &cli->argc, cli->argv);
-    cli_out_put(cli->port_id, "\r\n", 2);
+    cli_out_put(cli, "\r\n", 2);
     result = cli_cmd_exec(cli->argc, cli->argv);
     if (OPRT_OK != result) {
         cli_print_string(cli, "No command or file name");
@@ -520,18 +480,18 @@ static void cli_backspace_key(cli_t *cli)
         cli->insert--;
         memmove(&cli->buffer[cli->insert], &cli->buffer[cli->insert + 1], cli->index - cli->insert);
         cli->buffer[cli->index] = '\0';
-        cli_out_put(cli->port_id, &ch, 1);
-        cli_out_put(cli->port_id, &cli->buffer[cli->insert], cli->index - cli->insert);
-        cli_out_put(cli->port_id, " \b", 2);
+        cli_out_put(cli, &ch, 1);
+        cli_out_put(cli, &cli->buffer[cli->insert], cli->index - cli->insert);
+        cli_out_put(cli, " \b", 2);
         int i;
         for (i = 0; i < (cli->index - cli->insert); i++) {
-            cli_out_put(cli->port_id, &ch, 1);
+            cli_out_put(cli, &ch, 1);
         }
     } else {
         cli->index--;
         cli->insert--;
         cli->buffer[cli->insert] = '\0';
-        cli_out_put(cli->port_id, "\b \b", 3);
+        cli_out_put(cli, "\b \b", 3);
     }
 }
 
@@ -543,15 +503,15 @@ static void cli_up_key(cli_t *cli)
 
     if (cli_histroy_data_perv(cli, &history_data)) {
         ch = '\r';
-        cli_out_put(cli->port_id, &ch, 1);
+        cli_out_put(cli, &ch, 1);
         ch = ' ';
         for (i = 0; i < cli->index + strlen(cli->prompt); i++) {
-            cli_out_put(cli->port_id, &ch, 1);
+            cli_out_put(cli, &ch, 1);
         }
         ch = '\r';
-        cli_out_put(cli->port_id, &ch, 1);
-        cli_out_put(cli->port_id, cli->prompt, strlen(cli->prompt));
-        cli_out_put(cli->port_id, (char *)history_data, strlen((char *)history_data));
+        cli_out_put(cli, &ch, 1);
+        cli_out_put(cli, cli->prompt, strlen(cli->prompt));
+        cli_out_put(cli, (char *)history_data, strlen((char *)history_data));
         strcpy(cli->buffer, (char *)history_data);
         cli->index = strlen(cli->buffer);
         cli->buffer[cli->index] = '\0';
@@ -567,15 +527,15 @@ static void cli_down_key(cli_t *cli)
 
     if (cli_histroy_data_next(cli, &history_data)) {
         ch = '\r';
-        cli_out_put(cli->port_id, &ch, 1);
+        cli_out_put(cli, &ch, 1);
         ch = ' ';
         for (i = 0; i < cli->index + strlen(cli->prompt); i++) {
-            cli_out_put(cli->port_id, &ch, 1);
+            cli_out_put(cli, &ch, 1);
         }
         ch = '\r';
-        cli_out_put(cli->port_id, &ch, 1);
-        cli_out_put(cli->port_id, cli->prompt, strlen(cli->prompt));
-        cli_out_put(cli->port_id, (char *)history_data, strlen((char *)history_data));
+        cli_out_put(cli, &ch, 1);
+        cli_out_put(cli, cli->prompt, strlen(cli->prompt));
+        cli_out_put(cli, (char *)history_data, strlen((char *)history_data));
         strcpy(cli->buffer, (char *)history_data);
         cli->index = strlen(cli->buffer);
         cli->buffer[cli->index] = '\0';
@@ -588,7 +548,7 @@ static void cli_letf_key(cli_t *cli)
     char ch = '\b';
 
     if (cli->insert) {
-        cli_out_put(cli->port_id, &ch, 1);
+        cli_out_put(cli, &ch, 1);
         cli->insert--;
     }
 }
@@ -599,7 +559,7 @@ static void cli_right_key(cli_t *cli)
 
     if (cli->insert < cli->index) {
         ch = cli->buffer[cli->insert];
-        cli_out_put(cli->port_id, &ch, 1);
+        cli_out_put(cli, &ch, 1);
         cli->insert++;
     }
 }
@@ -643,72 +603,131 @@ static void cli_key_app(cli_t *cli, cli_key_t key)
     }
 }
 
+static void cli_input_char(cli_t *cli, char data)
+{
+    cli_key_t key;
+
+    if (OPRT_OK != cli_key_detect(cli, data, &key)) {
+        return;
+    }
+    if (CLI_NULL_KEY != key) {
+        cli_key_app(cli, key);
+        return;
+    }
+    if (!((32 <= data) && (127 >= data))) {
+        return;
+    }
+    if (CLI_BUFFER_SIZE - 1 < cli->index) {
+        return;
+    }
+    if (cli->insert != cli->index) {
+        memmove(&cli->buffer[cli->insert + 1], &cli->buffer[cli->insert], cli->index - cli->insert);
+        cli->buffer[cli->insert] = data;
+        cli->index++;
+        cli_out_put(cli, &cli->buffer[cli->insert], cli->index - cli->insert);
+        int i;
+        char ch = '\b';
+        cli->insert++;
+        for (i = 0; i < (cli->index - cli->insert); i++) {
+            cli_out_put(cli, &ch, 1);
+        }
+        return;
+    } else {
+        cli->buffer[cli->index++] = data;
+        cli->insert = cli->index;
+    }
+    if (cli->echo) {
+        cli_out_put(cli, &data, 1);
+    }
+}
+
 static void cli_task(void *parameter)
 {
     cli_t *cli;
-    char data;
-    cli_key_t key;
+    int i, len;
+    char data[CLI_RX_CHUNK_SIZE];
 
     cli = (cli_t *)parameter;
-    cli->prompt = "tuya>";
     cli_print_prompt(cli);
-    cli->echo = 1;
 
     for (;;) {
-        cli_key_detect(cli->port_id, &data, &key);
-        if (CLI_NULL_KEY != key) {
-            cli_key_app(cli, key);
-            continue;
+        //! returns as soon as any data is buffered
+        len = tal_uart_read(cli->port_id, (uint8_t *)data, sizeof(data));
+        for (i = 0; i < len; i++) {
+            cli_input_char(cli, data[i]);
         }
-        if (!((32 <= data) && (127 >= data))) {
-            continue;
+    }
+}
+
+static int cli_cmd_register(cli_cmd_t *cmd, uint8_t num)
+{
+    int result = OPRT_OK;
+    uint8_t i;
+    uint16_t pos;
+    uint32_t size;
+    cli_cmd_t **index;
+
+    //! the index mutex is created by tal_cli_init*
+    if (NULL == s_cli_index.mutex) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    tal_mutex_lock(s_cli_index.mutex);
+    if (s_cli_index.num + num > s_cli_index.size) {
+        size = s_cli_index.size ? s_cli_index.size : CLI_CMD_INDEX_INIT_SIZE;
+        while (size < (uint32_t)s_cli_index.num + num) {
+            size *= 2;
         }
-        if (CLI_BUFFER_SIZE - 1 < cli->index) {
-            continue;
+        if (size > UINT16_MAX) {
+            result = OPRT_EXCEED_UPPER_LIMIT;
+            goto __exit;
         }
-        if (cli->insert != cli->index) {
-            memmove(&cli->buffer[cli->insert + 1], &cli->buffer[cli->insert], cli->index - cli->insert);
-            cli->buffer[cli->insert] = data;
-            cli->index++;
-            cli_out_put(cli->port_id, &cli->buffer[cli->insert], cli->index - cli->insert);
-            int i;
-            char ch = '\b';
-            cli->insert++;
-            for (i = 0; i < (cli->index - cli->insert); i++) {
-                cli_out_put(cli->port_id, &ch, 1);
-            }
-            continue;
+        if (s_cli_index.cmd) {
+            index = tal_realloc(s_cli_index.cmd, size * sizeof(cli_cmd_t *));
         } else {
-            cli->buffer[cli->index++] = data;
-            cli->insert = cli->index;
+            index = tal_malloc(size * sizeof(cli_cmd_t *));
         }
-        if (cli->echo) {
-            cli_out_put(cli->port_id, &data, 1);
+        if (NULL == index) {
+            result = OPRT_MALLOC_FAILED;
+            goto __exit;
         }
+        s_cli_index.cmd = index;
+        s_cli_index.size = size;
+    }
+
+    //! insert after commands of the same name, lookup keeps finding the first one
+    for (i = 0; i < num; i++) {
+        pos = cli_cmd_bound(cmd[i].name, strlen(cmd[i].name) + 1, 1);
+        memmove(&s_cli_index.cmd[pos + 1], &s_cli_index.cmd[pos], (s_cli_index.num - pos) * sizeof(cli_cmd_t *));
+        s_cli_index.cmd[pos] = &cmd[i];
+        s_cli_index.num++;
     }
+
+__exit:
+    tal_mutex_unlock(s_cli_index.mutex);
+
+    return result;
 }
 
-static int cli_cmd_register(cli_cmd_t *cmd, uint8_t num)
+static cli_t *cli_create(void)
 {
-    int i = 0;
+    cli_t *cli;
 
-    for (i = 0; i < CLI_CMD_TABLE_NUM; i++) {
-        if (s_cli_static_table[i].cmd) {
-            continue;
-        }
-        s_cli_static_table[i].cmd = cmd;
-        s_cli_static_table[i].num = num;
-        return OPRT_OK;
+    //! created once here, before any command can be registered
+    if (NULL == s_cli_index.mutex && OPRT_OK != tal_mutex_create_init(&s_cli_index.mutex)) {
+        return NULL;
     }
-    cli_cmd_node_t *node = tal_malloc(sizeof(cli_cmd_node_t));
-    if (NULL == node) {
-        return OPRT_MALLOC_FAILED;
+
+    cli = tal_malloc(sizeof(cli_t));
+    if (NULL == cli) {
+        return NULL;
     }
-    node->table.cmd = cmd;
-    node->table.num = num;
-    tuya_slist_add_head(&s_cli_dynamic_table, &node->next);
+    memset(cli, 0, sizeof(cli_t));
+    cli->prompt = "tuya>";
+    cli->echo = 1;
+    cli->key_state = CLI_KEY_STATE_KEY;
 
-    return OPRT_OK;
+    return cli;
 }
 
 /**
@@ -732,6 +751,7 @@ void tal_cli_echo(char *string)
  * @param cmd Pointer to the command structure to be registered.
  * @param num Number of commands to be registered.
  * @return Returns OPRT_INVALID_PARM if the cmd pointer is NULL or num is 0.
+ *         Returns OPRT_RESOURCE_NOT_READY if the CLI is not initialized.
  *         Returns the result of the cli_cmd_register function otherwise.
  */
 int tal_cli_cmd_register(const cli_cmd_t *cmd, uint8_t num)
@@ -758,12 +778,13 @@ int tal_cli_init_with_uart(uint8_t uart_num)
     if (s_cli_handle) {
         return OPRT_OK;
     }
-    s_cli_handle = tal_malloc(sizeof(cli_t));
+    s_cli_handle = cli_create();
     if (NULL == s_cli_handle) {
         return OPRT_MALLOC_FAILED;
     }
-    memset(s_cli_handle, 0, sizeof(cli_t));
     s_cli_handle->port_id = uart_num;
+    s_cli_handle->output = cli_uart_output;
+    s_cli_handle->output_arg = s_cli_handle;
     TAL_UART_CFG_T cfg = {0};
     cfg.base_cfg.baudrate = 115200;
     cfg.base_cfg.databits = TUYA_UART_DATA_LEN_8BIT;
@@ -812,3 +833,65 @@ int tal_cli_init(void)
 {
     return tal_cli_init_with_uart(TUYA_UART_NUM_0);
 }
+
+/**
+ * @brief Initializes the CLI engine without a transport.
+ *
+ * The caller feeds the received data with tal_cli_input() and the CLI writes
+ * its echo and command output through the output callback. No thread is
+ * created, so any transport (a UART, a socket, a pipe or a script) can drive
+ * the CLI.
+ *
+ * @param output The callback used to write the CLI output.
+ * @param arg The user data passed to the output callback.
+ * @return Returns OPRT_OK if the CLI is successfully initialized, otherwise
+ * returns an error code.
+ */
+int tal_cli_init_with_output(cli_output_cb_t output, void *arg)
+{
+    if (NULL == output) {
+        return OPRT_INVALID_PARM;
+    }
+    if (s_cli_handle) {
+        return OPRT_OK;
+    }
+
+    s_cli_handle = cli_create();
+    if (NULL == s_cli_handle) {
+        return OPRT_MALLOC_FAILED;
+    }
+    s_cli_handle->output = output;
+    s_cli_handle->output_arg = arg;
+    tal_cli_cmd_register((cli_cmd_t *)&s_cli_cmd, 1);
+    cli_print_prompt(s_cli_handle);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Feeds received data into the CLI engine.
+ *
+ * The data may be split at any byte, partial lines and escape sequences are
+ * kept until the next call. Complete lines are executed before returning.
+ *
+ * @param data The received data.
+ * @param len The length of the data.
+ * @return Returns OPRT_OK on success, otherwise returns an error code.
+ */
+int tal_cli_input(const uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+
+    if (NULL == s_cli_handle) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+    if (NULL == data && len) {
+        return OPRT_INVALID_PARM;
+    }
+
+    for (i = 0; i < len; i++) {
+        cli_input_char(s_cli_handle, (char)data[i]);
+    }
+
+    return OPRT_OK;
+}
@@ -17,15 +17,34 @@
 #include "tuya_ringbuf.h"
 #include "tal_api.h"
 
+/* bytes moved per tkl_uart_read/tkl_uart_write call */
+#define UART_BULK_SIZE 128
+
+/* a sync dma write waits for the transfer time of the chunk plus this margin */
+#define UART_TX_DMA_MARGIN_MS 100
+
+#ifdef CONFIG_UART_ASYNC_WRITE
+#define UART_IS_ASYNC_WRITE(dev) ((dev)->open_mode & O_ASYNC_WRITE)
+#else
+#define UART_IS_ASYNC_WRITE(dev) 0
+#endif
+
 typedef struct uart_dev_node {
     SLIST_HEAD node;
     uint32_t port_num;
     uint32_t open_mode;
     SEM_HANDLE rx_ring_sem;
     TUYA_RINGBUFF_T rx_ring;
+    uint8_t rx_bulk[UART_BULK_SIZE];
+    uint32_t rx_overflow;
+    uint32_t baudrate;
+    SEM_HANDLE tx_done_sem;
 #ifdef CONFIG_UART_ASYNC_WRITE
-    TKL_SEM_HANDLE tx_ring_sem;
+    SEM_HANDLE tx_ring_sem;
     TUYA_RINGBUFF_T tx_ring;
+    uint8_t tx_bulk[UART_BULK_SIZE];
+    uint16_t tx_bulk_pos;
+    uint16_t tx_bulk_len;
 #endif
     uint16_t wait_rx_flag;
     uint16_t wait_tx_flag;
@@ -84,40 +103,66 @@ OPERATE_RET uart_list_delete_one_node(TAL_UART_DEV *uart_info)
 }
 
 #ifdef CONFIG_UART_ASYNC_WRITE
-void uart_tx_chars_in_isr(uint32_t port_num)
+void uart_tx_chars_in_isr(TUYA_UART_NUM_E port_num)
 {
     TAL_UART_DEV *uart_info = uart_list_get_one_node(port_num);
     if (uart_info == NULL) {
         return;
     }
 
-    ring_buffer_s *tx_ring = uart_info->tx_ring;
-    uint8_t tx_byte;
-    uint8_t tx_count = 0;
+    int ret = 0;
+    uint32_t tx_count = 0;
 
+    /*
+     * The tx ring is drained in bursts of UART_BULK_SIZE. A burst the hardware
+     * does not take at once stays in tx_bulk and is continued on the next tx
+     * interrupt. With tx dma the buffer is in flight until the next interrupt,
+     * so only one burst is started per interrupt.
+     */
     while (1) {
-        ret = tuya_ring_buff_read(tx_ring, &tx_byte, 1);
-        if (ret != 1) {
-            break;
+        if (uart_info->tx_bulk_pos == uart_info->tx_bulk_len) {
+            uart_info->tx_bulk_pos = 0;
+            uart_info->tx_bulk_len = tuya_ring_buff_read(uart_info->tx_ring, uart_info->tx_bulk, UART_BULK_SIZE);
+            if (uart_info->tx_bulk_len == 0) {
+                tkl_uart_set_tx_int(port_num, FALSE);
+                break;
+            }
         }
 
-        ret = tkl_uart_write(port_num, &tx_byte, 1);
-        if (ret != 1) {
+        ret = tkl_uart_write(port_num, &uart_info->tx_bulk[uart_info->tx_bulk_pos],
+                             uart_info->tx_bulk_len - uart_info->tx_bulk_pos);
+        if (ret <= 0) {
             break;
         }
 
-        tx_count++;
+        uart_info->tx_bulk_pos += ret;
+        tx_count += ret;
+
+        if ((uart_info->open_mode & O_TX_DMA) || (uart_info->tx_bulk_pos != uart_info->tx_bulk_len)) {
+            break;
+        }
     }
 
     if ((uart_info->open_mode & O_BLOCK) && (tx_count > 0)) {
-        if (uart_info->wait_rx_flag == TRUE) {
-            uart_info->wait_rx_flag = FALSE;
+        if (uart_info->wait_tx_flag == TRUE) {
+            uart_info->wait_tx_flag = FALSE;
             tal_semaphore_post(uart_info->tx_block_sem);
         }
     }
 }
 #endif
 
+/* tx dma of a sync write is done, the caller buffer can be returned */
+void uart_tx_done_in_isr(TUYA_UART_NUM_E port_num)
+{
+    TAL_UART_DEV *uart_info = uart_list_get_one_node(port_num);
+    if (uart_info == NULL || uart_info->tx_done_sem == NULL) {
+        return;
+    }
+
+    tal_semaphore_post(uart_info->tx_done_sem);
+}
+
 void uart_rx_chars_in_isr(TUYA_UART_NUM_E port_num)
 {
     TAL_UART_DEV *uart_info = uart_list_get_one_node(port_num);
@@ -125,31 +170,43 @@ void uart_rx_chars_in_isr(TUYA_UART_NUM_E port_num)
         return;
     }
 
-    uint8_t rx_char;
     int ret = 0;
     uint32_t rx_bytes = 0;
+    uint32_t rx_len = 0;
 
     /*
-     * When the software buffer is full, the data read will not be written into
-     * the software buffer. However, it will continue to read the content of the
-     * hardware buffer until it is empty.
+     * The hardware fifo (or the dma buffer on an idle line event) is moved into
+     * the software buffer in whole chunks, a short read means the hardware
+     * buffer is empty. No more than the free space of the software buffer is
+     * read. Once it is full the hardware buffer is still drained and the data
+     * dropped, a pending rx source would raise the interrupt again at once.
      */
     while (1) {
-        ret = tkl_uart_read(port_num, &rx_char, 1);
-        if (ret != 1) {
-            break;
+        rx_len = tuya_ring_buff_free_size_get(uart_info->rx_ring);
+        if (rx_len > UART_BULK_SIZE) {
+            rx_len = UART_BULK_SIZE;
+        }
+        if (rx_len == 0) {
+            ret = tkl_uart_read(port_num, uart_info->rx_bulk, UART_BULK_SIZE);
+            if (ret <= 0) {
+                break;
+            }
+            uart_info->rx_overflow += ret;
+            if (ret < UART_BULK_SIZE) {
+                break;
+            }
+            continue;
         }
 
-        ret = tuya_ring_buff_write(uart_info->rx_ring, &rx_char, 1);
-        if (ret != 1) {
+        ret = tkl_uart_read(port_num, uart_info->rx_bulk, rx_len);
+        if (ret <= 0) {
             break;
         }
 
-        rx_bytes++;
-
-#if OPERATING_SYSTEM == SYSTEM_LINUX
-        break;
-#endif
+        rx_bytes += tuya_ring_buff_write(uart_info->rx_ring, uart_info->rx_bulk, ret);
+        if (ret < rx_len) {
+            break;
+        }
     }
 
 #ifdef CONFIG_UART_FLOW_CONTRAL
@@ -192,6 +249,10 @@ void uart_free_source(TAL_UART_DEV *uart_info)
         tal_semaphore_release(uart_info->rx_ring_sem);
     }
 
+    if (uart_info->tx_done_sem != NULL) {
+        tal_semaphore_release(uart_info->tx_done_sem);
+    }
+
     tal_free(uart_info);
 }
 
@@ -232,6 +293,7 @@ OPERATE_RET tal_uart_init(TUYA_UART_NUM_E port_num, TAL_UART_CFG_T *cfg)
 
     uart_info->port_num = port_num;
     uart_info->open_mode = cfg->open_mode;
+    uart_info->baudrate = cfg->base_cfg.baudrate;
 
     if (uart_info->open_mode & O_BLOCK) {
         ret = tal_semaphore_create_init(&uart_info->rx_block_sem, 0, 1);
@@ -250,6 +312,30 @@ OPERATE_RET tal_uart_init(TUYA_UART_NUM_E port_num, TAL_UART_CFG_T *cfg)
         goto ERR_EXIT;
     }
 
+    /* dma and idle line rx need the platform, otherwise the fifo interrupts are used */
+    if (uart_info->open_mode & (O_RX_DMA | O_TX_DMA)) {
+#if defined(ENABLE_UART_BULK_TRANSFER) && (ENABLE_UART_BULK_TRANSFER == 1)
+        TUYA_UART_BULK_CFG_T bulk_cfg = {
+            .rx_threshold = UART_BULK_SIZE / 2,
+            .rx_idle_bits = 10,
+            .rx_dma = (uart_info->open_mode & O_RX_DMA) ? TRUE : FALSE,
+            .tx_dma = (uart_info->open_mode & O_TX_DMA) ? TRUE : FALSE,
+        };
+        if (tkl_uart_set_bulk_mode(port_num, &bulk_cfg) != OPRT_OK)
+#endif
+        {
+            uart_info->open_mode &= ~(O_RX_DMA | O_TX_DMA);
+        }
+    }
+
+    /* the dma reads the caller buffer of a sync write until the tx callback */
+    if ((uart_info->open_mode & O_TX_DMA) && !UART_IS_ASYNC_WRITE(uart_info)) {
+        ret = tal_semaphore_create_init(&uart_info->tx_done_sem, 0, 1);
+        if (ret != OPRT_OK) {
+            goto ERR_EXIT;
+        }
+    }
+
     ret = tuya_ring_buff_create(cfg->rx_buffer_size, OVERFLOW_STOP_TYPE, &uart_info->rx_ring);
     if (ret != OPRT_OK) {
         goto ERR_EXIT;
@@ -261,8 +347,6 @@ OPERATE_RET tal_uart_init(TUYA_UART_NUM_E port_num, TAL_UART_CFG_T *cfg)
     }
 
 #ifdef CONFIG_UART_ASYNC_WRITE
-    tkl_uart_tx_irq_cb_reg(port_num, uart_tx_chars_in_isr);
-
     ret = tuya_ring_buff_create(cfg->tx_buffer_size, OVERFLOW_STOP_TYPE, &uart_info->tx_ring);
     if (ret != OPRT_OK) {
         goto ERR_EXIT;
@@ -272,6 +356,16 @@ OPERATE_RET tal_uart_init(TUYA_UART_NUM_E port_num, TAL_UART_CFG_T *cfg)
     if (ret != OPRT_OK) {
         goto ERR_EXIT;
     }
+
+#endif
+
+    if (uart_info->tx_done_sem != NULL) {
+        tkl_uart_tx_irq_cb_reg(port_num, uart_tx_done_in_isr);
+    }
+#ifdef CONFIG_UART_ASYNC_WRITE
+    else {
+        tkl_uart_tx_irq_cb_reg(port_num, uart_tx_chars_in_isr);
+    }
 #endif
 
     ret = uart_list_add_one_node(uart_info);
@@ -320,12 +414,14 @@ int tal_uart_read(TUYA_UART_NUM_E port_num, uint8_t *data, uint32_t len)
     } else {
         if (uart_info->open_mode & O_BLOCK) {
             while (read_count == 0) {
+                /* raise the flag before the last look, data that lands after it posts the semaphore */
+                uart_info->wait_rx_flag = TRUE;
                 read_count = tuya_ring_buff_read(rx_ring, data, len);
                 if (read_count != 0) {
+                    uart_info->wait_rx_flag = FALSE;
                     break;
                 }
 
-                uart_info->wait_rx_flag = TRUE;
                 ret = tal_semaphore_wait(uart_info->rx_block_sem, SEM_WAIT_FOREVER);
                 if (ret != OPRT_OK) {
                     break;
@@ -347,38 +443,36 @@ int tal_uart_read(TUYA_UART_NUM_E port_num, uint8_t *data, uint32_t len)
     return read_count;
 }
 
-#ifdef CONFIG_UART_WRITE_ASYNC
-OPERATE_RET uart_async_write(TAL_UART_DEV *uart_info, uint8_t *data, uint32_t len)
+#ifdef CONFIG_UART_ASYNC_WRITE
+int uart_async_write(TAL_UART_DEV *uart_info, const uint8_t *data, uint32_t len)
 {
     OPERATE_RET ret = tal_semaphore_wait(uart_info->tx_ring_sem, SEM_WAIT_FOREVER);
-    if (uart_info == NULL) {
+    if (ret != OPRT_OK) {
         return ret;
     }
 
-    uint16_t tx_bytes = tuya_ring_buff_write(uart_info->tx_ring, data, len);
+    uint32_t tx_bytes = tuya_ring_buff_write(uart_info->tx_ring, data, len);
 
-#ifdef CONFIG_UART_BLOCK
     if (uart_info->open_mode & O_BLOCK) {
-        while (ret == OPRT_OK) {
-            tx_bytes = tuya_ring_buff_write(uart_info->tx_ring, data, len);
-        }
-        if (tx_bytes != 0) {
-            break;
-        }
+        while (tx_bytes < len) {
+            uart_info->wait_tx_flag = TRUE;
+            tkl_uart_set_tx_int(uart_info->port_num, TRUE);
+            ret = tal_semaphore_wait(uart_info->tx_block_sem, SEM_WAIT_FOREVER);
+            if (ret != OPRT_OK) {
+                break;
+            }
 
-        uart_info->wait_tx_flag = TRUE;
-        ret = tal_semaphore_wait(uart_info->tx_block_sem, SEM_WAIT_FOREVER);
+            tx_bytes += tuya_ring_buff_write(uart_info->tx_ring, &data[tx_bytes], len - tx_bytes);
+        }
     }
-}
-#endif
 
-if (tx_bytes != 0) {
-    set_tx_int(uart_info->port_num, true);
-}
+    if (tx_bytes != 0) {
+        tkl_uart_set_tx_int(uart_info->port_num, TRUE);
+    }
 
-tal_semaphore_post(uart_info->tx_ring_sem);
+    tal_semaphore_post(uart_info->tx_ring_sem);
 
-return tx_bytes;
+    return tx_bytes;
 }
 #endif
 
@@ -404,22 +498,40 @@ int tal_uart_write(TUYA_UART_NUM_E port_num, const uint8_t *data, uint32_t len)
         return OPRT_INVALID_PARM;
     }
 
-    int tx_bytes = 0;
+#ifdef CONFIG_UART_ASYNC_WRITE
+    if (uart_info->open_mode & O_ASYNC_WRITE) {
+        return uart_async_write(uart_info, data, len);
+    }
+#endif
+
+    uint32_t tx_bytes = 0;
+    uint32_t tx_len;
     int ret;
-    if ((uart_info->open_mode & O_ASYNC_WRITE) == 0) {
-        while (tx_bytes != len) {
-            ret = tkl_uart_write(port_num, (void *)&data[tx_bytes], 1);
-            if (ret != 1) {
+
+    while (tx_bytes < len) {
+        tx_len = len - tx_bytes;
+        if (tx_len > 0xFFFF) {
+            tx_len = 0xFFFF;
+        }
+
+        ret = tkl_uart_write(port_num, (void *)&data[tx_bytes], tx_len);
+        if (ret <= 0) {
+            break;
+        }
+        tx_bytes += ret;
+
+        if (uart_info->tx_done_sem != NULL) {
+            /* 10 bit times per byte, data must stay valid until the dma is done */
+            uint32_t timeout = UART_TX_DMA_MARGIN_MS;
+            if (uart_info->baudrate) {
+                timeout += (uint32_t)((uint64_t)ret * 10 * 1000 / uart_info->baudrate);
+            }
+            if (tal_semaphore_wait(uart_info->tx_done_sem, timeout) != OPRT_OK) {
+                PR_ERR("uart %d tx dma timeout", port_num);
                 break;
             }
-            tx_bytes++;
         }
     }
-#ifdef CONFIG_UART_WRITE_ASYNC
-    else {
-        tx_bytes = uart_async_write(uart_info, data, len);
-    }
-#endif
 
     return tx_bytes;
 }
@@ -464,6 +576,10 @@ OPERATE_RET tal_uart_deinit(TUYA_UART_NUM_E port_num)
         tal_semaphore_release(uart_info->tx_block_sem);
     }
 
+    if (uart_info->tx_done_sem != NULL) {
+        tal_semaphore_release(uart_info->tx_done_sem);
+    }
+
     tal_free(uart_info);
 
     return ret;
@@ -481,3 +597,13 @@ int tal_uart_get_rx_data_size(TUYA_UART_NUM_E port_num)
 
     return buffer_size;
 }
+
+int tal_uart_get_rx_overflow(TUYA_UART_NUM_E port_num)
+{
+    TAL_UART_DEV *uart_info = uart_list_get_one_node(port_num);
+    if (uart_info == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return uart_info->rx_overflow;
+}
@@ -4,6 +4,7 @@
 // System includes
 #include "tal_log.h"
 #include "tal_memory.h"
+#include "tuya_crc.h"
 #include <inttypes.h>
 
 #define LFS_NO_ASSERT
@@ -199,19 +200,7 @@ static inline uint32_t lfs_tobe32(uint32_t a)
 // Calculate CRC-32 with polynomial = 0x04c11db7
 static __attribute__((unused)) uint32_t lfs_crc(uint32_t crc, const void *buffer, size_t size)
 {
-    static const uint32_t rtable[16] = {
-        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
-        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
-    };
-
-    const uint8_t *data = (const uint8_t *)buffer;
-
-    for (size_t i = 0; i < size; i++) {
-        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 0)) & 0xf];
-        crc = (crc >> 4) ^ rtable[(crc ^ (data[i] >> 4)) & 0xf];
-    }
-
-    return crc;
+    return tuya_crc32_update(crc, buffer, size);
 }
 
 // Allocate memory, only used if buffers are not provided to littlefs
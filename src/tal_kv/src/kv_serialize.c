@@ -1,6 +1,7 @@
 /**
  * @file kv_serialize.c
- * @brief Implements serialization of key-value pairs into a JSON string.
+ * @brief Implements serialization of key-value pairs into a JSON string or a
+ * compact binary record.
  *
  * This file contains the implementation of the kv_serialize function, which is
  * responsible for converting a database of key-value pairs into a JSON
@@ -13,7 +14,9 @@
  *
  * The implementation utilizes the cJSON library for JSON serialization and
  * includes optimizations for memory usage and processing time, making it
- * suitable for resource-constrained environments.
+ * suitable for resource-constrained environments. The binary record format
+ * stores integers as varints and raw data without base64, it needs no string
+ * formatting or JSON parsing, and JSON records are still accepted when read.
  *
  * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
  *
@@ -275,3 +278,353 @@ ERR_EXIT:
 
     return op_ret;
 }
+
+/*
+ * Binary record format, version 1:
+ *
+ *   magic(1) version(1) { key_len(1) key type(1) [value] } ...
+ *
+ * Integers are zigzag varints, false/true/null carry no value, strings and raw
+ * data are a varint length followed by the bytes (no '\0'). The magic byte is
+ * not valid as the first byte of a JSON text, so old JSON records are still
+ * read by kv_deserialize_bin.
+ */
+#define KV_BIN_MAGIC   0xA5
+#define KV_BIN_VERSION 1
+
+#define KV_BIN_INT   0
+#define KV_BIN_FALSE 1
+#define KV_BIN_TRUE  2
+#define KV_BIN_NULL  3
+#define KV_BIN_BYTES 4
+
+static uint32_t __varint_size(uint32_t val)
+{
+    uint32_t size = 1;
+
+    while (val >= 0x80) {
+        val >>= 7;
+        size++;
+    }
+
+    return size;
+}
+
+static uint8_t *__varint_put(uint8_t *p, uint32_t val)
+{
+    while (val >= 0x80) {
+        *p++ = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    *p++ = (uint8_t)val;
+
+    return p;
+}
+
+static const uint8_t *__varint_get(const uint8_t *p, const uint8_t *end, uint32_t *val)
+{
+    uint32_t shift = 0;
+
+    *val = 0;
+    while (p < end && shift < 35) {
+        *val |= (uint32_t)(*p & 0x7F) << shift;
+        if (0 == (*p++ & 0x80)) {
+            return p;
+        }
+        shift += 7;
+    }
+
+    return NULL;
+}
+
+static int32_t __kv_int_get(const kv_db_t *db)
+{
+    switch (db->tp) {
+    case KV_CHAR:
+        return *((char *)(db->val));
+    case KV_BYTE:
+        return *((uint8_t *)(db->val));
+    case KV_SHORT:
+        return *((int16_t *)(db->val));
+    case KV_USHORT:
+        return *((uint16_t *)(db->val));
+    default:
+        return *((int32_t *)(db->val));
+    }
+}
+
+static uint32_t __kv_bytes_len(const kv_db_t *db)
+{
+    if (db->tp == KV_STRING) {
+        return strlen((char *)db->val);
+    }
+
+    return db->len;
+}
+
+/**
+ * Serializes the key-value pairs in the given database into the binary record
+ * format.
+ *
+ * @param db The pointer to the database containing the key-value pairs.
+ * @param dbcnt The number of key-value pairs in the database.
+ * @param out The pointer to store the serialized record.
+ * @param out_len The pointer to store the length of the serialized record.
+ * @return Returns OPRT_OK if serialization is successful, otherwise returns an
+ * error code.
+ */
+int kv_serialize_bin(const kv_db_t *db, const uint32_t dbcnt, uint8_t **out, uint32_t *out_len)
+{
+    int i = 0;
+    uint32_t key_len = 0;
+    uint32_t val_len = 0;
+    uint32_t len = 2; // magic + version
+
+    // count need buf size
+    for (i = 0; i < dbcnt; i++) {
+        key_len = strlen(db[i].key);
+        if (key_len > 0xFF) {
+            PR_ERR("key too long %s", db[i].key);
+            return OPRT_INVALID_PARM;
+        }
+        len += 1 + key_len + 1;
+
+        if (db[i].tp <= KV_INT) {
+            int32_t val = __kv_int_get(&db[i]);
+            len += __varint_size(((uint32_t)val << 1) ^ (uint32_t)(val >> 31));
+        } else if (db[i].tp == KV_STRING || db[i].tp == KV_RAW) {
+            val_len = __kv_bytes_len(&db[i]);
+            if (val_len) {
+                len += __varint_size(val_len) + val_len;
+            }
+        } else if (db[i].tp != KV_BOOL) {
+            PR_ERR("type invalid %d", db[i].tp);
+            return OPRT_COM_ERROR;
+        }
+    }
+
+    uint8_t *buf = tal_malloc(len);
+    if (NULL == buf) {
+        PR_ERR("maloc fails %d", len);
+        return OPRT_MALLOC_FAILED;
+    }
+
+    uint8_t *p = buf;
+    *p++ = KV_BIN_MAGIC;
+    *p++ = KV_BIN_VERSION;
+
+    for (i = 0; i < dbcnt; i++) {
+        // add key
+        key_len = strlen(db[i].key);
+        *p++ = (uint8_t)key_len;
+        memcpy(p, db[i].key, key_len);
+        p += key_len;
+
+        // add value
+        if (db[i].tp <= KV_INT) {
+            int32_t val = __kv_int_get(&db[i]);
+            *p++ = KV_BIN_INT;
+            p = __varint_put(p, ((uint32_t)val << 1) ^ (uint32_t)(val >> 31));
+        } else if (db[i].tp == KV_BOOL) {
+            *p++ = (FALSE == *((BOOL_T *)(db[i].val))) ? KV_BIN_FALSE : KV_BIN_TRUE;
+        } else {
+            val_len = __kv_bytes_len(&db[i]);
+            if (0 == val_len) {
+                *p++ = KV_BIN_NULL;
+            } else {
+                *p++ = KV_BIN_BYTES;
+                p = __varint_put(p, val_len);
+                memcpy(p, db[i].val, val_len);
+                p += val_len;
+            }
+        }
+    }
+
+    *out = buf;
+    *out_len = len;
+
+    return OPRT_OK;
+}
+
+static int __kv_db_find(const kv_db_t *db, const uint32_t dbcnt, uint32_t hint, const uint8_t *key, uint32_t key_len)
+{
+    uint32_t i = 0;
+    uint32_t idx = 0;
+
+    // records are usually stored in the order of db, so start at the hint
+    for (i = 0; i < dbcnt; i++) {
+        idx = (hint + i) % dbcnt;
+        if (0 == strncmp(db[idx].key, (const char *)key, key_len) && 0 == db[idx].key[key_len]) {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Deserialize a record and populate a key-value database.
+ *
+ * Records written by kv_serialize_bin are decoded directly, any other record
+ * is handed to kv_deserialize as JSON. Properties missing in the record are
+ * set to zero, unknown properties in the record are skipped.
+ *
+ * @param[in] in The record to deserialize, JSON records must be '\0' ended.
+ * @param[in] in_len The length of the record.
+ * @param[in,out] db The key-value database to populate.
+ * @param[in] dbcnt The number of elements in the key-value database.
+ * @return Returns OPRT_OK if the deserialization is successful. Otherwise, it
+ * returns an error code indicating the failure reason.
+ */
+int kv_deserialize_bin(const uint8_t *in, const uint32_t in_len, kv_db_t *db, const uint32_t dbcnt)
+{
+    if (in_len < 2 || in[0] != KV_BIN_MAGIC) {
+        return kv_deserialize((const char *)in, db, dbcnt);
+    }
+
+    if (in[1] > KV_BIN_VERSION) {
+        PR_ERR("version not support %d", in[1]);
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    int op_ret = OPRT_OK;
+    int i = 0;
+    const uint8_t *p = in + 2;
+    const uint8_t *end = in + in_len;
+    const uint8_t *key = NULL;
+    uint32_t key_len = 0;
+    uint8_t type = 0;
+    uint32_t val = 0;
+    uint32_t hint = 0;
+
+    // default set zero
+    for (i = 0; i < dbcnt; i++) {
+        memset(db[i].val, 0, db[i].len);
+    }
+
+    while (p < end) {
+        key_len = *p++;
+        if (end - p < key_len + 1) {
+            op_ret = OPRT_COM_ERROR;
+            goto ERR_EXIT;
+        }
+        key = p;
+        p += key_len;
+        type = *p++;
+
+        val = 0;
+        if (type == KV_BIN_INT || type == KV_BIN_BYTES) {
+            p = __varint_get(p, end, &val);
+            if (NULL == p || (type == KV_BIN_BYTES && end - p < val)) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+        } else if (type > KV_BIN_BYTES) {
+            op_ret = OPRT_COM_ERROR;
+            goto ERR_EXIT;
+        }
+
+        i = __kv_db_find(db, dbcnt, hint, key, key_len);
+        if (i < 0) {
+            if (type == KV_BIN_BYTES) {
+                p += val;
+            }
+            continue;
+        }
+        hint = i + 1;
+
+        if (db[i].tp <= KV_INT && type != KV_BIN_INT) {
+            op_ret = OPRT_CJSON_GET_ERR;
+            goto ERR_EXIT;
+        } else if (db[i].tp == KV_BOOL && type != KV_BIN_FALSE && type != KV_BIN_TRUE) {
+            op_ret = OPRT_CJSON_GET_ERR;
+            goto ERR_EXIT;
+        } else if ((db[i].tp == KV_STRING || db[i].tp == KV_RAW) && type != KV_BIN_BYTES && type != KV_BIN_NULL) {
+            op_ret = OPRT_CJSON_GET_ERR;
+            goto ERR_EXIT;
+        }
+
+        int32_t ival = (int32_t)((val >> 1) ^ (0 - (val & 1)));
+
+        switch (db[i].tp) {
+        case KV_CHAR: {
+            if (ival < -128 || ival > 127) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+            *((char *)db[i].val) = ival;
+        } break;
+
+        case KV_BYTE: {
+            if (ival < 0 || ival > 255) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+            *((uint8_t *)db[i].val) = ival;
+        } break;
+
+        case KV_SHORT: {
+            if (ival < -32768 || ival > 32767) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+            *((int16_t *)db[i].val) = ival;
+        } break;
+
+        case KV_USHORT: {
+            if (ival < 0 || ival > 65535) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+            *((uint16_t *)db[i].val) = ival;
+        } break;
+
+        case KV_INT: {
+            *((int *)db[i].val) = ival;
+        } break;
+
+        case KV_BOOL: {
+            *((BOOL_T *)db[i].val) = (type == KV_BIN_FALSE) ? 0 : 1;
+        } break;
+
+        case KV_STRING: {
+            if (db[i].len < val + 1) {
+                op_ret = OPRT_COM_ERROR;
+                goto ERR_EXIT;
+            }
+            memcpy(db[i].val, p, val);
+            ((char *)db[i].val)[val] = 0;
+        } break;
+
+        case KV_RAW: {
+            if (type == KV_BIN_NULL) {
+                db[i].len = 0;
+            } else {
+                if (db[i].len < val) {
+                    op_ret = OPRT_COM_ERROR;
+                    goto ERR_EXIT;
+                }
+                memcpy(db[i].val, p, val);
+                db[i].len = val;
+            }
+        } break;
+
+        default: {
+            PR_ERR("type invalid %d", db[i].tp);
+            op_ret = OPRT_COM_ERROR;
+            goto ERR_EXIT;
+        }
+        }
+
+        if (type == KV_BIN_BYTES) {
+            p += val;
+        }
+    }
+
+    return OPRT_OK;
+
+ERR_EXIT:
+    PR_ERR("deserial fails %d", op_ret);
+
+    return op_ret;
+}
@@ -35,9 +35,15 @@ static lfs_t lfs;
 static lfs_size_t lfs_flash_addr;
 static tal_kv_cfg_t lfs_kv_cfg;
 static MUTEX_HANDLE lfs_mutex;
+static TAL_CIPHER_CTX_T lfs_enc_ctx;
+static TAL_CIPHER_CTX_T lfs_dec_ctx;
+
+#define KV_CRYPT_CHUNK_SIZE 128
 
 extern int kv_serialize(const kv_db_t *db, const uint32_t dbcnt, char **out, uint32_t *out_len);
 extern int kv_deserialize(const char *in, kv_db_t *db, const uint32_t dbcnt);
+extern int kv_serialize_bin(const kv_db_t *db, const uint32_t dbcnt, uint8_t **out, uint32_t *out_len);
+extern int kv_deserialize_bin(const uint8_t *in, const uint32_t in_len, kv_db_t *db, const uint32_t dbcnt);
 
 /**
  * Reads data from a user-provided block device.
@@ -137,6 +143,7 @@ int user_provided_block_device_sync(const struct lfs_config *c)
  */
 int tal_kv_init(tal_kv_cfg_t *kv_cfg)
 {
+    OPERATE_RET rt = OPRT_OK;
     uint8_t sha256_ret[32];
 
     //! init flash key
@@ -148,6 +155,16 @@ int tal_kv_init(tal_kv_cfg_t *kv_cfg)
 
     tal_mutex_create_init(&lfs_mutex);
 
+    //! expand the flash key once, the contexts are reused by every set/get
+    TUYA_CALL_ERR_GOTO(
+        tal_cipher_setup(&lfs_enc_ctx, TAL_CIPHER_AES_CBC, SYMMETRY_ENCRYPT, (uint8_t *)lfs_kv_cfg.key, 128),
+        __CIPHER_ERR);
+    TUYA_CALL_ERR_GOTO(tal_cipher_set_padding(&lfs_enc_ctx, TRUE), __CIPHER_ERR);
+    TUYA_CALL_ERR_GOTO(
+        tal_cipher_setup(&lfs_dec_ctx, TAL_CIPHER_AES_CBC, SYMMETRY_DECRYPT, (uint8_t *)lfs_kv_cfg.key, 128),
+        __CIPHER_ERR);
+    TUYA_CALL_ERR_GOTO(tal_cipher_set_padding(&lfs_dec_ctx, TRUE), __CIPHER_ERR);
+
     TUYA_FLASH_BASE_INFO_T info;
     tkl_flash_get_one_type_info(TUYA_FLASH_TYPE_UF, &info);
     lfs_flash_addr = info.partition[0].start_addr;
@@ -179,6 +196,15 @@ int tal_kv_init(tal_kv_cfg_t *kv_cfg)
     }
 
     return err;
+
+__CIPHER_ERR:
+    //! without the flash key every set/get would fail, do not mount
+    tal_cipher_free(&lfs_enc_ctx);
+    tal_cipher_free(&lfs_dec_ctx);
+    tal_mutex_release(lfs_mutex);
+    lfs_mutex = NULL;
+
+    return rt;
 }
 
 /**
@@ -212,27 +238,31 @@ int tal_kv_set(const char *key, const uint8_t *value, size_t length)
         PR_ERR("lfs open %s err", key);
         return result;
     }
-    uint8_t *ec_data = NULL;
-    uint32_t ec_len = 0;
-    uint8_t iv[16];
+    //! encrypt and write in chunks, no buffer for the whole value is needed
+    uint8_t ec_buf[KV_CRYPT_CHUNK_SIZE + TAL_CIPHER_BLOCK_SIZE];
+    size_t ec_len = 0, offset = 0, chunk;
 
-    memcpy(iv, lfs_kv_cfg.seed, 16);
-    result =
-        tal_aes128_cbc_encode((uint8_t *)value, length, (uint8_t *)lfs_kv_cfg.key, iv, &ec_data, (uint32_t *)&ec_len);
-    if (OPRT_OK != result) {
-        lfs_file_close(&lfs, &file);
-        tal_mutex_unlock(lfs_mutex);
-        PR_DEBUG("key %s encrypt failed", key);
-        return result;
-    }
     lfs_file_rewind(&lfs, &file);
-    result = lfs_file_write(&lfs, &file, ec_data, ec_len);
+    result = tal_cipher_reset(&lfs_enc_ctx, (uint8_t *)lfs_kv_cfg.seed);
+    while (OPRT_OK == result && offset < length) {
+        chunk = (length - offset > KV_CRYPT_CHUNK_SIZE) ? KV_CRYPT_CHUNK_SIZE : length - offset;
+        result = tal_cipher_update(&lfs_enc_ctx, value + offset, chunk, ec_buf, &ec_len);
+        offset += chunk;
+        if (OPRT_OK == result && ec_len && lfs_file_write(&lfs, &file, ec_buf, ec_len) != (lfs_ssize_t)ec_len) {
+            result = OPRT_KVS_WR_FAIL;
+        }
+    }
+    if (OPRT_OK == result) {
+        result = tal_cipher_finish(&lfs_enc_ctx, ec_buf, &ec_len);
+        if (OPRT_OK == result && lfs_file_write(&lfs, &file, ec_buf, ec_len) != (lfs_ssize_t)ec_len) {
+            result = OPRT_KVS_WR_FAIL;
+        }
+    }
     lfs_file_close(&lfs, &file);
-    tal_aes_free_data(ec_data);
     tal_mutex_unlock(lfs_mutex);
-    if (result != ec_len) {
-        PR_ERR("kv write fail %d", result);
-        return OPRT_KVS_WR_FAIL;
+    if (OPRT_OK != result) {
+        PR_ERR("kv %s write fail %d", key, result);
+        return result;
     }
 
     return OPRT_OK;
@@ -282,27 +312,26 @@ int tal_kv_get(const char *key, uint8_t **value, size_t *length)
     PR_DEBUG("key:%s, len:%d", key, ec_len);
     result = lfs_file_read(&lfs, &file, ec_data, ec_len);
     lfs_file_close(&lfs, &file);
-    tal_mutex_unlock(lfs_mutex);
     if (result <= 0) {
+        tal_mutex_unlock(lfs_mutex);
         *length = 0;
         tal_free(ec_data);
         PR_ERR("kv read error %d", result);
         return OPRT_KVS_RD_FAIL;
     }
-    uint8_t *dec_data = NULL;
-    uint32_t dec_len = 0;
-    uint8_t iv[16];
-
-    memcpy(iv, lfs_kv_cfg.seed, 16);
-    result = tal_aes128_cbc_decode(ec_data, ec_len, (uint8_t *)lfs_kv_cfg.key, iv, &dec_data, (uint32_t *)&dec_len);
-    dec_len = tal_aes_get_actual_length(dec_data, dec_len);
-    tal_free(ec_data);
-    if (OPRT_OK != result || dec_len > ec_len) {
-        PR_ERR("key %s decrypt failed %d, %d-%d", key, result, dec_len, ec_len);
+    //! decrypt in place, the read buffer is returned as the value
+    uint8_t *dec_data = ec_data;
+    size_t dec_len = 0;
+
+    result = tal_cipher_crypt(&lfs_dec_ctx, (uint8_t *)lfs_kv_cfg.seed, ec_data, ec_len, dec_data, &dec_len);
+    tal_mutex_unlock(lfs_mutex);
+    if (OPRT_OK != result) {
+        PR_ERR("key %s decrypt failed %d, %d", key, result, ec_len);
+        tal_free(ec_data);
         return OPRT_BUFFER_NOT_ENOUGH;
     }
     *value = dec_data;
-    *length = (size_t)dec_len;
+    *length = dec_len;
     dec_data[dec_len] = 0;
 
     return OPRT_OK;
@@ -410,17 +439,25 @@ int tal_kv_serialize_set(const char *key, kv_db_t *db, size_t dbcnt)
         return OPRT_INVALID_PARM;
     }
 
-    char *buf = NULL;
+    uint8_t *buf = NULL;
     uint32_t len = 0;
     int ret = OPRT_OK;
 
-    ret = kv_serialize(db, dbcnt, &buf, &len);
+#if defined(ENABLE_KV_SERIALIZE_JSON) && (ENABLE_KV_SERIALIZE_JSON == 1)
+    ret = kv_serialize(db, dbcnt, (char **)&buf, &len);
     if (OPRT_OK != ret) {
         PR_ERR("kv_serialize  fail. %d", ret);
         return ret;
     }
     PR_TRACE("write buf:%s", buf);
-    ret = tal_kv_set(key, (const uint8_t *)buf, len);
+#else
+    ret = kv_serialize_bin(db, dbcnt, &buf, &len);
+    if (OPRT_OK != ret) {
+        PR_ERR("kv_serialize_bin fail. %d", ret);
+        return ret;
+    }
+#endif
+    ret = tal_kv_set(key, buf, len);
     tal_free(buf);
     if (OPRT_OK != ret) {
         PR_ERR("kv_set fails %s %d", key, ret);
@@ -458,7 +495,7 @@ int tal_kv_serialize_get(const char *key, kv_db_t *db, size_t dbcnt)
         PR_ERR("kv_get fails %s %d", key, ret);
         return ret;
     }
-    ret = kv_deserialize((char *)buf, db, dbcnt);
+    ret = kv_deserialize_bin(buf, len, db, dbcnt);
     tal_free(buf);
     if (OPRT_OK != ret) {
         PR_ERR("kv_deserialize fail. %d", ret);
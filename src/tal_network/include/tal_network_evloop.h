@@ -0,0 +1,139 @@
+/**
+ * @file tal_network_evloop.h
+ * @brief Socket event loop interface for Tuya SDK.
+ *
+ * This header file defines a readiness based event loop on top of the network
+ * utilities. Sockets are registered once with the events they are interested
+ * in (readable, writable) and the loop reports only the sockets that are
+ * ready, so the caller no longer rebuilds fd sets and rescans all sockets on
+ * every iteration. The loop can be woken from any thread, which lets other
+ * tasks register new sockets or queue data without waiting for a timeout.
+ *
+ * On Linux the loop is backed by epoll and an eventfd. On lwIP and other TKL
+ * based systems it falls back to select and a loopback UDP socket used as a
+ * self-pipe.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+#ifndef __TAL_NETWORK_EVLOOP_H__
+#define __TAL_NETWORK_EVLOOP_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* socket events */
+#define TAL_NET_EV_READ  0x01
+#define TAL_NET_EV_WRITE 0x02
+#define TAL_NET_EV_ERROR 0x04
+
+/* wait forever in tal_net_evloop_wait */
+#define TAL_NET_EVLOOP_WAIT_FOREVER 0xFFFFFFFF
+
+typedef void *TAL_NET_EVLOOP_HANDLE;
+
+/**
+ * @brief ready event reported by tal_net_evloop_wait
+ *
+ */
+typedef struct {
+    int fd;          // socket fd
+    uint32_t events; // TAL_NET_EV_xxx
+    void *ctx;       // user data given when the fd was added
+} TAL_NET_EVENT_T;
+
+/**
+ * @brief Create event loop
+ *
+ * @param[out] loop: event loop handle
+ * @param[in] max_fds: max count of fd the loop can watch
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_create(TAL_NET_EVLOOP_HANDLE *loop, uint32_t max_fds);
+
+/**
+ * @brief Release event loop
+ *
+ * @param[in] loop: event loop handle
+ *
+ * @note The watched fds are not closed.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_release(TAL_NET_EVLOOP_HANDLE loop);
+
+/**
+ * @brief Add fd to event loop
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ * @param[in] events: TAL_NET_EV_READ and/or TAL_NET_EV_WRITE
+ * @param[in] ctx: user data reported with the events of fd
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_add(TAL_NET_EVLOOP_HANDLE loop, int fd, uint32_t events, void *ctx);
+
+/**
+ * @brief Modify watched events of fd
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ * @param[in] events: TAL_NET_EV_READ and/or TAL_NET_EV_WRITE
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_modify(TAL_NET_EVLOOP_HANDLE loop, int fd, uint32_t events);
+
+/**
+ * @brief Remove fd from event loop
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ *
+ * @note Must be called before the fd is closed.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_del(TAL_NET_EVLOOP_HANDLE loop, int fd);
+
+/**
+ * @brief Wait for ready fds
+ *
+ * @param[in] loop: event loop handle
+ * @param[out] events: ready events
+ * @param[in] max_events: size of events
+ * @param[in] ms_timeout: time out, TAL_NET_EVLOOP_WAIT_FOREVER to wait forever
+ *
+ * @note Returns early with 0 when the loop is woken by tal_net_evloop_wakeup.
+ *
+ * @return >=0 the count of ready events, <0 error.
+ */
+int tal_net_evloop_wait(TAL_NET_EVLOOP_HANDLE loop, TAL_NET_EVENT_T *events, int max_events, uint32_t ms_timeout);
+
+/**
+ * @brief Wake up the thread blocked in tal_net_evloop_wait
+ *
+ * @param[in] loop: event loop handle
+ *
+ * @note Can be called from any thread.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_wakeup(TAL_NET_EVLOOP_HANDLE loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
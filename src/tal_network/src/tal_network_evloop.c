@@ -0,0 +1,568 @@
+/**
+ * @file tal_network_evloop.c
+ * @brief Socket event loop implementation for Tuya SDK.
+ *
+ * The loop keeps a fixed table of watched fds, allocated when the loop is
+ * created. On Linux the table entries are registered with epoll and an
+ * eventfd is used to wake the waiting thread. On lwIP and TKL based systems
+ * the table is turned into fd sets for select on every wait, and a UDP socket
+ * bound to the loopback address sends a byte to itself to wake the loop.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+#include "tuya_iot_config.h"
+#include "tal_api.h"
+#include "tal_network.h"
+#include "tal_network_evloop.h"
+
+#if 100 == OPERATING_SYSTEM
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define EVLOOP_USING_EPOLL 1
+#elif defined(ENABLE_LIBLWIP) && (ENABLE_LIBLWIP == 1)
+#include "lwip/sockets.h"
+#else
+#include "tkl_network.h"
+#endif
+
+typedef struct {
+    BOOL_T used;
+    int fd;
+    uint32_t events;
+    void *ctx;
+} EVLOOP_ENTRY_T;
+
+typedef struct {
+    MUTEX_HANDLE mutex;
+    uint32_t max_fds;
+    EVLOOP_ENTRY_T *entries;
+#if EVLOOP_USING_EPOLL
+    int epfd;
+    int wakeup_fd;
+    struct epoll_event *ready;
+#else
+    int wakeup_fd;
+    uint16_t wakeup_port;
+    TUYA_FD_SET_T rfds;
+    TUYA_FD_SET_T wfds;
+    TUYA_FD_SET_T efds;
+#endif
+} TAL_NET_EVLOOP_T;
+
+static EVLOOP_ENTRY_T *__evloop_entry_find(TAL_NET_EVLOOP_T *loop, int fd)
+{
+    uint32_t i;
+    for (i = 0; i < loop->max_fds; i++) {
+        if (loop->entries[i].used && loop->entries[i].fd == fd) {
+            return &loop->entries[i];
+        }
+    }
+    return NULL;
+}
+
+#if EVLOOP_USING_EPOLL
+static uint32_t __evloop_to_epoll(uint32_t events)
+{
+    uint32_t ep_events = 0;
+    if (events & TAL_NET_EV_READ) {
+        ep_events |= EPOLLIN;
+    }
+    if (events & TAL_NET_EV_WRITE) {
+        ep_events |= EPOLLOUT;
+    }
+    return ep_events;
+}
+
+static OPERATE_RET __evloop_backend_init(TAL_NET_EVLOOP_T *loop)
+{
+    struct epoll_event ev = {0};
+
+    loop->ready = tal_malloc((loop->max_fds + 1) * sizeof(struct epoll_event));
+    if (NULL == loop->ready) {
+        return OPRT_MALLOC_FAILED;
+    }
+
+    loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epfd < 0) {
+        PR_ERR("epoll create err:%d", errno);
+        return OPRT_COM_ERROR;
+    }
+
+    loop->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop->wakeup_fd < 0) {
+        PR_ERR("eventfd create err:%d", errno);
+        return OPRT_COM_ERROR;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, loop->wakeup_fd, &ev) < 0) {
+        PR_ERR("epoll add wakeup fd err:%d", errno);
+        return OPRT_COM_ERROR;
+    }
+
+    return OPRT_OK;
+}
+
+static void __evloop_backend_deinit(TAL_NET_EVLOOP_T *loop)
+{
+    if (loop->wakeup_fd >= 0) {
+        close(loop->wakeup_fd);
+    }
+    if (loop->epfd >= 0) {
+        close(loop->epfd);
+    }
+    if (loop->ready) {
+        tal_free(loop->ready);
+    }
+}
+
+static OPERATE_RET __evloop_backend_ctl(TAL_NET_EVLOOP_T *loop, int op, EVLOOP_ENTRY_T *entry)
+{
+    struct epoll_event ev = {0};
+
+    ev.events = __evloop_to_epoll(entry->events);
+    ev.data.ptr = entry;
+    if (epoll_ctl(loop->epfd, op, entry->fd, &ev) < 0) {
+        PR_ERR("epoll ctl op:%d fd:%d err:%d", op, entry->fd, errno);
+        return OPRT_COM_ERROR;
+    }
+
+    return OPRT_OK;
+}
+
+#define EVLOOP_CTL_ADD EPOLL_CTL_ADD
+#define EVLOOP_CTL_MOD EPOLL_CTL_MOD
+#define EVLOOP_CTL_DEL EPOLL_CTL_DEL
+
+static int __evloop_backend_wait(TAL_NET_EVLOOP_T *loop, TAL_NET_EVENT_T *events, int max_events,
+                                 uint32_t ms_timeout)
+{
+    int i, cnt = 0, ready_cnt;
+    int timeout = (TAL_NET_EVLOOP_WAIT_FOREVER == ms_timeout) ? -1 : (int)ms_timeout;
+
+    if (max_events > loop->max_fds + 1) {
+        max_events = loop->max_fds + 1;
+    }
+
+    ready_cnt = epoll_wait(loop->epfd, loop->ready, max_events, timeout);
+    if (ready_cnt < 0) {
+        return (EINTR == errno) ? 0 : ready_cnt;
+    }
+
+    tal_mutex_lock(loop->mutex);
+    for (i = 0; i < ready_cnt; i++) {
+        EVLOOP_ENTRY_T *entry = loop->ready[i].data.ptr;
+        if (NULL == entry) {
+            uint64_t val;
+            while (read(loop->wakeup_fd, &val, sizeof(val)) > 0) {
+            }
+            continue;
+        }
+        if (!entry->used) {
+            continue;
+        }
+        events[cnt].fd = entry->fd;
+        events[cnt].ctx = entry->ctx;
+        events[cnt].events = 0;
+        if (loop->ready[i].events & (EPOLLIN | EPOLLHUP)) {
+            events[cnt].events |= TAL_NET_EV_READ;
+        }
+        if (loop->ready[i].events & EPOLLOUT) {
+            events[cnt].events |= TAL_NET_EV_WRITE;
+        }
+        if (loop->ready[i].events & EPOLLERR) {
+            events[cnt].events |= TAL_NET_EV_ERROR;
+        }
+        cnt++;
+    }
+    tal_mutex_unlock(loop->mutex);
+
+    return cnt;
+}
+
+static OPERATE_RET __evloop_backend_wakeup(TAL_NET_EVLOOP_T *loop)
+{
+    uint64_t val = 1;
+    if (write(loop->wakeup_fd, &val, sizeof(val)) < 0 && EAGAIN != errno) {
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+#else
+
+static OPERATE_RET __evloop_backend_init(TAL_NET_EVLOOP_T *loop)
+{
+    TUYA_IP_ADDR_T addr = 0;
+
+    // no pipe on lwIP, a loopback udp socket talking to itself wakes select
+    loop->wakeup_fd = tal_net_socket_create(PROTOCOL_UDP);
+    if (loop->wakeup_fd < 0) {
+        PR_ERR("wakeup sock create err:%d", tal_net_get_errno());
+        return OPRT_SOCK_ERR;
+    }
+    if (OPRT_OK != tal_net_bind(loop->wakeup_fd, TY_IPADDR_LOOPBACK, 0)) {
+        PR_ERR("wakeup sock bind err:%d", tal_net_get_errno());
+        return OPRT_SOCK_ERR;
+    }
+#if defined(ENABLE_LIBLWIP) && (ENABLE_LIBLWIP == 1)
+    struct sockaddr_in sock_addr;
+    socklen_t addr_len = sizeof(sock_addr);
+    if (getsockname(loop->wakeup_fd, (struct sockaddr *)&sock_addr, &addr_len) < 0) {
+        return OPRT_SOCK_ERR;
+    }
+    loop->wakeup_port = ntohs(sock_addr.sin_port);
+#else
+    if (OPRT_OK != tkl_net_getsockname(loop->wakeup_fd, &addr, &loop->wakeup_port)) {
+        return OPRT_SOCK_ERR;
+    }
+#endif
+    (void)addr;
+    tal_net_set_block(loop->wakeup_fd, FALSE);
+
+    return OPRT_OK;
+}
+
+static void __evloop_backend_deinit(TAL_NET_EVLOOP_T *loop)
+{
+    if (loop->wakeup_fd >= 0) {
+        tal_net_close(loop->wakeup_fd);
+    }
+}
+
+static OPERATE_RET __evloop_backend_ctl(TAL_NET_EVLOOP_T *loop, int op, EVLOOP_ENTRY_T *entry)
+{
+    // the table is turned into fd sets on every wait
+    return OPRT_OK;
+}
+
+#define EVLOOP_CTL_ADD 0
+#define EVLOOP_CTL_MOD 1
+#define EVLOOP_CTL_DEL 2
+
+static int __evloop_backend_wait(TAL_NET_EVLOOP_T *loop, TAL_NET_EVENT_T *events, int max_events,
+                                 uint32_t ms_timeout)
+{
+    uint32_t i;
+    int cnt = 0, ready_cnt, max_fd;
+
+    tal_mutex_lock(loop->mutex);
+    tal_net_fd_zero(&loop->rfds);
+    tal_net_fd_zero(&loop->wfds);
+    tal_net_fd_zero(&loop->efds);
+    tal_net_fd_set(loop->wakeup_fd, &loop->rfds);
+    max_fd = loop->wakeup_fd;
+    for (i = 0; i < loop->max_fds; i++) {
+        EVLOOP_ENTRY_T *entry = &loop->entries[i];
+        if (!entry->used) {
+            continue;
+        }
+        if (entry->events & TAL_NET_EV_READ) {
+            tal_net_fd_set(entry->fd, &loop->rfds);
+        }
+        if (entry->events & TAL_NET_EV_WRITE) {
+            tal_net_fd_set(entry->fd, &loop->wfds);
+        }
+        tal_net_fd_set(entry->fd, &loop->efds);
+        if (entry->fd > max_fd) {
+            max_fd = entry->fd;
+        }
+    }
+    tal_mutex_unlock(loop->mutex);
+
+    // tal_net_select treats 0 as forever
+    if (TAL_NET_EVLOOP_WAIT_FOREVER == ms_timeout) {
+        ms_timeout = 0;
+    } else if (0 == ms_timeout) {
+        ms_timeout = 1;
+    }
+
+    ready_cnt = tal_net_select(max_fd + 1, &loop->rfds, &loop->wfds, &loop->efds, ms_timeout);
+    if (ready_cnt <= 0) {
+        return (ready_cnt < 0 && UNW_EINTR != tal_net_get_errno()) ? ready_cnt : 0;
+    }
+
+    if (tal_net_fd_isset(loop->wakeup_fd, &loop->rfds)) {
+        uint8_t val[8];
+        while (tal_net_recv(loop->wakeup_fd, val, sizeof(val)) > 0) {
+        }
+    }
+
+    tal_mutex_lock(loop->mutex);
+    for (i = 0; i < loop->max_fds && cnt < max_events; i++) {
+        EVLOOP_ENTRY_T *entry = &loop->entries[i];
+        if (!entry->used) {
+            continue;
+        }
+        events[cnt].events = 0;
+        if (tal_net_fd_isset(entry->fd, &loop->rfds)) {
+            events[cnt].events |= TAL_NET_EV_READ;
+        }
+        if (tal_net_fd_isset(entry->fd, &loop->wfds)) {
+            events[cnt].events |= TAL_NET_EV_WRITE;
+        }
+        if (tal_net_fd_isset(entry->fd, &loop->efds)) {
+            events[cnt].events |= TAL_NET_EV_ERROR;
+        }
+        if (events[cnt].events) {
+            events[cnt].fd = entry->fd;
+            events[cnt].ctx = entry->ctx;
+            cnt++;
+        }
+    }
+    tal_mutex_unlock(loop->mutex);
+
+    return cnt;
+}
+
+static OPERATE_RET __evloop_backend_wakeup(TAL_NET_EVLOOP_T *loop)
+{
+    uint8_t val = 1;
+    if (tal_net_send_to(loop->wakeup_fd, &val, sizeof(val), TY_IPADDR_LOOPBACK, loop->wakeup_port) < 0) {
+        return OPRT_SOCK_ERR;
+    }
+    return OPRT_OK;
+}
+#endif
+
+/**
+ * @brief Create event loop
+ *
+ * @param[out] loop: event loop handle
+ * @param[in] max_fds: max count of fd the loop can watch
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_create(TAL_NET_EVLOOP_HANDLE *loop, uint32_t max_fds)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TAL_NET_EVLOOP_T *evloop = NULL;
+
+    if (NULL == loop || 0 == max_fds) {
+        return OPRT_INVALID_PARM;
+    }
+
+    evloop = tal_malloc(sizeof(TAL_NET_EVLOOP_T));
+    if (NULL == evloop) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(evloop, 0, sizeof(TAL_NET_EVLOOP_T));
+    evloop->max_fds = max_fds;
+    evloop->wakeup_fd = -1;
+#if EVLOOP_USING_EPOLL
+    evloop->epfd = -1;
+#endif
+
+    evloop->entries = tal_malloc(max_fds * sizeof(EVLOOP_ENTRY_T));
+    if (NULL == evloop->entries) {
+        rt = OPRT_MALLOC_FAILED;
+        goto __exit;
+    }
+    memset(evloop->entries, 0, max_fds * sizeof(EVLOOP_ENTRY_T));
+
+    TUYA_CALL_ERR_GOTO(tal_mutex_create_init(&evloop->mutex), __exit);
+    TUYA_CALL_ERR_GOTO(__evloop_backend_init(evloop), __exit);
+
+    *loop = evloop;
+    return OPRT_OK;
+
+__exit:
+    tal_net_evloop_release(evloop);
+    return rt;
+}
+
+/**
+ * @brief Release event loop
+ *
+ * @param[in] loop: event loop handle
+ *
+ * @note The watched fds are not closed.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_release(TAL_NET_EVLOOP_HANDLE loop)
+{
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+
+    if (NULL == evloop) {
+        return OPRT_INVALID_PARM;
+    }
+
+    __evloop_backend_deinit(evloop);
+    if (evloop->mutex) {
+        tal_mutex_release(evloop->mutex);
+    }
+    if (evloop->entries) {
+        tal_free(evloop->entries);
+    }
+    tal_free(evloop);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Add fd to event loop
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ * @param[in] events: TAL_NET_EV_READ and/or TAL_NET_EV_WRITE
+ * @param[in] ctx: user data reported with the events of fd
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_add(TAL_NET_EVLOOP_HANDLE loop, int fd, uint32_t events, void *ctx)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+    EVLOOP_ENTRY_T *entry = NULL;
+    uint32_t i;
+
+    if (NULL == evloop || fd < 0) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(evloop->mutex);
+    if (__evloop_entry_find(evloop, fd)) {
+        tal_mutex_unlock(evloop->mutex);
+        return OPRT_COM_ERROR;
+    }
+    for (i = 0; i < evloop->max_fds; i++) {
+        if (!evloop->entries[i].used) {
+            entry = &evloop->entries[i];
+            break;
+        }
+    }
+    if (NULL == entry) {
+        tal_mutex_unlock(evloop->mutex);
+        return OPRT_EXCEED_UPPER_LIMIT;
+    }
+    entry->fd = fd;
+    entry->events = events;
+    entry->ctx = ctx;
+    rt = __evloop_backend_ctl(evloop, EVLOOP_CTL_ADD, entry);
+    if (OPRT_OK == rt) {
+        entry->used = TRUE;
+    }
+    tal_mutex_unlock(evloop->mutex);
+
+    return rt;
+}
+
+/**
+ * @brief Modify watched events of fd
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ * @param[in] events: TAL_NET_EV_READ and/or TAL_NET_EV_WRITE
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_modify(TAL_NET_EVLOOP_HANDLE loop, int fd, uint32_t events)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+    EVLOOP_ENTRY_T *entry = NULL;
+
+    if (NULL == evloop || fd < 0) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(evloop->mutex);
+    entry = __evloop_entry_find(evloop, fd);
+    if (NULL == entry) {
+        tal_mutex_unlock(evloop->mutex);
+        return OPRT_NOT_FOUND;
+    }
+    if (entry->events != events) {
+        entry->events = events;
+        rt = __evloop_backend_ctl(evloop, EVLOOP_CTL_MOD, entry);
+    }
+    tal_mutex_unlock(evloop->mutex);
+
+    return rt;
+}
+
+/**
+ * @brief Remove fd from event loop
+ *
+ * @param[in] loop: event loop handle
+ * @param[in] fd: socket fd
+ *
+ * @note Must be called before the fd is closed.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_del(TAL_NET_EVLOOP_HANDLE loop, int fd)
+{
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+    EVLOOP_ENTRY_T *entry = NULL;
+
+    if (NULL == evloop || fd < 0) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(evloop->mutex);
+    entry = __evloop_entry_find(evloop, fd);
+    if (NULL == entry) {
+        tal_mutex_unlock(evloop->mutex);
+        return OPRT_NOT_FOUND;
+    }
+    __evloop_backend_ctl(evloop, EVLOOP_CTL_DEL, entry);
+    memset(entry, 0, sizeof(EVLOOP_ENTRY_T));
+    tal_mutex_unlock(evloop->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Wait for ready fds
+ *
+ * @param[in] loop: event loop handle
+ * @param[out] events: ready events
+ * @param[in] max_events: size of events
+ * @param[in] ms_timeout: time out, TAL_NET_EVLOOP_WAIT_FOREVER to wait forever
+ *
+ * @note Returns early with 0 when the loop is woken by tal_net_evloop_wakeup.
+ *
+ * @return >=0 the count of ready events, <0 error.
+ */
+int tal_net_evloop_wait(TAL_NET_EVLOOP_HANDLE loop, TAL_NET_EVENT_T *events, int max_events, uint32_t ms_timeout)
+{
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+
+    if (NULL == evloop || NULL == events || max_events <= 0) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __evloop_backend_wait(evloop, events, max_events, ms_timeout);
+}
+
+/**
+ * @brief Wake up the thread blocked in tal_net_evloop_wait
+ *
+ * @param[in] loop: event loop handle
+ *
+ * @note Can be called from any thread.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_net_evloop_wakeup(TAL_NET_EVLOOP_HANDLE loop)
+{
+    TAL_NET_EVLOOP_T *evloop = (TAL_NET_EVLOOP_T *)loop;
+
+    if (NULL == evloop) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __evloop_backend_wakeup(evloop);
+}
@@ -39,6 +39,43 @@ typedef struct {
     uint8_t opad[64]; /*!< HMAC: outer padding */
 } tal_hash_mac_context_t;
 
+typedef enum {
+    TAL_HMAC_SHA256 = 0,
+    TAL_HMAC_SHA1,
+} TAL_HMAC_TYPE_E;
+
+/**
+ * @brief HMAC key with precomputed inner and outer hash state
+ *
+ * The key is padded and absorbed once by tal_hmac_key_init. Every message
+ * continues from a clone of that state, the key is never rehashed. The key is
+ * read-only after init and can be shared by several threads.
+ */
+typedef struct {
+    TAL_HMAC_TYPE_E type;
+    TKL_HASH_HANDLE inner; /*!< hash state after the inner padding */
+    TKL_HASH_HANDLE outer; /*!< hash state after the outer padding */
+    uint8_t ipad[64];      /*!< HMAC: inner padding, used if state can't be cloned */
+    uint8_t opad[64];      /*!< HMAC: outer padding, used if state can't be cloned */
+} TAL_HMAC_KEY_T;
+
+/**
+ * @brief per message HMAC context
+ */
+typedef struct {
+    const TAL_HMAC_KEY_T *key;
+    TKL_HASH_HANDLE ctx;
+} TAL_HMAC_CTX_T;
+
+/**
+ * @brief one message of tal_hmac_multi
+ */
+typedef struct {
+    const uint8_t *input; /*!< message */
+    size_t ilen;          /*!< message length */
+    uint8_t *output;      /*!< digest, 32 bytes for SHA256, 20 bytes for SHA1 */
+} TAL_HMAC_MSG_T;
+
 /**
  * @brief This function Create&initializes a sha256 context.
  *
@@ -109,6 +146,20 @@ OPERATE_RET tal_sha256_update_ret(TKL_HASH_HANDLE ctx, const uint8_t *input, siz
  */
 OPERATE_RET tal_sha256_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[32]);
 
+/**
+ * @brief This function clones the state of a sha256 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha256. OPRT_NOT_SUPPORTED is returned if
+ * the platform cannot copy the hash state.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_sha256_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src);
+
 /**
  * @brief This function Create&initializes a md5 context.
  *
@@ -244,6 +295,20 @@ OPERATE_RET tal_sha1_update_ret(TKL_HASH_HANDLE ctx, const uint8_t *input, size_
  * tuya_error_code.h
  */
 OPERATE_RET tal_sha1_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[20]);
+
+/**
+ * @brief This function clones the state of a sha1 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha1. OPRT_NOT_SUPPORTED is returned if
+ * the platform cannot copy the hash state.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_sha1_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src);
 /**
  * @brief          This function calculates the SHA-224 or SHA-256
  *                 checksum of a buffer.
@@ -474,6 +539,119 @@ OPERATE_RET tal_sha1_mac_finish(tal_hash_mac_context_t *hmac_handle, uint8_t *ou
  */
 OPERATE_RET tal_sha1_mac(const uint8_t *key, size_t keylen, const uint8_t *input, size_t ilen, uint8_t *output);
 
+/**
+ * @brief This function precomputes the inner and outer hash state of an HMAC
+ *                 key.
+ *
+ * @param[out] hkey: HMAC key
+ * @param[in] type: TAL_HMAC_SHA256 or TAL_HMAC_SHA1
+ * @param[in] key: key
+ * @param[in] keylen: key length in Bytes
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_key_init(TAL_HMAC_KEY_T *hkey, TAL_HMAC_TYPE_E type, const uint8_t *key, size_t keylen);
+
+/**
+ * @brief This function clears an HMAC key.
+ *
+ * @param[in] hkey: HMAC key
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_key_free(TAL_HMAC_KEY_T *hkey);
+
+/**
+ * @brief This function Create&initializes an HMAC context bound to a key.
+ *
+ * @param[out] hmac: HMAC context
+ * @param[in] hkey: HMAC key, must stay valid while the context is used
+ *
+ * @note The context can be reused for any number of messages, each one started
+ * with tal_hmac_starts.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_create_init(TAL_HMAC_CTX_T *hmac, const TAL_HMAC_KEY_T *hkey);
+
+/**
+ * @brief This function clears an HMAC context.
+ *
+ * @param[in] hmac: HMAC context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_free(TAL_HMAC_CTX_T *hmac);
+
+/**
+ * @brief This function starts a new HMAC message from the precomputed key
+ *                 state.
+ *
+ * @param[in] hmac: HMAC context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_starts(TAL_HMAC_CTX_T *hmac);
+
+/**
+ * @brief This function feeds an input buffer into an ongoing HMAC
+ *                 calculation.
+ *
+ * @param[in] hmac: HMAC context
+ * @param[in] input: The buffer holding the data.
+ * @param[in] ilen: The length of the input data in Bytes.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_update(TAL_HMAC_CTX_T *hmac, const uint8_t *input, size_t ilen);
+
+/**
+ * @brief This function finishes the HMAC calculation and writes the result
+ *                 to the output buffer.
+ *
+ * @param[in] hmac: HMAC context
+ * @param[out] output: The HMAC result, 32 Bytes for SHA256, 20 Bytes for SHA1.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_finish(TAL_HMAC_CTX_T *hmac, uint8_t *output);
+
+/**
+ * @brief This function calculates the HMAC of a buffer with a precomputed
+ *                 key.
+ *
+ * @param[in] hkey: HMAC key
+ * @param[in] input: The buffer holding the data.
+ * @param[in] ilen: The length of the input data in Bytes.
+ * @param[out] output: The HMAC result, 32 Bytes for SHA256, 20 Bytes for SHA1.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac(const TAL_HMAC_KEY_T *hkey, const uint8_t *input, size_t ilen, uint8_t *output);
+
+/**
+ * @brief This function calculates the HMAC of several buffers with a
+ *                 precomputed key.
+ *
+ * @param[in] hkey: HMAC key
+ * @param[in,out] msgs: messages, the digest of each one is written to its output
+ * @param[in] count: count of msgs
+ *
+ * @note One hash context is used for all messages.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_multi(const TAL_HMAC_KEY_T *hkey, const TAL_HMAC_MSG_T *msgs, uint32_t count);
+
 /**
  * @brief Performs a self-test for the SHA256 algorithm.
  *
@@ -37,6 +37,31 @@ typedef enum {
     SYMMETRY_ENCRYPT = 1,
 } TAL_SYMMETRY_CRYPT_MODE;
 
+#define TAL_CIPHER_BLOCK_SIZE 16
+
+typedef enum {
+    TAL_CIPHER_AES_ECB = 0,
+    TAL_CIPHER_AES_CBC,
+    TAL_CIPHER_AES_CTR,
+} TAL_CIPHER_MODE_E;
+
+/**
+ * @brief keyed cipher context
+ *
+ * The key is expanded once in tal_cipher_setup and the context is reused for
+ * any number of messages, no memory is allocated per message. The fields are
+ * private to tal_symmetry.c.
+ */
+typedef struct {
+    TKL_SYMMETRY_HANDLE aes;
+    TAL_CIPHER_MODE_E mode;
+    TAL_SYMMETRY_CRYPT_MODE operation;
+    uint8_t padding;                      // PKCS7 padding on finish, ECB/CBC only
+    uint8_t iv[TAL_CIPHER_BLOCK_SIZE];    // CBC iv or CTR nonce counter
+    uint8_t block[TAL_CIPHER_BLOCK_SIZE]; // pending input (ECB/CBC) or stream block (CTR)
+    size_t block_len;                     // pending input length (ECB/CBC) or stream offset (CTR)
+} TAL_CIPHER_CTX_T;
+
 /**
  * @brief This function Create&initializes a aes context.
  *
@@ -176,6 +201,116 @@ OPERATE_RET tal_aes_crypt_cbc(TKL_SYMMETRY_HANDLE ctx, int32_t mode, size_t leng
 OPERATE_RET tal_aes_crypt_ctr(TKL_SYMMETRY_HANDLE ctx, size_t length, size_t *nc_off, uint8_t nonce_counter[16],
                               uint8_t stream_block[16], uint8_t *input, uint8_t *output);
 
+/**
+ * @brief Set up a keyed cipher context.
+ *
+ * @param[out] ctx: cipher context
+ * @param[in] mode: TAL_CIPHER_AES_ECB, TAL_CIPHER_AES_CBC or TAL_CIPHER_AES_CTR
+ * @param[in] operation: SYMMETRY_ENCRYPT or SYMMETRY_DECRYPT, ignored by CTR
+ * @param[in] key: AES key
+ * @param[in] keybits: key length in bits, 128, 192 or 256
+ *
+ * @note The key is expanded here once. Padding is off by default, see
+ * tal_cipher_set_padding.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_setup(TAL_CIPHER_CTX_T *ctx, TAL_CIPHER_MODE_E mode, TAL_SYMMETRY_CRYPT_MODE operation,
+                             const uint8_t *key, uint32_t keybits);
+
+/**
+ * @brief Enable or disable PKCS7 padding in tal_cipher_finish.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] enable: TRUE to add (encrypt) or strip and check (decrypt) PKCS7
+ * padding, only for ECB and CBC
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_set_padding(TAL_CIPHER_CTX_T *ctx, BOOL_T enable);
+
+/**
+ * @brief Start a new message on a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] iv: CBC iv or CTR nonce counter of 16 bytes, NULL for ECB
+ *
+ * @note Pending data of an unfinished message is dropped.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_reset(TAL_CIPHER_CTX_T *ctx, const uint8_t *iv);
+
+/**
+ * @brief Feed data into the message started by tal_cipher_reset.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] input: input data
+ * @param[in] ilen: input length, any length is accepted
+ * @param[out] output: output buffer, may be the same as input
+ * @param[out] olen: bytes written to output
+ *
+ * @note ECB and CBC only output full blocks and keep the rest until the next
+ * call, output must have room for ilen + TAL_CIPHER_BLOCK_SIZE bytes. CTR
+ * writes exactly ilen bytes. In-place operation (output == input) is allowed
+ * for all modes, partially overlapping buffers are not.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_update(TAL_CIPHER_CTX_T *ctx, const uint8_t *input, size_t ilen, uint8_t *output,
+                              size_t *olen);
+
+/**
+ * @brief Finish the current message.
+ *
+ * @param[in] ctx: cipher context
+ * @param[out] output: output buffer of at least TAL_CIPHER_BLOCK_SIZE bytes
+ * @param[out] olen: bytes written to output
+ *
+ * @note With padding enabled the encrypt side writes the padded last block
+ * and the decrypt side writes the last block without its padding. Without
+ * padding the message must be a multiple of the block size. CTR writes
+ * nothing.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_finish(TAL_CIPHER_CTX_T *ctx, uint8_t *output, size_t *olen);
+
+/**
+ * @brief Encrypt or decrypt a whole message with a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] iv: CBC iv or CTR nonce counter of 16 bytes, NULL for ECB
+ * @param[in] input: input data
+ * @param[in] ilen: input length
+ * @param[out] output: output buffer, may be the same as input
+ * @param[out] olen: bytes written to output
+ *
+ * @note Same as tal_cipher_reset, tal_cipher_update and tal_cipher_finish.
+ * With padding enabled output must have room for ilen + TAL_CIPHER_BLOCK_SIZE
+ * bytes on encryption.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_crypt(TAL_CIPHER_CTX_T *ctx, const uint8_t *iv, const uint8_t *input, size_t ilen,
+                             uint8_t *output, size_t *olen);
+
+/**
+ * @brief Release a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_free(TAL_CIPHER_CTX_T *ctx);
+
 /**
  * @brief Encodes data using AES-128 ECB mode.
  *
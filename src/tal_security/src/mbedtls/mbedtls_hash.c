@@ -132,6 +132,26 @@ OPERATE_RET tkl_sha256_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[32])
 
     return OPRT_OK;
 }
+
+/**
+ * @brief This function clones the state of a sha256 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha256.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_sha256_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src)
+{
+    if (dst == NULL || src == NULL)
+        return OPRT_INVALID_PARM;
+
+    mbedtls_sha256_clone((mbedtls_sha256_context *)dst, (const mbedtls_sha256_context *)src);
+
+    return OPRT_OK;
+}
 #endif
 
 #if !defined(ENABLE_PLATFORM_MD5)
@@ -346,4 +366,24 @@ OPERATE_RET tkl_sha1_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[20])
     return OPRT_OK;
 }
 
+/**
+ * @brief This function clones the state of a sha1 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha1.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_sha1_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src)
+{
+    if (dst == NULL || src == NULL)
+        return OPRT_INVALID_PARM;
+
+    mbedtls_sha1_clone((mbedtls_sha1_context *)dst, (const mbedtls_sha1_context *)src);
+
+    return OPRT_OK;
+}
+
 #endif
\ No newline at end of file
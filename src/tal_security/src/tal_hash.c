@@ -101,6 +101,27 @@ OPERATE_RET tal_sha256_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[32])
     return tkl_sha256_finish_ret(ctx, output);
 }
 
+/**
+ * @brief This function clones the state of a sha256 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha256.
+ *
+ * @return OPRT_OK on success. OPRT_NOT_SUPPORTED if the platform sha256
+ * has no clone. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tal_sha256_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src)
+{
+#if defined(ENABLE_PLATFORM_SHA256)
+    //! platform ports predate tkl_sha256_clone, callers fall back to restarting
+    return OPRT_NOT_SUPPORTED;
+#else
+    return tkl_sha256_clone(dst, src);
+#endif
+}
+
 /**
  * @brief This function Create&initializes a md5 context.
  *
@@ -267,6 +288,27 @@ OPERATE_RET tal_sha1_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[20])
     return tkl_sha1_finish_ret(ctx, output);
 }
 
+/**
+ * @brief This function clones the state of a sha1 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to clone sha1.
+ *
+ * @return OPRT_OK on success. OPRT_NOT_SUPPORTED if the platform sha1
+ * has no clone. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tal_sha1_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src)
+{
+#if defined(ENABLE_PLATFORM_SHA1)
+    //! platform ports predate tkl_sha1_clone, callers fall back to restarting
+    return OPRT_NOT_SUPPORTED;
+#else
+    return tkl_sha1_clone(dst, src);
+#endif
+}
+
 /**
  * @brief          This function calculates the SHA-224 or SHA-256
  *                 checksum of a buffer.
@@ -829,6 +871,351 @@ cleanup:
 
     return (ret);
 }
+typedef struct {
+    OPERATE_RET (*create_init)(TKL_HASH_HANDLE *ctx);
+    OPERATE_RET (*free)(TKL_HASH_HANDLE ctx);
+    OPERATE_RET (*starts)(TKL_HASH_HANDLE ctx);
+    OPERATE_RET (*update)(TKL_HASH_HANDLE ctx, const uint8_t *input, size_t ilen);
+    OPERATE_RET (*finish)(TKL_HASH_HANDLE ctx, uint8_t *output);
+    OPERATE_RET (*clone)(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src);
+    OPERATE_RET (*ret)(const uint8_t *input, size_t ilen, uint8_t *output);
+    size_t size;
+} HMAC_HASH_OPS_T;
+
+static OPERATE_RET __hmac_sha256_starts(TKL_HASH_HANDLE ctx)
+{
+    return tal_sha256_starts_ret(ctx, 0);
+}
+
+static OPERATE_RET __hmac_sha256_ret(const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    return tal_sha256_ret(input, ilen, output, 0);
+}
+
+static const HMAC_HASH_OPS_T s_hmac_ops[] = {
+    [TAL_HMAC_SHA256] = {tal_sha256_create_init, tal_sha256_free, __hmac_sha256_starts, tal_sha256_update_ret,
+                         tal_sha256_finish_ret, tal_sha256_clone, __hmac_sha256_ret, 32},
+    [TAL_HMAC_SHA1] = {tal_sha1_create_init, tal_sha1_free, tal_sha1_starts_ret, tal_sha1_update_ret,
+                       tal_sha1_finish_ret, tal_sha1_clone, tal_sha1_ret, 20},
+};
+
+/**
+ * @brief Continue ctx from a precomputed pad state, or restart and absorb the
+ * pad if the platform can't clone hash state.
+ */
+static OPERATE_RET __hmac_load(const HMAC_HASH_OPS_T *ops, TKL_HASH_HANDLE ctx, TKL_HASH_HANDLE state,
+                               const uint8_t *pad)
+{
+    OPERATE_RET ret;
+
+    if (state) {
+        return ops->clone(ctx, state);
+    }
+
+    if ((ret = ops->starts(ctx)) != OPRT_OK) {
+        return ret;
+    }
+
+    return ops->update(ctx, pad, 64);
+}
+
+/**
+ * @brief This function precomputes the inner and outer hash state of an HMAC
+ *                 key.
+ *
+ * @param[out] hkey: HMAC key
+ * @param[in] type: TAL_HMAC_SHA256 or TAL_HMAC_SHA1
+ * @param[in] key: key
+ * @param[in] keylen: key length in Bytes
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_key_init(TAL_HMAC_KEY_T *hkey, TAL_HMAC_TYPE_E type, const uint8_t *key, size_t keylen)
+{
+    OPERATE_RET ret;
+    const HMAC_HASH_OPS_T *ops;
+    uint8_t sum[32];
+    size_t i;
+
+    if (hkey == NULL || (key == NULL && keylen) || type > TAL_HMAC_SHA1) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(hkey, 0, sizeof(TAL_HMAC_KEY_T));
+    hkey->type = type;
+    ops = &s_hmac_ops[type];
+
+    if (keylen > 64) {
+        if ((ret = ops->ret(key, keylen, sum)) != OPRT_OK) {
+            goto exit;
+        }
+        keylen = ops->size;
+        key = sum;
+    }
+
+    memset(hkey->ipad, 0x36, sizeof(hkey->ipad));
+    memset(hkey->opad, 0x5C, sizeof(hkey->opad));
+
+    for (i = 0; i < keylen; i++) {
+        hkey->ipad[i] = (uint8_t)(hkey->ipad[i] ^ key[i]);
+        hkey->opad[i] = (uint8_t)(hkey->opad[i] ^ key[i]);
+    }
+
+    if ((ret = ops->create_init(&hkey->inner)) != OPRT_OK) {
+        hkey->inner = NULL;
+        goto exit;
+    }
+    if ((ret = ops->create_init(&hkey->outer)) != OPRT_OK) {
+        hkey->outer = NULL;
+        goto exit;
+    }
+
+    if ((ret = ops->starts(hkey->inner)) != OPRT_OK || (ret = ops->update(hkey->inner, hkey->ipad, 64)) != OPRT_OK) {
+        goto exit;
+    }
+
+    // probe whether the platform can clone hash state, if not every message
+    // restarts from the pads instead
+    ret = ops->clone(hkey->outer, hkey->inner);
+    if (OPRT_NOT_SUPPORTED == ret) {
+        ops->free(hkey->inner);
+        ops->free(hkey->outer);
+        hkey->inner = NULL;
+        hkey->outer = NULL;
+        ret = OPRT_OK;
+        goto exit;
+    } else if (ret != OPRT_OK) {
+        goto exit;
+    }
+
+    if ((ret = ops->starts(hkey->outer)) != OPRT_OK || (ret = ops->update(hkey->outer, hkey->opad, 64)) != OPRT_OK) {
+        goto exit;
+    }
+
+exit:
+    memset(sum, 0, sizeof(sum));
+    if (ret != OPRT_OK) {
+        tal_hmac_key_free(hkey);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief This function clears an HMAC key.
+ *
+ * @param[in] hkey: HMAC key
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_key_free(TAL_HMAC_KEY_T *hkey)
+{
+    const HMAC_HASH_OPS_T *ops;
+
+    if (hkey == NULL || hkey->type > TAL_HMAC_SHA1) {
+        return OPRT_INVALID_PARM;
+    }
+
+    ops = &s_hmac_ops[hkey->type];
+    if (hkey->inner) {
+        ops->free(hkey->inner);
+    }
+    if (hkey->outer) {
+        ops->free(hkey->outer);
+    }
+    memset(hkey, 0, sizeof(TAL_HMAC_KEY_T));
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief This function Create&initializes an HMAC context bound to a key.
+ *
+ * @param[out] hmac: HMAC context
+ * @param[in] hkey: HMAC key, must stay valid while the context is used
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_create_init(TAL_HMAC_CTX_T *hmac, const TAL_HMAC_KEY_T *hkey)
+{
+    if (hmac == NULL || hkey == NULL || hkey->type > TAL_HMAC_SHA1) {
+        return OPRT_INVALID_PARM;
+    }
+
+    hmac->key = hkey;
+    hmac->ctx = NULL;
+
+    return s_hmac_ops[hkey->type].create_init(&hmac->ctx);
+}
+
+/**
+ * @brief This function clears an HMAC context.
+ *
+ * @param[in] hmac: HMAC context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_free(TAL_HMAC_CTX_T *hmac)
+{
+    OPERATE_RET ret = OPRT_OK;
+
+    if (hmac == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (hmac->key && hmac->ctx) {
+        ret = s_hmac_ops[hmac->key->type].free(hmac->ctx);
+    }
+    memset(hmac, 0, sizeof(TAL_HMAC_CTX_T));
+
+    return ret;
+}
+
+/**
+ * @brief This function starts a new HMAC message from the precomputed key
+ *                 state.
+ *
+ * @param[in] hmac: HMAC context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_starts(TAL_HMAC_CTX_T *hmac)
+{
+    if (hmac == NULL || hmac->key == NULL || hmac->ctx == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return __hmac_load(&s_hmac_ops[hmac->key->type], hmac->ctx, hmac->key->inner, hmac->key->ipad);
+}
+
+/**
+ * @brief This function feeds an input buffer into an ongoing HMAC
+ *                 calculation.
+ *
+ * @param[in] hmac: HMAC context
+ * @param[in] input: The buffer holding the data.
+ * @param[in] ilen: The length of the input data in Bytes.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_update(TAL_HMAC_CTX_T *hmac, const uint8_t *input, size_t ilen)
+{
+    if (hmac == NULL || hmac->key == NULL || hmac->ctx == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return s_hmac_ops[hmac->key->type].update(hmac->ctx, input, ilen);
+}
+
+/**
+ * @brief This function finishes the HMAC calculation and writes the result
+ *                 to the output buffer.
+ *
+ * @param[in] hmac: HMAC context
+ * @param[out] output: The HMAC result, 32 Bytes for SHA256, 20 Bytes for SHA1.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_finish(TAL_HMAC_CTX_T *hmac, uint8_t *output)
+{
+    OPERATE_RET ret;
+    const HMAC_HASH_OPS_T *ops;
+    uint8_t tmp[32];
+
+    if (hmac == NULL || hmac->key == NULL || hmac->ctx == NULL || output == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    ops = &s_hmac_ops[hmac->key->type];
+
+    if ((ret = ops->finish(hmac->ctx, tmp)) != OPRT_OK) {
+        goto exit;
+    }
+
+    if ((ret = __hmac_load(ops, hmac->ctx, hmac->key->outer, hmac->key->opad)) != OPRT_OK) {
+        goto exit;
+    }
+
+    if ((ret = ops->update(hmac->ctx, tmp, ops->size)) != OPRT_OK) {
+        goto exit;
+    }
+
+    ret = ops->finish(hmac->ctx, output);
+
+exit:
+    memset(tmp, 0, sizeof(tmp));
+
+    return ret;
+}
+
+/**
+ * @brief This function calculates the HMAC of a buffer with a precomputed
+ *                 key.
+ *
+ * @param[in] hkey: HMAC key
+ * @param[in] input: The buffer holding the data.
+ * @param[in] ilen: The length of the input data in Bytes.
+ * @param[out] output: The HMAC result, 32 Bytes for SHA256, 20 Bytes for SHA1.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac(const TAL_HMAC_KEY_T *hkey, const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    TAL_HMAC_MSG_T msg = {.input = input, .ilen = ilen, .output = output};
+
+    return tal_hmac_multi(hkey, &msg, 1);
+}
+
+/**
+ * @brief This function calculates the HMAC of several buffers with a
+ *                 precomputed key.
+ *
+ * @param[in] hkey: HMAC key
+ * @param[in,out] msgs: messages, the digest of each one is written to its output
+ * @param[in] count: count of msgs
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_hmac_multi(const TAL_HMAC_KEY_T *hkey, const TAL_HMAC_MSG_T *msgs, uint32_t count)
+{
+    OPERATE_RET ret;
+    TAL_HMAC_CTX_T hmac;
+    uint32_t i;
+
+    if (msgs == NULL && count) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if ((ret = tal_hmac_create_init(&hmac, hkey)) != OPRT_OK) {
+        return ret;
+    }
+
+    for (i = 0; i < count; i++) {
+        if ((ret = tal_hmac_starts(&hmac)) != OPRT_OK) {
+            break;
+        }
+        if ((ret = tal_hmac_update(&hmac, msgs[i].input, msgs[i].ilen)) != OPRT_OK) {
+            break;
+        }
+        if ((ret = tal_hmac_finish(&hmac, msgs[i].output)) != OPRT_OK) {
+            break;
+        }
+    }
+
+    tal_hmac_free(&hmac);
+
+    return ret;
+}
+
 #if defined(ENABLE_TAL_SECURITY_SELF_TEST)
 /*
  * FIPS-180-2 test vectors
@@ -1165,6 +1552,7 @@ OPERATE_RET tal_sha256_mac_self_test(int32_t verbose)
     OPERATE_RET ret = OPRT_OK;
     uint8_t sha256_mac[32];
     uint32_t len;
+    TAL_HMAC_KEY_T hkey;
 
     for (i = 0; i < 7; i++) {
         if (verbose != 0) {
@@ -1186,6 +1574,20 @@ OPERATE_RET tal_sha256_mac_self_test(int32_t verbose)
             goto fail;
         }
 
+        ret = tal_hmac_key_init(&hkey, TAL_HMAC_SHA256, sha256_mac_test_key[i], sha256_mac_test_keylen[i]);
+        if (ret != 0) {
+            goto fail;
+        }
+        ret = tal_hmac(&hkey, sha256_mac_test_buf[i], sha256_mac_test_buflen[i], sha256_mac);
+        tal_hmac_key_free(&hkey);
+        if (ret != 0) {
+            goto fail;
+        }
+        if (memcmp(sha256_mac, sha256_mac_test_sum[i], len) != 0) {
+            ret = 1;
+            goto fail;
+        }
+
         if (verbose != 0) {
             PR_DEBUG("passed\n");
         }
@@ -1274,6 +1676,7 @@ OPERATE_RET tal_sha1_mac_self_test(int32_t verbose)
     OPERATE_RET ret = OPRT_OK;
     uint8_t sha1_mac[20];
     uint32_t len;
+    TAL_HMAC_KEY_T hkey;
 
     for (i = 0; i < 7; i++) {
         if (verbose != 0) {
@@ -1294,6 +1697,20 @@ OPERATE_RET tal_sha1_mac_self_test(int32_t verbose)
             goto fail;
         }
 
+        ret = tal_hmac_key_init(&hkey, TAL_HMAC_SHA1, sha1_mac_test_key[i], sha1_mac_test_keylen[i]);
+        if (ret != 0) {
+            goto fail;
+        }
+        ret = tal_hmac(&hkey, sha1_mac_test_buf[i], sha1_mac_test_buflen[i], sha1_mac);
+        tal_hmac_key_free(&hkey);
+        if (ret != 0) {
+            goto fail;
+        }
+        if (memcmp(sha1_mac, sha1_mac_test_sum[i], len) != 0) {
+            ret = 1;
+            goto fail;
+        }
+
         if (verbose != 0) {
             PR_DEBUG("passed\n");
         }
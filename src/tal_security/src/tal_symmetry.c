@@ -729,6 +729,326 @@ OPERATE_RET tal_aes_free_data(uint8_t *data)
     return OPRT_OK;
 }
 
+static OPERATE_RET __cipher_blocks(TAL_CIPHER_CTX_T *ctx, size_t length, uint8_t *input, uint8_t *output)
+{
+    if (TAL_CIPHER_AES_CBC == ctx->mode) {
+        return tal_aes_crypt_cbc(ctx->aes, ctx->operation, length, ctx->iv, input, output);
+    }
+
+    return tal_aes_crypt_ecb(ctx->aes, ctx->operation, length, input, output);
+}
+
+/**
+ * @brief Set up a keyed cipher context.
+ *
+ * @param[out] ctx: cipher context
+ * @param[in] mode: TAL_CIPHER_AES_ECB, TAL_CIPHER_AES_CBC or TAL_CIPHER_AES_CTR
+ * @param[in] operation: SYMMETRY_ENCRYPT or SYMMETRY_DECRYPT, ignored by CTR
+ * @param[in] key: AES key
+ * @param[in] keybits: key length in bits, 128, 192 or 256
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_setup(TAL_CIPHER_CTX_T *ctx, TAL_CIPHER_MODE_E mode, TAL_SYMMETRY_CRYPT_MODE operation,
+                             const uint8_t *key, uint32_t keybits)
+{
+    OPERATE_RET ret;
+
+    if (NULL == ctx || NULL == key || mode > TAL_CIPHER_AES_CTR) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(ctx, 0, sizeof(TAL_CIPHER_CTX_T));
+    ctx->mode = mode;
+    // CTR only runs the block cipher forward
+    ctx->operation = (TAL_CIPHER_AES_CTR == mode) ? SYMMETRY_ENCRYPT : operation;
+
+    if ((ret = tal_aes_create_init(&ctx->aes)) != OPRT_OK) {
+        ctx->aes = NULL;
+        return ret;
+    }
+
+    if (SYMMETRY_ENCRYPT == ctx->operation) {
+        ret = tal_aes_setkey_enc(ctx->aes, (uint8_t *)key, keybits);
+    } else {
+        ret = tal_aes_setkey_dec(ctx->aes, (uint8_t *)key, keybits);
+    }
+    if (ret != OPRT_OK) {
+        tal_aes_free(ctx->aes);
+        ctx->aes = NULL;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Enable or disable PKCS7 padding in tal_cipher_finish.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] enable: TRUE to use PKCS7 padding, only for ECB and CBC
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_set_padding(TAL_CIPHER_CTX_T *ctx, BOOL_T enable)
+{
+    if (NULL == ctx || (enable && TAL_CIPHER_AES_CTR == ctx->mode)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    ctx->padding = enable ? 1 : 0;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Start a new message on a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] iv: CBC iv or CTR nonce counter of 16 bytes, NULL for ECB
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_reset(TAL_CIPHER_CTX_T *ctx, const uint8_t *iv)
+{
+    if (NULL == ctx || NULL == ctx->aes || (NULL == iv && TAL_CIPHER_AES_ECB != ctx->mode)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (iv) {
+        memcpy(ctx->iv, iv, TAL_CIPHER_BLOCK_SIZE);
+    }
+    memset(ctx->block, 0, TAL_CIPHER_BLOCK_SIZE);
+    ctx->block_len = 0;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Feed data into the message started by tal_cipher_reset.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] input: input data
+ * @param[in] ilen: input length
+ * @param[out] output: output buffer, may be the same as input
+ * @param[out] olen: bytes written to output
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_update(TAL_CIPHER_CTX_T *ctx, const uint8_t *input, size_t ilen, uint8_t *output,
+                              size_t *olen)
+{
+    OPERATE_RET ret;
+    uint8_t tmp[TAL_CIPHER_BLOCK_SIZE];
+    size_t hold, lag, n;
+
+    if (NULL == ctx || NULL == ctx->aes || (NULL == input && ilen) || NULL == output || NULL == olen) {
+        return OPRT_INVALID_PARM;
+    }
+
+    *olen = 0;
+
+    if (TAL_CIPHER_AES_CTR == ctx->mode) {
+        ret = tal_aes_crypt_ctr(ctx->aes, ilen, &ctx->block_len, ctx->iv, ctx->block, (uint8_t *)input, output);
+        if (OPRT_OK == ret) {
+            *olen = ilen;
+        }
+        return ret;
+    }
+
+    // decryption with padding keeps the last full block for tal_cipher_finish
+    hold = (ctx->padding && SYMMETRY_DECRYPT == ctx->operation) ? 1 : 0;
+
+    if (0 == ctx->block_len) {
+        n = ilen & ~(size_t)(TAL_CIPHER_BLOCK_SIZE - 1);
+        if (hold && n && n == ilen) {
+            n -= TAL_CIPHER_BLOCK_SIZE;
+        }
+        if (n) {
+            if ((ret = __cipher_blocks(ctx, n, (uint8_t *)input, output)) != OPRT_OK) {
+                return ret;
+            }
+            input += n;
+            ilen -= n;
+            *olen = n;
+        }
+        memcpy(ctx->block, input, ilen);
+        ctx->block_len = ilen;
+        return OPRT_OK;
+    }
+
+    // The pending bytes delay the output by lag bytes. Read the next lag bytes
+    // of input before a block is written out, so in-place output never
+    // overwrites input that has not been read yet.
+    lag = ctx->block_len;
+    while (ctx->block_len + ilen >= TAL_CIPHER_BLOCK_SIZE + hold) {
+        n = TAL_CIPHER_BLOCK_SIZE - ctx->block_len;
+        memcpy(ctx->block + ctx->block_len, input, n);
+        input += n;
+        ilen -= n;
+
+        if ((ret = __cipher_blocks(ctx, TAL_CIPHER_BLOCK_SIZE, ctx->block, tmp)) != OPRT_OK) {
+            return ret;
+        }
+
+        n = (ilen < lag) ? ilen : lag;
+        memcpy(ctx->block, input, n);
+        input += n;
+        ilen -= n;
+        ctx->block_len = n;
+
+        memcpy(output + *olen, tmp, TAL_CIPHER_BLOCK_SIZE);
+        *olen += TAL_CIPHER_BLOCK_SIZE;
+    }
+
+    memcpy(ctx->block + ctx->block_len, input, ilen);
+    ctx->block_len += ilen;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Finish the current message.
+ *
+ * @param[in] ctx: cipher context
+ * @param[out] output: output buffer of at least TAL_CIPHER_BLOCK_SIZE bytes
+ * @param[out] olen: bytes written to output
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_finish(TAL_CIPHER_CTX_T *ctx, uint8_t *output, size_t *olen)
+{
+    OPERATE_RET ret = OPRT_OK;
+    uint8_t pad, i;
+
+    if (NULL == ctx || NULL == ctx->aes || NULL == output || NULL == olen) {
+        return OPRT_INVALID_PARM;
+    }
+
+    *olen = 0;
+
+    if (TAL_CIPHER_AES_CTR == ctx->mode) {
+        return OPRT_OK;
+    }
+
+    if (!ctx->padding) {
+        if (ctx->block_len) {
+            PR_ERR("cipher input not block aligned");
+            ret = OPRT_INVALID_PARM;
+        }
+        goto exit;
+    }
+
+    if (SYMMETRY_ENCRYPT == ctx->operation) {
+        add_pkcs_padding(ctx->block, TAL_CIPHER_BLOCK_SIZE, ctx->block_len);
+        if ((ret = __cipher_blocks(ctx, TAL_CIPHER_BLOCK_SIZE, ctx->block, output)) == OPRT_OK) {
+            *olen = TAL_CIPHER_BLOCK_SIZE;
+        }
+        goto exit;
+    }
+
+    if (TAL_CIPHER_BLOCK_SIZE != ctx->block_len) {
+        PR_ERR("cipher input not block aligned");
+        ret = OPRT_INVALID_PARM;
+        goto exit;
+    }
+
+    if ((ret = __cipher_blocks(ctx, TAL_CIPHER_BLOCK_SIZE, ctx->block, ctx->block)) != OPRT_OK) {
+        goto exit;
+    }
+
+    pad = ctx->block[TAL_CIPHER_BLOCK_SIZE - 1];
+    if (0 == pad || pad > TAL_CIPHER_BLOCK_SIZE) {
+        ret = OPRT_COM_ERROR;
+        goto exit;
+    }
+    for (i = TAL_CIPHER_BLOCK_SIZE - pad; i < TAL_CIPHER_BLOCK_SIZE; i++) {
+        if (ctx->block[i] != pad) {
+            ret = OPRT_COM_ERROR;
+            goto exit;
+        }
+    }
+
+    memcpy(output, ctx->block, TAL_CIPHER_BLOCK_SIZE - pad);
+    *olen = TAL_CIPHER_BLOCK_SIZE - pad;
+
+exit:
+    memset(ctx->block, 0, TAL_CIPHER_BLOCK_SIZE);
+    ctx->block_len = 0;
+
+    return ret;
+}
+
+/**
+ * @brief Encrypt or decrypt a whole message with a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ * @param[in] iv: CBC iv or CTR nonce counter of 16 bytes, NULL for ECB
+ * @param[in] input: input data
+ * @param[in] ilen: input length
+ * @param[out] output: output buffer, may be the same as input
+ * @param[out] olen: bytes written to output
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_crypt(TAL_CIPHER_CTX_T *ctx, const uint8_t *iv, const uint8_t *input, size_t ilen,
+                             uint8_t *output, size_t *olen)
+{
+    OPERATE_RET ret;
+    size_t len, fin_len;
+
+    if (NULL == olen) {
+        return OPRT_INVALID_PARM;
+    }
+
+    *olen = 0;
+
+    if ((ret = tal_cipher_reset(ctx, iv)) != OPRT_OK) {
+        return ret;
+    }
+
+    if ((ret = tal_cipher_update(ctx, input, ilen, output, &len)) != OPRT_OK) {
+        return ret;
+    }
+
+    if ((ret = tal_cipher_finish(ctx, output + len, &fin_len)) != OPRT_OK) {
+        return ret;
+    }
+
+    *olen = len + fin_len;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Release a keyed cipher context.
+ *
+ * @param[in] ctx: cipher context
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_cipher_free(TAL_CIPHER_CTX_T *ctx)
+{
+    OPERATE_RET ret = OPRT_OK;
+
+    if (NULL == ctx) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (ctx->aes) {
+        ret = tal_aes_free(ctx->aes);
+    }
+    memset(ctx, 0, sizeof(TAL_CIPHER_CTX_T));
+
+    return ret;
+}
+
 #if defined(ENABLE_TAL_SECURITY_SELF_TEST)
 /*
  * AES test vectors from:
@@ -237,6 +237,30 @@ BOOL_T tal_time_is_in_sum_zone(TIME_T time);
  */
 OPERATE_RET tal_time_get_local_time_custom(TIME_T in_time, POSIX_TM_S *tm);
 
+/**
+ * @brief get IoTOS local time now (local, contains the time zone and summer
+ * time zone)
+ *
+ * @param[out] tm the local time in posix format
+ * @param[out] ms the millisecond part of the local time, can be NULL
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ *
+ * @note the broken-down date and the time zone offset are cached, only the
+ * time of day is calculated per call
+ */
+OPERATE_RET tal_time_get_local_now(POSIX_TM_S *tm, uint32_t *ms);
+
+/**
+ * @brief get IoTOS local time now as "MM-DD hh:mm:ss" or "MM-DD hh:mm:ss.mmm"
+ *
+ * @param[out] buf the string buffer
+ * @param[in] len the size of buf, at least 15, or 19 with ms
+ * @param[in] with_ms append the milliseconds
+ * @return the length of the string, < 0 on error
+ */
+int tal_time_get_local_now_str(char *buf, uint32_t len, BOOL_T with_ms);
+
 /**
  * @brief get sum zone info
  *
@@ -410,23 +410,10 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
         len += cnt;
     }
 
-    POSIX_TM_S tm;
-    memset(&tm, 0, sizeof(tm));
-
-    if (pLogManage->ms_level == FALSE) {
-        tal_time_get_local_time_custom(0, &tm);
-        cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len,
-                       "[%02d-%02d %02d:%02d:%02d %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
-                       tm.tm_min, tm.tm_sec, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
-    } else {
-        SYS_TICK_T time_ms = tal_time_get_posix_ms();
-        TIME_T sec = (TIME_T)(time_ms / 1000);
-        uint32_t ms = (uint32_t)(time_ms % 1000);
-        tal_time_get_local_time_custom(sec, &tm);
-        cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len,
-                       "[%02d-%02d %02d:%02d:%02d:%" PRIu32 " %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1, tm.tm_mday,
-                       tm.tm_hour, tm.tm_min, tm.tm_sec, ms, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
-    }
+    char time_str[20];
+    tal_time_get_local_now_str(time_str, sizeof(time_str), pLogManage->ms_level);
+    cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "[%s %s %s][%s:%" PRIu32 "] ", time_str,
+                   pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
     if (cnt <= 0) {
         goto ERR_EXIT;
     }
@@ -61,6 +61,23 @@ static BOOL_T s_time_cloud_sync = FALSE;
 static TIME_T s_time_cloud_posix = 0;
 static BOOL_T s_time_disable_update = FALSE;
 
+/*
+ * Local time cache. offset (time zone and summer time) is valid while the UTC
+ * time stays in [offset_from, offset_until], day_tm is the broken-down date of
+ * the local day starting at day_start. Both are only recalculated when the
+ * time leaves the cached range, so getting the local time is O(1) for the
+ * rest of the day.
+ */
+static struct {
+    BOOL_T offset_valid;
+    int offset;
+    TIME_T offset_from;
+    TIME_T offset_until;
+    BOOL_T day_valid;
+    TIME_T day_start;
+    POSIX_TM_S day_tm;
+} s_time_local;
+
 /***********************************************************
 *************************function define********************
 ***********************************************************/
@@ -214,6 +231,75 @@ static OPERATE_RET __get_time_zone(const char *time_zone, int *posix)
     return OPRT_OK;
 }
 
+/**
+ * @brief Drops the cached local time offset, called when the time zone or the
+ * summer time table changes.
+ */
+static void __local_offset_reset(void)
+{
+    tal_mutex_lock(s_time_mutex);
+    s_time_local.offset_valid = FALSE;
+    tal_mutex_unlock(s_time_mutex);
+}
+
+/**
+ * @brief Calculates the local time offset for the UTC time and the range of
+ * UTC time it stays valid for, s_time_mutex must be held.
+ *
+ * @param now The current UTC time.
+ */
+static void __local_offset_update(TIME_T now)
+{
+    uint32_t i = 0;
+    BOOL_T in_sum_zone = FALSE;
+    TIME_T from = 0;
+    TIME_T until = (TIME_T)-1;
+
+    for (i = 0; i < s_time_sz_tbl.cnt; i++) {
+        const SUM_ZONE_S *zone = &s_time_sz_tbl.zone[i];
+        if ((now >= zone->posix_min) && (now <= zone->posix_max)) {
+            in_sum_zone = TRUE;
+            from = (zone->posix_min > from) ? zone->posix_min : from;
+            until = (zone->posix_max < until) ? zone->posix_max : until;
+        } else if (zone->posix_min > now) {
+            until = (zone->posix_min - 1 < until) ? zone->posix_min - 1 : until;
+        } else {
+            from = (zone->posix_max + 1 > from) ? zone->posix_max + 1 : from;
+        }
+    }
+
+    s_time_local.offset = s_time_tz + (in_sum_zone ? SEC_PER_HOUR : 0);
+    s_time_local.offset_from = from;
+    s_time_local.offset_until = until;
+    s_time_local.offset_valid = TRUE;
+}
+
+/**
+ * @brief Converts a local time to posix format with the cached local day,
+ * s_time_mutex must be held.
+ *
+ * @param local_time The local time.
+ * @param tm The local time in posix format.
+ */
+static void __local_tm_get(TIME_T local_time, POSIX_TM_S *tm)
+{
+    TIME_T sec = 0;
+
+    if (!s_time_local.day_valid || (local_time < s_time_local.day_start) ||
+        (local_time - s_time_local.day_start >= SEC_PER_DAY)) {
+        s_time_local.day_start = local_time - local_time % SEC_PER_DAY;
+        tal_time_gmtime_r(&s_time_local.day_start, &s_time_local.day_tm);
+        s_time_local.day_valid = TRUE;
+    }
+
+    sec = local_time - s_time_local.day_start;
+    *tm = s_time_local.day_tm;
+    tm->tm_hour = sec / SEC_PER_HOUR;
+    sec = sec % SEC_PER_HOUR;
+    tm->tm_min = sec / 60;
+    tm->tm_sec = sec % 60;
+}
+
 /**
  * @brief time-management module initialization
  *
@@ -235,6 +321,7 @@ OPERATE_RET tal_time_service_init(void)
     s_time_cloud_posix = 0;
     s_time_last_ms = tal_system_get_millisecond();
     memset(&s_time_sz_tbl, 0, sizeof(s_time_sz_tbl));
+    memset(&s_time_local, 0, sizeof(s_time_local));
 
     return OPRT_OK;
 }
@@ -431,15 +518,12 @@ OPERATE_RET tal_time_check_time_zone_sync(void)
 }
 
 /**
- * @brief get IoTOS UTC time in TIME_T format
+ * @brief get IoTOS UTC time in milliseconds, s_time_mutex must be held
  *
- * @return the current second time in TIME_T format
+ * @return the current millisecond time
  */
-TIME_T tal_time_get_posix(void)
+static SYS_TICK_T __get_posix_ms(void)
 {
-    TIME_T tmp_cur_posix_time = 0;
-
-    tal_mutex_lock(s_time_mutex);
     SYS_TIME_T curr_time_ms = tal_system_get_millisecond();
 
     if (s_time_last_ms > curr_time_ms) { // recycle
@@ -447,8 +531,20 @@ TIME_T tal_time_get_posix(void)
         s_time_last_ms = 0;
     }
 
-    tmp_cur_posix_time = s_time_cloud_posix;
-    tmp_cur_posix_time += (curr_time_ms - s_time_last_ms) / 1000;
+    return (SYS_TICK_T)s_time_cloud_posix * 1000 + (curr_time_ms - s_time_last_ms);
+}
+
+/**
+ * @brief get IoTOS UTC time in TIME_T format
+ *
+ * @return the current second time in TIME_T format
+ */
+TIME_T tal_time_get_posix(void)
+{
+    TIME_T tmp_cur_posix_time = 0;
+
+    tal_mutex_lock(s_time_mutex);
+    tmp_cur_posix_time = (TIME_T)(__get_posix_ms() / 1000);
     tal_mutex_unlock(s_time_mutex);
 
     return tmp_cur_posix_time;
@@ -461,18 +557,10 @@ TIME_T tal_time_get_posix(void)
  */
 SYS_TICK_T tal_time_get_posix_ms(void)
 {
-    SYS_TIME_T tmp_cur_posix_time_ms = 0;
+    SYS_TICK_T tmp_cur_posix_time_ms = 0;
 
     tal_mutex_lock(s_time_mutex);
-    SYS_TIME_T curr_time_ms = tal_system_get_millisecond();
-
-    if (s_time_last_ms > curr_time_ms) { // recycle
-        s_time_cloud_posix += ((0x100000000 - s_time_last_ms) / 1000);
-        s_time_last_ms = 0;
-    }
-
-    tmp_cur_posix_time_ms = (SYS_TICK_T)s_time_cloud_posix * 1000;
-    tmp_cur_posix_time_ms += (curr_time_ms - s_time_last_ms);
+    tmp_cur_posix_time_ms = __get_posix_ms();
     tal_mutex_unlock(s_time_mutex);
 
     return tmp_cur_posix_time_ms;
@@ -523,6 +611,7 @@ OPERATE_RET tal_time_set_time_zone(const char *time_zone)
         return op_ret;
     }
     s_time_tz_sync = TRUE;
+    __local_offset_reset();
 
     return OPRT_OK;
 }
@@ -551,6 +640,7 @@ OPERATE_RET tal_time_set_time_zone_seconds(int time_zone_sec)
 {
     s_time_tz = time_zone_sec;
     s_time_tz_sync = TRUE;
+    __local_offset_reset();
     return OPRT_OK;
 }
 
@@ -572,24 +662,97 @@ OPERATE_RET tal_time_get_local_time_custom(TIME_T in_time, POSIX_TM_S *tm)
         return OPRT_INVALID_PARM;
     }
 
-    TIME_T local_time = 0;
-    if (in_time == 0) {
-        local_time = tal_time_get_posix() + s_time_tz;
-    } else {
-        local_time = in_time + s_time_tz;
+    tal_mutex_lock(s_time_mutex);
+    TIME_T now = (TIME_T)(__get_posix_ms() / 1000);
+    if (!s_time_local.offset_valid || (now < s_time_local.offset_from) || (now > s_time_local.offset_until)) {
+        __local_offset_update(now);
     }
 
-    if (TRUE == __is_in_sum_zone()) {
-        local_time += SEC_PER_HOUR;
+    __local_tm_get(((in_time == 0) ? now : in_time) + s_time_local.offset, tm);
+    tal_mutex_unlock(s_time_mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief get IoTOS local time now (local, contains the time zone and summer
+ * time zone)
+ *
+ * @param[out] tm the local time in posix format
+ * @param[out] ms the millisecond part of the local time, can be NULL
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_time_get_local_now(POSIX_TM_S *tm, uint32_t *ms)
+{
+    if (NULL == tm) {
+        return OPRT_INVALID_PARM;
     }
 
-    if (tal_time_gmtime_r((const TIME_T *)&local_time, tm) == NULL) {
-        return OPRT_COM_ERROR;
+    tal_mutex_lock(s_time_mutex);
+    SYS_TICK_T now_ms = __get_posix_ms();
+    TIME_T now = (TIME_T)(now_ms / 1000);
+    if (!s_time_local.offset_valid || (now < s_time_local.offset_from) || (now > s_time_local.offset_until)) {
+        __local_offset_update(now);
+    }
+
+    __local_tm_get(now + s_time_local.offset, tm);
+    tal_mutex_unlock(s_time_mutex);
+
+    if (ms) {
+        *ms = (uint32_t)(now_ms % 1000);
     }
 
     return OPRT_OK;
 }
 
+static char *__put_2digits(char *p, int val)
+{
+    *p++ = '0' + (val / 10) % 10;
+    *p++ = '0' + val % 10;
+
+    return p;
+}
+
+/**
+ * @brief get IoTOS local time now as "MM-DD hh:mm:ss" or "MM-DD hh:mm:ss.mmm"
+ *
+ * @param[out] buf the string buffer
+ * @param[in] len the size of buf, at least 15, or 19 with ms
+ * @param[in] with_ms append the milliseconds
+ * @return the length of the string, < 0 on error
+ */
+int tal_time_get_local_now_str(char *buf, uint32_t len, BOOL_T with_ms)
+{
+    POSIX_TM_S tm;
+    uint32_t ms = 0;
+
+    if ((NULL == buf) || (len < (with_ms ? 19 : 15))) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_time_get_local_now(&tm, &ms);
+
+    char *p = buf;
+    p = __put_2digits(p, tm.tm_mon + 1);
+    *p++ = '-';
+    p = __put_2digits(p, tm.tm_mday);
+    *p++ = ' ';
+    p = __put_2digits(p, tm.tm_hour);
+    *p++ = ':';
+    p = __put_2digits(p, tm.tm_min);
+    *p++ = ':';
+    p = __put_2digits(p, tm.tm_sec);
+    if (with_ms) {
+        *p++ = '.';
+        *p++ = '0' + ms / 100;
+        p = __put_2digits(p, ms % 100);
+    }
+    *p = 0;
+
+    return p - buf;
+}
+
 /**
  * @brief set IoTOS summer time zone
  *
@@ -602,6 +765,7 @@ void tal_time_set_sum_zone_tbl(const SUM_ZONE_S *zone, const uint32_t cnt)
 {
     if (NULL == zone || 0 == cnt) {
         s_time_sz_tbl.cnt = 0;
+        __local_offset_reset();
         return;
     }
 
@@ -612,6 +776,7 @@ void tal_time_set_sum_zone_tbl(const SUM_ZONE_S *zone, const uint32_t cnt)
     }
 
     memcpy(s_time_sz_tbl.zone, zone, sizeof(SUM_ZONE_S) * s_time_sz_tbl.cnt);
+    s_time_local.offset_valid = FALSE;
 
     tal_mutex_unlock(s_time_mutex);
     return;
@@ -24,7 +24,7 @@
 #include "ble_trsmitr.h"
 #include "ble_cryption.h"
 #include "tal_bluetooth.h"
-#include "crc_16.h"
+#include "tuya_crc.h"
 #include "uni_random.h"
 
 /** GAP - scan response data (max size = 31 bytes) */
@@ -301,7 +301,7 @@ static int ble_packet_recv(tuya_ble_mgr_t *ble, uint8_t *buf, uint16_t len, ble_
     uint16_t our_crc = 0;
     our_crc = packet_recv->dec_buf[BLE_PACKET_CRC16_IND + data_len] << 8;
     our_crc += packet_recv->dec_buf[BLE_PACKET_CRC16_IND + data_len + 1];
-    uint16_t his_crc = get_crc_16(packet_recv->dec_buf, data_len + BLE_PACKET_DATA_IND);
+    uint16_t his_crc = tuya_crc16(packet_recv->dec_buf, data_len + BLE_PACKET_DATA_IND);
     if (our_crc != his_crc) {
         PR_ERR("ble packet crc err:0x%04x, 0x%04x", our_crc, his_crc);
         return OPRT_INVALID_PARM;
@@ -525,7 +525,7 @@ static int ble_packet_encode(tuya_ble_mgr_t *ble, ble_packet_t *packet, uint8_t
     }
     //! CRC16 offset(12) + app_data->len
     frame_len += packet->len;
-    uint16_t crc16 = get_crc_16(ble_frame, frame_len);
+    uint16_t crc16 = tuya_crc16(ble_frame, frame_len);
     ble_frame[frame_len++] = crc16 >> 8;
     ble_frame[frame_len++] = crc16;
     //! flag + iv = 17
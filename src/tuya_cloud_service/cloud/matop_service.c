@@ -15,10 +15,132 @@
 #include "tuya_error_code.h"
 #include "cJSON.h"
 #include "matop_service.h"
+#include "matop_tracker.h"
 #include "atop_base.h"
 #include "tal_api.h"
 
 #define MATOP_DEFAULT_BUFFER_LEN (128)
+#define MATOP_HEAP_INIT_SIZE     (8)
+
+#define MESSAGE_BUCKET(id) ((id) & (MATOP_MESSAGE_BUCKETS - 1))
+
+/* -------------------------------------------------------------------------- */
+/*                              Message tracker                               */
+/* -------------------------------------------------------------------------- */
+static void matop_heap_set(matop_context_t *matop, uint32_t index, mqtt_atop_message_t *message)
+{
+    matop->message_heap[index] = message;
+    message->heap_index = index;
+}
+
+static void matop_heap_sift_up(matop_context_t *matop, uint32_t index)
+{
+    mqtt_atop_message_t *message = matop->message_heap[index];
+
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (matop->message_heap[parent]->timeout <= message->timeout) {
+            break;
+        }
+        matop_heap_set(matop, index, matop->message_heap[parent]);
+        index = parent;
+    }
+    matop_heap_set(matop, index, message);
+}
+
+static void matop_heap_sift_down(matop_context_t *matop, uint32_t index)
+{
+    mqtt_atop_message_t *message = matop->message_heap[index];
+
+    for (;;) {
+        uint32_t child = index * 2 + 1;
+        if (child >= matop->message_count) {
+            break;
+        }
+        if (child + 1 < matop->message_count &&
+            matop->message_heap[child + 1]->timeout < matop->message_heap[child]->timeout) {
+            child++;
+        }
+        if (message->timeout <= matop->message_heap[child]->timeout) {
+            break;
+        }
+        matop_heap_set(matop, index, matop->message_heap[child]);
+        index = child;
+    }
+    matop_heap_set(matop, index, message);
+}
+
+/**
+ * @brief Tracks an outstanding message by deadline and by id.
+ *
+ * @param matop The MATOP context.
+ * @param message The message, its id and timeout must be set.
+ * @return Returns OPRT_OK on success, or OPRT_MALLOC_FAILED.
+ */
+int matop_message_track(matop_context_t *matop, mqtt_atop_message_t *message)
+{
+    if (matop->message_count == matop->message_heap_size) {
+        uint32_t size = matop->message_heap_size ? matop->message_heap_size * 2 : MATOP_HEAP_INIT_SIZE;
+        mqtt_atop_message_t **heap = tal_realloc(matop->message_heap, size * sizeof(mqtt_atop_message_t *));
+        if (heap == NULL) {
+            return OPRT_MALLOC_FAILED;
+        }
+        matop->message_heap = heap;
+        matop->message_heap_size = size;
+    }
+
+    matop->message_heap[matop->message_count] = message;
+    matop_heap_sift_up(matop, matop->message_count++);
+
+    mqtt_atop_message_t **bucket = &matop->message_bucket[MESSAGE_BUCKET(message->id)];
+    message->next = *bucket;
+    *bucket = message;
+    return OPRT_OK;
+}
+
+static void matop_message_untrack(matop_context_t *matop, mqtt_atop_message_t *message)
+{
+    mqtt_atop_message_t **current = &matop->message_bucket[MESSAGE_BUCKET(message->id)];
+    for (; *current; current = &(*current)->next) {
+        if (*current == message) {
+            *current = message->next;
+            break;
+        }
+    }
+
+    uint32_t index = message->heap_index;
+    mqtt_atop_message_t *last = matop->message_heap[--matop->message_count];
+    if (index == matop->message_count) {
+        return;
+    }
+    matop_heap_set(matop, index, last);
+    if (index > 0 && matop->message_heap[(index - 1) / 2]->timeout > last->timeout) {
+        matop_heap_sift_up(matop, index);
+    } else {
+        matop_heap_sift_down(matop, index);
+    }
+}
+
+/**
+ * @brief Finds an outstanding message by id and takes it out of the tracker.
+ *
+ * @param matop The MATOP context.
+ * @param id The message id.
+ * @return Returns the message, owned by the caller, or NULL if not found.
+ */
+mqtt_atop_message_t *matop_message_take(matop_context_t *matop, uint16_t id)
+{
+    mqtt_atop_message_t *message = matop->message_bucket[MESSAGE_BUCKET(id)];
+
+    while (message) {
+        if (message->id == id) {
+            matop_message_untrack(matop, message);
+            return message;
+        }
+        message = message->next;
+    }
+    return NULL;
+}
 
 /* -------------------------------------------------------------------------- */
 /*                              Internal callback                             */
@@ -46,14 +168,7 @@ static int matop_service_data_receive_cb(void *context, const uint8_t *input, si
     cJSON *data = cJSON_GetObjectItem(root, "data");
 
     /* found message id */
-    mqtt_atop_message_t *target_message = matop->message_list;
-    while (target_message) {
-        if (target_message->id == id) {
-            break;
-        }
-        target_message = target_message->next;
-    }
-
+    mqtt_atop_message_t *target_message = matop_message_take(matop, id);
     if (target_message == NULL) {
         PR_WARN("not found id.");
         cJSON_Delete(root);
@@ -80,18 +195,7 @@ static int matop_service_data_receive_cb(void *context, const uint8_t *input, si
     }
 
     cJSON_Delete(root);
-
-    /* remove target from list  */
-    mqtt_atop_message_t **current;
-    for (current = &matop->message_list; *current;) {
-        mqtt_atop_message_t *entry = *current;
-        if (entry == target_message) {
-            *current = entry->next;
-            tal_free(entry);
-        } else {
-            current = &entry->next;
-        }
-    }
+    tal_free(target_message);
     return 0;
 }
 
@@ -108,14 +212,7 @@ static int matop_service_file_rawdata_receive_cb(void *context, const uint8_t *i
     PR_INFO("file data id:%d", id);
 
     /* found message id */
-    mqtt_atop_message_t *target_message = matop->message_list;
-    while (target_message) {
-        if (target_message->id == id) {
-            break;
-        }
-        target_message = target_message->next;
-    }
-
+    mqtt_atop_message_t *target_message = matop_message_take(matop, id);
     if (target_message == NULL) {
         PR_WARN("not found id.");
         return OPRT_COM_ERROR;
@@ -134,17 +231,7 @@ static int matop_service_file_rawdata_receive_cb(void *context, const uint8_t *i
         target_message->notify_cb(&response, target_message->user_data);
     }
 
-    /* remove target from list  */
-    mqtt_atop_message_t **current;
-    for (current = &matop->message_list; *current;) {
-        mqtt_atop_message_t *entry = *current;
-        if (entry == target_message) {
-            *current = entry->next;
-            tal_free(entry);
-        } else {
-            current = &entry->next;
-        }
-    }
+    tal_free(target_message);
     return 0;
 }
 
@@ -214,8 +301,8 @@ int matop_serice_init(matop_context_t *context, const matop_config_t *config)
 /**
  * @brief Performs a yield operation for the MATOP service.
  *
- * This function removes the target from the message list if it has timed out.
- * If a timeout occurs, the corresponding callback function is called with a
+ * This function removes all the messages that have timed out, earliest
+ * deadline first. For each of them the callback function is called with a
  * failure response.
  *
  * @param context The MATOP context.
@@ -228,23 +315,21 @@ int matop_serice_yield(matop_context_t *context)
         return OPRT_INVALID_PARM;
     }
 
-    /* remove target from list  */
-    mqtt_atop_message_t **current;
-    for (current = &context->message_list; *current;) {
-        mqtt_atop_message_t *entry = *current;
-        if (tal_system_get_millisecond() > entry->timeout) {
-            PR_WARN("Message id %d timeout.", entry->id);
-            if (entry->notify_cb) {
-                entry->notify_cb(&(atop_base_response_t){.success = false}, entry->user_data);
-            }
-            *current = entry->next;
-            tal_free(entry);
-            return OPRT_TIMEOUT;
-        } else {
-            current = &entry->next;
+    int rt = OPRT_OK;
+    SYS_TIME_T now = tal_system_get_millisecond();
+
+    /* earliest deadline is on the top of the heap */
+    while (context->message_count && context->message_heap[0]->timeout < now) {
+        mqtt_atop_message_t *entry = context->message_heap[0];
+        matop_message_untrack(context, entry);
+        PR_WARN("Message id %d timeout.", entry->id);
+        if (entry->notify_cb) {
+            entry->notify_cb(&(atop_base_response_t){.success = false}, entry->user_data);
         }
+        tal_free(entry);
+        rt = OPRT_TIMEOUT;
     }
-    return OPRT_OK;
+    return rt;
 }
 
 /**
@@ -274,12 +359,15 @@ int matop_serice_destory(matop_context_t *context)
     tuya_mqtt_subscribe_message_callback_unregister(context->config.mqctx, topic_buffer);
     PR_DEBUG("MQTT unsubscribe %s result:%d", topic_buffer, ret);
 
-    /* remove target from list when destory */
-    mqtt_atop_message_t **current;
-    for (current = &context->message_list; *current;) {
-        mqtt_atop_message_t *entry = *current;
-        *current = entry->next;
-        tal_free(entry);
+    /* remove all messages when destory */
+    while (context->message_count) {
+        tal_free(context->message_heap[--context->message_count]);
+    }
+    memset(context->message_bucket, 0, sizeof(context->message_bucket));
+    if (context->message_heap) {
+        tal_free(context->message_heap);
+        context->message_heap = NULL;
+        context->message_heap_size = 0;
     }
 
     return OPRT_OK;
@@ -354,18 +442,12 @@ int matop_service_request_async(matop_context_t *context, const mqtt_atop_reques
         return rt;
     }
 
-    /* first head message */
-    if (matop->message_list == NULL) {
-        matop->message_list = message_handle;
-        return OPRT_OK;
-    }
-
-    /* add to message list */
-    mqtt_atop_message_t *target = matop->message_list;
-    while (target->next) {
-        target = target->next;
+    rt = matop_message_track(matop, message_handle);
+    if (rt != OPRT_OK) {
+        PR_ERR("matop message track error:%d", rt);
+        tal_free(message_handle);
+        return rt;
     }
-    target->next = message_handle;
 
     return OPRT_OK;
 }
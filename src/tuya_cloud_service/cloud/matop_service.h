@@ -37,10 +37,14 @@ typedef struct {
 
 typedef void (*mqtt_atop_response_cb_t)(atop_base_response_t *response, void *user_data);
 
+// outstanding message hash buckets, power of 2
+#define MATOP_MESSAGE_BUCKETS (64U)
+
 typedef struct mqtt_atop_message {
-    struct mqtt_atop_message *next;
+    struct mqtt_atop_message *next; // bucket chain
     uint16_t id;
-    uint32_t timeout;
+    uint32_t heap_index;
+    SYS_TIME_T timeout;
     mqtt_atop_response_cb_t notify_cb;
     void *user_data;
 } mqtt_atop_message_t;
@@ -54,7 +58,10 @@ typedef struct matop_context {
     matop_config_t config;
     uint32_t id_cnt;
     char resquest_topic[64];
-    mqtt_atop_message_t *message_list;
+    mqtt_atop_message_t *message_bucket[MATOP_MESSAGE_BUCKETS];
+    mqtt_atop_message_t **message_heap; // min-heap by timeout
+    uint32_t message_count;
+    uint32_t message_heap_size;
 } matop_context_t;
 
 /**
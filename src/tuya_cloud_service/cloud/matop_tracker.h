@@ -0,0 +1,43 @@
+/**
+ * @file matop_tracker.h
+ * @brief Message tracker of the MATOP service, internal to matop_service.c.
+ *
+ * Outstanding requests are kept in a min-heap ordered by deadline and in a
+ * hash indexed by message id. These functions are not part of the service API,
+ * callers go through matop_service_request_async.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef MATOP_TRACKER_H_
+#define MATOP_TRACKER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "matop_service.h"
+
+/**
+ * @brief Tracks an outstanding message by deadline and by id.
+ *
+ * @param context The MATOP context.
+ * @param message The message, its id and timeout must be set.
+ * @return Returns 0 on success, or a negative error code on failure.
+ */
+int matop_message_track(matop_context_t *context, mqtt_atop_message_t *message);
+
+/**
+ * @brief Finds an outstanding message by id and takes it out of the tracker.
+ *
+ * @param context The MATOP context.
+ * @param id The message id.
+ * @return Returns the message, owned by the caller, or NULL if not found.
+ */
+mqtt_atop_message_t *matop_message_take(matop_context_t *context, uint16_t id);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
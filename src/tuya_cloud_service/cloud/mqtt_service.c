@@ -31,7 +31,6 @@
 #include "cJSON.h"
 #include "mqtt_service.h"
 #include "tal_security.h"
-#include "crc32i.h"
 #include "tal_api.h"
 #include "tuya_protocol.h"
 
@@ -288,6 +287,217 @@ static void on_subscribe_message_default(uint16_t msgid, const mqtt_client_messa
 /* -------------------------------------------------------------------------- */
 /*                         MQTT Client event callback                         */
 /* -------------------------------------------------------------------------- */
+#define PUBLISH_BUCKET(msgid) ((msgid) & (TUYA_MQTT_PUBLISH_BUCKETS - 1))
+
+static void mqtt_publish_handle_free(mqtt_publish_handle_t *handle)
+{
+    tal_free(handle->payload);
+    tal_free(handle);
+}
+
+static void mqtt_publish_notify(mqtt_publish_handle_t *list, int result)
+{
+    mqtt_publish_handle_t *entry = NULL;
+
+    while (list) {
+        entry = list;
+        list = entry->next;
+        entry->cb(result, entry->user_data);
+        mqtt_publish_handle_free(entry);
+    }
+}
+
+/* ready queue is ordered by deadline, FIFO for the same deadline */
+static void mqtt_publish_ready_insert(tuya_mqtt_context_t *context, mqtt_publish_handle_t *handle)
+{
+    handle->next = NULL;
+    if (context->publish_ready == NULL) {
+        context->publish_ready = handle;
+        context->publish_ready_tail = handle;
+        return;
+    }
+
+    if (handle->timeout >= context->publish_ready_tail->timeout) {
+        context->publish_ready_tail->next = handle;
+        context->publish_ready_tail = handle;
+        return;
+    }
+
+    mqtt_publish_handle_t **next_handle = &context->publish_ready;
+    while ((*next_handle)->timeout <= handle->timeout) {
+        next_handle = &(*next_handle)->next;
+    }
+    handle->next = *next_handle;
+    *next_handle = handle;
+}
+
+static mqtt_publish_handle_t *mqtt_publish_ready_pop(tuya_mqtt_context_t *context)
+{
+    mqtt_publish_handle_t *handle = context->publish_ready;
+
+    if (handle) {
+        context->publish_ready = handle->next;
+        if (context->publish_ready == NULL) {
+            context->publish_ready_tail = NULL;
+        }
+        handle->next = NULL;
+    }
+    return handle;
+}
+
+/* retransmit queue is ordered by retransmit time, search from the tail */
+static void mqtt_publish_inflight_insert(tuya_mqtt_context_t *context, mqtt_publish_handle_t *handle)
+{
+    mqtt_publish_handle_t *pos = context->publish_inflight_tail;
+
+    while (pos && pos->resend > handle->resend) {
+        pos = pos->prev;
+    }
+
+    handle->prev = pos;
+    handle->next = pos ? pos->next : context->publish_inflight;
+    if (handle->next) {
+        handle->next->prev = handle;
+    } else {
+        context->publish_inflight_tail = handle;
+    }
+    if (pos) {
+        pos->next = handle;
+    } else {
+        context->publish_inflight = handle;
+    }
+}
+
+static void mqtt_publish_inflight_remove(tuya_mqtt_context_t *context, mqtt_publish_handle_t *handle)
+{
+    if (handle->prev) {
+        handle->prev->next = handle->next;
+    } else {
+        context->publish_inflight = handle->next;
+    }
+    if (handle->next) {
+        handle->next->prev = handle->prev;
+    } else {
+        context->publish_inflight_tail = handle->prev;
+    }
+    handle->next = NULL;
+    handle->prev = NULL;
+}
+
+static void mqtt_publish_bucket_add(tuya_mqtt_context_t *context, mqtt_publish_handle_t *handle)
+{
+    mqtt_publish_handle_t **bucket = &context->publish_bucket[PUBLISH_BUCKET(handle->msgid)];
+
+    handle->hash_next = *bucket;
+    *bucket = handle;
+}
+
+static mqtt_publish_handle_t *mqtt_publish_bucket_take(tuya_mqtt_context_t *context, uint16_t msgid)
+{
+    mqtt_publish_handle_t **next_handle = &context->publish_bucket[PUBLISH_BUCKET(msgid)];
+
+    for (; *next_handle; next_handle = &(*next_handle)->hash_next) {
+        mqtt_publish_handle_t *entry = *next_handle;
+        if (msgid == entry->msgid) {
+            *next_handle = entry->hash_next;
+            entry->hash_next = NULL;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* take the in-flight publish out of the window */
+static void mqtt_publish_inflight_take(tuya_mqtt_context_t *context, mqtt_publish_handle_t *handle)
+{
+    mqtt_publish_bucket_take(context, handle->msgid);
+    mqtt_publish_inflight_remove(context, handle);
+    context->publish_inflight_count--;
+}
+
+/* the session is clean after reconnect, send everything in flight again as new */
+static void mqtt_publish_inflight_requeue(tuya_mqtt_context_t *context)
+{
+    mqtt_publish_handle_t *entry = NULL;
+
+    while ((entry = context->publish_inflight)) {
+        mqtt_publish_inflight_take(context, entry);
+        entry->msgid = 0;
+        mqtt_publish_ready_insert(context, entry);
+    }
+}
+
+static mqtt_publish_handle_t *mqtt_publish_expire(tuya_mqtt_context_t *context, SYS_TIME_T now)
+{
+    mqtt_publish_handle_t *expired = NULL;
+    mqtt_publish_handle_t *entry = NULL;
+
+    while ((entry = context->publish_ready) && entry->timeout <= now) {
+        mqtt_publish_ready_pop(context);
+        entry->next = expired;
+        expired = entry;
+    }
+
+    return expired;
+}
+
+/**
+ * @brief Retransmit the publishes which are not acknowledged in time and
+ * fill the in-flight window from the ready queue.
+ *
+ * @param context Pointer to the MQTT context, publish_mutex locked.
+ * @param now Current time in ms.
+ * @return The list of publishes timed out while in flight.
+ */
+static mqtt_publish_handle_t *mqtt_publish_pump(tuya_mqtt_context_t *context, SYS_TIME_T now)
+{
+    mqtt_publish_handle_t *expired = NULL;
+    mqtt_publish_handle_t *entry = NULL;
+
+    while ((entry = context->publish_inflight) && entry->resend <= now) {
+        if (entry->timeout <= now) {
+            mqtt_publish_inflight_take(context, entry);
+            entry->next = expired;
+            expired = entry;
+            continue;
+        }
+
+        PR_DEBUG("PUBLISH retry ID:%d", entry->msgid);
+        mqtt_client_republish(context->mqtt_client, entry->msgid, entry->topic, entry->payload, entry->payload_length,
+                              MQTT_QOS_1);
+        mqtt_publish_inflight_remove(context, entry);
+        entry->resend = MIN(now + MQTT_PUBLISH_RETRY_INTERVAL_MS, entry->timeout);
+        mqtt_publish_inflight_insert(context, entry);
+    }
+
+    while (context->publish_inflight_count < MQTT_PUBLISH_INFLIGHT_MAX && (entry = context->publish_ready)) {
+        uint16_t msgid =
+            mqtt_client_publish(context->mqtt_client, entry->topic, entry->payload, entry->payload_length, MQTT_QOS_1);
+        if (msgid == 0) {
+            // keep it queued, try again next loop
+            break;
+        }
+        mqtt_publish_ready_pop(context);
+        entry->msgid = msgid;
+        entry->resend = MIN(now + MQTT_PUBLISH_RETRY_INTERVAL_MS, entry->timeout);
+        mqtt_publish_bucket_add(context, entry);
+        mqtt_publish_inflight_insert(context, entry);
+        context->publish_inflight_count++;
+    }
+
+    return expired;
+}
+
+static void mqtt_publish_release_all(tuya_mqtt_context_t *context)
+{
+    mqtt_publish_handle_t *entry = NULL;
+
+    mqtt_publish_inflight_requeue(context);
+    while ((entry = mqtt_publish_ready_pop(context))) {
+        mqtt_publish_handle_free(entry);
+    }
+}
+
 static void mqtt_client_connected_cb(void *client, void *userdata)
 {
     client = client;
@@ -309,6 +519,10 @@ static void mqtt_client_disconnected_cb(void *client, void *userdata)
     tuya_mqtt_context_t *context = (tuya_mqtt_context_t *)userdata;
     PR_INFO("mqtt client disconnected!");
     context->is_connected = false;
+
+    tal_mutex_lock(context->publish_mutex);
+    mqtt_publish_inflight_requeue(context);
+    tal_mutex_unlock(context->publish_mutex);
     if (context->on_disconnect) {
         context->on_disconnect(context, context->user_data);
     }
@@ -337,20 +551,18 @@ static void mqtt_client_puback_cb(void *client, uint16_t msgid, void *userdata)
     tuya_mqtt_context_t *context = (tuya_mqtt_context_t *)userdata;
     PR_DEBUG("PUBACK ID:%d", msgid);
 
-    /* LOCK */
-    /* publish async process */
-    mqtt_publish_handle_t **next_handle = &context->publish_list;
-    for (; *next_handle; next_handle = &(*next_handle)->next) {
-        mqtt_publish_handle_t *entry = *next_handle;
-        if (msgid == entry->msgid) {
-            entry->cb(OPRT_OK, entry->user_data);
-            *next_handle = entry->next;
-            tal_free(entry->payload);
-            tal_free(entry);
-            break;
-        }
+    tal_mutex_lock(context->publish_mutex);
+    mqtt_publish_handle_t *entry = mqtt_publish_bucket_take(context, msgid);
+    if (entry) {
+        mqtt_publish_inflight_remove(context, entry);
+        context->publish_inflight_count--;
+    }
+    tal_mutex_unlock(context->publish_mutex);
+
+    if (entry) {
+        entry->cb(OPRT_OK, entry->user_data);
+        mqtt_publish_handle_free(entry);
     }
-    /* UNLOCK */
 }
 
 /**
@@ -392,6 +604,11 @@ int tuya_mqtt_init(tuya_mqtt_context_t *context, const tuya_mqtt_config_t *confi
         return rt;
     }
 
+    rt = tal_mutex_create_init(&context->publish_mutex);
+    if (OPRT_OK != rt) {
+        return rt;
+    }
+
     /* MQTT Client object new */
     context->mqtt_client = mqtt_client_new();
     if (context->mqtt_client == NULL) {
@@ -656,34 +873,32 @@ int tuya_mqtt_client_publish_common(tuya_mqtt_context_t *context, const char *to
 
     mqtt_publish_handle_t *handle = tal_malloc(sizeof(mqtt_publish_handle_t));
     TUYA_CHECK_NULL_RETURN(handle, OPRT_MALLOC_FAILED);
-    handle->next = NULL;
-    handle->msgid = 0;
+    memset(handle, 0, sizeof(mqtt_publish_handle_t));
     handle->topic = (char *)topic;
-    handle->timeout = tal_time_get_posix() + timeout_ms;
+    handle->timeout = tal_system_get_millisecond() + timeout_ms;
     handle->cb = cb;
     handle->user_data = user_data;
     handle->payload_length = payload_length;
     handle->payload = tal_malloc(payload_length);
     if (handle->payload == NULL) {
+        tal_free(handle);
         return OPRT_MALLOC_FAILED;
     }
     memcpy(handle->payload, payload, payload_length);
 
+    tal_mutex_lock(context->publish_mutex);
+    mqtt_publish_ready_insert(context, handle);
     if (async == false) {
-        handle->msgid = mqtt_client_publish(context->mqtt_client, handle->topic, handle->payload,
-                                            handle->payload_length, MQTT_QOS_1);
-    }
-
-    if (context->publish_list == NULL) {
-        context->publish_list = handle;
+        /* send now if the window has room, otherwise it waits in the ready queue */
+        mqtt_publish_handle_t *expired = mqtt_publish_pump(context, tal_system_get_millisecond());
+        tal_mutex_unlock(context->publish_mutex);
+        mqtt_publish_notify(expired, OPRT_TIMEOUT);
         return OPRT_OK;
     }
+    tal_mutex_unlock(context->publish_mutex);
 
-    mqtt_publish_handle_t *last = context->publish_list;
-    while (last->next != NULL) {
-        last = last->next;
-    }
-    last->next = handle;
+    /* the loop task sends it */
+    tuya_mqtt_wakeup(context);
 
     return OPRT_OK;
 }
@@ -828,6 +1043,12 @@ int tuya_mqtt_loop(tuya_mqtt_context_t *context)
         return rt;
     }
 
+    /* publish waiting for a window slot may expire while offline */
+    tal_mutex_lock(context->publish_mutex);
+    mqtt_publish_handle_t *expired = mqtt_publish_expire(context, tal_system_get_millisecond());
+    tal_mutex_unlock(context->publish_mutex);
+    mqtt_publish_notify(expired, OPRT_TIMEOUT);
+
     /* reconnect */
     if (context->is_connected == false) {
         mqtt_status = mqtt_client_connect(context->mqtt_client);
@@ -851,26 +1072,11 @@ int tuya_mqtt_loop(tuya_mqtt_context_t *context)
         return rt;
     }
 
-    /* LOCK */
     /* publish async process */
-    mqtt_publish_handle_t **next_handle = &context->publish_list;
-    for (; *next_handle; next_handle = &(*next_handle)->next) {
-        mqtt_publish_handle_t *entry = *next_handle;
-
-        if (entry->timeout <= tal_time_get_posix()) {
-            entry->cb(OPRT_TIMEOUT, entry->user_data);
-            *next_handle = entry->next;
-            tal_free(entry->payload);
-            tal_free(entry);
-            continue;
-        }
-
-        if (entry->msgid <= 0) {
-            entry->msgid =
-                mqtt_client_publish(context->mqtt_client, entry->topic, entry->payload, entry->payload_length, 1);
-        }
-    }
-    /* UNLOCK */
+    tal_mutex_lock(context->publish_mutex);
+    expired = mqtt_publish_pump(context, tal_system_get_millisecond());
+    tal_mutex_unlock(context->publish_mutex);
+    mqtt_publish_notify(expired, OPRT_TIMEOUT);
 
     /* yield */
     mqtt_client_yield(context->mqtt_client);
@@ -878,6 +1084,21 @@ int tuya_mqtt_loop(tuya_mqtt_context_t *context)
     return rt;
 }
 
+/**
+ * @brief Wakes up the task blocked in tuya_mqtt_loop.
+ *
+ * @param context Pointer to the MQTT context.
+ * @return OPRT_OK on success, otherwise an error code.
+ */
+int tuya_mqtt_wakeup(tuya_mqtt_context_t *context)
+{
+    if (context == NULL || context->mqtt_client == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    return mqtt_client_wakeup(context->mqtt_client) == MQTT_STATUS_SUCCESS ? OPRT_OK : OPRT_COM_ERROR;
+}
+
 /**
  * @brief Destroys the MQTT context.
  *
@@ -894,6 +1115,11 @@ int tuya_mqtt_destory(tuya_mqtt_context_t *context)
     }
 
     tuya_mqtt_protocol_unregister_all(context);
+    if (context->publish_mutex) {
+        mqtt_publish_release_all(context);
+        tal_mutex_release(context->publish_mutex);
+        context->publish_mutex = NULL;
+    }
     if (context->mqtt_client) {
         mqtt_client_status_t mqtt_status = mqtt_client_deinit(context->mqtt_client);
         mqtt_client_free(context->mqtt_client);
@@ -28,6 +28,8 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "cJSON.h"
+#include "tuya_cloud_types.h"
+#include "tal_mutex.h"
 #include "mqtt_client_interface.h"
 #include "backoff_algorithm.h"
 
@@ -41,6 +43,9 @@ extern "C" {
 #define TUYA_MQTT_TOPIC_MAXLEN      (64U)
 #define TUYA_MQTT_TOPIC_MAXLEN      (64U)
 
+// in-flight publish hash buckets, power of 2
+#define TUYA_MQTT_PUBLISH_BUCKETS (16U)
+
 // Tuya mqtt protocol
 #define PRO_DATA_PUSH            4  /* device -> cloud push dp data */
 #define PRO_CMD                  5  /* cloud -> device send dp data */
@@ -155,8 +160,11 @@ typedef void (*mqtt_publish_notify_cb_t)(int result, void *user_data);
 
 typedef struct mqtt_publish_handle {
     struct mqtt_publish_handle *next;
+    struct mqtt_publish_handle *prev;      // retransmit queue only
+    struct mqtt_publish_handle *hash_next; // in-flight bucket
     uint16_t msgid;
-    int timeout;
+    SYS_TIME_T timeout; // deadline, ms
+    SYS_TIME_T resend;  // next retransmit, ms
     char *topic;
     uint8_t *payload;
     size_t payload_length;
@@ -169,7 +177,13 @@ typedef struct {
     tuya_mqtt_access_t signature;
     tuya_protocol_handle_t *protocol_list;
     mqtt_subscribe_handle_t *subscribe_list;
-    mqtt_publish_handle_t *publish_list;
+    MUTEX_HANDLE publish_mutex;
+    mqtt_publish_handle_t *publish_ready; // waiting for a window slot, ordered by deadline
+    mqtt_publish_handle_t *publish_ready_tail;
+    mqtt_publish_handle_t *publish_inflight; // waiting for PUBACK, ordered by retransmit time
+    mqtt_publish_handle_t *publish_inflight_tail;
+    mqtt_publish_handle_t *publish_bucket[TUYA_MQTT_PUBLISH_BUCKETS];
+    uint32_t publish_inflight_count;
     BackoffAlgorithmContext_t backoff_algorithm;
     uint32_t sequence_in;
     uint32_t sequence_out;
@@ -228,6 +242,18 @@ int tuya_mqtt_stop(tuya_mqtt_context_t *context);
  */
 int tuya_mqtt_loop(tuya_mqtt_context_t *context);
 
+/**
+ * @brief Wakes up the task blocked in tuya_mqtt_loop.
+ *
+ * tuya_mqtt_loop sleeps until the MQTT socket is readable or the receive
+ * timeout expires. This function ends the sleep so that queued publishes
+ * are sent at once. It can be called from any task.
+ *
+ * @param context A pointer to the MQTT context structure.
+ * @return OPRT_OK on success, otherwise an error code.
+ */
+int tuya_mqtt_wakeup(tuya_mqtt_context_t *context);
+
 /**
  * @brief Destroys the MQTT context and releases any resources associated with
  * it.
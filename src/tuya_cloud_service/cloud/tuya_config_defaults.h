@@ -45,6 +45,23 @@
 #define MQTT_KEEPALIVE_INTERVALIN (120)
 #endif
 
+/**
+ * @brief Max count of QoS1 publishes waiting for PUBACK,
+ * must not exceed MQTT_STATE_ARRAY_MAX_COUNT of coreMQTT.
+ *
+ */
+#ifndef MQTT_PUBLISH_INFLIGHT_MAX
+#define MQTT_PUBLISH_INFLIGHT_MAX (8U)
+#endif
+
+/**
+ * @brief Retransmit interval of a QoS1 publish without PUBACK.
+ *
+ */
+#ifndef MQTT_PUBLISH_RETRY_INTERVAL_MS
+#define MQTT_PUBLISH_RETRY_INTERVAL_MS (3000U)
+#endif
+
 /**
  * @brief Defaults auto check upgrade interval.
  *
@@ -52,6 +52,8 @@ typedef enum {
 
 static tuya_iot_client_t *s_iot_client_solo;
 
+#define TUYA_IOT_RETRY_INTERVAL_MS (1000)
+
 /* -------------------------------------------------------------------------- */
 /*                          Internal utils functions                          */
 /* -------------------------------------------------------------------------- */
@@ -445,6 +447,23 @@ static void check_auto_upgrade_timeout_on(TIMER_ID timer, void *user_data)
 /*                       Internal machine state process                       */
 /* -------------------------------------------------------------------------- */
 
+/* block the yield task until timeout or tuya_iot_wakeup */
+static void tuya_iot_wait(tuya_iot_client_t *client, uint32_t timeout_ms)
+{
+    tal_semaphore_wait(client->wakeup, timeout_ms);
+}
+
+static int tuya_iot_link_status_change_cb(void *data)
+{
+    tuya_iot_client_t *client = tuya_iot_client_get();
+
+    if (client) {
+        tuya_iot_wakeup(client);
+    }
+
+    return OPRT_OK;
+}
+
 static int run_state_startup_update(tuya_iot_client_t *client)
 {
     int rt = OPRT_OK;
@@ -558,6 +577,7 @@ int tuya_iot_init(tuya_iot_client_t *client, const tuya_iot_config_t *config)
     PR_DEBUG("authkey:%s", client->config.authkey);
 
     tal_semaphore_create_init(&client->token_get.sem, 0, 1);
+    tal_semaphore_create_init(&client->wakeup, 0, 1);
 
     /* Default storage namespace */
     if (client->config.storage_namespace == NULL) {
@@ -615,6 +635,7 @@ int tuya_iot_start(tuya_iot_client_t *client)
         return OPRT_COM_ERROR;
     }
     client->nextstate = STATE_START;
+    tuya_iot_wakeup(client);
     return OPRT_OK;
 }
 
@@ -629,6 +650,7 @@ int tuya_iot_start(tuya_iot_client_t *client)
 int tuya_iot_stop(tuya_iot_client_t *client)
 {
     client->nextstate = STATE_STOP;
+    tuya_iot_wakeup(client);
     return OPRT_OK;
 }
 
@@ -649,6 +671,7 @@ int tuya_iot_reconnect(tuya_iot_client_t *client)
         return OPRT_COM_ERROR;
     }
     client->nextstate = STATE_MQTT_RECONNECT;
+    tuya_iot_wakeup(client);
     return OPRT_OK;
 }
 
@@ -688,10 +711,36 @@ int tuya_iot_reset(tuya_iot_client_t *client)
         client->token_get.result = OPRT_COM_ERROR;
         tal_semaphore_post(client->token_get.sem);
     }
+    tuya_iot_wakeup(client);
 
     return ret;
 }
 
+/**
+ * @brief Wakes up the Tuya IoT client task.
+ *
+ * tuya_iot_yield blocks while there is nothing to do, e.g. in the idle state,
+ * while waiting for the network or online on the MQTT socket. This function
+ * ends the wait so that a new state takes effect at once. It can be called
+ * from any task.
+ *
+ * @param client Pointer to the Tuya IoT client structure.
+ * @return OPRT_OK on success, otherwise an error code.
+ */
+int tuya_iot_wakeup(tuya_iot_client_t *client)
+{
+    if (client == NULL || client->wakeup == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    /* online the task sleeps in the MQTT loop on the socket */
+    if (client->mqctx.is_inited) {
+        tuya_mqtt_wakeup(&client->mqctx);
+    }
+
+    return tal_semaphore_post(client->wakeup);
+}
+
 /**
  * @brief Destroys the Tuya IoT client.
  *
@@ -786,7 +835,8 @@ int tuya_iot_yield(tuya_iot_client_t *client)
         break;
 
     case STATE_IDLE:
-        tal_system_sleep(500);
+        /* woken by tuya_iot_start */
+        tuya_iot_wait(client, SEM_WAIT_FOREVER);
         break;
 
     case STATE_START:
@@ -800,6 +850,8 @@ int tuya_iot_yield(tuya_iot_client_t *client)
         }
         TUYA_CALL_ERR_LOG(
             tal_event_subscribe(EVENT_LINK_TYPE_CHG, "iot", __tuya_iot_link_type_change_cb, SUBSCRIBE_TYPE_NORMAL));
+        TUYA_CALL_ERR_LOG(
+            tal_event_subscribe(EVENT_LINK_STATUS_CHG, "iot", tuya_iot_link_status_change_cb, SUBSCRIBE_TYPE_NORMAL));
         break;
 
     case STATE_DATA_LOAD:
@@ -855,7 +907,7 @@ int tuya_iot_yield(tuya_iot_client_t *client)
             client->status = TUYA_STATUS_WIFI_CONNECTED;
             client->nextstate = client->is_activated ? STATE_ENDPOINT_GET : STATE_ENDPOINT_UPDATE;
         } else {
-            tal_system_sleep(1000);
+            tuya_iot_wait(client, TUYA_IOT_RETRY_INTERVAL_MS);
         }
         break;
 
@@ -873,7 +925,7 @@ int tuya_iot_yield(tuya_iot_client_t *client)
     case STATE_ENDPOINT_UPDATE:
         rt = tuya_endpoint_update();
         if (rt != OPRT_OK) {
-            tal_system_sleep(1000);
+            tuya_iot_wait(client, TUYA_IOT_RETRY_INTERVAL_MS);
             break;
         }
         if (client->is_activated) {
@@ -891,7 +943,7 @@ int tuya_iot_yield(tuya_iot_client_t *client)
     case STATE_ACTIVATING:
         rt = client_activate_process(client, client->binding->token);
         if (rt != OPRT_OK) {
-            tal_system_sleep(1000);
+            tuya_iot_wait(client, TUYA_IOT_RETRY_INTERVAL_MS);
             break;
         }
 
@@ -936,6 +988,8 @@ int tuya_iot_yield(tuya_iot_client_t *client)
     case STATE_MQTT_CONNECT_START:
         if (run_state_mqtt_connect_start(client) == OPRT_OK) {
             client->nextstate = STATE_MQTT_CONNECTING;
+        } else {
+            tuya_iot_wait(client, TUYA_IOT_RETRY_INTERVAL_MS);
         }
         break;
 
@@ -963,7 +1017,7 @@ int tuya_iot_yield(tuya_iot_client_t *client)
             client->status = TUYA_STATUS_WIFI_CONNECTED;
             client->nextstate = STATE_MQTT_CONNECT_START;
         } else {
-            tal_system_sleep(1000);
+            tuya_iot_wait(client, TUYA_IOT_RETRY_INTERVAL_MS);
         }
         break;
 
@@ -223,6 +223,7 @@ struct tuya_iot_client_handle {
     matop_context_t matop;
     tuya_event_msg_t event;
     tuya_token_get_t token_get;
+    SEM_HANDLE wakeup;
     tuya_binding_info_t *binding;
     TIMER_ID check_upgrade_timer;
     uint8_t status;
@@ -282,6 +283,14 @@ int tuya_iot_reset(tuya_iot_client_t *client);
  */
 int tuya_iot_reconnect(tuya_iot_client_t *client);
 
+/**
+ * @brief Wake up the Tuya client task blocked in tuya_iot_yield.
+ *
+ * @param client - The Tuya client context.
+ * @return int - OPRT_OK successful or error code.
+ */
+int tuya_iot_wakeup(tuya_iot_client_t *client);
+
 /**
  * @brief Destroy the Tuya client and release resources.
  *
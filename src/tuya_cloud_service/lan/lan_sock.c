@@ -6,11 +6,11 @@
  * The mechanism is designed to manage multiple socket readers, handle socket
  * events efficiently, and provide a clean shutdown process.
  *
- * The implementation utilizes a select-based approach to monitor and react to
- * socket events across multiple sockets. It supports operations such as adding
- * a new socket reader, updating existing readers, and removing readers. Error
- * handling and socket event detection are integral parts of the loop to ensure
- * robust operation.
+ * The implementation is built on the tal_network event loop (epoll on Linux,
+ * select on lwIP), so only ready sockets are dispatched and a socket can be
+ * watched for writable while it has pending data. Registering or removing a
+ * reader wakes the loop immediately. Error handling and socket event detection
+ * are integral parts of the loop to ensure robust operation.
  *
  * Additionally, the file includes utility functions for setting up the
  * environment for socket event handling, including initializing and
@@ -28,6 +28,7 @@
 #include "lan_sock.h"
 #include "tal_api.h"
 #include "tal_network.h"
+#include "tal_network_evloop.h"
 #include "tuya_lan.h"
 
 #pragma pack(1)
@@ -38,8 +39,11 @@ typedef struct LAN_SLOOP_S {
     THREAD_HANDLE thread;
     int cnt;
     sloop_sock_t *readers;
+    uint32_t *watch;      // events each reader is registered with
+    TAL_NET_EVENT_T *evs; // ready events
     BOOL_T terminate;
     QUEUE_HANDLE queue;
+    TAL_NET_EVLOOP_HANDLE evloop;
 } LAN_SLOOP_S, *P_LAN_SLOOP_S;
 #pragma pack()
 
@@ -50,18 +54,31 @@ static P_LAN_SLOOP_S g_sloop = NULL;
 #define STACK_SIZE_LAN (4 * 1024)
 #endif
 
+// wake up period for pre_select handlers (session timeout check)
+#define LAN_SLOOP_TIMEOUT_MS 1000
+
 static uint32_t __ty_sock_get_reader_num(void)
 {
     return (LAN_UDP_READER_CNT + tuya_lan_get_client_num());
 }
 
-static void __sock_table_set_fds(TUYA_FD_SET_T *rfds, TUYA_FD_SET_T *efds)
+static void __sock_table_update_watch(void)
 {
     int idx;
+    uint32_t events;
     for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
-        if (g_sloop->readers[idx].sock >= 0) {
-            tal_net_fd_set(g_sloop->readers[idx].sock, rfds);
-            tal_net_fd_set(g_sloop->readers[idx].sock, efds);
+        if (g_sloop->readers[idx].sock < 0) {
+            continue;
+        }
+        events = TAL_NET_EV_READ;
+        if (g_sloop->readers[idx].write && g_sloop->readers[idx].write_pending &&
+            g_sloop->readers[idx].write_pending(g_sloop->readers[idx].sock)) {
+            events |= TAL_NET_EV_WRITE;
+        }
+        if (events != g_sloop->watch[idx]) {
+            if (OPRT_OK == tal_net_evloop_modify(g_sloop->evloop, g_sloop->readers[idx].sock, events)) {
+                g_sloop->watch[idx] = events;
+            }
         }
     }
 }
@@ -90,18 +107,32 @@ void __ty_sock_loop_deinit(void)
         for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
             if (g_sloop->readers[idx].sock != -1) {
                 PR_DEBUG("deinit lan sock %d and close it", g_sloop->readers[idx].sock);
+                if (g_sloop->evloop) {
+                    tal_net_evloop_del(g_sloop->evloop, g_sloop->readers[idx].sock);
+                }
                 tal_net_close(g_sloop->readers[idx].sock);
                 g_sloop->readers[idx].sock = -1;
                 g_sloop->readers[idx].pre_select = NULL;
                 g_sloop->readers[idx].read = NULL;
                 g_sloop->readers[idx].err = NULL;
                 g_sloop->readers[idx].quit = NULL;
+                g_sloop->readers[idx].write = NULL;
+                g_sloop->readers[idx].write_pending = NULL;
                 g_sloop->cnt--;
             }
         }
         tal_free(g_sloop->readers);
         g_sloop->readers = NULL;
     }
+    if (g_sloop->watch) {
+        tal_free(g_sloop->watch);
+    }
+    if (g_sloop->evs) {
+        tal_free(g_sloop->evs);
+    }
+    if (g_sloop->evloop) {
+        tal_net_evloop_release(g_sloop->evloop);
+    }
     if (g_sloop->queue) {
         tal_queue_free(g_sloop->queue);
     }
@@ -134,8 +165,14 @@ void __ty_add_sock_reader(sloop_sock_t sock_info)
         for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
             if (-1 == g_sloop->readers[idx].sock) {
                 PR_DEBUG("reg lan sock %d,read:%p", sock_info.sock, sock_info.read);
+                if (OPRT_OK != tal_net_evloop_add(g_sloop->evloop, sock_info.sock, TAL_NET_EV_READ,
+                                                  (void *)(intptr_t)idx)) {
+                    PR_ERR("watch lan sock %d err", sock_info.sock);
+                    return;
+                }
                 memset(&g_sloop->readers[idx], 0, sizeof(sloop_sock_t));
                 memcpy(&g_sloop->readers[idx], &sock_info, sizeof(sloop_sock_t));
+                g_sloop->watch[idx] = TAL_NET_EV_READ;
                 g_sloop->cnt++;
                 break;
             }
@@ -156,12 +193,16 @@ void __ty_del_sock_reader(int sock)
     for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
         if (g_sloop->readers[idx].sock == sock) {
             PR_DEBUG("unreg lan sock %d and close it", sock);
+            tal_net_evloop_del(g_sloop->evloop, g_sloop->readers[idx].sock);
             tal_net_close(g_sloop->readers[idx].sock);
+            g_sloop->watch[idx] = 0;
             g_sloop->readers[idx].sock = -1;
             // g_sloop->readers[idx].pre_select = NULL;
             g_sloop->readers[idx].read = NULL;
             g_sloop->readers[idx].err = NULL;
             g_sloop->readers[idx].quit = NULL;
+            g_sloop->readers[idx].write = NULL;
+            g_sloop->readers[idx].write_pending = NULL;
             g_sloop->cnt--;
             break;
         }
@@ -179,83 +220,54 @@ void tuya_sock_loop_run(void *data)
 {
     int actv_cnt = 0;
     int idx = 0;
-    TUYA_FD_SET_T *rfds, *efds;
+    int i = 0;
+    uint32_t timeout = 0;
     sloop_sock_t queue_data = {0};
 
-    rfds = tal_malloc(sizeof(TUYA_FD_SET_T));
-    efds = tal_malloc(sizeof(TUYA_FD_SET_T));
-    if (rfds == NULL || efds == NULL) {
-        PR_ERR("malloc err");
-        goto Err;
-    }
-    memset(rfds, 0, sizeof(TUYA_FD_SET_T));
-    memset(efds, 0, sizeof(TUYA_FD_SET_T));
-
     // while (tuya_get_sock_loop_terminate() &&
     // tal_thread_get_state(g_sloop->thread) == THREAD_STATE_RUNNING) {
     while (tuya_get_sock_loop_terminate()) {
         memset(&queue_data, 0, sizeof(sloop_sock_t));
-        if (tal_queue_fetch(g_sloop->queue, &queue_data, 0) == 0) {
+        while (tal_queue_fetch(g_sloop->queue, &queue_data, 0) == 0) {
             if (queue_data.read) {
                 __ty_add_sock_reader(queue_data);
             } else {
                 __ty_del_sock_reader(queue_data.sock);
             }
+            memset(&queue_data, 0, sizeof(sloop_sock_t));
         }
         for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
             if (g_sloop->readers[idx].pre_select) {
                 g_sloop->readers[idx].pre_select();
             }
         }
-        if (g_sloop->cnt == 0) {
-            tal_system_sleep(2000);
-            continue;
-        }
 
-        tal_net_fd_zero(rfds);
-        tal_net_fd_zero(efds);
-        __sock_table_set_fds(rfds, efds);
-        actv_cnt = tal_net_select(g_sloop->max_sock + 1, rfds, NULL, efds, 1 * 1000);
+        // nothing to watch, sleep until a reader is registered
+        timeout = (g_sloop->cnt == 0) ? TAL_NET_EVLOOP_WAIT_FOREVER : LAN_SLOOP_TIMEOUT_MS;
+        __sock_table_update_watch();
+        actv_cnt = tal_net_evloop_wait(g_sloop->evloop, g_sloop->evs, __ty_sock_get_reader_num(), timeout);
         if (actv_cnt < 0) {
             PR_ERR("errno:%d", tal_net_get_errno());
             __sock_select_err_handle();
             tal_system_sleep(1000);
             continue;
-        } else if (actv_cnt == 0) {
-            continue;
-        } else {
-            for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
-                if (g_sloop->readers[idx].sock >= 0) {
-                    if (0 == tal_net_fd_isset(g_sloop->readers[idx].sock, efds)) {
-                        continue;
-                    }
-                    if (g_sloop->readers[idx].err) {
-                        PR_ERR("socket err:%d, sock:%d, idx:%d", tal_net_get_errno(), g_sloop->readers[idx].sock, idx);
-                        g_sloop->readers[idx].err(g_sloop->readers[idx].sock);
-                    }
-                    actv_cnt--;
-                    if (0 == actv_cnt) {
-                        break;
-                    }
-                }
-            }
         }
 
-        if (0 == actv_cnt) {
-            continue;
-        }
-
-        for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
-            if (g_sloop->readers[idx].sock >= 0) {
-                if (tal_net_fd_isset(g_sloop->readers[idx].sock, rfds)) {
-                    if (g_sloop->readers[idx].read) {
-                        g_sloop->readers[idx].read(g_sloop->readers[idx].sock);
-                        actv_cnt--;
-                        if (0 == actv_cnt) {
-                            break;
-                        }
-                    }
-                }
+        for (i = 0; i < actv_cnt; i++) {
+            idx = (int)(intptr_t)g_sloop->evs[i].ctx;
+            if (idx < 0 || idx >= __ty_sock_get_reader_num() || g_sloop->readers[idx].sock != g_sloop->evs[i].fd) {
+                continue;
+            }
+            if ((g_sloop->evs[i].events & TAL_NET_EV_ERROR) && g_sloop->readers[idx].err) {
+                PR_ERR("socket err:%d, sock:%d, idx:%d", tal_net_get_errno(), g_sloop->readers[idx].sock, idx);
+                g_sloop->readers[idx].err(g_sloop->readers[idx].sock);
+            }
+            if ((g_sloop->evs[i].events & TAL_NET_EV_READ) && g_sloop->readers[idx].read) {
+                g_sloop->readers[idx].read(g_sloop->readers[idx].sock);
+            }
+            // drain pending tx data of writable socks
+            if ((g_sloop->evs[i].events & TAL_NET_EV_WRITE) && g_sloop->readers[idx].write) {
+                g_sloop->readers[idx].write(g_sloop->readers[idx].sock);
             }
         }
     }
@@ -266,14 +278,6 @@ void tuya_sock_loop_run(void *data)
         }
     }
 
-Err:
-    if (rfds) {
-        tal_free(rfds);
-    }
-    if (efds) {
-        tal_free(efds);
-    }
-
     tuya_lan_exit();
     __ty_sock_loop_deinit();
 
@@ -323,6 +327,21 @@ OPERATE_RET tuya_sock_loop_init(void)
     for (idx = 0; idx < __ty_sock_get_reader_num(); idx++) {
         g_sloop->readers[idx].sock = -1;
     }
+
+    g_sloop->watch = tal_malloc(__ty_sock_get_reader_num() * sizeof(uint32_t));
+    g_sloop->evs = tal_malloc(__ty_sock_get_reader_num() * sizeof(TAL_NET_EVENT_T));
+    if (NULL == g_sloop->watch || NULL == g_sloop->evs) {
+        PR_ERR("tal_malloc err");
+        op_ret = OPRT_MALLOC_FAILED;
+        goto Err;
+    }
+    memset(g_sloop->watch, 0, __ty_sock_get_reader_num() * sizeof(uint32_t));
+
+    op_ret = tal_net_evloop_create(&g_sloop->evloop, __ty_sock_get_reader_num());
+    if (OPRT_OK != op_ret) {
+        PR_ERR("init evloop err");
+        goto Err;
+    }
     THREAD_CFG_T thread_cfg = {.priority = THREAD_PRIO_2, .stackDepth = STACK_SIZE_LAN, .thrdname = "lan_sock_loop"};
 
     op_ret = tal_thread_create_and_start(&g_sloop->thread, NULL, NULL, tuya_sock_loop_run, NULL, &thread_cfg);
@@ -360,6 +379,7 @@ OPERATE_RET tuya_reg_lan_sock(sloop_sock_t sock_info)
         PR_ERR("queue post err");
         return op_ret;
     }
+    tal_net_evloop_wakeup(g_sloop->evloop);
     PR_DEBUG("reg post queue %d", sock_info.sock);
     return OPRT_OK;
 }
@@ -385,10 +405,26 @@ OPERATE_RET tuya_unreg_lan_sock(int sock)
         PR_ERR("queue post err");
         return op_ret;
     }
+    tal_net_evloop_wakeup(g_sloop->evloop);
     PR_DEBUG("unreg post queue %d", sock);
     return OPRT_OK;
 }
 
+/**
+ * @brief Wakes up the socket loop.
+ *
+ * This function wakes up the socket loop so that it re-evaluates which
+ * sockets have pending data and need to be watched for writable.
+ */
+void tuya_sock_loop_wakeup(void)
+{
+    if (NULL == g_sloop) {
+        return;
+    }
+
+    tal_net_evloop_wakeup(g_sloop->evloop);
+}
+
 /**
  * @brief Disables the socket loop for Tuya Cloud service.
  *
@@ -402,6 +438,7 @@ void tuya_sock_loop_disable(void)
     }
 
     g_sloop->terminate = FALSE;
+    tal_net_evloop_wakeup(g_sloop->evloop);
 }
 
 /**
@@ -452,6 +489,9 @@ void tuya_dump_lan_sock_reader(void)
             if (g_sloop->readers[idx].quit) {
                 PR_DEBUG("quit:%p", g_sloop->readers[idx].quit);
             }
+            if (g_sloop->readers[idx].write) {
+                PR_DEBUG("write:%p", g_sloop->readers[idx].write);
+            }
         }
     }
     PR_DEBUG("**************lan sock reader info dump end**************");
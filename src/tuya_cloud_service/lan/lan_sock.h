@@ -57,6 +57,23 @@ typedef void (*sloop_sock_err)(int sock);
  */
 typedef void (*sloop_sock_quit)();
 
+/**
+ * @brief sock writable handler
+ *
+ * @param[in] sock fd
+ *
+ */
+typedef void (*sloop_sock_write)(int sock);
+
+/**
+ * @brief query if sock has pending data to send
+ *
+ * @param[in] sock fd
+ *
+ * @return TRUE when the sock should be watched for writable
+ */
+typedef BOOL_T (*sloop_sock_write_pending)(int sock);
+
 /**
  * @brief reg sock info
  *
@@ -67,6 +84,8 @@ typedef struct sloop_sock_t {
     sloop_sock_read read;
     sloop_sock_err err;
     sloop_sock_quit quit;
+    sloop_sock_write write;
+    sloop_sock_write_pending write_pending;
 } sloop_sock_t;
 
 /**
@@ -91,6 +110,14 @@ OPERATE_RET tuya_reg_lan_sock(sloop_sock_t sock_info);
  */
 OPERATE_RET tuya_unreg_lan_sock(int sock);
 
+/**
+ * @brief wake up sock loop
+ *
+ * @note used when a sock gets pending data to send, so the loop starts
+ * watching it for writable without waiting for the loop timeout
+ */
+void tuya_sock_loop_wakeup(void);
+
 /**
  * @brief set sock loop disable
  *
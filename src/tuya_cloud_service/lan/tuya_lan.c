@@ -28,14 +28,16 @@
 #include "mix_method.h"
 #include "lan_sock.h"
 #include "tuya_iot_dp.h"
-#include "crc32i.h"
 #include "cJSON.h"
 #include "netmgr.h"
 
 #define SERV_PORT_TCP           6668 // device listens for the APP TCP connection
 #define SERV_PORT_APP_UDP_BCAST 7000 // APP broadcast, device listening port
+#define SERV_PORT_UDP_BCAST     6667 // device broadcast, APP listening port
 
 #define UDP_T_ITRV         5 // s
+#define UDP_BCAST_ITRV_MIN 1000                      // ms, after boot, link up or APP query
+#define UDP_BCAST_ITRV_MAX (UDP_T_ITRV * 1000 * 12) // ms, backoff limit when idle
 #define CLIENT_LMT         3
 #define RECV_BUF_LMT       512
 #define LAN_FRAME_MAX_LEN  (4 * 1024)
@@ -46,10 +48,34 @@
 #define RAND_LEN       16
 #define SESSIONKEY_LEN 16
 
+#define LAN_DISC_JSON_MAX_LEN 256
+#define LAN_DISC_FRAME_MAX_LEN                                                                                         \
+    (LPV35_FRAME_HEAD_SIZE + sizeof(lpv35_additional_data_t) + LPV35_FRAME_NONCE_SIZE +                                \
+     sizeof(lpv35_plaintext_data_t) + LAN_DISC_JSON_MAX_LEN + LPV35_FRAME_TAG_SIZE + LPV35_FRAME_TAIL_SIZE)
+
+/* frames are serialized into the arena and kept there until the socket
+ * accepts them, so lan_send never blocks the caller nor allocates */
+typedef struct {
+    MUTEX_HANDLE mutex;
+    uint32_t head; // first byte not yet sent
+    uint32_t tail; // end of queued data
+    uint8_t buf[LAN_FRAME_MAX_LEN];
+} lan_tx_arena_t;
+
+/* received bytes of a tcp session, frames are decoded in place and a partial
+ * frame stays in the buffer until the rest of it arrives */
+typedef struct {
+    uint32_t head; // first byte not yet decoded
+    uint32_t tail; // end of received data
+    uint8_t buf[LAN_FRAME_MAX_LEN];
+} lan_rx_stream_t;
+
 typedef struct {
     BOOL_T active;
     BOOL_T fault;
     int fd;
+    lan_tx_arena_t *tx; // keep across session reuse
+    lan_rx_stream_t *rx; // keep across session reuse
     TIME_T time;
     uint32_t sequence_in;
     uint32_t sequence_out;
@@ -92,8 +118,15 @@ typedef struct {
 
     tuya_iot_client_t *iot_client;
     lan_cfg_t *cfg;
+
+    // discovery, the encrypted frame is cached until link or activation changes
+    TIMER_ID bcast_timer;
+    uint32_t bcast_itrv;
+    BOOL_T disc_valid;
+    BOOL_T disc_activated;
+    int disc_len;
+    uint8_t disc_frame[LAN_DISC_FRAME_MAX_LEN];
     // extension
-    uint32_t recv_offset;
     uint8_t recv_buf[0]; // keep it last !!!
 } lan_mgr_t;
 
@@ -113,8 +146,23 @@ static lan_mgr_t *lan_mgr_get(void)
 
 static void lan_session_free(lan_session_t *session)
 {
+    lan_tx_arena_t *tx = session->tx;
+    lan_rx_stream_t *rx = session->rx;
+
     memset(session, 0, sizeof(lan_session_t));
     session->fd = -1;
+    session->tx = tx;
+    session->rx = rx;
+    if (rx) {
+        rx->head = 0;
+        rx->tail = 0;
+    }
+    if (tx) {
+        tal_mutex_lock(tx->mutex);
+        tx->head = 0;
+        tx->tail = 0;
+        tal_mutex_unlock(tx->mutex);
+    }
 }
 
 static void lan_session_close(lan_session_t *session)
@@ -427,6 +475,29 @@ static int lan_get_valid_socket_num(lan_mgr_t *lan)
     return (num - fault_cnt);
 }
 
+/* push queued bytes to the socket, caller must hold tx->mutex */
+static int lan_tx_flush(lan_session_t *session)
+{
+    lan_tx_arena_t *tx = session->tx;
+
+    while (tx->head < tx->tail) {
+        int ret = tal_net_send(session->fd, tx->buf + tx->head, tx->tail - tx->head);
+        if (ret <= 0) {
+            if ((tal_net_get_errno() == UNW_EINTR) || (tal_net_get_errno() == UNW_EAGAIN)) {
+                // socket buffer full, sock loop will drain it when writable
+                return OPRT_OK;
+            }
+            PR_ERR("ret:%d send_len:%d errno:%d", ret, tx->tail - tx->head, tal_net_get_errno());
+            return OPRT_SVC_LAN_SEND_ERR;
+        }
+        tx->head += ret;
+    }
+
+    tx->head = 0;
+    tx->tail = 0;
+    return OPRT_OK;
+}
+
 static int lan_send(lan_session_t *session, uint32_t fr_num, uint32_t fr_type, uint32_t ret_code, uint8_t *data,
                     uint32_t len, BOOL_T encryption)
 {
@@ -447,9 +518,6 @@ static int lan_send(lan_session_t *session, uint32_t fr_num, uint32_t fr_type, u
     }
     tal_mutex_unlock(s_lan_mgr->mutex);
 
-    uint8_t *send_buf = NULL;
-    uint32_t send_len = 0;
-
     PR_TRACE("tcp sendbuf socket:%d fr_num:%u fr_type:%d ret:%d len:%d", session->fd, fr_num, fr_type, ret_code, len);
 
     uint8_t *key = NULL;
@@ -464,57 +532,94 @@ static int lan_send(lan_session_t *session, uint32_t fr_num, uint32_t fr_type, u
         //! TODO:
         return OPRT_COM_ERROR;
     }
-    int plaintext_len = sizeof(lpv35_plaintext_data_t) + len;
-    lpv35_plaintext_data_t *plaintext_data = tal_malloc(plaintext_len);
-    if (plaintext_data == NULL) {
-        PR_ERR("plaintext_data fail");
-        return OPRT_MALLOC_FAILED;
+
+    lan_tx_arena_t *tx = session->tx;
+    uint32_t plaintext_len = sizeof(lpv35_plaintext_data_t) + len;
+    lpv35_frame_object_t frame = {.type = fr_type, .data_len = plaintext_len};
+    uint32_t frame_size = lpv35_frame_buffer_size_get(&frame);
+    if (frame_size > sizeof(tx->buf)) {
+        PR_ERR("lan frame len %d is out of limit", frame_size);
+        return OPRT_EXCEED_UPPER_LIMIT;
+    }
+
+    tal_mutex_lock(tx->mutex);
+    if (frame_size > sizeof(tx->buf) - tx->tail) {
+        memmove(tx->buf, tx->buf + tx->head, tx->tail - tx->head);
+        tx->tail -= tx->head;
+        tx->head = 0;
+    }
+    if (frame_size > sizeof(tx->buf) - tx->tail) {
+        PR_ERR("lan tx queue full, fd:%d pending:%d", session->fd, tx->tail);
+        tal_mutex_unlock(tx->mutex);
+        return OPRT_BUFFER_NOT_ENOUGH;
     }
-    memset(plaintext_data, 0, plaintext_len);
+
+    // build the plaintext where the ciphertext goes, lpv35 encrypts it in place
+    uint8_t *frame_buf = tx->buf + tx->tail;
+    lpv35_plaintext_data_t *plaintext_data =
+        (lpv35_plaintext_data_t *)(frame_buf + LPV35_FRAME_HEAD_SIZE + sizeof(lpv35_additional_data_t) +
+                                   LPV35_FRAME_NONCE_SIZE);
     plaintext_data->ret_code = ret_code;
-    memcpy(plaintext_data->data, data, len);
-    // lpv3.5 test arch
-    lpv35_frame_object_t frame = {.sequence = session->sequence_out++,
-                                  .type = fr_type,
-                                  .data = (void *)plaintext_data,
-                                  .data_len = plaintext_len};
-    send_buf = tal_malloc(lpv35_frame_buffer_size_get(&frame));
-    if (send_buf == NULL) {
-        PR_ERR("send_buf malloc fail");
-        tal_free(plaintext_data);
-        return OPRT_MALLOC_FAILED;
+    if (len) {
+        memcpy(plaintext_data->data, data, len);
     }
-    memset(send_buf, 0, lpv35_frame_buffer_size_get(&frame));
-    op_ret = lpv35_frame_serialize(key, 16, &frame, send_buf, (int *)&send_len);
-    tal_free(plaintext_data);
+    // lpv3.5 test arch
+    frame.sequence = session->sequence_out++;
+    frame.data = (void *)plaintext_data;
+
+    int send_len = 0;
+    op_ret = lpv35_frame_serialize(key, 16, &frame, frame_buf, &send_len);
     if (op_ret != OPRT_OK) {
         PR_ERR("lpv35_frame_serialize fail:%d", op_ret);
-        tal_free(send_buf);
+        tal_mutex_unlock(tx->mutex);
         return OPRT_COM_ERROR;
     }
-    tal_mutex_lock(s_lan_mgr->mutex);
-    int ret = tal_net_send(session->fd, send_buf, send_len);
-    if (ret <= 0 || ret != send_len) {
-        if ((tal_net_get_errno() == UNW_EINTR) || (tal_net_get_errno() == UNW_EAGAIN)) {
-            tal_system_sleep(100);
-            ret = tal_net_send(session->fd, send_buf, send_len);
-            if (ret <= 0 || ret != send_len) {
-                op_ret = OPRT_SVC_LAN_SEND_ERR;
-            }
-        } else {
-            op_ret = OPRT_SVC_LAN_SEND_ERR;
-        }
-    }
+    tx->tail += send_len;
 
-    tal_free(send_buf);
+    op_ret = lan_tx_flush(session);
+    BOOL_T pending = (tx->head != tx->tail);
+    tal_mutex_unlock(tx->mutex);
     if (op_ret == OPRT_SVC_LAN_SEND_ERR) {
         lan_session_fault_set(session);
-        PR_ERR("ret:%d send_len:%d errno:%d", ret, send_len, tal_net_get_errno());
+    } else if (pending) {
+        tuya_sock_loop_wakeup();
     }
-    tal_mutex_unlock(s_lan_mgr->mutex);
     return op_ret;
 }
 
+static BOOL_T lan_tcp_client_sock_write_pending(int fd)
+{
+    BOOL_T pending = FALSE;
+    lan_session_t *session = lan_session_get_by_fd(fd);
+
+    if (NULL == session || !session->active || NULL == session->tx) {
+        return FALSE;
+    }
+
+    tal_mutex_lock(session->tx->mutex);
+    pending = (session->tx->head != session->tx->tail);
+    tal_mutex_unlock(session->tx->mutex);
+
+    return pending;
+}
+
+static void lan_tcp_client_sock_write(int fd)
+{
+    int op_ret = OPRT_OK;
+    lan_session_t *session = lan_session_get_by_fd(fd);
+
+    if (NULL == session || !session->active || NULL == session->tx) {
+        return;
+    }
+
+    tal_mutex_lock(session->tx->mutex);
+    op_ret = lan_tx_flush(session);
+    tal_mutex_unlock(session->tx->mutex);
+    if (op_ret == OPRT_SVC_LAN_SEND_ERR) {
+        lan_session_fault_set(session);
+    }
+}
+
 static int lan_setup_udp_serv_socket(int port)
 {
     int ret = OPRT_OK;
@@ -544,7 +649,7 @@ __exit:
     return ret;
 }
 
-static void lan_make_udp_packets(uint8_t **out, int *p_olen)
+static int lan_make_udp_packets(uint8_t *out, int *p_olen)
 {
     int op_ret = OPRT_OK;
     NW_IP_S ip;
@@ -556,7 +661,6 @@ static void lan_make_udp_packets(uint8_t **out, int *p_olen)
 
     lan_mgr_t *lan = lan_mgr_get();
 
-    uint32_t offset = 0;
     char *id = NULL;
     if (lan->iot_client->is_activated) {
         id = lan->iot_client->activate.devid;
@@ -564,64 +668,173 @@ static void lan_make_udp_packets(uint8_t **out, int *p_olen)
         id = (char *)lan->iot_client->config.uuid;
     }
 
-    uint32_t data_len = 256;
-    char *json_buf = tal_malloc(data_len);
-    if (NULL == json_buf) {
-        PR_ERR("tal_malloc Fail");
-        return;
-    }
-    memset(json_buf, 0, data_len);
-
-    offset += sprintf(json_buf + offset, "{\"ip\":\"%s\",\"gwId\":\"%s\",\"uuid\":\"%s\"", ip.ip, id,
-                      lan->iot_client->config.uuid);
-    offset += sprintf(json_buf + offset, ",\"active\":%d,\"ablilty\":0", lan->iot_client->is_activated ? 2 : 0);
-    offset += sprintf(json_buf + offset, ",\"encrypt\":true");
-    offset += sprintf(json_buf + offset, ",\"productKey\":\"%s\"", lan->iot_client->config.productkey);
-    offset += sprintf(json_buf + offset, ",\"version\":\"%s\"", TUYA_LPV35);
-    offset += sprintf(json_buf + offset, ",\"sl\":%d", TUYA_SECURITY_LEVEL);
-    json_buf[offset] = '}';
-    json_buf[offset + 1] = 0;
-
-    // PR_DEBUG("BufToSend %d %d:%s",data_len, offset, json_buf);
-    int plaintext_len = sizeof(lpv35_plaintext_data_t) + strlen(json_buf);
-    lpv35_plaintext_data_t *plaintext_data = tal_malloc(plaintext_len);
-    if (plaintext_data == NULL) {
-        PR_ERR("plaintext_data fail");
-        tal_free(json_buf);
-        return;
-    }
-    memset(plaintext_data, 0, plaintext_len);
+    // write the json where the ciphertext goes, lpv35 encrypts it in place
+    lpv35_plaintext_data_t *plaintext_data =
+        (lpv35_plaintext_data_t *)(out + LPV35_FRAME_HEAD_SIZE + sizeof(lpv35_additional_data_t) +
+                                   LPV35_FRAME_NONCE_SIZE);
     plaintext_data->ret_code = 0;
-    memcpy(plaintext_data->data, json_buf, strlen(json_buf));
-    tal_free(json_buf);
+    int json_len = snprintf((char *)plaintext_data->data, LAN_DISC_JSON_MAX_LEN,
+                            "{\"ip\":\"%s\",\"gwId\":\"%s\",\"uuid\":\"%s\",\"active\":%d,\"ablilty\":0,"
+                            "\"encrypt\":true,\"productKey\":\"%s\",\"version\":\"%s\",\"sl\":%d}",
+                            ip.ip, id, lan->iot_client->config.uuid, lan->iot_client->is_activated ? 2 : 0,
+                            lan->iot_client->config.productkey, TUYA_LPV35, TUYA_SECURITY_LEVEL);
+    if (json_len < 0 || json_len >= LAN_DISC_JSON_MAX_LEN) {
+        PR_ERR("discovery json too long:%d", json_len);
+        return OPRT_BUFFER_NOT_ENOUGH;
+    }
 
     // lpv3.5 test arch
     lpv35_frame_object_t frame = {
         .sequence = 0,
         .type = FRM_TYPE_ENCRYPTION,
         .data = (uint8_t *)plaintext_data,
-        .data_len = plaintext_len,
+        .data_len = sizeof(lpv35_plaintext_data_t) + json_len,
     };
 
-    uint8_t *send_buf = tal_malloc(lpv35_frame_buffer_size_get(&frame));
-    if (send_buf == NULL) {
-        PR_ERR("send_buf malloc fail");
-        tal_free(plaintext_data);
-        return;
-    }
-    memset(send_buf, 0, lpv35_frame_buffer_size_get(&frame));
-    op_ret = lpv35_frame_serialize(app_key2, APP_KEY_LEN, &frame, send_buf, p_olen);
-    tal_free(plaintext_data);
+    op_ret = lpv35_frame_serialize(app_key2, APP_KEY_LEN, &frame, out, p_olen);
     if (op_ret != OPRT_OK) {
         PR_ERR("lpv35_frame_serialize fail:%d", op_ret);
-        tal_free(send_buf);
-        return;
+        return op_ret;
     }
 
     // tuya_debug_hex_dump("frame", 8, send_buf, olen);
     // PR_DEBUG("local key:%s", gw_cntl->gw_actv.local_key);
 
-    *out = send_buf;
+    return OPRT_OK;
+}
+
+/* send the cached discovery frame, rebuild it only when it went stale */
+static int lan_udp_disc_send(lan_mgr_t *lan, int fd, TUYA_IP_ADDR_T addr, uint16_t port)
+{
+    int ret = OPRT_OK;
+
+    tal_mutex_lock(lan->mutex);
+    if (!lan->disc_valid || lan->disc_activated != lan->iot_client->is_activated) {
+        lan->disc_activated = lan->iot_client->is_activated;
+        lan->disc_valid = (OPRT_OK == lan_make_udp_packets(lan->disc_frame, &lan->disc_len));
+    }
+    if (!lan->disc_valid) {
+        tal_mutex_unlock(lan->mutex);
+        return OPRT_COM_ERROR;
+    }
+    ret = tal_net_send_to(fd, lan->disc_frame, lan->disc_len, addr, port);
+    tal_mutex_unlock(lan->mutex);
+    if (ret < 0) {
+        PR_ERR("sendto Fail: len:%d ret:%d,errno:%d port:%d", lan->disc_len, ret, tal_net_get_errno(), port);
+        return OPRT_SVC_LAN_SEND_ERR;
+    }
+
+    return OPRT_OK;
+}
+
+static void lan_udp_disc_invalidate(lan_mgr_t *lan)
+{
+    tal_mutex_lock(lan->mutex);
+    lan->disc_valid = FALSE;
+    tal_mutex_unlock(lan->mutex);
+}
+
+/* go back to the fast broadcast pace */
+static void lan_udp_bcast_speedup(lan_mgr_t *lan)
+{
+    if (NULL == lan->bcast_timer) {
+        return;
+    }
+    tal_mutex_lock(lan->mutex);
+    lan->bcast_itrv = UDP_BCAST_ITRV_MIN;
+    tal_sw_timer_start(lan->bcast_timer, lan->bcast_itrv, TAL_TIMER_ONCE);
+    tal_mutex_unlock(lan->mutex);
+}
+
+static void lan_udp_bcast_timeout(TIMER_ID timer_id, void *arg)
+{
+    lan_mgr_t *lan = lan_mgr_get();
+    netmgr_status_e status = NETMGR_LINK_DOWN;
+
+    if (NULL == lan || lan->udp_client_fd < 0) {
+        return;
+    }
+
+    netmgr_conn_get(NETCONN_AUTO, NETCONN_CMD_STATUS, &status);
+    if (NETMGR_LINK_DOWN == status) {
+        // restarted by the link up event
+        return;
+    }
+
+    lan_udp_disc_send(lan, lan->udp_client_fd, TY_IPADDR_BROADCAST, SERV_PORT_UDP_BCAST);
+
+    // exponential backoff while nobody asks for us, the link event may reset the pace meanwhile
+    tal_mutex_lock(lan->mutex);
+    lan->bcast_itrv *= 2;
+    if (lan->bcast_itrv > UDP_BCAST_ITRV_MAX) {
+        lan->bcast_itrv = UDP_BCAST_ITRV_MAX;
+    }
+    tal_sw_timer_start(lan->bcast_timer, lan->bcast_itrv, TAL_TIMER_ONCE);
+    tal_mutex_unlock(lan->mutex);
+}
+
+static int lan_link_status_changed_cb(void *data)
+{
+    netmgr_status_e status = (netmgr_status_e)(intptr_t)data;
+    lan_mgr_t *lan = lan_mgr_get();
+
+    if (NULL == lan) {
+        return OPRT_OK;
+    }
+
+    // ip may have changed
+    lan_udp_disc_invalidate(lan);
+    if (NETMGR_LINK_DOWN == status) {
+        if (lan->bcast_timer) {
+            tal_sw_timer_stop(lan->bcast_timer);
+        }
+    } else {
+        lan_udp_bcast_speedup(lan);
+    }
+
+    return OPRT_OK;
+}
+
+static int lan_disc_reset_cb(void *data)
+{
+    lan_mgr_t *lan = lan_mgr_get();
+
+    if (lan) {
+        lan_udp_disc_invalidate(lan);
+    }
+
+    return OPRT_OK;
+}
+
+static int lan_udp_bcast_init(lan_mgr_t *lan)
+{
+    int op_ret = OPRT_OK;
+
+    lan->udp_client_fd = tal_net_socket_create(PROTOCOL_UDP);
+    if (lan->udp_client_fd < 0) {
+        PR_ERR("create udp client fd err:%d", tal_net_get_errno());
+        lan->udp_client_fd = -1;
+        return OPRT_SOCK_ERR;
+    }
+    tal_net_set_broadcast(lan->udp_client_fd);
+    tal_net_set_block(lan->udp_client_fd, false);
+
+    op_ret = tal_sw_timer_create(lan_udp_bcast_timeout, NULL, &lan->bcast_timer);
+    if (OPRT_OK != op_ret) {
+        PR_ERR("create udp bcast timer err:%d", op_ret);
+        tal_net_close(lan->udp_client_fd);
+        lan->udp_client_fd = -1;
+        lan->bcast_timer = NULL;
+        return op_ret;
+    }
+
+    tal_event_subscribe(EVENT_LINK_STATUS_CHG, "lan", lan_link_status_changed_cb, SUBSCRIBE_TYPE_NORMAL);
+    tal_event_subscribe(EVENT_RESET, "lan", lan_disc_reset_cb, SUBSCRIBE_TYPE_NORMAL);
+
+    // boot, broadcast fast for a while
+    lan_udp_bcast_speedup(lan);
+
+    return OPRT_OK;
 }
 
 /**
@@ -845,159 +1058,173 @@ static void lan_tcp_client_sock_err(int fd)
     return;
 }
 
-static void lan_tcp_client_sock_read(int32_t fd)
+/* move rx->head to the next frame head, drop the garbage before it */
+static BOOL_T lan_rx_stream_sync(lan_rx_stream_t *rx)
 {
-    int ret = 0;
-    uint8_t *frame_buffer = NULL;
-    uint8_t *tmp_recv_buf = NULL;
+    uint8_t *start = rx->buf + rx->head;
+    uint8_t *end = rx->buf + rx->tail;
+    uint8_t *p = start + LPV35_FRAME_HEAD_SIZE - 1;
+
+    // the last head byte is rare in the stream, scan for it and check the rest
+    while (p < end && NULL != (p = memchr(p, LPV35_FRAME_HEAD[LPV35_FRAME_HEAD_SIZE - 1], end - p))) {
+        if (0 == memcmp(p - (LPV35_FRAME_HEAD_SIZE - 1), LPV35_FRAME_HEAD, LPV35_FRAME_HEAD_SIZE - 1)) {
+            if (p - (LPV35_FRAME_HEAD_SIZE - 1) != start) {
+                PR_DEBUG("lan skip %d bytes", (int)(p - (LPV35_FRAME_HEAD_SIZE - 1) - start));
+            }
+            rx->head = p - (LPV35_FRAME_HEAD_SIZE - 1) - rx->buf;
+            return TRUE;
+        }
+        p++;
+    }
 
-    lan_mgr_t *lan = lan_mgr_get();
-    lan_session_t *session = lan_session_get_by_fd(fd);
+    // no head found, keep the bytes that may be the beginning of one
+    if (rx->tail - rx->head >= LPV35_FRAME_HEAD_SIZE) {
+        rx->head = rx->tail - (LPV35_FRAME_HEAD_SIZE - 1);
+    }
+    return FALSE;
+}
+
+static void lan_tcp_frame_process(lan_mgr_t *lan, lan_session_t *session, uint8_t *frame_buffer, uint32_t frame_len)
+{
+    int ret = 0;
+    lpv35_fixed_head_t *fixed_head = (lpv35_fixed_head_t *)(frame_buffer + LPV35_FRAME_HEAD_SIZE);
 
-    if (NULL == lan || NULL == session || !session->active) {
+    // verify sequence
+    uint32_t fr_sequence = UNI_NTOHL(fixed_head->sequence);
+    if (fr_sequence <= session->sequence_in) {
+        PR_ERR("fd:%d, sequence error in:%d, pre:%d", session->fd, fr_sequence, session->sequence_in);
+        PR_ERR("threshold:%d", lan->cfg->sequence_err_threshold);
+        if ((session->sequence_in - fr_sequence) >= lan->cfg->sequence_err_threshold) {
+            lan_session_close(session);
+        }
         return;
     }
+    PR_TRACE("fr_num in:%u, pre:%u", fr_sequence, session->sequence_in);
+    session->sequence_in = fr_sequence;
 
-    uint32_t offset = 0;
-    int recv_datalen = 0;
+    uint32_t fr_type = UNI_NTOHL(fixed_head->type);
+    uint8_t *key = NULL;
 
-    lan->recv_offset = 0;
+    //! TODO:
+    if (lan->iot_client->is_activated) {
+        if (fr_type == FRM_SECURITY_TYPE3 || fr_type == FRM_SECURITY_TYPE4 || fr_type == FRM_SECURITY_TYPE5) {
+            lan->cfg->allow_no_session_key_num = ALLOW_NO_KEY_NUM;
+            if (session->secret_key[0]) {
+                PR_WARN("already have the session_key, reset session..");
+                lan_session_close(session);
+                return;
+            }
+            key = (uint8_t *)lan->iot_client->activate.localkey;
+        } else {
+            if (0 == session->secret_key[0]) {
+                // fr_type come first than TYPE3,4,5, wait some packets
+                // before close(used in pressure test)
+                if (lan->cfg->allow_no_session_key_num > 0) {
+                    PR_ERR("allow no seesion key %d", lan->cfg->allow_no_session_key_num);
+                    lan->cfg->allow_no_session_key_num--;
+                } else {
+                    PR_ERR("ERROR, no session_key");
+                    lan_session_close(session);
+                    lan->cfg->allow_no_session_key_num = ALLOW_NO_KEY_NUM;
+                }
+                return;
+            }
+            // PR_DEBUG("use session_key");
+            key = (uint8_t *)session->secret_key;
+        }
+    } else {
+        //! TODO:
+        lan_session_close(session);
+        return;
+    }
 
-recv_again:
-    recv_datalen = tal_net_recv(fd, lan->recv_buf + lan->recv_offset, lan->cfg->bufsize - lan->recv_offset);
-    if (recv_datalen <= 0) {
-        PR_ERR("net recv err fd:%d,errno:%d", fd, tal_net_get_errno());
-        lan_session_fault_set(session);
+    // Heartbeat packet has no data content and responds directly
+    if (FRM_TP_HB == fr_type) {
+        ret = lan_send(session, 0, FRM_TP_HB, 0, NULL, 0, false);
+        PR_TRACE("lan heart beat:%d", ret);
+        lan_session_time_update(session, tal_time_get_posix());
         return;
     }
-    // recv data process
-    recv_datalen += lan->recv_offset;
-    if (recv_datalen < LPV35_FRAME_MINI_SIZE) {
-        PR_ERR("not enough data len:%d", recv_datalen);
+    //! TODO:
+    lpv35_frame_object_t frame_out = {0};
+    ret = lpv35_frame_parse(key, SESSIONKEY_LEN, frame_buffer, frame_len, &frame_out);
+    if (ret != OPRT_OK) {
+        PR_ERR("lpv35_frame_parse fail:%d", ret);
         return;
     }
+    // update time
+    lan_session_time_update(session, tal_time_get_posix());
+    lan_protocol_process(lan, session, &frame_out);
+    if (frame_out.data) {
+        tal_free(frame_out.data);
+    }
+}
 
-    offset = 0;
-    frame_buffer = NULL;
-    tmp_recv_buf = NULL;
-    while (recv_datalen >= LPV35_FRAME_MINI_SIZE + offset) {
-        if (tmp_recv_buf) {
+/* decode every complete frame in the rx stream, a partial one is kept */
+static void lan_rx_stream_process(lan_mgr_t *lan, lan_session_t *session)
+{
+    lan_rx_stream_t *rx = session->rx;
+
+    while (session->active && lan_rx_stream_sync(rx)) {
+        uint32_t avail = rx->tail - rx->head;
+        if (avail < LPV35_FRAME_MINI_SIZE) {
             break;
         }
-        if (memcmp(lan->recv_buf + offset, LPV35_FRAME_HEAD, LPV35_FRAME_HEAD_SIZE) != 0) {
-            offset++;
+
+        uint8_t *frame_buffer = rx->buf + rx->head;
+        lpv35_fixed_head_t *fixed_head = (lpv35_fixed_head_t *)(frame_buffer + LPV35_FRAME_HEAD_SIZE);
+        uint32_t length = UNI_NTOHL(fixed_head->length);
+        if (length > sizeof(rx->buf) - LPV35_FRAME_HEAD_SIZE - sizeof(lpv35_fixed_head_t) - LPV35_FRAME_TAIL_SIZE ||
+            length < LPV35_FRAME_NONCE_SIZE + LPV35_FRAME_TAG_SIZE) {
+            // not a frame we can take, resync after this head
+            PR_ERR("lan data len %d is out of limit", length);
+            rx->head++;
             continue;
         }
-        frame_buffer = lan->recv_buf + offset;
-        lpv35_fixed_head_t *fixed_head = (lpv35_fixed_head_t *)(frame_buffer + LPV35_FRAME_HEAD_SIZE);
-        // verify sequence
-        uint32_t fr_sequence = UNI_NTOHL(fixed_head->sequence);
-        if (fr_sequence <= session->sequence_in) {
-            PR_ERR("fd:%d, sequence error in:%d, pre:%d", session->fd, fr_sequence, session->sequence_in);
-            PR_ERR("threshold:%d", lan->cfg->sequence_err_threshold);
-            if ((session->sequence_in - fr_sequence) >= lan->cfg->sequence_err_threshold) {
-                lan_session_close(session);
-            }
+
+        uint32_t frame_len = LPV35_FRAME_HEAD_SIZE + sizeof(lpv35_fixed_head_t) + length + LPV35_FRAME_TAIL_SIZE;
+        if (frame_len > avail) {
             break;
         }
-        PR_TRACE("fr_num in:%u, pre:%u", fr_sequence, session->sequence_in);
-        session->sequence_in = fr_sequence;
-        // frame_len verify
-        uint32_t frame_len =
-            LPV35_FRAME_HEAD_SIZE + sizeof(lpv35_fixed_head_t) + UNI_NTOHL(fixed_head->length) + LPV35_FRAME_TAIL_SIZE;
-        if (frame_len > (recv_datalen - offset)) { // recv data not enough buf
-            if (frame_len >= LAN_FRAME_MAX_LEN) {
-                PR_ERR("lan data len is out of limit");
-                break;
-            }
-            tmp_recv_buf = tal_malloc(frame_len + 1);
-            if (NULL == tmp_recv_buf) {
-                PR_ERR("malloc error");
-                break;
-            }
-            memset(tmp_recv_buf, 0, frame_len + 1);
-            memcpy(tmp_recv_buf, lan->recv_buf + offset, recv_datalen - offset);
-            recv_datalen = recv_datalen - offset;
-            offset = 0;
-            ret = tal_net_recv_nd_size(session->fd, tmp_recv_buf + recv_datalen, frame_len + 1 - recv_datalen,
-                                       frame_len - recv_datalen);
-            if (ret < 0) {
-                PR_ERR("tuya_hal_net_recv_nd_size error ret:%d", ret);
-                break;
-            }
-            frame_buffer = tmp_recv_buf;
-        }
+        rx->head += frame_len;
+        lan_tcp_frame_process(lan, session, frame_buffer, frame_len);
+    }
 
-        uint32_t fr_type = UNI_NTOHL(fixed_head->type);
-        uint8_t *key = NULL;
+    if (rx->head == rx->tail) {
+        rx->head = 0;
+        rx->tail = 0;
+    }
+}
 
-        //! TODO:
-        if (lan->iot_client->is_activated) {
-            if (fr_type == FRM_SECURITY_TYPE3 || fr_type == FRM_SECURITY_TYPE4 || fr_type == FRM_SECURITY_TYPE5) {
-                lan->cfg->allow_no_session_key_num = ALLOW_NO_KEY_NUM;
-                if (session->secret_key[0]) {
-                    PR_WARN("already have the session_key, reset session..");
-                    lan_session_close(session);
-                    break;
-                }
-                key = (uint8_t *)lan->iot_client->activate.localkey;
-            } else {
-                if (0 == session->secret_key[0]) {
-                    // fr_type come first than TYPE3,4,5, wait some packets
-                    // before close(used in pressure test)
-                    if (lan->cfg->allow_no_session_key_num > 0) {
-                        PR_ERR("allow no seesion key %d", lan->cfg->allow_no_session_key_num);
-                        lan->cfg->allow_no_session_key_num--;
-                    } else {
-                        PR_ERR("ERROR, no session_key");
-                        lan_session_close(session);
-                        lan->cfg->allow_no_session_key_num = ALLOW_NO_KEY_NUM;
-                    }
-                    break;
-                }
-                // PR_DEBUG("use session_key");
-                key = (uint8_t *)session->secret_key;
-            }
-        } else {
-            //! TODO:
-            lan_session_close(session);
-            break;
-        }
+static void lan_tcp_client_sock_read(int32_t fd)
+{
+    lan_mgr_t *lan = lan_mgr_get();
+    lan_session_t *session = lan_session_get_by_fd(fd);
 
-        // Heartbeat packet has no data content and responds directly
-        if (FRM_TP_HB == fr_type) {
-            ret = lan_send(session, 0, FRM_TP_HB, 0, NULL, 0, false);
-            PR_TRACE("lan heart beat:%d", ret);
-            offset += frame_len;
-            lan_session_time_update(session, tal_time_get_posix());
-            continue;
-        }
-        //! TODO:
-        lpv35_frame_object_t frame_out = {0};
-        ret = lpv35_frame_parse(key, SESSIONKEY_LEN, frame_buffer, frame_len, &frame_out);
-        if (ret != OPRT_OK) {
-            PR_ERR("lpv35_frame_parse fail:%d", ret);
-            break;
-        }
-        offset += frame_len;
-        // update time
-        lan_session_time_update(session, tal_time_get_posix());
-        lan_protocol_process(lan, session, &frame_out);
-        if (frame_out.data) {
-            tal_free(frame_out.data);
-        }
+    if (NULL == lan || NULL == session || !session->active || NULL == session->rx) {
+        return;
     }
 
-    if (tmp_recv_buf) {
-        tal_free(tmp_recv_buf);
-    } else if (recv_datalen != offset) {
-        PR_DEBUG("recv_datalen:%d, offset:%d", recv_datalen, offset);
-        memmove(lan->recv_buf, lan->recv_buf + offset, recv_datalen - offset);
-        lan->recv_offset = recv_datalen - offset;
-        goto recv_again;
+    lan_rx_stream_t *rx = session->rx;
+    if (rx->head) {
+        memmove(rx->buf, rx->buf + rx->head, rx->tail - rx->head);
+        rx->tail -= rx->head;
+        rx->head = 0;
     }
 
-    return;
+    // one non-blocking read per readiness, a slow client never holds the loop
+    int recv_datalen = tal_net_recv(fd, rx->buf + rx->tail, sizeof(rx->buf) - rx->tail);
+    if (recv_datalen <= 0) {
+        if (recv_datalen < 0 && ((tal_net_get_errno() == UNW_EINTR) || (tal_net_get_errno() == UNW_EAGAIN))) {
+            return;
+        }
+        PR_ERR("net recv err fd:%d,errno:%d", fd, tal_net_get_errno());
+        lan_session_fault_set(session);
+        return;
+    }
+    rx->tail += recv_datalen;
+
+    lan_rx_stream_process(lan, session);
 }
 
 static void lan_tcp_serv_sock_read(int32_t fd)
@@ -1031,7 +1258,9 @@ static void lan_tcp_serv_sock_read(int32_t fd)
                               .pre_select = NULL,
                               .read = lan_tcp_client_sock_read,
                               .err = lan_tcp_client_sock_err,
-                              .quit = NULL};
+                              .quit = NULL,
+                              .write = lan_tcp_client_sock_write,
+                              .write_pending = lan_tcp_client_sock_write_pending};
 
     ret = tuya_reg_lan_sock(sock_info);
     if (OPRT_OK != ret) {
@@ -1132,28 +1361,9 @@ static void lan_udp_serv_sock_read(int32_t fd)
     cJSON_Delete(root);
     tal_free(frame_out.data);
 
-    int olen = 0;
-    uint8_t *send_buf = NULL;
-    lan_make_udp_packets(&send_buf, &olen);
-    if (NULL == send_buf) {
-        return;
-    }
-    int ret = tal_net_send_to(fd, send_buf, olen, addr_json, SERV_PORT_APP_UDP_BCAST);
-    if (ret < 0) {
-        if ((tal_net_get_errno() == UNW_EINTR) || (tal_net_get_errno() == UNW_EAGAIN)) {
-            tal_system_sleep(100);
-            ret = tal_net_send_to(fd, send_buf, olen, addr_json, SERV_PORT_APP_UDP_BCAST);
-            if (ret < 0) {
-                op_ret = OPRT_SVC_LAN_SEND_ERR;
-            }
-        } else {
-            op_ret = OPRT_SVC_LAN_SEND_ERR;
-        }
-    }
-    tal_free(send_buf);
-    if (op_ret == OPRT_SVC_LAN_SEND_ERR) {
-        PR_ERR("sendto Fail: len:%d ret:%d,errno:%d port:%d", olen, ret, tal_net_get_errno(), SERV_PORT_APP_UDP_BCAST);
-    }
+    // someone is looking for devices, answer and speed up the broadcast
+    lan_udp_disc_send(lan, fd, addr_json, SERV_PORT_APP_UDP_BCAST);
+    lan_udp_bcast_speedup(lan);
 }
 
 static void lan_udp_serv_sock_err(int fd)
@@ -1281,6 +1491,29 @@ int tuya_lan_init(tuya_iot_client_t *iot_client)
     memset(s_lan_mgr->session, 0, client_len);
     s_lan_mgr->iot_client = iot_client;
 
+    // preallocate tx arenas and rx streams, sessions never allocate afterwards
+    int i;
+    for (i = 0; i < s_lan_mgr->cfg->client_num; i++) {
+        s_lan_mgr->session[i].fd = -1;
+        s_lan_mgr->session[i].tx = tal_malloc(sizeof(lan_tx_arena_t));
+        if (NULL == s_lan_mgr->session[i].tx) {
+            op_ret = OPRT_MALLOC_FAILED;
+            goto __exit;
+        }
+        memset(s_lan_mgr->session[i].tx, 0, sizeof(lan_tx_arena_t));
+        op_ret = tal_mutex_create_init(&s_lan_mgr->session[i].tx->mutex);
+        if (OPRT_OK != op_ret) {
+            goto __exit;
+        }
+        s_lan_mgr->session[i].rx = tal_malloc(sizeof(lan_rx_stream_t));
+        if (NULL == s_lan_mgr->session[i].rx) {
+            op_ret = OPRT_MALLOC_FAILED;
+            goto __exit;
+        }
+        s_lan_mgr->session[i].rx->head = 0;
+        s_lan_mgr->session[i].rx->tail = 0;
+    }
+
     if (lan_tcp_create_serv_socket(s_lan_mgr) < 0) {
         PR_ERR("init tcp serv fd err");
         goto __exit;
@@ -1291,6 +1524,10 @@ int tuya_lan_init(tuya_iot_client_t *iot_client)
         goto __exit;
     }
 
+    if (OPRT_OK != lan_udp_bcast_init(s_lan_mgr)) {
+        PR_ERR("init udp broadcast err");
+    }
+
     PR_DEBUG("lan init success");
     return OPRT_OK;
 
@@ -1313,8 +1550,27 @@ int tuya_lan_exit(void)
     if (s_lan_mgr == NULL) {
         return OPRT_OK;
     }
+    tal_event_unsubscribe(EVENT_LINK_STATUS_CHG, "lan", lan_link_status_changed_cb);
+    tal_event_unsubscribe(EVENT_RESET, "lan", lan_disc_reset_cb);
+    if (s_lan_mgr->bcast_timer) {
+        tal_sw_timer_delete(s_lan_mgr->bcast_timer);
+        s_lan_mgr->bcast_timer = NULL;
+    }
     lan_session_close_all();
     if (s_lan_mgr->session) {
+        int i;
+        for (i = 0; i < s_lan_mgr->cfg->client_num; i++) {
+            lan_tx_arena_t *tx = s_lan_mgr->session[i].tx;
+            if (tx) {
+                if (tx->mutex) {
+                    tal_mutex_release(tx->mutex);
+                }
+                tal_free(tx);
+            }
+            if (s_lan_mgr->session[i].rx) {
+                tal_free(s_lan_mgr->session[i].rx);
+            }
+        }
         tal_free(s_lan_mgr->session);
         s_lan_mgr->session = NULL;
     }
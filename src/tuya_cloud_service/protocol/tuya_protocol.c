@@ -20,7 +20,6 @@
 
 #include "tuya_protocol.h"
 #include "tal_api.h"
-#include "crc32i.h"
 #include "mix_method.h"
 #include "uni_random.h"
 
@@ -0,0 +1,66 @@
+/**
+ * @file tkl_crc.h
+ * @brief Common process - adapter the crc api provide by OS
+ * @version 0.1
+ * @date 2025-03-20
+ *
+ * @copyright Copyright 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TKL_CRC_H__
+#define __TKL_CRC_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Feed data into a CRC-32/IEEE calculation with the hw CRC engine.
+ *
+ * @param[in,out] crc: raw CRC register, reflected, no final xor
+ * @param[in] data: data to be calculated
+ * @param[in] len: size of data in bytes
+ *
+ * @note This API is only used when ENABLE_PLATFORM_CRC is enabled. Return
+ * OPRT_NOT_SUPPORTED to fall back to the software implementation.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_crc32_update(uint32_t *crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Feed data into a CRC-32C/Castagnoli calculation with the hw CRC engine.
+ *
+ * @param[in,out] crc: raw CRC register, reflected, no final xor
+ * @param[in] data: data to be calculated
+ * @param[in] len: size of data in bytes
+ *
+ * @note This API is only used when ENABLE_PLATFORM_CRC is enabled. Return
+ * OPRT_NOT_SUPPORTED to fall back to the software implementation.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_crc32c_update(uint32_t *crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Feed data into a CRC-16/MODBUS calculation with the hw CRC engine.
+ *
+ * @param[in,out] crc: raw CRC register, reflected
+ * @param[in] data: data to be calculated
+ * @param[in] len: size of data in bytes
+ *
+ * @note This API is only used when ENABLE_PLATFORM_CRC is enabled. Return
+ * OPRT_NOT_SUPPORTED to fall back to the software implementation.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_crc16_update(uint16_t *crc, const uint8_t *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
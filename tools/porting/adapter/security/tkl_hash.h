@@ -84,6 +84,20 @@ OPERATE_RET tkl_sha256_update_ret(TKL_HASH_HANDLE ctx, const uint8_t *input, siz
  */
 OPERATE_RET tkl_sha256_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[32]);
 
+/**
+ * @brief This function clones the state of a sha256 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to continue one sha256 calculation several times, e.g.
+ * from a precomputed HMAC key state. Return OPRT_NOT_SUPPORTED if the state
+ * cannot be copied, the caller then restarts the calculation.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_sha256_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src);
+
 /**
  * @brief This function Create&initializes a md5 context.
  *
@@ -209,6 +223,20 @@ OPERATE_RET tkl_sha1_update_ret(TKL_HASH_HANDLE ctx, const uint8_t *input, size_
  * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
  */
 OPERATE_RET tkl_sha1_finish_ret(TKL_HASH_HANDLE ctx, uint8_t output[20]);
+
+/**
+ * @brief This function clones the state of a sha1 context.
+ *
+ * @param[out] dst: The destination context. This must be initialized.
+ * @param[in] src: The context to clone. This must be initialized.
+ *
+ * @note This API is used to continue one sha1 calculation several times, e.g.
+ * from a precomputed HMAC key state. Return OPRT_NOT_SUPPORTED if the state
+ * cannot be copied, the caller then restarts the calculation.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_sha1_clone(TKL_HASH_HANDLE dst, TKL_HASH_HANDLE src);
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
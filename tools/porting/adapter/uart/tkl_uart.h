@@ -56,6 +56,10 @@ OPERATE_RET tkl_uart_deinit(TUYA_UART_NUM_E port_id);
  * @param[in] data: write buff
  * @param[in] len:  buff len
  *
+ * @note Write as many bytes as the tx fifo takes, the caller retries with the
+ * rest. With tx dma enabled by tkl_uart_set_bulk_mode, the transfer is started
+ * and buff must stay valid until the tx callback is called.
+ *
  * @return return > 0: number of data written; return <= 0: write errror
  */
 int tkl_uart_write(TUYA_UART_NUM_E port_id, void *buff, uint16_t len);
@@ -104,6 +108,9 @@ void tkl_uart_tx_irq_cb_reg(TUYA_UART_NUM_E port_id, TUYA_UART_IRQ_CB tx_cb);
  * @param[out] data: read data
  * @param[in] len:  buff len
  *
+ * @note Must not block. Return all received data up to len, a return value
+ * less than len means the rx fifo (or rx dma buffer) is empty.
+ *
  * @return return >= 0: number of data read; return < 0: read errror
  */
 int tkl_uart_read(TUYA_UART_NUM_E port_id, void *buff, uint16_t len);
@@ -166,6 +173,37 @@ OPERATE_RET tkl_uart_wait_for_data(TUYA_UART_NUM_E port_id, int timeout_ms);
  */
 OPERATE_RET tkl_uart_ioctl(TUYA_UART_NUM_E port_id, uint32_t cmd, void *arg);
 
+/**
+ * @brief uart block transfer config
+ *
+ */
+typedef struct {
+    uint16_t rx_threshold; // call the rx callback once this many bytes are received
+    uint16_t rx_idle_bits; // call the rx callback after the line is idle for this many bit times, 0 to disable
+    BOOL_T rx_dma;         // receive by dma instead of the rx fifo interrupt
+    BOOL_T tx_dma;         // send by dma, the tx callback is called when the transfer is done
+} TUYA_UART_BULK_CFG_T;
+
+/**
+ * @brief set uart block transfer mode
+ *
+ * @param[in] port_id: uart port id, id index starts at 0
+ *                     in linux platform,
+ *                         high 16 bits aslo means uart type,
+ *                                   it's value must be one of the TUYA_UART_TYPE_E type
+ *                         the low 16bit - means uart port id
+ *                         you can input like this TUYA_UART_PORT_ID(TUYA_UART_SYS, 2)
+ * @param[in] cfg: block transfer config
+ *
+ * @note This API is only used when ENABLE_UART_BULK_TRANSFER is enabled. Return
+ * OPRT_NOT_SUPPORTED to keep the fifo interrupts. In block transfer mode the rx
+ * callback is called per chunk (threshold, idle line or dma half/full buffer)
+ * instead of per byte, and tkl_uart_read returns the whole chunk.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_uart_set_bulk_mode(TUYA_UART_NUM_E port_id, TUYA_UART_BULK_CFG_T *cfg);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -31,7 +31,8 @@ typedef struct {
     int fd;
     pthread_t tid;
     TUYA_UART_IRQ_CB rx_cb;
-    uint8_t readchar;
+    uint16_t readpos;
+    uint16_t readlen;
     uint8_t readbuff[1024];
 } uart_dev_t;
 
@@ -64,8 +65,9 @@ static void __udp_irq_handler(void *arg)
         select(uart_dev->fd + 1, &readfd, NULL, NULL, NULL);
         if (FD_ISSET(uart_dev->fd, &readfd)) {
             ssize_t readlen = recvfrom(uart_dev->fd, uart_dev->readbuff, sizeof(uart_dev->readbuff), 0, NULL, 0);
-            for (int i = 0; i < readlen; i++) {
-                uart_dev->readchar = uart_dev->readbuff[i];
+            if (readlen > 0) {
+                uart_dev->readpos = 0;
+                uart_dev->readlen = readlen;
                 uart_dev->rx_cb(1);
             }
         }
@@ -246,8 +248,14 @@ int tkl_uart_read(uint32_t port_id, void *buff, uint16_t len)
     if (0 == port_id) {
         return read(s_uart_dev[port_id].fd, buff, len);
     } else if (1 == port_id) {
-        *(uint8_t *)buff = s_uart_dev[port_id].readchar;
-        return 1;
+        uart_dev_t *uart_dev = &s_uart_dev[port_id];
+        uint16_t readlen = uart_dev->readlen - uart_dev->readpos;
+        if (readlen > len) {
+            readlen = len;
+        }
+        memcpy(buff, &uart_dev->readbuff[uart_dev->readpos], readlen);
+        uart_dev->readpos += readlen;
+        return readlen;
     }
 
     return -1;
@@ -322,3 +330,21 @@ OPERATE_RET tkl_uart_ioctl(uint32_t port_id, uint32_t cmd, void *arg)
 {
     return OPRT_NOT_SUPPORTED;
 }
+
+/**
+ * @brief set uart block transfer mode
+ *
+ * @param[in] port_id: uart port id, id index starts at 0
+ *                     in linux platform,
+ *                         high 16 bits aslo means uart type,
+ *                                   it's value must be one of the TUYA_UART_TYPE_E type
+ *                         the low 16bit - means uart port id
+ *                         you can input like this TUYA_UART_PORT_ID(TUYA_UART_SYS, 2)
+ * @param[in] cfg: block transfer config
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tkl_uart_set_bulk_mode(uint32_t port_id, TUYA_UART_BULK_CFG_T *cfg)
+{
+    return OPRT_NOT_SUPPORTED;
+}